@@ -39,6 +39,7 @@
 
 #include <ray/math.h>
 #include <ray/except.h>
+#include <ray/archive_map.h>
 #include <variant>
 
 _NAME_BEGIN
@@ -57,7 +58,7 @@ public:
 	using string_t = std::string;
 	using object_t = archivebuf;;
 	using array_t = std::vector<archivebuf>;
-	using map_t = std::list<std::pair<std::string, object_t>>;
+	using map_t = archive_map<std::string, object_t>;
 	using iterator = map_t::iterator;
 	using reverse_iterator = map_t::reverse_iterator;
 	using const_iterator = map_t::const_iterator;
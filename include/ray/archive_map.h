@@ -0,0 +1,281 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#ifndef _H_ARCHIVE_MAP_H_
+#define _H_ARCHIVE_MAP_H_
+
+#include <ray/platform.h>
+
+_NAME_BEGIN
+
+namespace detail
+{
+	template<typename _Iter, typename _Value>
+	class archive_map_iterator
+	{
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = std::remove_const_t<_Value>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = _Value*;
+		using reference = _Value&;
+
+	public:
+		archive_map_iterator() noexcept {}
+		archive_map_iterator(_Iter it) noexcept : _it(it) {}
+
+		template<typename _OtherIter, typename _OtherValue, typename = std::enable_if_t<std::is_convertible<_OtherIter, _Iter>::value>>
+		archive_map_iterator(const archive_map_iterator<_OtherIter, _OtherValue>& it) noexcept : _it(it.base()) {}
+
+		reference operator*() const noexcept { return **_it; }
+		pointer operator->() const noexcept { return *_it; }
+
+		archive_map_iterator& operator++() noexcept { ++_it; return *this; }
+		archive_map_iterator& operator--() noexcept { --_it; return *this; }
+
+		archive_map_iterator operator++(int) noexcept { auto it = *this; ++_it; return it; }
+		archive_map_iterator operator--(int) noexcept { auto it = *this; --_it; return it; }
+
+		bool operator==(const archive_map_iterator& other) const noexcept { return _it == other._it; }
+		bool operator!=(const archive_map_iterator& other) const noexcept { return _it != other._it; }
+
+		const _Iter& base() const noexcept { return _it; }
+
+	private:
+		_Iter _it;
+	};
+}
+
+// Insertion ordered key/value storage used by archivebuf objects.
+// Entries live in blocks owned by the map so their addresses stay valid while more keys
+// are appended, lookups compare a cached hash before the key and switch to an open
+// addressing index once the map holds more than index_threshold keys.
+// Duplicate keys are kept (xml documents repeat element names), lookups return the first one.
+template<typename _Key, typename _Tx>
+class archive_map final
+{
+public:
+	using key_type = _Key;
+	using mapped_type = _Tx;
+	using value_type = std::pair<_Key, _Tx>;
+	using size_type = std::size_t;
+
+	using iterator = detail::archive_map_iterator<typename std::vector<value_type*>::iterator, value_type>;
+	using const_iterator = detail::archive_map_iterator<typename std::vector<value_type*>::const_iterator, const value_type>;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	static constexpr size_type index_threshold = 8;
+	static constexpr size_type block_size = 4;
+
+public:
+	archive_map() noexcept
+		: _blockUsed(0)
+	{
+	}
+
+	~archive_map() noexcept
+	{
+	}
+
+	iterator begin() noexcept { return iterator(_entries.begin()); }
+	iterator end() noexcept { return iterator(_entries.end()); }
+
+	const_iterator begin() const noexcept { return const_iterator(_entries.begin()); }
+	const_iterator end() const noexcept { return const_iterator(_entries.end()); }
+
+	reverse_iterator rbegin() noexcept { return reverse_iterator(this->end()); }
+	reverse_iterator rend() noexcept { return reverse_iterator(this->begin()); }
+
+	const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(this->end()); }
+	const_reverse_iterator rend() const noexcept { return const_reverse_iterator(this->begin()); }
+
+	value_type& front() noexcept { assert(!_entries.empty()); return *_entries.front(); }
+	const value_type& front() const noexcept { assert(!_entries.empty()); return *_entries.front(); }
+
+	value_type& back() noexcept { assert(!_entries.empty()); return *_entries.back(); }
+	const value_type& back() const noexcept { assert(!_entries.empty()); return *_entries.back(); }
+
+	size_type size() const noexcept { return _entries.size(); }
+	bool empty() const noexcept { return _entries.empty(); }
+
+	template<typename _Other>
+	value_type* find(const _Other& key) noexcept
+	{
+		return const_cast<value_type*>(static_cast<const archive_map*>(this)->find(key));
+	}
+
+	template<typename _Other>
+	const value_type* find(const _Other& key) const noexcept
+	{
+		auto length = archive_map::length(key);
+		auto hash = archive_map::hash(archive_map::data(key), length);
+
+		if (_index.empty())
+		{
+			for (size_type i = 0; i < _entries.size(); i++)
+			{
+				if (_hashes[i] == hash && archive_map::equal(_entries[i]->first, archive_map::data(key), length))
+					return _entries[i];
+			}
+		}
+		else
+		{
+			auto mask = _index.size() - 1;
+			for (auto slot = hash & mask; _index[slot]; slot = (slot + 1) & mask)
+			{
+				auto n = _index[slot] - 1;
+				if (_hashes[n] == hash && archive_map::equal(_entries[n]->first, archive_map::data(key), length))
+					return _entries[n];
+			}
+		}
+
+		return nullptr;
+	}
+
+	value_type& push_back(value_type&& value)
+	{
+		if (_entries.empty())
+		{
+			_entries.reserve(block_size);
+			_hashes.reserve(block_size);
+		}
+
+		auto entry = this->_allocate();
+		*entry = std::move(value);
+
+		_entries.push_back(entry);
+		_hashes.push_back(archive_map::hash(entry->first.data(), entry->first.size()));
+
+		if (!_index.empty() && _entries.size() * 2 <= _index.size())
+			this->_insertIndex(_entries.size() - 1);
+		else if (_entries.size() > index_threshold)
+			this->_rehash();
+
+		return *entry;
+	}
+
+	void clear() noexcept
+	{
+		_entries.clear();
+		_hashes.clear();
+		_index.clear();
+		_blocks.clear();
+		_blockUsed = 0;
+	}
+
+private:
+	static std::uint32_t hash(const typename _Key::value_type* key, std::size_t length) noexcept
+	{
+		// FNV-1a
+		std::uint32_t value = 2166136261U;
+		for (std::size_t i = 0; i < length; i++)
+		{
+			value ^= (std::uint8_t)key[i];
+			value *= 16777619U;
+		}
+
+		return value;
+	}
+
+	static bool equal(const _Key& a, const typename _Key::value_type* b, std::size_t length) noexcept
+	{
+		return a.size() == length && std::char_traits<typename _Key::value_type>::compare(a.data(), b, length) == 0;
+	}
+
+	static const typename _Key::value_type* data(const _Key& key) noexcept { return key.data(); }
+	static const typename _Key::value_type* data(const typename _Key::value_type* key) noexcept { return key; }
+
+	static std::size_t length(const _Key& key) noexcept { return key.size(); }
+	static std::size_t length(const typename _Key::value_type* key) noexcept { return std::char_traits<typename _Key::value_type>::length(key); }
+
+	value_type* _allocate()
+	{
+		// blocks double in size so a map with n keys needs log(n) allocations
+		std::size_t capacity = _blocks.empty() ? block_size : block_size << (_blocks.size() - 1);
+		if (_blocks.empty() || _blockUsed == capacity)
+		{
+			capacity = _blocks.empty() ? block_size : capacity << 1;
+			_blocks.push_back(std::make_unique<value_type[]>(capacity));
+			_blockUsed = 0;
+		}
+
+		return &_blocks.back()[_blockUsed++];
+	}
+
+	void _insertIndex(size_type n) noexcept
+	{
+		auto mask = _index.size() - 1;
+		auto slot = _hashes[n] & mask;
+
+		for (; _index[slot]; slot = (slot + 1) & mask)
+		{
+			auto other = _index[slot] - 1;
+			if (_hashes[other] == _hashes[n] && _entries[other]->first == _entries[n]->first)
+				return;
+		}
+
+		_index[slot] = static_cast<std::uint32_t>(n + 1);
+	}
+
+	void _rehash()
+	{
+		size_type size = 16;
+		while (size < _entries.size() * 4)
+			size <<= 1;
+
+		_index.assign(size, 0);
+
+		for (size_type i = 0; i < _entries.size(); i++)
+			this->_insertIndex(i);
+	}
+
+private:
+	archive_map(const archive_map&) = delete;
+	archive_map& operator=(const archive_map&) = delete;
+
+private:
+	std::vector<value_type*> _entries;
+	std::vector<std::uint32_t> _hashes;
+	std::vector<std::uint32_t> _index;
+
+	std::vector<std::unique_ptr<value_type[]>> _blocks;
+	std::size_t _blockUsed;
+};
+
+_NAME_END
+
+#endif
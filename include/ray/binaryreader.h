@@ -0,0 +1,105 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#ifndef _H_BINARYREADER_H_
+#define _H_BINARYREADER_H_
+
+#include <ray/ioarchive.h>
+
+_NAME_BEGIN
+
+// Binary archive layout, every field is little endian and 4 byte aligned:
+//   header : 'RAYB', version, string count, string table size
+//   strings: { length, chars padded to 4 }
+//   node   : type, payload
+//            boolean/integer/unsigned/float : 4 bytes
+//            string      : length, chars padded to 4
+//            array       : byte size, count, nodes
+//            float array : count, floats (copied into float nodes)
+//            object      : byte size, count, { key index into string table, node }
+class EXPORT BinaryReader final : public iarchive
+{
+public:
+	BinaryReader() noexcept;
+	BinaryReader(StreamReader& stream) except;
+	BinaryReader(const std::string& path) except;
+	~BinaryReader() noexcept;
+
+	BinaryReader& open(StreamReader& stream) except;
+	BinaryReader& open(const std::string& path) except;
+	BinaryReader& open(const char* data, std::size_t length) except;
+
+	bool is_open() const noexcept;
+
+	void close() noexcept;
+
+	static bool canRead(StreamReader& stream) noexcept;
+
+private:
+	BinaryReader(const BinaryReader&) noexcept = delete;
+	BinaryReader& operator=(const BinaryReader&) noexcept = delete;
+
+private:
+	archivebuf _binary;
+};
+
+class EXPORT BinaryWrite final : public oarchive
+{
+public:
+	BinaryWrite() noexcept;
+	~BinaryWrite() noexcept;
+
+	BinaryWrite& save(StreamWrite& stream) except;
+	BinaryWrite& save(const std::string& path) except;
+
+	BinaryWrite& save(StreamWrite& stream, const iarchive& archive) except;
+	BinaryWrite& save(const std::string& path, const iarchive& archive) except;
+
+	void close() noexcept;
+
+	bool is_open() const noexcept;
+
+private:
+	BinaryWrite(const BinaryWrite&) noexcept = delete;
+	BinaryWrite& operator=(const BinaryWrite&) noexcept = delete;
+
+private:
+	archivebuf _binary;
+};
+
+_NAME_END
+
+#endif
@@ -38,7 +38,6 @@
 #define _H_FONT_DISTANCE_FIELD_H_
 
 #include <ray/font_bitmap.h>
-#include <ray/kdtree.h>
 
 struct FT_BitmapGlyphRec_;
 struct FT_LibraryRec_;
@@ -57,6 +56,16 @@ struct DFFINFOHEADER
 	std::uint32_t sizeOfBitmap;
 };
 
+// Scratch buffers for the distance transform, kept around so that a thread can reuse them from glyph to glyph.
+struct FontDistanceWorkspace
+{
+	std::vector<float> inside;
+	std::vector<float> outside;
+	std::vector<float> parabola;
+	std::vector<float> boundary;
+	std::vector<std::int32_t> vertex;
+};
+
 class EXPORT FontPointBitmap : public FontBitmap
 {
 public:
@@ -102,12 +111,15 @@ public:
 	FontDistanceField() noexcept;
 	virtual ~FontDistanceField() noexcept;
 
+	// Places the glyph at origin inside a gridWidth x gridHeight pixel grid and writes one signed distance
+	// texel per sampleSize pixels, where 128 lies on the contour and spread is the distance in pixels to 0 or 255.
+	static void computeDistanceField(const FT_BitmapGlyph bitmapGlyph, std::int32_t originX, std::int32_t originY, std::size_t gridWidth, std::size_t gridHeight, std::size_t sampleSize, float spread, std::uint8_t* bitmap, std::size_t pitch, FontDistanceWorkspace& workspace) noexcept;
+
 private:
 	virtual void computeBitmaps(FT_Library library, FT_Face face, std::size_t internalSize, std::size_t startCode, std::size_t endCode);
 
-	static void computeEdge(const FT_BitmapGlyph bitmapGlyph, std::size_t fontSize, std::size_t internalSize, KdimensionTree<short2>& nodes);
-	static void computeDistance(const FT_BitmapGlyph bitmapGlyph, KdimensionTree<short2>& nodes, std::size_t fontSize, std::size_t internalSize, std::size_t distanceSize, std::vector<float>& distance);
-	static void computeDistanceField(const std::vector<float>& distanceArray, std::vector<std::uint8_t>& bitmap, std::size_t fontSize, std::size_t bitmapSize, std::size_t distanceSize, std::size_t offsetX, std::size_t offsetY);
+	static void computeColumns(float* grid, std::size_t width, std::size_t height) noexcept;
+	static void computeRows(float* grid, std::size_t width, std::size_t height, FontDistanceWorkspace& workspace) noexcept;
 };
 
 _NAME_END
@@ -0,0 +1,166 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#ifndef _H_FONT_GLYPH_CACHE_H_
+#define _H_FONT_GLYPH_CACHE_H_
+
+#include <ray/font_distance_field.h>
+#include <ray/graphics_types.h>
+
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <condition_variable>
+
+_NAME_BEGIN
+
+// Distance-field glyphs rasterized on first use by worker threads and shelf-packed into a single atlas.
+//
+// getGlyph() never blocks: a glyph that is not in the atlas yet is queued and the call returns nullptr
+// until a later update() has packed it. Glyph metrics are in pixels of the rasterized font size,
+// offsetX/offsetY is the texel position in the atlas and the field spans width / getSampleSize() texels.
+// When the atlas runs out of room it is flushed, which invalidates every glyph handed out before.
+class EXPORT FontGlyphCache final
+{
+public:
+	FontGlyphCache() noexcept;
+	~FontGlyphCache() noexcept;
+
+	bool setup(StreamReader& stream, std::uint32_t fontSize = 64, std::uint32_t sampleSize = 2, std::uint32_t atlasSize = 1024, std::uint32_t numThreads = 0) noexcept;
+	bool setup(const std::string& fontpath, std::uint32_t fontSize = 64, std::uint32_t sampleSize = 2, std::uint32_t atlasSize = 1024, std::uint32_t numThreads = 0) noexcept;
+	void close() noexcept;
+
+	void preload(const std::wstring& charsets) noexcept;
+
+	const FontGlyph* getGlyph(std::uint32_t code) noexcept;
+
+	void update() noexcept;
+	void flush() noexcept;
+
+	std::uint32_t getFontSize() const noexcept;
+	std::uint32_t getSampleSize() const noexcept;
+	std::uint32_t getAtlasSize() const noexcept;
+	float getSpread() const noexcept;
+
+	const FontBitmaps& getBitmapData() const noexcept;
+	const GraphicsTexturePtr& getTexture() const noexcept;
+
+	std::size_t getNumGlyphs() const noexcept;
+	std::size_t getNumPending() const noexcept;
+	std::size_t getNumRasterized() const noexcept;
+	std::size_t getNumUploads() const noexcept;
+	std::size_t getNumUploadedBytes() const noexcept;
+	std::size_t getNumFlushes() const noexcept;
+
+	float getStartupTime() const noexcept;
+	float getRasterTime() const noexcept;
+	float getGlyphsPerSecond() const noexcept;
+
+private:
+	struct Shelf
+	{
+		std::uint32_t x;
+		std::uint32_t y;
+		std::uint32_t height;
+	};
+
+	struct Rasterized
+	{
+		FontGlyph glyph;
+
+		std::uint32_t width;
+		std::uint32_t height;
+		std::vector<std::uint8_t> field;
+
+		float time;
+	};
+
+	void rasterize(FT_Face face, std::uint32_t code, Rasterized& result, FontDistanceWorkspace& workspace) noexcept;
+	bool pack(std::uint32_t width, std::uint32_t height, std::uint32_t& x, std::uint32_t& y) noexcept;
+	void upload() noexcept;
+
+	void dispose(std::size_t thread) noexcept;
+
+private:
+	FontGlyphCache(const FontGlyphCache&) = delete;
+	FontGlyphCache& operator=(const FontGlyphCache&) = delete;
+
+private:
+	std::uint32_t _fontSize;
+	std::uint32_t _sampleSize;
+	std::uint32_t _atlasSize;
+	std::uint32_t _padding;
+	float _spread;
+
+	std::vector<std::uint8_t> _fontData;
+	std::vector<FT_Face> _faces;
+	std::vector<FT_Library> _librarys;
+
+	std::unordered_map<std::uint32_t, FontGlyph> _glyphs;
+	std::unordered_set<std::uint32_t> _requested;
+
+	std::vector<Shelf> _shelves;
+	std::uint32_t _shelfTop;
+
+	FontBitmaps _bitmap;
+	std::vector<std::uint8_t> _staging;
+	std::uint32_t _dirty[4];
+
+	GraphicsTexturePtr _texture;
+
+	std::size_t _numRasterized;
+	std::size_t _numUploads;
+	std::size_t _numUploadedBytes;
+	std::size_t _numFlushes;
+
+	float _startupTime;
+	float _rasterTime;
+
+	bool _quit;
+	std::deque<std::uint32_t> _requests;
+	std::vector<Rasterized> _results;
+	std::vector<Rasterized> _finished;
+
+	std::mutex _mutex;
+	std::condition_variable _dispatch;
+	std::vector<std::unique_ptr<std::thread>> _threads;
+};
+
+_NAME_END
+
+#endif
\ No newline at end of file
@@ -73,6 +73,10 @@ public:
 
 	virtual GameComponentPtr clone() const noexcept = 0;
 
+	// Returning true lets the frame callbacks of this type run on several threads at once,
+	// such a component must not touch other components nor add or remove dispatches from them.
+	virtual bool isThreadSafe() const noexcept;
+
 protected:
 	void sendMessage(const MessagePtr& message) except;
 	void sendMessageUpwards(const MessagePtr& message) except;
@@ -106,15 +110,23 @@ private:
 
 private:
 	friend GameObject;
+	friend GameObjectManager;
 	void _setGameObject(GameObject* gameobj) noexcept;
 
 private:
+	static const std::uint32_t dispatchNone = 0xFFFFFFFF;
 
 	bool _active;
 
 	std::string _name;
 
 	GameObject* _gameObject;
+
+	std::uint32_t _dispatchGroups[GameDispatchType::GameDispatchTypeFrameEnd + 1];
+	std::uint32_t _dispatchIndices[GameDispatchType::GameDispatchTypeFrameEnd + 1];
+
+	// position in the dispatch lists of the owning object, which hold every type and outlive deactivation
+	std::uint32_t _objectDispatchIndices[GameDispatchType::GameDispatchTypeRangeSize];
 };
 
 _NAME_END
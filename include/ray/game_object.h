@@ -165,10 +165,6 @@ private:
 	void _onActivate() except;
 	void _onDeactivate() noexcept;
 
-	void _onFrameBegin() except;
-	void _onFrame() except;
-	void _onFrameEnd() except;
-
 	void _onMoveBefore() except;
 	void _onMoveAfter() except;
 
@@ -216,6 +212,8 @@ private:
 
 	GameComponents _components;
 	std::vector<GameComponents> _dispatchComponents;
+
+	mutable std::vector<std::pair<const rtti::Rtti*, GameComponentPtr>> _componentCache;
 };
 
 _NAME_END
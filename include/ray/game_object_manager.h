@@ -38,6 +38,10 @@
 #define _H_GAME_OBJECT_MANAGER_H_
 
 #include <stack>
+#include <thread>
+#include <mutex>
+#include <unordered_map>
+#include <condition_variable>
 #include <ray/game_features.h>
 
 _NAME_BEGIN
@@ -74,17 +78,56 @@ public:
 
 private:
 	friend GameObject;
+	friend GameComponent;
 
 	void _instanceObject(GameObject* entity, std::size_t& instanceID) noexcept;
 	void _unsetObject(GameObject* entity) noexcept;
-	void _activeObject(GameObject* entity, bool active) noexcept;
+
+	void _addComponentDispatch(GameDispatchType type, GameComponent* component) noexcept;
+	void _removeComponentDispatch(GameDispatchType type, GameComponent* component) noexcept;
 
 private:
-	bool _hasEmptyActors;
+	// Components that want a frame callback, one contiguous group per concrete component type,
+	// so a group runs the same virtual function over and over and may be split across threads.
+	struct DispatchGroup
+	{
+		const rtti::Rtti* type;
+		bool threadSafe;
+		std::vector<GameComponent*> components;
+	};
+
+	struct DispatchList
+	{
+		std::vector<DispatchGroup> groups;
+		std::unordered_map<const rtti::Rtti*, std::uint32_t> indices;
+	};
+
+	void dispatch(GameDispatchType type) noexcept;
+	void dispatchGroup(GameDispatchType type, std::size_t group, std::size_t first, std::size_t last) noexcept;
+	void dispatchParallel(GameDispatchType type, std::size_t group) noexcept;
+	void compact(GameDispatchType type) noexcept;
+
+	void dispose() noexcept;
 
+private:
 	std::stack<std::size_t> _emptyLists;
 	std::vector<GameObject*> _instanceLists;
-	std::vector<GameObject*> _activeActors;
+
+	bool _isDispatching;
+	bool _hasEmptyComponents;
+	DispatchList _dispatchLists[GameDispatchType::GameDispatchTypeRangeSize];
+
+	bool _quit;
+	std::uint32_t _generation;
+	std::uint32_t _numBusy;
+	std::atomic<std::size_t> _nextComponent;
+	GameDispatchType _parallelType;
+	std::size_t _parallelGroup;
+
+	std::mutex _mutex;
+	std::condition_variable _dispatch;
+	std::condition_variable _finish;
+	std::vector<std::unique_ptr<std::thread>> _threads;
 };
 
 _NAME_END
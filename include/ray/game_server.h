@@ -113,6 +113,7 @@ private:
 	GameListenerPtr _gameListener;
 
 	MessageDispatcher _dispatcher;
+	Messages _dispatchEvents;
 };
 
 _NAME_END
@@ -68,6 +68,9 @@ public:
 	void setReceiveShadow(bool enable) noexcept;
 	bool getReceiveShadow() const noexcept;
 
+	std::uint32_t getShadowStaticFrame() const noexcept;
+	bool getShadowStatic() const noexcept;
+
 	void setMaterial(const MaterialPtr& material) noexcept;
 	const MaterialPtr& getMaterial() noexcept;
 
@@ -82,6 +85,9 @@ public:
 	GraphicsIndirectPtr getGraphicsIndirect() noexcept;
 
 private:
+	void onMoveBefore() noexcept;
+	void onMoveAfter() noexcept;
+
 	bool onVisiableTest(const Camera& camera, const Frustum& fru) noexcept;
 
 	void onAddRenderData(RenderDataManager& manager) noexcept;
@@ -94,6 +100,8 @@ private:
 	bool _isCastShadow;
 	bool _isReceiveShadow;
 
+	std::uint32_t _moveFrame;
+
 	MaterialPtr _material;
 	RenderPipelineStagePtr _pipelineStages[RenderQueue::RenderQueueRangeSize];
 	MaterialTechPtr _techniques[RenderQueue::RenderQueueRangeSize];
@@ -51,8 +51,12 @@ public:
 	void setDeviceType(GraphicsDeviceType type) noexcept;
 	GraphicsDeviceType getDeviceType() const noexcept;
 
+	void setShaderCachePath(const std::string& path) noexcept;
+	const std::string& getShaderCachePath() const noexcept;
+
 private:
 	GraphicsDeviceType _deviceType;
+	std::string _shaderCachePath;
 };
 
 class EXPORT GraphicsDevice : public rtti::Interface
@@ -77,6 +81,8 @@ public:
 	virtual GraphicsDescriptorSetPtr createDescriptorSet(const GraphicsDescriptorSetDesc& desc) noexcept = 0;
 	virtual GraphicsDescriptorSetLayoutPtr createDescriptorSetLayout(const GraphicsDescriptorSetLayoutDesc& desc) noexcept = 0;
 	virtual GraphicsDescriptorPoolPtr createDescriptorPool(const GraphicsDescriptorPoolDesc& desc) noexcept = 0;
+	virtual GraphicsTransientBufferPtr createTransientBuffer(const GraphicsTransientBufferDesc& desc) noexcept = 0;
+	virtual GraphicsQueryPtr createQuery(const GraphicsQueryDesc& desc) noexcept = 0;
 
 	virtual void copyDescriptorSets(GraphicsDescriptorSetPtr& source, std::uint32_t descriptorCopyCount, const GraphicsDescriptorSetPtr descriptorCopies[]) noexcept = 0;
 
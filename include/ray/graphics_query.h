@@ -2,7 +2,7 @@
 // | Project : ray.
 // | All rights reserved.
 // +----------------------------------------------------------------------
-// | Copyright (c) 2013-2014.
+// | Copyright (c) 2013-2017.
 // +----------------------------------------------------------------------
 // | * Redistribution and use of this software in source and binary forms,
 // |   with or without modification, are permitted provided that the following
@@ -34,81 +34,50 @@
 // | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // +----------------------------------------------------------------------
-#ifndef _H_OCCLUSION_OBJECT_H_
-#define _H_OCCLUSION_OBJECT_H_
+#ifndef _H_GRAPHICS_QUERY_H_
+#define _H_GRAPHICS_QUERY_H_
 
-#include <ray/occlusion_types.h>
+#include <ray/graphics_child.h>
 
 _NAME_BEGIN
 
-class OcclusionTree;
-class OcclusionObject
+class EXPORT GraphicsQueryDesc final
 {
 public:
-    OcclusionObject() noexcept;
-    virtual ~OcclusionObject() noexcept;
+	GraphicsQueryDesc() noexcept;
+	GraphicsQueryDesc(GraphicsQueryType type) noexcept;
+	~GraphicsQueryDesc() noexcept;
 
-    bool isLeaf() const noexcept;
-    bool isVirtualLeaf() const noexcept;
-
-    const Bound& getBoundingxBox() const noexcept;
-
-private:
-
-    friend OcclusionTree;
-
-    Bound _boundingBox;
-
-    int _depth;
-    int _leaves;
-
-    bool _isVirtualLeaf;
-
-    OcclusionObjectPtr _parent;
-};
-
-class OcclusionObjectLeaf
-{
-public:
-
-};
-
-class OcclusionObjectIterator
-{
-public:
-
-    OcclusionObjectPtr frist();
-    OcclusionObjectPtr second();
+	void setType(GraphicsQueryType type) noexcept;
+	GraphicsQueryType getType() const noexcept;
 
 private:
-
-    OcclusionObjectPtr _frist;
-    OcclusionObjectPtr _second;
+	GraphicsQueryType _type;
 };
 
-class OcclusionTree
+// Counts the samples that pass the depth and stencil tests between queryBegin() and queryEnd().
+// Results arrive some time after the draws were submitted, poll isAvailable() before reading
+// one to avoid waiting on the GPU.
+class EXPORT GraphicsQuery : public GraphicsChild
 {
+	__DeclareSubInterface(GraphicsQuery, GraphicsChild)
 public:
+	GraphicsQuery() noexcept;
+	virtual ~GraphicsQuery() noexcept;
 
-    void addOcclusionObject(OcclusionObjectPtr object) noexcept;
-
-    bool isVisiable(OcclusionObjectPtr object) noexcept;
+	virtual void queryBegin() noexcept = 0;
+	virtual void queryEnd() noexcept = 0;
 
-    void collectObjects(OcclusionObjectPtr root, OcclusionObjectContainer& container) noexcept;
+	virtual bool isAvailable() const noexcept = 0;
 
-    void computeBounds(OcclusionObjectPtr root) noexcept;
-    void computeLeaves(OcclusionObjectPtr root) noexcept;
+	// Blocks until the result is available
+	virtual std::uint32_t getResult() const noexcept = 0;
 
+	virtual const GraphicsQueryDesc& getGraphicsQueryDesc() const noexcept = 0;
 
 private:
-
-    Bound _boundingBox;
-
-    Frustum _frustum;
-
-    OcclusionObjectPtr _root;
-
-    std::vector<OcclusionObjectPtr> _occlusionObjects;
+	GraphicsQuery(const GraphicsQuery&) = delete;
+	GraphicsQuery& operator=(const GraphicsQuery&) = delete;
 };
 
 _NAME_END
@@ -0,0 +1,98 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#ifndef _H_GRAPHICS_TRANSIENT_BUFFER_H_
+#define _H_GRAPHICS_TRANSIENT_BUFFER_H_
+
+#include <ray/graphics_child.h>
+
+_NAME_BEGIN
+
+class EXPORT GraphicsTransientBufferDesc final
+{
+public:
+	GraphicsTransientBufferDesc() noexcept;
+	GraphicsTransientBufferDesc(GraphicsDataType type, std::size_t frameSize, std::uint32_t frameCount = 3) noexcept;
+	~GraphicsTransientBufferDesc() noexcept;
+
+	void setType(GraphicsDataType type) noexcept;
+	GraphicsDataType getType() const noexcept;
+
+	void setFrameSize(std::size_t size) noexcept;
+	std::size_t getFrameSize() const noexcept;
+
+	void setFrameCount(std::uint32_t count) noexcept;
+	std::uint32_t getFrameCount() const noexcept;
+
+private:
+	GraphicsDataType _type;
+	std::size_t _frameSize;
+	std::uint32_t _frameCount;
+};
+
+// Per-frame suballocator over one buffer of frameSize * frameCount bytes.
+// Allocations are valid until frameEnd(), after which the region is fenced and
+// only reused once the GPU has finished with it frameCount frames later.
+class EXPORT GraphicsTransientBuffer : public GraphicsChild
+{
+	__DeclareSubInterface(GraphicsTransientBuffer, GraphicsChild)
+public:
+	GraphicsTransientBuffer() noexcept;
+	virtual ~GraphicsTransientBuffer() noexcept;
+
+	// Returns false when the current frame region is full
+	virtual bool allocate(std::size_t size, std::size_t alignment, std::size_t& offset, void** data) noexcept = 0;
+
+	// Makes the writes visible to the GPU, call once before drawing with this frame's allocations
+	virtual void flush() noexcept = 0;
+	virtual void frameEnd() noexcept = 0;
+
+	virtual const GraphicsDataPtr& getGraphicsData() const noexcept = 0;
+
+	// Number of times allocate() had to block on a fence that was still pending
+	virtual std::size_t getWaitCount() const noexcept = 0;
+	virtual std::size_t getFrameNumber() const noexcept = 0;
+
+	virtual const GraphicsTransientBufferDesc& getGraphicsTransientBufferDesc() const noexcept = 0;
+
+private:
+	GraphicsTransientBuffer(const GraphicsTransientBuffer&) = delete;
+	GraphicsTransientBuffer& operator=(const GraphicsTransientBuffer&) = delete;
+};
+
+_NAME_END
+
+#endif
\ No newline at end of file
@@ -72,6 +72,8 @@ typedef std::shared_ptr<class GraphicsCommandPool> GraphicsCommandPoolPtr;
 typedef std::shared_ptr<class GraphicsCommandQueue> GraphicsCommandQueuePtr;
 typedef std::shared_ptr<class GraphicsCommandList> GraphicsCommandListPtr;
 typedef std::shared_ptr<class GraphicsSemaphore> GraphicsSemaphorePtr;
+typedef std::shared_ptr<class GraphicsTransientBuffer> GraphicsTransientBufferPtr;
+typedef std::shared_ptr<class GraphicsQuery> GraphicsQueryPtr;
 typedef std::shared_ptr<class GraphicsIndirect> GraphicsIndirectPtr;
 typedef std::shared_ptr<class GraphicsDeviceDesc> GraphicsDeviceDescPtr;
 typedef std::shared_ptr<class GraphicsSwapchainDesc> GraphicsSwapchainDescPtr;
@@ -94,6 +96,8 @@ typedef std::shared_ptr<class GraphicsCommandQueueDesc> GraphicsCommandQueueDesc
 typedef std::shared_ptr<class GraphicsCommandPoolDesc> GraphicsCommandPoolDescPtr;
 typedef std::shared_ptr<class GraphicsCommandListDesc> GraphicsCommandListDescPtr;
 typedef std::shared_ptr<class GraphicsSemaphoreDesc> GraphicsSemaphoreDescPtr;
+typedef std::shared_ptr<class GraphicsTransientBufferDesc> GraphicsTransientBufferDescPtr;
+typedef std::shared_ptr<class GraphicsQueryDesc> GraphicsQueryDescPtr;
 typedef std::shared_ptr<class GraphicsVertexLayout> GraphicsVertexLayoutPtr;
 typedef std::shared_ptr<class GraphicsVertexBinding> GraphicsVertexBindingPtr;
 typedef std::shared_ptr<class GraphicsDescriptorPoolComponent> GraphicsDescriptorPoolComponentPtr;
@@ -630,6 +634,15 @@ enum class GraphicsDataType : std::uint8_t
 	GraphicsDataTypeRangeSize = (GraphicsDataTypeEndRange - GraphicsDataTypeBeginRange + 1),
 };
 
+enum class GraphicsQueryType : std::uint8_t
+{
+	GraphicsQueryTypeSamplesPassed = 0,
+	GraphicsQueryTypeAnySamplesPassed = 1,
+	GraphicsQueryTypeBeginRange = GraphicsQueryTypeSamplesPassed,
+	GraphicsQueryTypeEndRange = GraphicsQueryTypeAnySamplesPassed,
+	GraphicsQueryTypeRangeSize = (GraphicsQueryTypeEndRange - GraphicsQueryTypeBeginRange + 1),
+};
+
 enum class GraphicsVertexType : std::uint8_t
 {
 	GraphicsVertexTypePointList = 0,
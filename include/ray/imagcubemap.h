@@ -38,6 +38,7 @@
 #define _H_IMAG_CUBEMAP_H_
 
 #include <ray/image.h>
+#include <ray/SH.h>
 
 _NAME_BEGIN
 
@@ -51,6 +52,9 @@ namespace image
 
 	bool EXPORT makeCubemapFromLatLong(Image& _dst, const Image& _src, bool _useBilinearInterpolation = false);
 	bool EXPORT makeLatLongFromCubemap(Image& _dst, const Image& _src, bool _useBilinearInterpolation = false);
+
+	bool EXPORT makeSH9FromCubemap(SH9Color& _dst, const Image& _src) noexcept;
+	bool EXPORT makePrefilteredCubemap(Image& _dst, const Image& _src, std::uint32_t _sampleCount = 64) noexcept;
 }
 
 _NAME_END
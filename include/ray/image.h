@@ -50,17 +50,22 @@ namespace image
 		using format_t = image::format_t;
 		using swizzle_t = image::swizzle_t;
 		using value_t = image::value_t;
+		using filter_t = image::filter_t;
 
 	public:
 		Image() noexcept;
 		Image(Image&& move) noexcept;
 		~Image() noexcept;
 
+		Image& operator=(Image&& move) noexcept;
+
 		bool create(std::uint32_t width, std::uint32_t height, format_t format, bool clear = true) noexcept;
 		bool create(std::uint32_t width, std::uint32_t height, std::uint32_t depth, format_t format, bool clear = true) noexcept;
 		bool create(std::uint32_t width, std::uint32_t height, std::uint32_t depth, format_t format, std::uint32_t mipLevel, std::uint32_t layerLevel, std::uint32_t mipBase = 0, std::uint32_t layerBase = 0, bool clear = true) noexcept;
 		bool create(const Image& src, format_t format = format_t::Undefined) noexcept;
 
+		bool generateMipmaps(filter_t filter = filter_t::Kaiser, MipmapFlags flags = 0, float alphaRef = 0.5f) noexcept;
+
 		void clear() noexcept;
 		bool empty() const noexcept;
 
@@ -93,9 +98,9 @@ namespace image
 		static std::uint8_t type_size(format_t format) noexcept;
 
 	public:
-		bool load(const std::string& filename, const char* type = nullptr) noexcept;
-		bool load(std::string::const_pointer filename, const char* type = nullptr) noexcept;
-		bool load(StreamReader& stream, const char* type = nullptr) noexcept;
+		bool load(const std::string& filename, const char* type = nullptr, LoadFlags flags = 0) noexcept;
+		bool load(std::string::const_pointer filename, const char* type = nullptr, LoadFlags flags = 0) noexcept;
+		bool load(StreamReader& stream, const char* type = nullptr, LoadFlags flags = 0) noexcept;
 
 		bool save(const std::string& filename, const char* type = "tga") noexcept;
 		bool save(std::string::const_pointer filename, const char* type = "tga") noexcept;
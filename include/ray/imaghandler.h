@@ -54,6 +54,7 @@ public:
 	virtual bool doCanRead(StreamReader& stream) const noexcept = 0;
 
 	virtual bool doLoad(StreamReader& stream, Image& image) except = 0;
+	virtual bool doLoad(StreamReader& stream, Image& image, LoadFlags) except { return this->doLoad(stream, image); }
 	virtual bool doSave(StreamWrite& stream, const Image& image) except = 0;
 
 private:
@@ -323,6 +323,31 @@ enum class value_t : std::uint8_t
 	RangeSize = (EndRange - BeginRange + 1),
 };
 
+enum class filter_t : std::uint8_t
+{
+	Box,
+	Kaiser,
+	Lanczos,
+	BeginRange = Box,
+	EndRange = Lanczos,
+	RangeSize = (EndRange - BeginRange + 1),
+};
+
+enum MipmapFlagBits
+{
+	MipmapFlagNormalMapBit = 0x00000001,
+	MipmapFlagAlphaCoverageBit = 0x00000002,
+};
+
+typedef std::uint32_t MipmapFlags;
+
+enum LoadFlagBits
+{
+	LoadFlagRGBA8Bit = 0x00000001,
+};
+
+typedef std::uint32_t LoadFlags;
+
 typedef std::shared_ptr<class Image> ImagePtr;
 typedef std::shared_ptr<class ImageHandler> ImageHandlerPtr;
 
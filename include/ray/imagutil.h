@@ -62,6 +62,9 @@ namespace image
 	EXPORT void rgba32f_to_rgba8sint(const Image& src, Image& dst);
 	EXPORT void rgba64f_to_rgba8sint(const Image& src, Image& dst);
 
+	EXPORT void rgb8_to_rgba8(const std::uint8_t* src, std::uint8_t* dst, std::uint32_t w, std::uint32_t h, std::uint8_t channel, swizzle_t swizzle = swizzle_t::RGB) noexcept;
+	EXPORT void rgb8_to_rgba8(const Image& src, Image& dst) noexcept;
+
 	template<typename _Tx, typename size_t = std::uint32_t, typename channel_t = std::uint8_t>
 	void flipHorizontal(_Tx* data, size_t w, size_t h, channel_t channel)
 	{
@@ -88,6 +88,8 @@ private:
 
 	GraphicsDataPtr _vbo;
 	GraphicsDataPtr _ibo;
+	GraphicsTransientBufferPtr _transientVbo;
+	GraphicsTransientBufferPtr _transientIbo;
 	GraphicsTexturePtr _texture;
 };
 
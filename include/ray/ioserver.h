@@ -40,6 +40,8 @@
 #include <ray/package.h>
 #include <ray/ioassign.h>
 
+#include <mutex>
+
 _NAME_BEGIN
 
 class EXPORT IoServer : public ios_base
@@ -55,6 +57,9 @@ public:
 	IoServer& mountArchives() noexcept;
 	IoServer& unmountArchives() noexcept;
 
+	IoServer& addArchive(const util::string& name, const util::string& path) noexcept;
+	IoServer& removeArchive(const util::string& name) noexcept;
+
 	IoServer& addAssign(IoAssign&& assign) noexcept;
 	IoServer& addAssign(const IoAssign& assign) noexcept;
 	IoServer& removeAssign(const util::string& name) noexcept;
@@ -63,6 +68,7 @@ public:
 	IoServer& getResolveAssign(const util::string& url, util::string& resolvePath) noexcept;
 	IoServer& getResolveAssign(util::string::const_pointer url, util::string& resolvePath) noexcept;
 
+	// the returned state is shared by every thread, threaded callers test the stream for null instead
 	IoServer& openFileURL(StreamReaderPtr& stream, const util::string& path, open_mode mode = ios_base::in) noexcept;
 	IoServer& openFileURL(StreamReaderPtr& stream, util::string::const_pointer path, open_mode mode = ios_base::in) noexcept;
 
@@ -114,12 +120,23 @@ public:
 	IoServer& deleteDirectory(const util::string& path) noexcept;
 	IoServer& existsDirectory(const util::string& path) noexcept;
 
+private:
+	void _addAssignArchive(const util::string& name, const util::string& path) noexcept;
+
+	const Package* _findArchiveFile(util::string::const_pointer url, util::string::const_pointer& name) const noexcept;
+
 private:
 
 	bool _enablePackage;
 
 	std::vector<IoListenerPtr> _ioListener;
 	std::map<util::string, util::string> _assignTable;
+
+	// loaders open files from worker threads, the stream state and the listeners are shared
+	std::mutex _openLock;
+
+	// searched back to front, so a later archive overrides files of an earlier one with the same assign
+	std::vector<std::pair<util::string, PackagePtr>> _archives;
 };
 
 _NAME_END
@@ -61,6 +61,11 @@ public:
 
 	streamsize gcount() const noexcept;
 
+	// the whole stream when it is held in memory, or nullptr; every non-null result must be paired with unmap()
+	char* map() noexcept;
+	void unmap() noexcept;
+	bool isMapping() const noexcept;
+
 protected:
 	class isentry final
 	{
@@ -88,6 +93,24 @@ private:
 	streamsize _count;
 };
 
+// maps the stream for the lifetime of the scope, data() is nullptr when the stream can't be mapped
+class EXPORT StreamMapping final
+{
+public:
+	StreamMapping(StreamReader& stream) noexcept;
+	~StreamMapping() noexcept;
+
+	char* data() const noexcept;
+
+private:
+	StreamMapping(const StreamMapping&) = delete;
+	StreamMapping& operator=(const StreamMapping&) = delete;
+
+private:
+	char* _data;
+	StreamReader& _stream;
+};
+
 _NAME_END
 
 #endif
\ No newline at end of file
@@ -39,6 +39,9 @@
 
 #include <ray/def.h>
 
+#include <thread>
+#include <limits>
+
 _NAME_BEGIN
 
 #ifndef SQ
@@ -449,6 +452,307 @@ public:
 	}
 };
 
+template<typename _Tx, typename _Ty = void>
+struct KdimensionFlatNode : public KdimensionData<_Ty>
+{
+	_Tx pos;
+	std::uint8_t split;
+};
+
+// A balanced tree built in one go and stored in a single array in depth-first order.
+//
+// A subtree covering [first, last) keeps its root at first, the left subtree at [first + 1, middle + 1)
+// and the right subtree at [middle + 1, last) with middle = (first + last) / 2, so no child links are
+// stored at all. Queries keep no state in the tree and may run on any number of threads at once.
+template<typename _Tx, typename _Ty = void>
+class KdimensionFlatTree final
+{
+public:
+	typedef KdimensionFlatNode<_Tx, _Ty> Node;
+	typedef std::vector<Node> Nodes;
+
+	struct Nearest
+	{
+		std::uint32_t index;
+		float distanceSqrt;
+
+		bool operator<(const Nearest& other) const noexcept
+		{
+			return distanceSqrt < other.distanceSqrt;
+		}
+	};
+
+	typedef std::vector<Nearest> Nearests;
+
+public:
+	KdimensionFlatTree() noexcept
+	{
+	}
+
+	~KdimensionFlatTree() noexcept
+	{
+	}
+
+	void clear() noexcept
+	{
+		_nodes.clear();
+	}
+
+	bool empty() const noexcept
+	{
+		return _nodes.empty();
+	}
+
+	std::size_t size() const noexcept
+	{
+		return _nodes.size();
+	}
+
+	const Node& at(std::uint32_t index) const noexcept
+	{
+		assert(index < _nodes.size());
+		return _nodes[index];
+	}
+
+	const Nodes& getNodes() const noexcept
+	{
+		return _nodes;
+	}
+
+	void build(const _Tx* points, std::size_t count, std::size_t numThreads = 1)
+	{
+		Nodes nodes(count);
+		for (std::size_t i = 0; i < count; i++)
+			nodes[i].pos = points[i];
+
+		this->build(std::move(nodes), numThreads);
+	}
+
+	void build(Nodes&& nodes, std::size_t numThreads = 1)
+	{
+		assert(nodes.size() < std::numeric_limits<std::uint32_t>::max());
+
+		_nodes = std::move(nodes);
+
+		std::size_t depth = 0;
+		while ((std::size_t(1) << depth) < numThreads)
+			depth++;
+
+		this->partition(0, _nodes.size(), depth);
+	}
+
+	bool nearest(const _Tx& pos, Nearest& result, float range = std::numeric_limits<float>::max()) const noexcept
+	{
+		result.index = std::numeric_limits<std::uint32_t>::max();
+		result.distanceSqrt = range < std::numeric_limits<float>::max() ? SQ(range) : range;
+
+		if (!_nodes.empty())
+			this->nearestNode(pos, 0, _nodes.size(), result);
+
+		return result.index != std::numeric_limits<std::uint32_t>::max();
+	}
+
+	// The k closest points within range, sorted from near to far.
+	std::size_t nearest(const _Tx& pos, std::size_t k, Nearests& result, float range = std::numeric_limits<float>::max()) const
+	{
+		result.clear();
+
+		if (!_nodes.empty() && k > 0)
+		{
+			result.reserve(k);
+			this->nearestNodes(pos, 0, _nodes.size(), k, range < std::numeric_limits<float>::max() ? SQ(range) : range, result);
+			std::sort_heap(result.begin(), result.end());
+		}
+
+		return result.size();
+	}
+
+	// Every point within range, in no particular order.
+	std::size_t radius(const _Tx& pos, float range, Nearests& result) const
+	{
+		result.clear();
+
+		if (!_nodes.empty())
+			this->radiusNodes(pos, 0, _nodes.size(), SQ(range), result);
+
+		return result.size();
+	}
+
+private:
+	static float distanceSqrt(const _Tx& pos1, const _Tx& pos2) noexcept
+	{
+		float distSq = 0;
+		for (std::uint8_t i = 0; i < _dimension; i++)
+			distSq += SQ(pos1[i] - pos2[i]);
+		return distSq;
+	}
+
+	void partition(std::size_t first, std::size_t last, std::size_t depth)
+	{
+		while (first < last)
+		{
+			_Tx min = _nodes[first].pos;
+			_Tx max = _nodes[first].pos;
+
+			for (std::size_t i = first + 1; i < last; i++)
+			{
+				for (std::uint8_t j = 0; j < _dimension; j++)
+				{
+					if (_nodes[i].pos[j] < min[j]) min[j] = _nodes[i].pos[j];
+					if (_nodes[i].pos[j] > max[j]) max[j] = _nodes[i].pos[j];
+				}
+			}
+
+			std::uint8_t split = 0;
+			for (std::uint8_t j = 1; j < _dimension; j++)
+			{
+				if (max[j] - min[j] > max[split] - min[split])
+					split = j;
+			}
+
+			std::size_t middle = (first + last) >> 1;
+
+			std::nth_element(_nodes.begin() + first, _nodes.begin() + middle, _nodes.begin() + last,
+				[split](const Node& lhs, const Node& rhs)
+			{
+				return lhs.pos[split] < rhs.pos[split];
+			}
+			);
+
+			// the median moves to the front, the element it displaces is no greater and stays on the left
+			std::swap(_nodes[first], _nodes[middle]);
+			_nodes[first].split = split;
+
+			if (depth > 0 && last - first > 4096)
+			{
+				std::thread thread(&KdimensionFlatTree::partition, this, first + 1, middle + 1, depth - 1);
+				this->partition(middle + 1, last, depth - 1);
+				thread.join();
+				return;
+			}
+
+			this->partition(first + 1, middle + 1, depth);
+
+			first = middle + 1;
+		}
+	}
+
+	void nearestNode(const _Tx& pos, std::size_t first, std::size_t last, Nearest& result) const noexcept
+	{
+		while (first < last)
+		{
+			const Node& node = _nodes[first];
+
+			float distSq = distanceSqrt(node.pos, pos);
+			if (distSq < result.distanceSqrt)
+			{
+				result.index = static_cast<std::uint32_t>(first);
+				result.distanceSqrt = distSq;
+			}
+
+			std::size_t middle = (first + last) >> 1;
+
+			float split = pos[node.split] - node.pos[node.split];
+			if (split < 0)
+			{
+				this->nearestNode(pos, first + 1, middle + 1, result);
+				if (SQ(split) >= result.distanceSqrt)
+					return;
+				first = middle + 1;
+			}
+			else
+			{
+				this->nearestNode(pos, middle + 1, last, result);
+				if (SQ(split) >= result.distanceSqrt)
+					return;
+				last = middle + 1;
+				first = first + 1;
+			}
+		}
+	}
+
+	void nearestNodes(const _Tx& pos, std::size_t first, std::size_t last, std::size_t k, float rangeSqrt, Nearests& result) const
+	{
+		while (first < last)
+		{
+			const Node& node = _nodes[first];
+
+			// the heap keeps the farthest of the k best on top, so it is the one to beat
+			float distSq = distanceSqrt(node.pos, pos);
+			if (distSq < rangeSqrt)
+			{
+				if (result.size() < k)
+				{
+					result.push_back(Nearest{ static_cast<std::uint32_t>(first), distSq });
+					std::push_heap(result.begin(), result.end());
+				}
+				else if (distSq < result.front().distanceSqrt)
+				{
+					std::pop_heap(result.begin(), result.end());
+					result.back() = Nearest{ static_cast<std::uint32_t>(first), distSq };
+					std::push_heap(result.begin(), result.end());
+				}
+			}
+
+			std::size_t middle = (first + last) >> 1;
+
+			float split = pos[node.split] - node.pos[node.split];
+			if (split < 0)
+				this->nearestNodes(pos, first + 1, middle + 1, k, rangeSqrt, result);
+			else
+				this->nearestNodes(pos, middle + 1, last, k, rangeSqrt, result);
+
+			float bound = result.size() < k ? rangeSqrt : result.front().distanceSqrt;
+			if (SQ(split) >= bound)
+				return;
+
+			if (split < 0)
+			{
+				first = middle + 1;
+			}
+			else
+			{
+				last = middle + 1;
+				first = first + 1;
+			}
+		}
+	}
+
+	void radiusNodes(const _Tx& pos, std::size_t first, std::size_t last, float rangeSqrt, Nearests& result) const
+	{
+		while (first < last)
+		{
+			const Node& node = _nodes[first];
+
+			float distSq = distanceSqrt(node.pos, pos);
+			if (distSq <= rangeSqrt)
+				result.push_back(Nearest{ static_cast<std::uint32_t>(first), distSq });
+
+			std::size_t middle = (first + last) >> 1;
+
+			float split = pos[node.split] - node.pos[node.split];
+			if (split < 0)
+			{
+				this->radiusNodes(pos, first + 1, middle + 1, rangeSqrt, result);
+				if (SQ(split) > rangeSqrt)
+					return;
+				first = middle + 1;
+			}
+			else
+			{
+				if (SQ(split) <= rangeSqrt)
+					this->radiusNodes(pos, first + 1, middle + 1, rangeSqrt, result);
+				first = middle + 1;
+			}
+		}
+	}
+
+private:
+	static const std::uint8_t _dimension = sizeof(_Tx) / sizeof(typename _Tx::value_type);
+
+	Nodes _nodes;
+};
+
 _NAME_END
 
 #endif
\ No newline at end of file
@@ -61,6 +61,14 @@ public:
 	void setShadowFactor(float factor) noexcept;
 	void setShadowMode(ShadowMode shadowType) noexcept;
 
+	void setShadowCascades(std::uint8_t cascades) noexcept;
+	void setShadowCascadeLambda(float lambda) noexcept;
+	void setShadowDistance(float distance) noexcept;
+
+	std::uint8_t getShadowCascades() const noexcept;
+	float getShadowCascadeLambda() const noexcept;
+	float getShadowDistance() const noexcept;
+
 	void setGlobalIllumination(bool enable) noexcept;
 	bool getGlobalIllumination() const noexcept;
 
@@ -89,10 +97,19 @@ public:
 
 	const CameraPtr& getCamera() const noexcept;
 
+	const Cameras& getShadowCascadeCameras() const noexcept;
+	const float4& getShadowCascadeSplits() const noexcept;
+	Viewport getShadowCascadeViewport(std::uint8_t cascade) const noexcept;
+	std::size_t getShadowCascadeDrawCount(std::uint8_t cascade) const noexcept;
+	float getShadowCascadeFitTime() const noexcept;
+
+	void updateShadowCascades(const Camera& camera) noexcept;
+
 	RenderObjectPtr clone() const noexcept;
 
 private:
 	bool setupShadowMap() noexcept;
+	bool setupShadowCascades(const RenderPipelineFramebufferPtr& framebuffer) noexcept;
 	bool setupReflectiveShadowMap() noexcept;
 
 	void destroyShadowMap() noexcept;
@@ -138,6 +155,13 @@ private:
 	CameraPtr _shadowCamera;
 	ShadowMode _shadowMode;
 
+	std::uint8_t _shadowCascades;
+	float _shadowCascadeLambda;
+	float _shadowCascadeFitTime;
+	float _shadowDistance;
+	float4 _shadowCascadeSplits;
+	Cameras _shadowCascadeCameras;
+
 	GraphicsTexturePtr _skybox;
 	GraphicsTexturePtr _skyDiffuseIBL;
 	GraphicsTexturePtr _skySpecularIBL;
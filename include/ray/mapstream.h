@@ -2,7 +2,7 @@
 // | Project : ray.
 // | All rights reserved.
 // +----------------------------------------------------------------------
-// | Copyright (c) 2013-2014.
+// | Copyright (c) 2013-2017.
 // +----------------------------------------------------------------------
 // | * Redistribution and use of this software in source and binary forms,
 // |   with or without modification, are permitted provided that the following
@@ -34,61 +34,42 @@
 // | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // +----------------------------------------------------------------------
-#ifndef _H_OCCLUSION_QUERY_H_
-#define _H_OCCLUSION_QUERY_H_
+#ifndef _H_MAPSTREAM_H_
+#define _H_MAPSTREAM_H_
 
-#include <ray/occlusion_tree.h>
+#include <ray/mstream.h>
 
 _NAME_BEGIN
 
-class OcclusionQuery
+class EXPORT MappingReader final : public StreamReader
 {
 public:
-    OcclusionQuery() noexcept;
-    virtual ~OcclusionQuery() noexcept;
+	// files smaller than this are read into memory, below it the page faults cost more than the copy
+	static const std::uint64_t mapThreshold = 1024 * 1024;
 
-    bool isAvailable() const noexcept;
-
-    int getQueryResult() const noexcept;
-    int getQueryInstnace() const noexcept;
-
-    void queryBegin() const noexcept;
-    void queryEnd() const noexcept;
+public:
+	MappingReader() noexcept;
+	~MappingReader() noexcept;
 
-    void addObject(OcclusionObjectPtr object) noexcept;
+	MappingReader& open(const char* filename) noexcept;
+	MappingReader& open(const wchar_t* filename) noexcept;
+	MappingReader& open(const std::string& filename) noexcept;
+	MappingReader& open(const std::wstring& filename) noexcept;
 
-    OcclusionObjectPtr getObject(std::size_t i = 0) const noexcept;
-    
-    OcclusionObjectContainer& getObjects() noexcept;
-    const OcclusionObjectContainer& getObjects() const noexcept;
+	MappingReader& close() noexcept;
 
-    std::size_t getObjectCount() const noexcept;
+	bool is_open() const noexcept;
 
-    void reset() noexcept;
+	// maps a whole file read-only, it stays mapped until the last reference is released
+	static std::shared_ptr<const char> mapFile(const char* filename, std::uint64_t& size) noexcept;
+	static std::shared_ptr<const char> mapFile(const wchar_t* filename, std::uint64_t& size) noexcept;
 
 private:
-
-    int _queryID;
-
-    OcclusionObjectContainer _objects;
-};
-
-class OcclusionQueryPool
-{
-public:
-    OcclusionQueryPool() noexcept;
-    virtual ~OcclusionQueryPool() noexcept;
-
-    OcclusionQuery* requestQuery() noexcept;
-
-    void resetQueries() noexcept;
-    void destroyQueries() noexcept;
+	MappingReader(const MappingReader&) noexcept = delete;
+	MappingReader& operator=(const MappingReader&) noexcept = delete;
 
 private:
-
-    std::size_t _current;
-
-    OcclusionQueryContainer _occlusionQueries;
+	MemoryBuf _buf;
 };
 
 _NAME_END
@@ -40,6 +40,11 @@
 #include <ray/material_loader.h>
 #include <ray/xmlreader.h>
 
+#include <ray/graphics_state.h>
+#include <ray/graphics_shader.h>
+#include <ray/graphics_sampler.h>
+#include <ray/graphics_input_layout.h>
+
 _NAME_BEGIN
 
 class EXPORT MaterialMaker final : public MaterialLoader
@@ -54,6 +59,12 @@ public:
 	bool load(MaterialManager& manager, Material& material, ixmlarchive& reader) except;
 	bool load(MaterialManager& manager, Material& material, StreamReader& stream) noexcept;
 
+	// parse() only reads the effect files and can run on any thread,
+	// instance() creates the graphics objects and has to run on the device thread.
+	bool parse(MaterialManager& manager, Material& material, const std::string& filename) noexcept;
+	bool parse(MaterialManager& manager, Material& material, ixmlarchive& reader) except;
+	bool instance(MaterialManager& manager, Material& material) noexcept;
+
 private:
 	bool loadMaterial(MaterialManager& manager, Material& material, ixmlarchive& reader) except;
 	bool loadEffect(MaterialManager& manager, Material& material, ixmlarchive& reader) except;
@@ -67,7 +78,7 @@ private:
 	void instanceMacro(MaterialManager& manager, Material& material, ixmlarchive& reader) except;
 	void instanceBuffer(MaterialManager& manager, Material& material, ixmlarchive& reader) except;
 	void instanceCodes(MaterialManager& manager, ixmlarchive& reader) except;
-	void instanceShader(MaterialManager& manager, Material& material, GraphicsProgramDesc& programDesc, ixmlarchive& reader) except;
+	void instanceShader(MaterialManager& manager, Material& material, std::vector<GraphicsShaderDesc>& shaders, ixmlarchive& reader) except;
 	void instanceInputLayout(MaterialManager& manager, Material& material, ixmlarchive& reader) except;
 
 	static bool GetShaderStage(const std::string& string, GraphicsShaderStageFlagBits& flags) noexcept;
@@ -92,6 +103,19 @@ private:
 	std::string _hlslCodes;
 	std::map<std::string, bool> _onceInclude;
 	std::map<std::string, std::vector<char>> _shaderCodes;
+
+	struct PassDesc
+	{
+		std::string path;
+		std::string inputLayout;
+		MaterialPassPtr pass;
+		GraphicsStateDesc stateDesc;
+		std::vector<GraphicsShaderDesc> shaders;
+	};
+
+	std::vector<PassDesc> _passes;
+	std::vector<std::pair<std::string, GraphicsSamplerDesc>> _samplers;
+	std::vector<std::pair<std::string, GraphicsInputLayoutDesc>> _inputLayouts;
 };
 
 _NAME_END
@@ -38,6 +38,7 @@
 #define _H_MATERIAL_MANAGER_H_
 
 #include <ray/material.h>
+#include <mutex>
 
 _NAME_BEGIN
 
@@ -53,6 +54,7 @@ public:
 	GraphicsDeviceType getDeviceType() const noexcept;
 	
 	MaterialPtr createMaterial(const std::string& name) noexcept;
+	bool createMaterials(const std::vector<std::string>& names, Materials& materials) noexcept;
 	MaterialPtr getMaterial(const std::string& name) noexcept;
 	void destroyMaterial(MaterialPtr& material) noexcept;
 	void destroyMaterial(MaterialPtr&& material) noexcept;
@@ -71,6 +73,8 @@ public:
 	void destroyInputLayout(const std::string& name) noexcept;
 	GraphicsInputLayoutPtr getInputLayout(const std::string& name) noexcept;
 
+	std::shared_ptr<const std::string> getIncludeFile(const std::string& filename) noexcept;
+
 private:
 	MaterialManager(const MaterialManager&) = delete;
 	MaterialManager& operator=(const MaterialManager&) = delete;
@@ -78,10 +82,16 @@ private:
 private:
 	GraphicsDevicePtr _graphicsDevice;
 
-	std::map<std::string, GraphicsShaderPtr> _shaders;
+	std::multimap<std::uint64_t, GraphicsShaderPtr> _shaders;
+	std::map<std::vector<std::uint32_t>, GraphicsStatePtr> _states;
+	std::map<std::vector<std::uintptr_t>, GraphicsProgramPtr> _programs;
+	std::map<std::vector<std::uint32_t>, GraphicsSamplerPtr> _samplerObjects;
 	std::map<std::string, GraphicsSamplerPtr> _samplers;
 	std::map<std::string, GraphicsInputLayoutPtr> _inputLayouts;
 	std::map<std::string, MaterialPtr> _materials;
+
+	std::mutex _includeLock;
+	std::map<std::string, std::shared_ptr<const std::string>> _includes;
 };
 
 _NAME_END
@@ -113,7 +113,7 @@ protected:
 
 	bool _buildRenderObjects(const MeshProperty& mesh, ModelMakerFlags flags) noexcept;
 
-	void _updateMaterial(std::size_t n) noexcept;
+	virtual void _updateMaterial(std::size_t n) noexcept;
 	void _updateMaterials() noexcept;
 
 private:
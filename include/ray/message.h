@@ -87,6 +87,67 @@ private:
 	MessageListener& operator=(const MessageListener&) noexcept = delete;
 };
 
+// recycles the memory of short lived messages, a block freed on the dispatching thread is
+// handed back to the posting threads instead of going through the global heap every frame
+class EXPORT MessagePool
+{
+public:
+	static void* allocate(std::size_t size) except;
+	static void deallocate(void* ptr, std::size_t size) noexcept;
+
+private:
+	MessagePool() noexcept = delete;
+	~MessagePool() noexcept = delete;
+};
+
+template<typename T>
+class MessageAllocator
+{
+public:
+	typedef T value_type;
+
+	template<typename U>
+	struct rebind
+	{
+		typedef MessageAllocator<U> other;
+	};
+
+	MessageAllocator() noexcept
+	{
+	}
+
+	template<typename U>
+	MessageAllocator(const MessageAllocator<U>&) noexcept
+	{
+	}
+
+	T* allocate(std::size_t n) except
+	{
+		static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not pooled");
+		return static_cast<T*>(MessagePool::allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T* ptr, std::size_t n) noexcept
+	{
+		MessagePool::deallocate(ptr, n * sizeof(T));
+	}
+
+	template<typename U>
+	bool operator==(const MessageAllocator<U>&) const noexcept
+	{
+		return true;
+	}
+
+	template<typename U>
+	bool operator!=(const MessageAllocator<U>&) const noexcept
+	{
+		return false;
+	}
+};
+
+// postMessage may be called from any thread, the poll, wait, peek and flush functions
+// belong to a single dispatching thread (the GameServer update loop), which is the
+// constructing thread until bindDispatchThread or the first poll says otherwise
 class EXPORT MessageDispatcher : public rtti::Interface
 {
 	__DeclareSubClass(MessageDispatcher, rtti::Interface)
@@ -105,22 +166,31 @@ public:
 
 	virtual void peekMessages(MessagePtr& event) noexcept;
 	virtual bool pollMessages(MessagePtr& event) noexcept;
+	virtual bool pollMessages(Messages& events) noexcept;
 	virtual bool waitMessages(MessagePtr& event) noexcept;
 	virtual bool waitMessages(MessagePtr& event, int timeout) noexcept;
 	virtual void flushMessage() noexcept;
 
+	virtual void bindDispatchThread() noexcept;
+
+private:
+	void _flushPendingMessages() noexcept;
+
 private:
 	MessageDispatcher(const MessageDispatcher&) noexcept = delete;
 	MessageDispatcher& operator=(const MessageDispatcher&) noexcept = delete;
 
 private:
 
-	typedef std::queue<MessagePtr>  Messages;
+	std::atomic<bool> _enableMessagePosting;
 
-	bool _enableMessagePosting;
+	mpsc_queue<MessagePtr> _events;
 
-	Messages _events;
+	// messages the dispatching thread posted to itself while the ring was full
+	std::queue<MessagePtr> _pendingEvents;
+	std::atomic<std::thread::id> _dispatchThread;
 
+	std::atomic<bool> _waiting;
 	std::mutex _mutex;
 	std::condition_variable _dispose;
 
@@ -130,7 +200,7 @@ private:
 template<class _Ty, class... _Types>
 inline typename std::enable_if<!std::is_array<_Ty>::value, std::shared_ptr<_Ty> >::type make_message(_Types&&... _Args)
 {
-	return std::make_shared<_Ty>(std::forward<_Types>(_Args)...);
+	return std::allocate_shared<_Ty>(MessageAllocator<_Ty>(), std::forward<_Types>(_Args)...);
 }
 
 _NAME_END
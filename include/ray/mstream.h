@@ -48,6 +48,7 @@ public:
 	~MemoryBuf() noexcept;
 
 	bool open(ios_base::openmode mode) noexcept;
+	bool open(const char* data, streamsize size, const std::shared_ptr<const void>& owner) noexcept;
 	bool close() noexcept;
 
 	streamsize read(char* str, std::streamsize cnt) noexcept;
@@ -67,6 +68,9 @@ public:
 
 	int flush() noexcept;
 
+private:
+	void detach() noexcept;
+
 private:
 
 	bool _isMappinged;
@@ -74,6 +78,11 @@ private:
 	streamoff _next;
 
 	std::vector<char> _data;
+
+	// read-only view of memory kept alive by _owner, copied into _data on the first write or resize
+	const char* _view;
+	streamsize _viewSize;
+	std::shared_ptr<const void> _owner;
 };
 
 class EXPORT MemoryReader final : public StreamReader
@@ -82,11 +91,10 @@ public:
 	MemoryReader() noexcept;
 	~MemoryReader() noexcept;
 
-	void resize(streamsize size) noexcept;
+	// reads the memory in place without copying it; the bytes returned by map() must not be written
+	bool open(const char* data, streamsize size, const std::shared_ptr<const void>& owner = nullptr) noexcept;
 
-	char* map() noexcept;
-	void unmap() noexcept;
-	bool isMapping() const noexcept;
+	void resize(streamsize size) noexcept;
 
 private:
 	MemoryBuf _buf;
@@ -37,15 +37,126 @@
 #ifndef _H_OCCLUSION_QUERY_QUEUE_H_
 #define _H_OCCLUSION_QUERY_QUEUE_H_
 
-#include <ray/occlusion_query.h>
+#include <ray/render_scene.h>
+
+#include <deque>
+#include <unordered_map>
 
 _NAME_BEGIN
 
-class OcclusionQueryQueue
+// Coherent hierarchical culling (CHC++) with hardware occlusion queries.
+// The geometry of a scene is grouped in a bounding volume hierarchy that is walked front to back using the
+// visibility earlier queries reported. Hidden nodes are skipped and queried again in batches, visible leaves
+// are drawn and only queried again every few frames. Queries are issued after the opaque pass and read back
+// one or more frames later, the CPU only waits on one that has been outstanding longer than the latency limit.
+class EXPORT OcclusionQueryQueue final
 {
 public:
+	OcclusionQueryQueue() noexcept;
+	~OcclusionQueryQueue() noexcept;
+
+	bool setup() noexcept;
+	void close() noexcept;
+
+	void setMaxLatency(std::uint32_t frames) noexcept;
+	std::uint32_t getMaxLatency() const noexcept;
+
+	void setVisibleQueryInterval(std::uint32_t frames) noexcept;
+	std::uint32_t getVisibleQueryInterval() const noexcept;
+
+	void setBatchSize(std::uint32_t count) noexcept;
+	std::uint32_t getBatchSize() const noexcept;
+
+	void setLeafSize(std::uint32_t count) noexcept;
+	std::uint32_t getLeafSize() const noexcept;
+
+	void traverse(const Camera& camera, OcclusionCullList& list) noexcept;
+	void renderQueries(RenderPipeline& pipeline) noexcept;
+
+	std::size_t getNumNodes() const noexcept;
+	std::size_t getNumQueries() const noexcept;
+	std::size_t getNumBatchedNodes() const noexcept;
+	std::size_t getNumPendingQueries() const noexcept;
+	std::size_t getNumCulled() const noexcept;
+	std::size_t getNumStalls() const noexcept;
+
+	float getAverageLatency() const noexcept;
+
+private:
+	struct Node
+	{
+		AABB bound;
+
+		std::uint32_t right;
+		std::uint32_t next;
+
+		std::uint32_t first;
+		std::uint32_t count;
+
+		std::uint32_t nextQuery;
+
+		bool leaf;
+		bool visible;
+		bool pending;
+	};
+
+	struct PendingQuery
+	{
+		GraphicsQueryPtr query;
+		std::vector<std::uint32_t> nodes;
+		std::uint32_t frame;
+		std::uint32_t build;
+	};
+
+	bool updateObjects(const RenderScene& scene) noexcept;
+
+	void buildHierarchy() noexcept;
+	std::uint32_t buildNode(std::uint32_t first, std::uint32_t count) noexcept;
+	void refitHierarchy() noexcept;
+
+	void fetchResults() noexcept;
+	void setSubtreeVisible(std::uint32_t index, bool visible) noexcept;
+	void pullUpVisibility() noexcept;
+
+	GraphicsQueryPtr allocQuery() noexcept;
+	void drawBound(RenderPipeline& pipeline, const AABB& bound) noexcept;
+
+	std::uint32_t random() noexcept;
+
+private:
+	OcclusionQueryQueue(const OcclusionQueryQueue&) = delete;
+	OcclusionQueryQueue& operator=(const OcclusionQueryQueue&) = delete;
+
+private:
+	std::uint32_t _maxLatency;
+	std::uint32_t _visibleQueryInterval;
+	std::uint32_t _batchSize;
+	std::uint32_t _leafSize;
+
+	std::uint32_t _frame;
+	std::uint32_t _build;
+	std::uint32_t _seed;
+
+	RenderObjectRaws _objects;
+	std::vector<Node> _nodes;
+	std::vector<bool> _rendered;
+	std::unordered_map<const RenderObject*, std::uint32_t> _slots;
+
+	std::vector<std::uint32_t> _visibleQueries;
+	std::vector<std::uint32_t> _invisibleQueries;
+
+	std::deque<PendingQuery> _pendingQueries;
+	std::vector<GraphicsQueryPtr> _freeQueries;
 
+	MaterialPtr _material;
+	MaterialTechPtr _technique;
 
+	std::size_t _numQueries;
+	std::size_t _numBatchedNodes;
+	std::size_t _numCulled;
+	std::size_t _numStalls;
+	std::size_t _numResults;
+	std::size_t _totalLatency;
 };
 
 _NAME_END
@@ -34,30 +34,140 @@
 // | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // +----------------------------------------------------------------------
-#ifndef _H_RENDER_TRAVERSER_H_
-#define _H_RENDER_TRAVERSER_H_
+#ifndef _H_OCCLUSION_TRAVERSER_H_
+#define _H_OCCLUSION_TRAVERSER_H_
 
-#include <ray/occlusion_query_queue.h>
-#include <queue>
+#include <ray/render_scene.h>
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 
 _NAME_BEGIN
 
-class OcclusionTraverser
+// A closed, simplified mesh in object space that stands in for an object when it hides others.
+class EXPORT Occluder final
 {
 public:
+	Occluder() noexcept;
+	Occluder(const Float3Array& vertices, const UintArray& indices) noexcept;
+	~Occluder() noexcept;
+
+	void setVertices(const Float3Array& vertices) noexcept;
+	const Float3Array& getVertices() const noexcept;
+
+	void setIndices(const UintArray& indices) noexcept;
+	const UintArray& getIndices() const noexcept;
+
+	static OccluderPtr makeBox(const AABB& box) noexcept;
+
+private:
+	Float3Array _vertices;
+	UintArray _indices;
+};
+
+// Software occlusion culling.
+// The largest occluders on screen are rasterized into a small depth buffer, split in tiles across threads,
+// then every other visible object is culled when the nearest point of its box lies behind the
+// farthest occluder depth over the screen rectangle it covers, read from a max depth pyramid.
+class EXPORT OcclusionTraverser final
+{
+public:
+	OcclusionTraverser() noexcept;
+	~OcclusionTraverser() noexcept;
+
+	bool setup(std::uint32_t width = 256, std::uint32_t height = 128, std::uint32_t numThreads = 0) noexcept;
+	void close() noexcept;
+
+	void setMaxOccluders(std::uint32_t count) noexcept;
+	std::uint32_t getMaxOccluders() const noexcept;
+
+	void setOccluderMinSize(float size) noexcept;
+	float getOccluderMinSize() const noexcept;
+
+	void setDebugEnable(bool enable) noexcept;
+	bool getDebugEnable() const noexcept;
+
+	void traverse(const Camera& camera, OcclusionCullList& list) noexcept;
+	bool traverseObject(const AABB& bound) const noexcept;
+
+	std::uint32_t getWidth() const noexcept;
+	std::uint32_t getHeight() const noexcept;
+
+	const std::vector<float>& getDepthMap() const noexcept;
+	const GraphicsTexturePtr& getDebugTexture() const noexcept;
+
+	std::size_t getNumOccluders() const noexcept;
+	std::size_t getNumTriangles() const noexcept;
+	std::size_t getNumTested() const noexcept;
+	std::size_t getNumCulled() const noexcept;
+
+	float getRasterTime() const noexcept;
+	float getTestTime() const noexcept;
+
+private:
+	struct Triangle
+	{
+		std::int32_t bounds[4];
+
+		float edge[3][3];
+		float depth[3];
+	};
+
+	void selectOccluders(const Camera& camera, const OcclusionCullList& list) noexcept;
+	void setupTriangles(const float4x4& viewProject) noexcept;
+
+	void rasterize() noexcept;
+	void rasterizeTiles() noexcept;
+	void rasterizeTile(std::uint32_t tile) noexcept;
+
+	void buildPyramid() noexcept;
+	void updateDebugTexture() noexcept;
+
+	void dispose() noexcept;
+
+private:
+	OcclusionTraverser(const OcclusionTraverser&) = delete;
+	OcclusionTraverser& operator=(const OcclusionTraverser&) = delete;
+
+private:
+	std::uint32_t _width;
+	std::uint32_t _height;
+	std::uint32_t _tilesX;
+	std::uint32_t _tilesY;
+
+	std::uint32_t _maxOccluders;
+	float _occluderMinSize;
+
+	bool _debugEnable;
+
+	float4x4 _viewProject;
+
+	RenderObjectRaws _occluders;
+	std::vector<Triangle> _triangles;
+	std::vector<std::vector<std::uint32_t>> _bins;
 
-    virtual void traverse() noexcept;
-    virtual void traverseObject(OcclusionObjectPtr object) noexcept;
+	std::vector<float> _depth;
+	std::vector<std::vector<float>> _pyramid;
 
-    virtual void update() noexcept;
+	GraphicsTexturePtr _debugTexture;
 
-protected:
+	std::size_t _numTested;
+	std::size_t _numCulled;
 
-    std::size_t _frustumCulledCount;
+	float _rasterTime;
+	float _testTime;
 
-    std::unique_ptr<OcclusionTree> _tree;
+	bool _quit;
+	std::uint32_t _generation;
+	std::uint32_t _numBusy;
+	std::atomic<std::uint32_t> _nextTile;
 
-    std::queue<OcclusionObjectPtr> _distanceQueue;
+	std::mutex _mutex;
+	std::condition_variable _dispatch;
+	std::condition_variable _finish;
+	std::vector<std::unique_ptr<std::thread>> _threads;
 };
 
 _NAME_END
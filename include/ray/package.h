@@ -39,17 +39,133 @@
 
 #include <ray/iostream.h>
 
+#include <unordered_set>
+
 _NAME_BEGIN
 
-class EXPORT Package
+enum PackageCompression
+{
+	PackageCompressionNone = 0,
+	PackageCompressionZlib = 1,
+	PackageCompressionBeginRange = PackageCompressionNone,
+	PackageCompressionEndRange = PackageCompressionZlib,
+	PackageCompressionRangeSize = (PackageCompressionEndRange - PackageCompressionBeginRange + 1),
+};
+
+// on-disk layout (little endian) : header, entry data aligned to Package::alignment, then the table of contents
+// made of numEntries entries, numBuckets open-addressing buckets of entry indices and the name blob
+struct PackageHeader
 {
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::uint32_t numEntries;
+	std::uint32_t numBuckets;
+	std::uint64_t tocOffset;
+	std::uint64_t tocSize;
+};
+
+struct PackageEntry
+{
+	std::uint64_t hash;
+	std::uint64_t offset;
+	std::uint64_t size;
+	std::uint64_t packedSize;
+	std::uint32_t nameOffset;
+	std::uint16_t nameLength;
+	std::uint8_t compression;
+	std::uint8_t reserved;
+};
+
+class EXPORT Package final
+{
+public:
+	static const std::uint32_t magic = 0x4B415052;
+	static const std::uint32_t version = 1;
+	static const std::uint32_t alignment = 4096;
+	static const std::uint32_t invalidIndex = 0xFFFFFFFF;
+
 public:
 	Package() noexcept;
-	virtual ~Package() noexcept;
+	~Package() noexcept;
+
+	bool open(const util::string& path) noexcept;
+	void close() noexcept;
+
+	bool is_open() const noexcept;
+
+	const util::string& getPath() const noexcept;
+
+	std::size_t size() const noexcept;
+	const PackageEntry& getEntry(std::size_t index) const noexcept;
+	util::string getEntryName(std::size_t index) const noexcept;
+
+	bool exists(const util::string& name) const noexcept;
+	bool exists(util::string::const_pointer name) const noexcept;
+
+	// stored entries are returned as views into the mapped archive, which stays mapped while any view is alive
+	bool openFile(StreamReaderPtr& stream, const util::string& name) const noexcept;
+	bool openFile(StreamReaderPtr& stream, util::string::const_pointer name) const noexcept;
+
+	static std::uint64_t hash(util::string::const_pointer name, std::size_t length) noexcept;
+	static util::string normalize(const util::string& name) noexcept;
+
+private:
+	bool validate() const noexcept;
+
+	const PackageEntry* find(util::string::const_pointer name, std::size_t length) const noexcept;
+
+	bool openFile(StreamReaderPtr& stream, const PackageEntry& entry) const noexcept;
 
 private:
 	Package(const Package&) noexcept = delete;
 	Package& operator=(const Package&) noexcept = delete;
+
+private:
+	util::string _path;
+
+	std::shared_ptr<const char> _mapping;
+	std::uint64_t _size;
+
+	const PackageHeader* _header;
+	const PackageEntry* _entries;
+	const std::uint32_t* _buckets;
+	const char* _names;
+	std::uint64_t _namesSize;
+};
+
+class EXPORT PackageWriter final
+{
+public:
+	PackageWriter() noexcept;
+	~PackageWriter() noexcept;
+
+	bool open(const util::string& path) noexcept;
+	bool close() noexcept;
+
+	bool is_open() const noexcept;
+
+	// entries are only kept compressed when that saves at least an eighth of their size
+	bool addFile(const util::string& name, const char* data, std::size_t size, bool compress) noexcept;
+
+	std::size_t size() const noexcept;
+	const PackageEntry& getEntry(std::size_t index) const noexcept;
+
+private:
+	bool pad() noexcept;
+
+private:
+	PackageWriter(const PackageWriter&) noexcept = delete;
+	PackageWriter& operator=(const PackageWriter&) noexcept = delete;
+
+private:
+	StreamWritePtr _stream;
+
+	std::uint64_t _offset;
+
+	std::string _names;
+	std::vector<PackageEntry> _entries;
+	std::unordered_set<util::string> _entryNames;
+	std::vector<char> _packed;
 };
 
 _NAME_END
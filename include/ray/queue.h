@@ -42,6 +42,8 @@
 #include <queue>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <vector>
 #include <condition_variable>
 
 _NAME_BEGIN
@@ -134,6 +136,138 @@ private:
 	mutable std::condition_variable _dispose;
 };
 
+// bounded ring for any number of producers and exactly one consumer, every cell carries a sequence
+// number telling whether it is free for the push at that position or holds the value for the pop
+template<typename T>
+class mpsc_queue
+{
+public:
+	mpsc_queue(std::size_t capacity) noexcept
+		: _mask(0)
+		, _enqueuePos(0)
+		, _dequeuePos(0)
+	{
+		std::size_t size = 2;
+		while (size < capacity)
+			size <<= 1;
+
+		_mask = size - 1;
+		_cells = std::make_unique<cell[]>(size);
+
+		for (std::size_t i = 0; i < size; i++)
+			_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	bool try_push(const T& value) noexcept
+	{
+		T copy(value);
+		return this->try_push(std::move(copy));
+	}
+
+	bool try_push(T&& value) noexcept
+	{
+		cell* target = nullptr;
+
+		std::size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			target = &_cells[pos & _mask];
+
+			std::size_t sequence = target->sequence.load(std::memory_order_acquire);
+			std::intptr_t diff = (std::intptr_t)sequence - (std::intptr_t)pos;
+			if (diff == 0)
+			{
+				if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = _enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+
+		target->value = std::move(value);
+		target->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool try_pop(T& value) noexcept
+	{
+		cell& target = _cells[_dequeuePos & _mask];
+		if (target.sequence.load(std::memory_order_acquire) != _dequeuePos + 1)
+			return false;
+
+		value = std::move(target.value);
+		target.value = T();
+		target.sequence.store(_dequeuePos + _mask + 1, std::memory_order_release);
+
+		_dequeuePos++;
+		return true;
+	}
+
+	std::size_t try_pop_all(std::vector<T>& values) noexcept
+	{
+		std::size_t count = 0;
+
+		for (;; count++)
+		{
+			cell& target = _cells[_dequeuePos & _mask];
+			if (target.sequence.load(std::memory_order_acquire) != _dequeuePos + 1)
+				break;
+
+			values.push_back(std::move(target.value));
+			target.value = T();
+			target.sequence.store(_dequeuePos + _mask + 1, std::memory_order_release);
+
+			_dequeuePos++;
+		}
+
+		return count;
+	}
+
+	bool try_peek(T& value) const noexcept
+	{
+		const cell& target = _cells[_dequeuePos & _mask];
+		if (target.sequence.load(std::memory_order_acquire) != _dequeuePos + 1)
+			return false;
+
+		value = target.value;
+		return true;
+	}
+
+	bool empty() const noexcept
+	{
+		return _cells[_dequeuePos & _mask].sequence.load(std::memory_order_acquire) != _dequeuePos + 1;
+	}
+
+	std::size_t capacity() const noexcept
+	{
+		return _mask + 1;
+	}
+
+private:
+	mpsc_queue(const mpsc_queue&) = delete;
+	mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+private:
+	struct cell
+	{
+		std::atomic<std::size_t> sequence;
+		T value;
+	};
+
+	std::size_t _mask;
+	std::unique_ptr<cell[]> _cells;
+
+	// producers and the consumer advance on separate cache lines
+	alignas(64) std::atomic<std::size_t> _enqueuePos;
+	alignas(64) std::size_t _dequeuePos;
+};
+
 _NAME_END
 
 #endif
\ No newline at end of file
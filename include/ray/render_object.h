@@ -71,6 +71,9 @@ public:
 	const BoundingBox& getBoundingBox() const noexcept;
 	const BoundingBox& getBoundingBoxInWorld() const noexcept;
 
+	void setOccluder(const OccluderPtr& occluder) noexcept;
+	const OccluderPtr& getOccluder() const noexcept;
+
 	void setRenderScene(RenderScenePtr scene) noexcept;
 	const RenderScenePtr& getRenderScene() const noexcept;
 
@@ -106,6 +109,8 @@ private:
 	BoundingBox _boundingBox;
 	BoundingBox _worldBoundingxBox;
 
+	OccluderPtr _occluder;
+
 	float4x4 _transform;
 	float4x4 _transformInverse;
 
@@ -53,6 +53,10 @@ public:
 
 	void assginVisiable(const Camera& camera) noexcept;
 
+	void setOcclusionQueryEnable(bool enable) noexcept;
+	bool getOcclusionQueryEnable() const noexcept;
+	const OcclusionQueryQueuePtr& getOcclusionQueryQueue() const noexcept;
+
 	void noticeObjectsRenderBefore(const Camera& camera) noexcept;
 	void noticeObjectsRenderAfter(const Camera& camera) noexcept;
 
@@ -64,6 +68,8 @@ private:
 private:
 	OcclusionCullList _visiable;
 	RenderObjectRaws _renderQueue[RenderQueue::RenderQueueRangeSize];
+
+	OcclusionQueryQueuePtr _occlusionQueryQueue;
 };
 
 _NAME_END
@@ -52,6 +52,10 @@ public:
 
 	virtual void assginVisiable(const Camera& camera) noexcept = 0;
 
+	virtual void setOcclusionQueryEnable(bool enable) noexcept = 0;
+	virtual bool getOcclusionQueryEnable() const noexcept = 0;
+	virtual const OcclusionQueryQueuePtr& getOcclusionQueryQueue() const noexcept = 0;
+
 	virtual void noticeObjectsRenderBefore(const Camera& camera) noexcept = 0;
 	virtual void noticeObjectsRenderAfter(const Camera& camera) noexcept = 0;
 };
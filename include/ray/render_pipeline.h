@@ -88,6 +88,7 @@ public:
 
 	void drawCone(const MaterialTech& tech, std::uint32_t layer = 0) noexcept;
 	void drawSphere(const MaterialTech& tech, std::uint32_t layer = 0) noexcept;
+	void drawCube(const MaterialTech& tech, std::uint32_t layer = 0) noexcept;
 	void drawScreenQuad(const MaterialTech& tech, std::uint32_t instanceCount = 1) noexcept;
 	void drawScreenQuadLayer(const MaterialTech& tech, std::uint32_t layer, std::uint32_t instanceCount = 1) noexcept;
 
@@ -118,6 +119,7 @@ public:
 	const MaterialSemanticPtr& getSemanticParam(GlobalSemanticType type) const noexcept;
 
 	GraphicsDataPtr createGraphicsData(const GraphicsDataDesc& desc) noexcept;
+	GraphicsQueryPtr createQuery(const GraphicsQueryDesc& desc) noexcept;
 	GraphicsInputLayoutPtr createInputLayout(const GraphicsInputLayoutDesc& desc) noexcept;
 	GraphicsTexturePtr createTexture(const GraphicsTextureDesc& desc) noexcept;
 	GraphicsTexturePtr createTexture(std::uint32_t w, std::uint32_t h, GraphicsTextureDim dim, GraphicsFormat format, GraphicsSamplerFilter filter = GraphicsSamplerFilter::GraphicsSamplerFilterLinear, GraphicsSamplerWrap wrap = GraphicsSamplerWrap::GraphicsSamplerWrapRepeat) noexcept;
@@ -138,6 +140,7 @@ private:
 	void destroyDataManager() noexcept;
 
 	void makePlane(float width, float height, std::uint32_t widthSegments, std::uint32_t heightSegments) noexcept;
+	void makeCube(float size) noexcept;
 	void makeCone(float radius, float height, std::uint32_t segments, float thetaStart = 0, float thetaLength = M_TWO_PI) noexcept;
 	void makeSphere(float radius, std::uint32_t widthSegments = 8, std::uint32_t heightSegments = 6, float phiStart = 0.0, float phiLength = M_TWO_PI, float thetaStart = 0, float thetaLength = M_PI) noexcept;
 
@@ -170,6 +173,11 @@ private:
 	GraphicsIndexType _sphereIndexType;
 	std::uint32_t _sphereIndices;
 
+	GraphicsDataPtr _cubeVbo;
+	GraphicsDataPtr _cubeIbo;
+	GraphicsIndexType _cubeIndexType;
+	std::uint32_t _cubeIndices;
+
 	GraphicsDataPtr _coneVbo;
 	GraphicsDataPtr _coneIbo;
 	GraphicsIndexType _coneIndexType;
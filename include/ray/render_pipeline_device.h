@@ -56,9 +56,12 @@ public:
 	RenderPipelinePtr createRenderPipeline(WindHandle window, std::uint32_t w, std::uint32_t h, std::uint32_t dpi_w, std::uint32_t dpi_h, GraphicsSwapInterval interval) noexcept;
 
 	MaterialPtr createMaterial(const std::string& name) noexcept;
+	bool createMaterials(const std::vector<std::string>& names, Materials& materials) noexcept;
 	void destroyMaterial(MaterialPtr material) noexcept;
 
 	GraphicsDataPtr createGraphicsData(const GraphicsDataDesc& desc) noexcept;
+	GraphicsTransientBufferPtr createTransientBuffer(const GraphicsTransientBufferDesc& desc) noexcept;
+	GraphicsQueryPtr createQuery(const GraphicsQueryDesc& desc) noexcept;
 	GraphicsInputLayoutPtr createInputLayout(const GraphicsInputLayoutDesc& desc) noexcept;
 	GraphicsPipelinePtr createGraphicsPipeline(const GraphicsPipelineDesc& desc) noexcept;
 	GraphicsSwapchainPtr createSwapchain(const GraphicsSwapchainDesc& desc) noexcept;
@@ -101,10 +101,21 @@ public:
 
 	void addRenderObject(RenderObject* object) except;
 	void removeRenderObject(RenderObject* object) noexcept;
+	const RenderObjectRaws& getRenderObjectList() const noexcept;
 
 	void computVisiable(const Camera& camera, OcclusionCullList& list) except;
 	void computVisiableLight(const Camera& camera, OcclusionCullList& list) except;
 
+	void setOcclusionCullEnable(bool enable) noexcept;
+	bool getOcclusionCullEnable() const noexcept;
+
+	const OcclusionTraverserPtr& getOcclusionTraverser() const noexcept;
+
+	std::uint32_t getFrameIndex() const noexcept;
+
+	void addShadowCasterChanged(const BoundingBox& bound) noexcept;
+	const BoundingBoxes& getShadowCasterChanged() const noexcept;
+
 	void onRenderBefore() except;
 	void onRenderAfter() except;
 
@@ -122,6 +133,11 @@ private:
 
 	RenderObjectRaws _renderObjectList;
 
+	std::uint32_t _frameIndex;
+	BoundingBoxes _shadowCasterChanged;
+
+	OcclusionTraverserPtr _occlusionTraverser;
+
 	static RenderScenes _sceneList;
 };
 
@@ -55,6 +55,7 @@ struct EXPORT RenderSetting
 
 	ShadowMode shadowMode;
 	ShadowQuality shadowQuality;
+	std::uint32_t shadowCacheBudget;
 
 	RenderPipelineType pipelineType;
 
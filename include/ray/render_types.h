@@ -66,6 +66,9 @@ typedef std::shared_ptr<class RenderScene> RenderScenePtr;
 typedef std::shared_ptr<class RenderObject> RenderObjectPtr;
 typedef std::shared_ptr<class RenderPostProcess> RenderPostProcessPtr;
 typedef std::shared_ptr<class RenderDataManager> RenderDataManagerPtr;
+typedef std::shared_ptr<class Occluder> OccluderPtr;
+typedef std::shared_ptr<class OcclusionTraverser> OcclusionTraverserPtr;
+typedef std::shared_ptr<class OcclusionQueryQueue> OcclusionQueryQueuePtr;
 typedef std::shared_ptr<class RenderPipeline> RenderPipelinePtr;
 typedef std::shared_ptr<class RenderPipelineDevice> RenderPipelineDevicePtr;
 typedef std::shared_ptr<class RenderPipelineController> RenderPipelineControllerPtr;
@@ -114,6 +117,7 @@ typedef std::map<std::string, MaterialParamPtr> MaterialParams;
 
 typedef std::vector<Camera*> CameraRaws;
 typedef std::vector<RenderObject*> RenderObjectRaws;
+typedef std::vector<BoundingBox> BoundingBoxes;
 
 enum class CameraType : std::uint8_t
 {
@@ -206,6 +210,12 @@ enum LightShadowSize
 	LightShadowSizeEnumCount = 4
 };
 
+enum LightShadowCascade
+{
+	LightShadowCascadeMin = 1,
+	LightShadowCascadeMax = 4
+};
+
 enum class RenderPipelineType : std::uint8_t
 {
 	RenderPipelineTypeForward,
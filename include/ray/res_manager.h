@@ -41,6 +41,7 @@
 #include <ray/render_types.h>
 #include <ray/game_types.h>
 #include <ray/modhelp.h>
+#include <ray/imagtypes.h>
 
 _NAME_BEGIN
 
@@ -69,6 +70,8 @@ public:
 	bool createModel(const util::string& path, ModelPtr& model) noexcept;
 	bool createMaterial(const util::string& path, MaterialPtr& material) noexcept;
 	bool createTexture(const util::string& path, GraphicsTexturePtr& texture, GraphicsTextureDim dim = GraphicsTextureDim::GraphicsTextureDim2D, GraphicsSamplerFilter filter = GraphicsSamplerFilter::GraphicsSamplerFilterLinear, GraphicsSamplerWrap warp = GraphicsSamplerWrap::GraphicsSamplerWrapRepeat, bool cache = true) noexcept;
+	bool createTexture(const util::string& path, const image::Image& image, GraphicsTexturePtr& texture, GraphicsTextureDim dim = GraphicsTextureDim::GraphicsTextureDim2D, GraphicsSamplerFilter filter = GraphicsSamplerFilter::GraphicsSamplerFilterLinear, GraphicsSamplerWrap warp = GraphicsSamplerWrap::GraphicsSamplerWrapRepeat, bool cache = true) noexcept;
+	bool createTextures(const std::vector<util::string>& paths, GraphicsTextures& textures, GraphicsTextureDim dim = GraphicsTextureDim::GraphicsTextureDim2D, GraphicsSamplerFilter filter = GraphicsSamplerFilter::GraphicsSamplerFilterLinear, GraphicsSamplerWrap warp = GraphicsSamplerWrap::GraphicsSamplerWrapRepeat, bool cache = true) noexcept;
 	bool createAnimation(const util::string& path, const GameObjects& bones, GameComponentPtr& animation) noexcept;
 
 	bool createGameObject(const Model& model, GameObjectPtr& gameObject) noexcept;
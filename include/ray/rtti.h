@@ -64,9 +64,16 @@ namespace rtti
 		bool isDerivedFrom(const std::string& name) const;
 
 	private:
+		friend class Factory;
+
 		std::string _name;
 		const Rtti* _parent;
 		RttiConstruct _construct;
+
+		// depth-first numbering handed out by Factory::open(), a type derives from another when its
+		// _intervalBegin lies in the other's [_intervalBegin, _intervalEnd]; zero until numbered
+		std::uint32_t _intervalBegin;
+		std::uint32_t _intervalEnd;
 	};
 
 	class EXPORT Interface : public std::enable_shared_from_this<Interface>
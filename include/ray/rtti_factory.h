@@ -39,6 +39,10 @@
 
 #include <ray/rtti.h>
 
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+
 _NAME_BEGIN
 
 namespace rtti
@@ -52,6 +56,8 @@ namespace rtti
 
 		bool open() noexcept;
 
+		// Registering after open() renumbers the intervals of every type in place, which isA reads without a lock.
+		// Such late registration must therefore happen on the thread that called open(), while no other thread tests types.
 		bool add(Rtti* rtti) noexcept;
 
 		Rtti* getRTTI(const char* name) noexcept;
@@ -88,8 +94,16 @@ namespace rtti
 		}
 
 	private:
-		std::vector<Rtti*> _rttis;
-		std::map<std::string, Rtti*> _rtti_lists;
+		typedef std::unordered_map<const Rtti*, std::vector<Rtti*>> RttiChildren;
+
+		void buildIntervals() noexcept;
+		void buildIntervals(Rtti* rtti, const RttiChildren& children, std::uint32_t& order) noexcept;
+
+	private:
+		bool _isOpened;
+		std::thread::id _openThread;
+
+		std::unordered_map<std::string, Rtti*> _rtti_lists;
 	};
 
 	template<typename T>
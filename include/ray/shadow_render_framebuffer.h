@@ -48,7 +48,28 @@ public:
 	ShadowRenderFramebuffer() noexcept;
 	virtual ~ShadowRenderFramebuffer() noexcept;
 
-	bool setup();
+	bool setup(std::uint32_t atlasSize = 1);
+
+	std::uint32_t getShadowMapSize() const noexcept;
+	std::uint32_t getShadowAtlasSize() const noexcept;
+
+	bool setupStaticCache(GraphicsFormat depthFormat) noexcept;
+	void destroyStaticCache() noexcept;
+
+	const GraphicsTexturePtr& getStaticCacheMap() const noexcept;
+	const GraphicsFramebufferPtr& getStaticCacheView() const noexcept;
+
+	void setStaticCacheFrame(std::uint32_t frame) noexcept;
+	std::uint32_t getStaticCacheFrame() const noexcept;
+
+	void setStaticCacheViewProject(const float4x4& viewProject) noexcept;
+	const float4x4& getStaticCacheViewProject() const noexcept;
+
+	void setStaticCacheStale(std::uint32_t frames) noexcept;
+	std::uint32_t getStaticCacheStale() const noexcept;
+
+	void setStaticCacheDynamic(bool dynamic) noexcept;
+	bool getStaticCacheDynamic() const noexcept;
 
 protected:
 	virtual void onResolutionChange() noexcept;
@@ -63,9 +84,21 @@ private:
 	ShadowRenderFramebuffer& operator=(const ShadowRenderFramebuffer&) noexcept = delete;
 
 private:
+	std::uint32_t _shadowMapSize;
+	std::uint32_t _shadowAtlasSize;
+
 	GraphicsTexturePtr _shadowDepthLinearMap;
 	GraphicsFramebufferPtr _shadowDepthLinearView;
 	GraphicsFramebufferLayoutPtr _shadowDepthLinearViewLayout;
+
+	std::uint32_t _staticCacheFrame;
+	std::uint32_t _staticCacheStale;
+	bool _staticCacheDynamic;
+	float4x4 _staticCacheViewProject;
+
+	GraphicsTexturePtr _staticCacheMap;
+	GraphicsFramebufferPtr _staticCacheView;
+	GraphicsFramebufferLayoutPtr _staticCacheViewLayout;
 };
 
 _NAME_END
@@ -68,11 +68,13 @@ private:
 
 	virtual void onFrameEnd() noexcept;
 
+	virtual void _updateMaterial(std::size_t n) noexcept;
+
 private:
-	bool _needUpdate;
+	std::size_t _jointOffset;
+	std::size_t _jointFrame;
 
 	GameObjects _transforms;
-	GraphicsDataPtr _jointData;
 	BoundingBox _boundingBox;
 	MeshPropertyPtr _mesh;
 
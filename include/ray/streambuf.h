@@ -59,6 +59,10 @@ public:
 
 	virtual int flush() noexcept = 0;
 
+	virtual char* map() noexcept;
+	virtual void unmap() noexcept;
+	virtual bool isMapping() const noexcept;
+
 	virtual void lock() noexcept;
 	virtual void unlock() noexcept;
 };
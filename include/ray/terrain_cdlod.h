@@ -0,0 +1,219 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#ifndef _H_TERRAIN_CDLOD_H_
+#define _H_TERRAIN_CDLOD_H_
+
+#include <ray/render_object.h>
+#include <ray/terrain_types.h>
+#include <ray/queue.h>
+
+#include <thread>
+#include <unordered_map>
+
+_NAME_BEGIN
+
+// Continuous distance-dependent level of detail terrain.
+// Every selected quadtree node draws the same grid mesh, displaced in the vertex shader from a height tile.
+// Tiles are raw 16 bit files named "<path>/<level>_<x>_<z>.r16" with (tileSize + 1)^2 samples,
+// a level n tile covers tileSize << n cells at one sample every 1 << n cells.
+// An optional "<path>/<level>_<x>_<z>.rg8" holds the matching normal tile, otherwise it is derived from the heights.
+class EXPORT TerrainCDLOD final : public RenderObject
+{
+	__DeclareSubClass(TerrainCDLOD, RenderObject)
+public:
+	TerrainCDLOD() noexcept;
+	~TerrainCDLOD() noexcept;
+
+	bool setup(const std::string& path, std::uint32_t size, std::uint32_t tileSize = 256, std::uint32_t gridSize = 32) noexcept;
+	void close() noexcept;
+
+	void setMaterial(const MaterialPtr& material) noexcept;
+	const MaterialPtr& getMaterial() const noexcept;
+
+	void setCellSize(float size) noexcept;
+	float getCellSize() const noexcept;
+
+	void setHeightScale(float scale) noexcept;
+	float getHeightScale() const noexcept;
+
+	void setLodDistance(float distance) noexcept;
+	float getLodDistance() const noexcept;
+
+	void setMorphRatio(float ratio) noexcept;
+	float getMorphRatio() const noexcept;
+
+	void setTileBudget(std::size_t bytes) noexcept;
+	std::size_t getTileBudget() const noexcept;
+
+	std::uint8_t getNumLods() const noexcept;
+	std::size_t getNumSelectedNodes() const noexcept;
+	std::size_t getNumResidentTiles() const noexcept;
+	std::size_t getNumPendingTiles() const noexcept;
+	std::size_t getResidentMemory() const noexcept;
+
+	float getSelectTime() const noexcept;
+
+private:
+	struct Tile
+	{
+		enum State
+		{
+			Loading,
+			Loaded,
+			Resident,
+			Missing
+		};
+
+		std::uint8_t level;
+		std::uint32_t x;
+		std::uint32_t z;
+
+		std::atomic<std::uint8_t> state;
+		std::uint32_t lastFrame;
+		std::size_t memoryUsage;
+
+		float spacing;
+		float heightScale;
+
+		std::vector<std::uint16_t> heights;
+		std::vector<std::uint8_t> normals;
+		std::vector<float2> bounds;
+
+		GraphicsTexturePtr heightMap;
+		GraphicsTexturePtr normalMap;
+	};
+
+	struct Node
+	{
+		std::uint8_t level;
+		std::uint32_t x;
+		std::uint32_t z;
+
+		const Tile* tile;
+	};
+
+	struct Selection
+	{
+		std::uint32_t frame;
+		std::vector<Node> nodes;
+	};
+
+	typedef std::shared_ptr<Tile> TilePtr;
+
+private:
+	bool setupGridMesh() noexcept;
+	bool setupMaterial() noexcept;
+
+	void updateLodRanges() noexcept;
+	void updateBoundingBox() noexcept;
+
+	bool selectNode(std::vector<Node>& nodes, const Frustum& fru, const float3& eye, std::uint8_t level, std::uint32_t x, std::uint32_t z, std::uint32_t frame) noexcept;
+	void addNode(std::vector<Node>& nodes, std::uint8_t level, std::uint32_t x, std::uint32_t z, std::uint32_t frame) noexcept;
+
+	AABB getNodeBound(std::uint8_t level, std::uint32_t x, std::uint32_t z) const noexcept;
+	Tile* getNodeTile(std::uint8_t level, std::uint32_t x, std::uint32_t z, bool request, std::uint32_t frame) noexcept;
+
+	void uploadTiles() noexcept;
+	void evictTiles(std::uint32_t frame) noexcept;
+
+	void loadTile(Tile& tile) noexcept;
+	void missingTile(Tile& tile) noexcept;
+	void dispose() noexcept;
+
+	static std::uint64_t makeTileKey(std::uint8_t level, std::uint32_t x, std::uint32_t z) noexcept;
+
+private:
+	bool onVisiableTest(const Camera& camera, const Frustum& fru) noexcept;
+
+	void onAddRenderData(RenderDataManager& manager) noexcept;
+	void onRenderObject(RenderPipeline& pipeline, RenderQueue queue, MaterialTech* tech) noexcept;
+
+private:
+	TerrainCDLOD(const TerrainCDLOD&) = delete;
+	TerrainCDLOD& operator=(const TerrainCDLOD&) = delete;
+
+private:
+	std::string _path;
+
+	std::uint32_t _size;
+	std::uint32_t _tileSize;
+	std::uint32_t _gridSize;
+	std::uint8_t _numLods;
+
+	float _cellSize;
+	float _heightScale;
+	float _lodDistance;
+	float _morphRatio;
+
+	std::vector<float> _lodRanges;
+
+	// shadow cameras are tested inside the pipeline of the main camera, so every camera keeps its own nodes
+	std::unordered_map<const Camera*, Selection> _selections;
+	std::size_t _numSelectedNodes;
+
+	std::size_t _tileBudget;
+	std::size_t _residentMemory;
+	std::size_t _numResidentTiles;
+	std::size_t _maxRequests;
+	std::size_t _maxUploads;
+
+	float _selectTime;
+
+	std::unordered_map<std::uint64_t, TilePtr> _tiles;
+
+	std::atomic<std::size_t> _numPending;
+	ray::threadsafe_queue<TilePtr> _requests;
+	ray::threadsafe_queue<TilePtr> _loaded;
+	std::unique_ptr<std::thread> _thread;
+
+	GraphicsDataPtr _vbo;
+	GraphicsDataPtr _ibo;
+	std::uint32_t _numIndices;
+
+	MaterialPtr _material;
+	MaterialTechPtr _techniques[RenderQueue::RenderQueueRangeSize];
+	MaterialParamPtr _cdlodNode;
+	MaterialParamPtr _cdlodMorph;
+	MaterialParamPtr _cdlodTile;
+	MaterialParamPtr _cdlodCamera;
+	MaterialParamPtr _cdlodHeightMap;
+	MaterialParamPtr _cdlodNormalMap;
+};
+
+_NAME_END
+
+#endif
\ No newline at end of file
@@ -44,6 +44,7 @@ _NAME_BEGIN
 typedef std::shared_ptr<class TerrainMap> TerrainMapPtr;
 typedef std::shared_ptr<class TerrainChunk> TerrainChunkPtr;
 typedef std::shared_ptr<class TerrainObserver> TerrainObserverPtr;
+typedef std::shared_ptr<class TerrainCDLOD> TerrainCDLODPtr;
 
 _NAME_END
 
@@ -38,6 +38,7 @@
 #define _H_THREAD_H_
 
 #include <ray/platform.h>
+#include <ray/singleton.h>
 
 #include <thread>
 #include <mutex>
@@ -94,6 +95,49 @@ private:
 	std::vector<std::function<void(void)>> _taskDispose;
 };
 
+// Spreads the iterations of a loop over helper threads that are started once and live for the whole process.
+// The calling thread takes a share as well, a loop started while another one runs, or from inside one, runs serially.
+class EXPORT ParallelFor final
+{
+	__DeclareSingleton(ParallelFor)
+public:
+	ParallelFor() noexcept;
+	~ParallelFor() noexcept;
+
+	void run(std::uint32_t count, const std::function<void(std::uint32_t)>& func) noexcept;
+
+private:
+	void start() noexcept;
+	void runTasks() noexcept;
+
+	void dispose() noexcept;
+
+private:
+	ParallelFor(const ParallelFor&) = delete;
+	ParallelFor& operator=(const ParallelFor&) = delete;
+
+private:
+	bool _quit;
+	std::uint32_t _generation;
+	std::uint32_t _numBusy;
+	std::uint32_t _count;
+	std::atomic<std::uint32_t> _next;
+	std::atomic<bool> _running;
+
+	const std::function<void(std::uint32_t)>* _func;
+
+	std::mutex _mutex;
+	std::condition_variable _dispatch;
+	std::condition_variable _finish;
+	std::vector<std::unique_ptr<std::thread>> _threads;
+};
+
+template<typename Function>
+void parallelFor(std::uint32_t count, const Function& func) noexcept
+{
+	ParallelFor::instance()->run(count, func);
+}
+
 _NAME_END
 
 #endif
\ No newline at end of file
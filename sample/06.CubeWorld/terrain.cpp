@@ -39,6 +39,13 @@
 
 __ImplementSubClass(TerrainComponent, ray::GameComponent, "Terrain")
 
+namespace
+{
+	// chunk offsets of the sides -x, +x, -z, +z, the opposite of a side is side ^ 1
+	const std::int32_t neighborX[4] = { -1, 1, 0, 0 };
+	const std::int32_t neighborZ[4] = { 0, 0, -1, 1 };
+}
+
 TerrainComponent::TerrainComponent() noexcept
 	: _createRadius(2)
 	, _deleteRadius(5)
@@ -48,6 +55,7 @@ TerrainComponent::TerrainComponent() noexcept
 	, _size(32)
 	, _scale(2)
 	, _dayTimer(0)
+	, _maxUploads(4)
 {
 	_maxItem = std::numeric_limits<InstanceID>::max();
 	_maxChunks = _deleteRadius  * _deleteRadius * _deleteRadius;
@@ -125,11 +133,7 @@ TerrainComponent::addBlockByRaycast(const ray::Vector3& translate, const ray::Ve
 		} while (data.instanceID);
 
 		if (chunk && data.instanceID == 0)
-		{
-			chunk->set(block);
-			chunk->update();
-			return true;
-		}
+			return chunk->edit(block);
 	}
 
 	return false;
@@ -143,10 +147,7 @@ TerrainComponent::removeBlockByMousePos(std::int32_t x, std::int32_t y) noexcept
 	if (chunk)
 	{
 		out.instanceID = 0;
-
-		chunk->set(out);
-		chunk->update();
-		return true;
+		return chunk->edit(out);
 	}
 
 	return false;
@@ -160,10 +161,7 @@ TerrainComponent::removeBlockByRaycast(const ray::Vector3& translate, const ray:
 	if (chunk)
 	{
 		out.instanceID = 0;
-
-		chunk->set(out);
-		chunk->update();
-		return true;
+		return chunk->edit(out);
 	}
 
 	return false;
@@ -338,6 +336,12 @@ TerrainComponent::getObjects() noexcept
 	return _objects;
 }
 
+const TerrainWorkers&
+TerrainComponent::getWorkers() const noexcept
+{
+	return _workers;
+}
+
 void
 TerrainComponent::deleteChunks() noexcept
 {
@@ -365,7 +369,7 @@ TerrainComponent::deleteChunks() noexcept
 void
 TerrainComponent::createChunks() noexcept
 {
-	if (_chunks.size() > _maxChunks)
+	if (_chunks.size() + _loading.size() > _maxChunks)
 		return;
 
 	auto translate = this->getGameObject()->getTranslate();
@@ -390,8 +394,7 @@ TerrainComponent::createChunks() noexcept
 			std::int32_t dy = y;
 			std::int32_t dz = z + ip;
 
-			auto chunk = this->getChunkByChunkPos(dx, dy, dz);
-			if (chunk && !chunk->dirt())
+			if (this->getChunkByChunkPos(dx, dy, dz) || this->isChunkLoading(dx, dy, dz))
 				continue;
 
 			std::int32_t invisiable = !this->visiable(fru, dx, dy, dz);
@@ -409,15 +412,11 @@ TerrainComponent::createChunks() noexcept
 	if (start == bestScore)
 		return;
 
-	auto chunk = this->getChunkByChunkPos(bestX, bestY, bestZ);
-	if (!chunk)
-	{
-		chunk = std::make_shared<TerrainChunk>(*this);
-		chunk->create(bestX, bestY, bestZ, _size);
-		chunk->setActive(true);
+	auto chunk = std::make_shared<TerrainChunk>(*this);
+	chunk->create(bestX, bestY, bestZ, _size);
 
-		_chunks.push_back(chunk);
-	}
+	_loading.push_back(chunk);
+	this->pushChunk(chunk);
 }
 
 void
@@ -448,25 +447,102 @@ TerrainComponent::hitChunks() noexcept
 }
 
 void
-TerrainComponent::dispose(std::shared_ptr<TerrainThread> ctx) noexcept
+TerrainComponent::buildChunks() noexcept
+{
+	for (auto& it : _chunks)
+	{
+		if (it->dirt() && !it->busy())
+			this->pushChunk(it);
+	}
+}
+
+void
+TerrainComponent::uploadChunks() noexcept
 {
-	while (!ctx->isQuitRequest)
+	TerrainChunkPtr chunk;
+
+	// the old meshes stay on screen until the rebuilt ones replace them here
+	for (std::size_t i = 0; i < _maxUploads && _workers.pop(chunk); i++)
 	{
-		if (ctx->state != TerrainThread::BUSY)
+		auto loading = std::find(_loading.begin(), _loading.end(), chunk);
+		if (loading != _loading.end())
 		{
-			ctx->mutex.lock();
-			ctx->dispose.wait(ctx->mutex);
-			ctx->mutex.unlock();
-			continue;
-		}
+			_loading.erase(loading);
+
+			if (chunk->upload())
+				this->updateNeighbors(chunk);
+
+			chunk->setActive(true);
 
-		if (ctx->chunk)
+			_chunks.push_back(chunk);
+		}
+		else if (std::find(_chunks.begin(), _chunks.end(), chunk) != _chunks.end())
+		{
+			if (chunk->upload())
+				this->updateNeighbors(chunk);
+		}
+		else
 		{
-			ctx->chunk->create(ctx->size, ctx->x, ctx->y, ctx->z);
+			chunk->busy(false);
 		}
+	}
+}
+
+void
+TerrainComponent::pushChunk(TerrainChunkPtr chunk) noexcept
+{
+	std::int32_t x, y, z;
+	chunk->getPosition(x, y, z);
+
+	// faces against a neighbour are culled with a copy of its border, taken before the worker starts
+	for (std::uint8_t side = 0; side < 4; side++)
+	{
+		auto neighbor = this->getChunkByChunkPos(x + neighborX[side], y, z + neighborZ[side]);
+		if (neighbor)
+			chunk->setNeighborBorder(side, neighbor->getBorder(side ^ 1));
+		else
+			chunk->setNeighborBorder(side, TerrainBorder());
+	}
+
+	_workers.push(chunk);
+}
+
+void
+TerrainComponent::updateNeighbors(TerrainChunkPtr chunk) noexcept
+{
+	std::int32_t x, y, z;
+	chunk->getPosition(x, y, z);
+
+	for (std::uint8_t side = 0; side < 4; side++)
+	{
+		auto neighbor = this->getChunkByChunkPos(x + neighborX[side], y, z + neighborZ[side]);
+		if (neighbor)
+			neighbor->update();
+	}
+}
+
+std::size_t
+TerrainComponent::getMemoryUsage() const noexcept
+{
+	std::size_t usage = 0;
+	for (auto& it : _chunks)
+		usage += it->getMemoryUsage();
+	return usage;
+}
+
+bool
+TerrainComponent::isChunkLoading(std::int32_t x, std::int32_t y, std::int32_t z) const noexcept
+{
+	for (auto& it : _loading)
+	{
+		std::int32_t _x, _y, _z;
+		it->getPosition(_x, _y, _z);
 
-		ctx->state = TerrainThread::DONE;
+		if (_x == x && _y == y && _z == z)
+			return true;
 	}
+
+	return false;
 }
 
 ray::GameComponentPtr
@@ -489,15 +565,17 @@ TerrainComponent::onActivate() except
 	auto y = chunked(translate.y);
 	auto z = chunked(translate.z);
 
+	_workers.start();
+
 	for (std::int32_t i = x - 1; i < x + 1; i++)
 	{
 		for (std::int32_t j = z - 1; j < z + 1; j++)
 		{
 			auto chunk = std::make_shared<TerrainChunk>(*this);
 			chunk->create(i, 0, j, _size);
-			chunk->setActive(true);
 
-			_chunks.push_back(chunk);
+			_loading.push_back(chunk);
+			this->pushChunk(chunk);
 		}
 	}
 
@@ -507,7 +585,10 @@ TerrainComponent::onActivate() except
 void
 TerrainComponent::onDeactivate() noexcept
 {
+	_workers.stop();
+
 	_chunks.clear();
+	_loading.clear();
 	_itmes.clear();
 
 	this->removeComponentDispatch(ray::GameDispatchType::GameDispatchTypeFrame, this);
@@ -519,4 +600,6 @@ TerrainComponent::onFrameEnd() except
 	this->deleteChunks();
 	this->createChunks();
 	this->hitChunks();
+	this->buildChunks();
+	this->uploadChunks();
 }
\ No newline at end of file
@@ -39,44 +39,7 @@
 
 #include "terrain_chunk.h"
 #include "terrain_item.h"
-
-class TerrainThread
-{
-public:
-	TerrainThread()
-		: state(IDLE)
-		, isQuitRequest(false)
-	{
-	}
-
-	bool isQuitRequest;
-
-	std::int32_t x;
-	std::int32_t y;
-	std::int32_t z;
-
-	std::size_t size;
-
-	TerrainChunkPtr chunk;
-
-	enum State
-	{
-		QUIT,
-		IDLE,
-		BUSY,
-		DONE,
-	};
-
-	std::atomic<State> state;
-
-	std::mutex mutex;
-	std::condition_variable_any dispose;
-	std::unique_ptr<std::thread> _thread;
-
-private:
-	TerrainThread(const TerrainThread&) = delete;
-	TerrainThread& operator=(TerrainThread&) = delete;
-};
+#include "terrain_workers.h"
 
 class TerrainComponent : public ray::GameComponent
 {
@@ -105,6 +68,9 @@ public:
 	void removeObject(TerrainObjectPtr object) noexcept;
 	TerrainObjects& getObjects() noexcept;
 
+	const TerrainWorkers& getWorkers() const noexcept;
+	std::size_t getMemoryUsage() const noexcept;
+
 	ray::GameComponentPtr clone() const noexcept;
 
 private:
@@ -113,8 +79,12 @@ private:
 	void createChunks() noexcept;
 	void checkChunks() noexcept;
 	void hitChunks() noexcept;
+	void buildChunks() noexcept;
+	void uploadChunks() noexcept;
+	void pushChunk(TerrainChunkPtr chunk) noexcept;
+	void updateNeighbors(TerrainChunkPtr chunk) noexcept;
 
-	void dispose(std::shared_ptr<TerrainThread> ctx) noexcept;
+	bool isChunkLoading(std::int32_t x, std::int32_t y, std::int32_t z) const noexcept;
 
 	void onActivate() except;
 	void onDeactivate() noexcept;
@@ -136,10 +106,14 @@ private:
 
 	std::size_t _maxChunks;
 	std::size_t _maxItem;
+	std::size_t _maxUploads;
 
 	std::vector<TerrainItemPtr> _itmes;
 	std::vector<TerrainObjectPtr> _objects;
 	std::vector<TerrainChunkPtr> _chunks;
+	std::vector<TerrainChunkPtr> _loading;
+
+	TerrainWorkers _workers;
 };
 
 #endif
\ No newline at end of file
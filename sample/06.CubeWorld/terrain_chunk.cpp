@@ -36,11 +36,14 @@
 // +----------------------------------------------------------------------
 #include "terrain_chunk.h"
 #include "terrain.h"
+#include "terrain_mesher.h"
 
 TerrainChunk::TerrainChunk(TerrainComponent& terrain) noexcept
 	: _terrain(terrain)
 	, _dirt(false)
+	, _busy(false)
 	, _active(false)
+	, _generated(false)
 {
 }
 
@@ -57,22 +60,83 @@ TerrainChunk::create(std::int32_t x, std::int32_t y, std::int32_t z, std::size_t
 	_z = z;
 	_size = size;
 	_map = std::make_shared<TerrainMap>();
-	_map->create(0x7FFF);
+	_map->create(size);
 
 	auto objects = _terrain.getObjects();
 	for (auto& it : objects)
+		_objects.push_back(it->clone());
+
+	_dirt = true;
+}
+
+void
+TerrainChunk::generate() noexcept
+{
+	for (auto& it : _objects)
+		it->create(*this);
+
+	_generated = true;
+}
+
+void
+TerrainChunk::build(TerrainMesher& mesher) noexcept
+{
+	mesher.setup(*this);
+
+	for (auto& it : _objects)
+		it->build(mesher);
+
+	this->buildBorders();
+}
+
+void
+TerrainChunk::buildBorders() noexcept
+{
+	std::int32_t size = _size;
+	std::int32_t height = _map->height();
+
+	for (std::uint8_t side = 0; side < 4; side++)
+		_bordersBack[side].resize(size * height);
+
+	for (std::int32_t y = 0; y < height; y++)
 	{
-		auto object = it->clone();
-		if (object->create(*this))
+		_map->getRow(y, 0, &_bordersBack[2][y * size]);
+		_map->getRow(y, size - 1, &_bordersBack[3][y * size]);
+
+		for (std::int32_t z = 0; z < size; z++)
 		{
-			_objects.push_back(object);
+			_bordersBack[0][y * size + z] = _map->get(0, y, z);
+			_bordersBack[1][y * size + z] = _map->get(size - 1, y, z);
 		}
 	}
+}
 
+bool
+TerrainChunk::upload() noexcept
+{
 	for (auto& it : _objects)
-	{
 		it->createObject(*this);
+
+	for (auto& it : _pending)
+		_map->set(it);
+
+	_dirt = !_pending.empty();
+	_busy = false;
+
+	_pending.clear();
+
+	bool changed = false;
+
+	for (std::uint8_t side = 0; side < 4; side++)
+	{
+		if (_borders[side] != _bordersBack[side])
+		{
+			std::swap(_borders[side], _bordersBack[side]);
+			changed = true;
+		}
 	}
+
+	return changed;
 }
 
 std::size_t
@@ -116,19 +180,56 @@ TerrainChunk::size() const noexcept
 	return _size;
 }
 
-const TerrainDatas&
-TerrainChunk::data() const noexcept
+const TerrainMapPtr&
+TerrainChunk::getMap() const noexcept
 {
-	return _map->data();
+	return _map;
+}
+
+std::size_t
+TerrainChunk::getMemoryUsage() const noexcept
+{
+	return _map->getMemoryUsage();
+}
+
+const TerrainBorder&
+TerrainChunk::getBorder(std::uint8_t side) const noexcept
+{
+	assert(side < 4);
+	return _borders[side];
+}
+
+void
+TerrainChunk::setNeighborBorder(std::uint8_t side, const TerrainBorder& border) noexcept
+{
+	assert(side < 4);
+	_neighbors[side] = border;
+}
+
+const TerrainBorder&
+TerrainChunk::getNeighborBorder(std::uint8_t side) const noexcept
+{
+	assert(side < 4);
+	return _neighbors[side];
+}
+
+bool
+TerrainChunk::edit(const TerrainData& data) noexcept
+{
+	// a worker may be reading the map, so the edit waits for the mesh it is building
+	if (_busy)
+		_pending.push_back(data);
+	else if (!this->set(data))
+		return false;
+
+	this->update();
+	return true;
 }
 
 void
 TerrainChunk::update() noexcept
 {
-	for (auto& it : _objects)
-	{
-		it->update(*this);
-	}
+	_dirt = true;
 }
 
 void
@@ -143,6 +244,24 @@ TerrainChunk::dirt() const noexcept
 	return _dirt;
 }
 
+void
+TerrainChunk::busy(bool busy) noexcept
+{
+	_busy = busy;
+}
+
+bool
+TerrainChunk::busy() const noexcept
+{
+	return _busy;
+}
+
+bool
+TerrainChunk::generated() const noexcept
+{
+	return _generated;
+}
+
 void
 TerrainChunk::setActive(bool active) noexcept
 {
@@ -46,6 +46,9 @@ public:
 	~TerrainChunk() noexcept;
 
 	void create(std::int32_t x, std::int32_t y, std::int32_t z, std::size_t size) noexcept;
+	void generate() noexcept;
+	void build(TerrainMesher& mesher) noexcept;
+	bool upload() noexcept;
 
 	void setActive(bool active) noexcept;
 	bool getActive() const noexcept;
@@ -53,6 +56,11 @@ public:
 	void dirt(bool dirt) noexcept;
 	bool dirt() const noexcept;
 
+	void busy(bool busy) noexcept;
+	bool busy() const noexcept;
+
+	bool generated() const noexcept;
+
 	std::size_t size() const noexcept;
 	std::size_t distance(std::int32_t x, std::int32_t y, std::int32_t z) noexcept;
 
@@ -60,11 +68,22 @@ public:
 
 	bool set(const TerrainData& data) noexcept;
 	bool get(TerrainData& data) const noexcept;
+	bool edit(const TerrainData& data) noexcept;
+
+	const TerrainMapPtr& getMap() const noexcept;
+	std::size_t getMemoryUsage() const noexcept;
+
+	// sides are ordered -x, +x, -z, +z, each border is stored as rows of blocks by height
+	const TerrainBorder& getBorder(std::uint8_t side) const noexcept;
 
-	const TerrainDatas& data() const noexcept;
+	void setNeighborBorder(std::uint8_t side, const TerrainBorder& border) noexcept;
+	const TerrainBorder& getNeighborBorder(std::uint8_t side) const noexcept;
 
 	void update() noexcept;
 
+private:
+	void buildBorders() noexcept;
+
 private:
 	TerrainChunk(const TerrainChunk&) noexcept = delete;
 	TerrainChunk& operator=(const TerrainChunk&) noexcept = delete;
@@ -74,7 +93,9 @@ private:
 	TerrainComponent& _terrain;
 
 	bool _dirt;
+	bool _busy;
 	bool _active;
+	bool _generated;
 
 	std::int32_t _x;
 	std::int32_t _y;
@@ -83,7 +104,12 @@ private:
 	std::size_t _size;
 
 	TerrainMapPtr _map;
+	TerrainDatas _pending;
 	TerrainObjects _objects;
+
+	TerrainBorder _borders[4];
+	TerrainBorder _bordersBack[4];
+	TerrainBorder _neighbors[4];
 };
 
 #endif
@@ -36,6 +36,7 @@
 // +----------------------------------------------------------------------
 #include "terrain_item.h"
 #include "terrain_chunk.h"
+#include "terrain_mesher.h"
 
 void
 TerrainItem::setInstance(InstanceID instance) noexcept
@@ -65,137 +66,43 @@ TerrainObject::getItems() noexcept
 	return items;
 }
 
-bool
-TerrainObject::visiable(const TerrainChunk& chunk, const TerrainData& it, VisiableFaces& faces) noexcept
+ray::MeshPropertyPtr
+TerrainObject::makeMesh(TerrainVertices& vertices) noexcept
 {
-	TerrainData d1(it.x - 1, it.y, it.z);
-	TerrainData d2(it.x + 1, it.y, it.z);
-	TerrainData d3(it.x, it.y - 1, it.z);
-	TerrainData d4(it.x, it.y + 1, it.z);
-	TerrainData d5(it.x, it.y, it.z - 1);
-	TerrainData d6(it.x, it.y, it.z + 1);
+	if (vertices.empty())
+		return nullptr;
 
-	bool f1 = false;
-	bool f2 = false;
-	bool f3 = false;
-	bool f4 = false;
-	bool f5 = false;
-	bool f6 = false;
+	auto mesh = std::make_shared<ray::MeshProperty>();
+	TerrainMesher::unpack(vertices, *mesh);
 
-	if (it.x >= 0) f1 = chunk.get(d1);
-	if (it.y >= 0) f3 = chunk.get(d3);
-	if (it.z >= 0) f5 = chunk.get(d5);
-	if (it.x < chunk.size()) f2 = chunk.get(d2);
-	if (it.y < chunk.size()) f4 = chunk.get(d4);
-	if (it.z < chunk.size()) f6 = chunk.get(d6);
+	mesh->computeTangents();
+	mesh->computeBoundingBox();
 
-	f1 = (d1.instanceID != it.instanceID) ? true : false;
-	f2 = (d2.instanceID != it.instanceID) ? true : false;
-	f3 = (d3.instanceID != it.instanceID) ? true : false;
-	f4 = (d4.instanceID != it.instanceID) ? true : false;
-	f5 = (d5.instanceID != it.instanceID) ? true : false;
-	f6 = (d6.instanceID != it.instanceID) ? true : false;
+	// the back buffer keeps its capacity for the next rebuild of this chunk
+	vertices.clear();
 
-	faces.left = f1;
-	faces.right = f2;
-	faces.bottom = f3;
-	faces.top = f4;
-	faces.front = f5;
-	faces.back = f6;
-
-	return (f1 + f2 + f3 + f4 + f5 + f6) ? true : false;
+	return mesh;
 }
 
-void
-TerrainObject::makeCube(ray::MeshPropertyPtr data, const VisiableFaces& faces, float x, float y, float z, float n) noexcept
+ray::GameObjectPtr
+TerrainObject::makeObject(TerrainChunk& chunk, const ray::GameObjectPtr& prototype, ray::MeshPropertyPtr mesh, const char* name) noexcept
 {
-	static const float positions[6][4][3] = 
-	{
-		{ { -1, -1, -1 },{ -1, -1, +1 },{ -1, +1, -1 },{ -1, +1, +1 } },
-		{ { +1, -1, -1 },{ +1, -1, +1 },{ +1, +1, -1 },{ +1, +1, +1 } },
-		{ { -1, +1, -1 },{ -1, +1, +1 },{ +1, +1, -1 },{ +1, +1, +1 } },
-		{ { -1, -1, -1 },{ -1, -1, +1 },{ +1, -1, -1 },{ +1, -1, +1 } },
-		{ { -1, -1, -1 },{ -1, +1, -1 },{ +1, -1, -1 },{ +1, +1, -1 } },
-		{ { -1, -1, +1 },{ -1, +1, +1 },{ +1, -1, +1 },{ +1, +1, +1 } }
-	};
-
-	static const float normals[6][3] = 
-	{
-		{ -1, 0, 0 },
-		{ +1, 0, 0 },
-		{ 0, +1, 0 },
-		{ 0, -1, 0 },
-		{ 0, 0, -1 },
-		{ 0, 0, +1 }
-	};
-
-	static const float uvs[6][4][2] = 
-	{
-		{ { 0, 0 },{ 1, 0 },{ 0, 1 },{ 1, 1 } },
-		{ { 1, 0 },{ 0, 0 },{ 1, 1 },{ 0, 1 } },
-		{ { 0, 1 },{ 0, 0 },{ 1, 1 },{ 1, 0 } },
-		{ { 0, 0 },{ 0, 1 },{ 1, 0 },{ 1, 1 } },
-		{ { 0, 0 },{ 0, 1 },{ 1, 0 },{ 1, 1 } },
-		{ { 1, 0 },{ 1, 1 },{ 0, 0 },{ 0, 1 } }
-	};
-
-	static const float indices[6][6] = 
-	{
-		{ 0, 3, 2, 0, 1, 3 },
-		{ 0, 3, 1, 0, 2, 3 },
-		{ 0, 3, 2, 0, 1, 3 },
-		{ 0, 3, 1, 0, 2, 3 },
-		{ 0, 3, 2, 0, 1, 3 },
-		{ 0, 3, 1, 0, 2, 3 }
-	};
-
-	static const float flipped[6][6] = 
-	{
-		{ 0, 1, 2, 1, 3, 2 },
-		{ 0, 2, 1, 2, 3, 1 },
-		{ 0, 1, 2, 1, 3, 2 },
-		{ 0, 2, 1, 2, 3, 1 },
-		{ 0, 1, 2, 1, 3, 2 },
-		{ 0, 2, 1, 2, 3, 1 }
-	};
-
-	float s = 0.0625;
-	float a = 0 + 1 / 2048.0;
-	float b = s - 1 / 2048.0;
-	int visiable[6] = { faces.left, faces.right, faces.top, faces.bottom, faces.front, faces.back };
+	int mx, my, mz;
+	chunk.getPosition(mx, my, mz);
 
-	auto& vertex = data->getVertexArray();
-	auto& normal = data->getNormalArray();
-	auto& texcoord = data->getTexcoordArray();
-	auto& face = data->getFaceArray();
+	int size = chunk.size();
 
-	for (int i = 0; i < 6; i++) 
-	{
-		if (visiable[i] == 0) 
-			continue;
-
-		for (int j = 0; j < 6; j++) 
-		{
-			int k = indices[i][j];
+	int offsetX = mx * size << 1;
+	int offsetY = my * size << 1;
+	int offsetZ = mz * size << 1;
 
-			ray::Vector3 v;
-			v.x = x + n * positions[i][k][0];
-			v.y = y + n * positions[i][k][1];
-			v.z = z + n * positions[i][k][2];
+	auto gameObject = prototype->clone();
+	gameObject->setName(ray::format(name) % offsetX % offsetY % offsetZ);
+	gameObject->setTranslate(ray::Vector3(offsetX, offsetY, offsetZ));
+	gameObject->getComponent<ray::MeshComponent>()->setMesh(mesh);
 
-			ray::Vector3 vn;
-			vn.x = normals[i][0];
-			vn.y = normals[i][1];
-			vn.z = normals[i][2];
+	if (chunk.getActive())
+		gameObject->setActive(true);
 
-			ray::Vector2 uv;
-			uv.x = (uvs[i][k][0] ? b : a);
-			uv.y = (uvs[i][k][1] ? b : a);
-
-			vertex.push_back(v);
-			normal.push_back(vn);
-			texcoord.push_back(uv);
-			face.push_back(vertex.size() - 1);
-		}
-	}
+	return gameObject;
 }
\ No newline at end of file
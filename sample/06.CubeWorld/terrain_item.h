@@ -50,34 +50,22 @@ private:
 	InstanceID _instanceID;
 };
 
-struct VisiableFaces
-{
-	InstanceID left;
-	InstanceID right;
-	InstanceID bottom;
-	InstanceID top;
-	InstanceID back;
-	InstanceID front;
-};
-
 class TerrainObject
 {
 public:
-
 	virtual bool create(TerrainChunk& chunk) noexcept = 0;
+	virtual void build(TerrainMesher& mesher) noexcept = 0;
 	virtual bool createObject(TerrainChunk& chunk) noexcept = 0;
 
 	virtual bool setActive(bool active) noexcept = 0;
 
-	virtual bool update(TerrainChunk& chunk) noexcept = 0;
-
 	virtual TerrainObjectPtr clone() noexcept = 0;
 
 	void addItem(TerrainItemPtr item) noexcept;
 	TerrainItems& getItems() noexcept;
 
-	bool visiable(const TerrainChunk& chunk, const TerrainData& entry, VisiableFaces& faces) noexcept;
-	void makeCube(ray::MeshPropertyPtr data, const VisiableFaces& faces, float x, float y, float z, float n) noexcept;
+	ray::MeshPropertyPtr makeMesh(TerrainVertices& vertices) noexcept;
+	ray::GameObjectPtr makeObject(TerrainChunk& chunk, const ray::GameObjectPtr& prototype, ray::MeshPropertyPtr mesh, const char* name) noexcept;
 
 private:
 	TerrainItems items;
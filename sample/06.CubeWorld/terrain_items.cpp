@@ -35,6 +35,7 @@
 // | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // +----------------------------------------------------------------------
 #include "terrain_items.h"
+#include "terrain_mesher.h"
 #include <ray/game_object_manager.h>
 
 TerrainGrass::TerrainGrass() noexcept
@@ -88,57 +89,25 @@ TerrainGrass::create(TerrainChunk& chunk) noexcept
 	return true;
 }
 
+void
+TerrainGrass::build(TerrainMesher& mesher) noexcept
+{
+	// the bottom layer is never seen from above ground
+	mesher.build(_grass->getInstance(), _grassVertices, 1);
+}
+
 bool
 TerrainGrass::createObject(TerrainChunk& chunk) noexcept
 {
-	auto mesh = std::make_shared<ray::MeshProperty>();
-
-	for (auto& it : chunk.data())
-	{
-		if (it.empty() || it.instanceID != _grass->getInstance())
-			continue;
-
-		if (it.y <= 0)
-			continue;
-
-		VisiableFaces faces;
-		int total = this->visiable(chunk, it, faces);
-		if (total)
-		{
-			int dx = it.x << 1;
-			int dy = it.y << 1;
-			int dz = it.z << 1;
-
-			this->makeCube(mesh, faces, dx, dy, dz, 1);
-		}
-	}
-
-	if (mesh->getNumVertices())
-	{
-		mesh->computeTangents();
-		mesh->computeTangentQuats();
-		mesh->computeBoundingBox();
-
-		int mx, my, mz;
-		chunk.getPosition(mx, my, mz);
+	auto mesh = this->makeMesh(_grassVertices);
+	auto object = mesh ? this->makeObject(chunk, _grassObject, mesh, "chunk_%d_%d_%d") : nullptr;
 
-		int size = chunk.size();
-
-		int offsetX = mx * size << 1;
-		int offsetY = my * size << 1;
-		int offsetZ = mz * size << 1;
-
-		auto gameObject = _grassObject->clone();
-		gameObject->setName(ray::format("chunk_%d_%d_%d") % offsetX % offsetY % offsetZ);
-		gameObject->setTranslate(ray::Vector3(offsetX, offsetY, offsetZ));
-		gameObject->getComponent<ray::MeshComponent>()->setMesh(mesh);
-
-		_object = gameObject;
+	if (_object)
+		_object->destroy();
 
-		return true;
-	}
+	_object = object;
 
-	return false;
+	return _object ? true : false;
 }
 
 bool
@@ -164,18 +133,6 @@ TerrainGrass::setActive(bool active) noexcept
 	}
 }
 
-bool
-TerrainGrass::update(TerrainChunk& chunk) noexcept
-{
-	_object->destroy();
-	_object = nullptr;
-
-	this->createObject(chunk);
-	this->setActive(true);
-
-	return true;
-}
-
 TerrainObjectPtr
 TerrainGrass::clone() noexcept
 {
@@ -270,73 +227,29 @@ TerrainTree::create(TerrainChunk& chunk) noexcept
 	return true;
 }
 
+void
+TerrainTree::build(TerrainMesher& mesher) noexcept
+{
+	mesher.build(_wood->getInstance(), _woodVertices);
+	mesher.build(_leaf->getInstance(), _leafVertices);
+}
+
 bool
 TerrainTree::createObject(TerrainChunk& chunk) noexcept
 {
-	auto woods = std::make_shared<ray::MeshProperty>();
-	auto leafs = std::make_shared<ray::MeshProperty>();
-
-	for (auto& it : chunk.data())
-	{
-		if (it.empty())
-			continue;
-
-		if (it.instanceID != _wood->getInstance() &&
-			it.instanceID != _leaf->getInstance())
-			continue;
-
-		VisiableFaces faces;
-		int total = this->visiable(chunk, it, faces);
-		if (total)
-		{
-			int dx = it.x << 1;
-			int dy = it.y << 1;
-			int dz = it.z << 1;
-
-			if (it.instanceID == _wood->getInstance())
-				this->makeCube(woods, faces, dx, dy, dz, 1);
-
-			if (it.instanceID == _leaf->getInstance())
-				this->makeCube(leafs, faces, dx, dy, dz, 1);
-		}
-	}
-
-	int mx, my, mz;
-	chunk.getPosition(mx, my, mz);
+	auto woods = this->makeMesh(_woodVertices);
+	auto leafs = this->makeMesh(_leafVertices);
 
-	int size = chunk.size();
-
-	int offsetX = mx * size << 1;
-	int offsetY = my * size << 1;
-	int offsetZ = mz * size << 1;
-
-	if (woods->getNumVertices())
-	{
-		woods->computeTangents();
-		woods->computeTangentQuats();
-		woods->computeBoundingBox();
-
-		auto gameObject = _woodObject->clone();
-		gameObject->setName(ray::format("chunk_wood_%d_%d_%d") % offsetX % offsetY % offsetZ);
-		gameObject->setTranslate(ray::Vector3(offsetX, offsetY, offsetZ));
-		gameObject->getComponent<ray::MeshComponent>()->setMesh(woods);
-
-		_objects.push_back(gameObject);
-	}
+	for (auto& it : _objects)
+		it->destroy();
 
-	if (leafs->getNumVertices())
-	{
-		leafs->computeTangents();
-		leafs->computeTangentQuats();
-		leafs->computeBoundingBox();
+	_objects.clear();
 
-		auto gameObject = _leafObject->clone();
-		gameObject->setName(ray::format("chunk_leaf_%d_%d_%d") % offsetX % offsetY % offsetZ);
-		gameObject->setTranslate(ray::Vector3(offsetX, offsetY, offsetZ));
-		gameObject->getComponent<ray::MeshComponent>()->setMesh(leafs);
+	if (woods)
+		_objects.push_back(this->makeObject(chunk, _woodObject, woods, "chunk_wood_%d_%d_%d"));
 
-		_objects.push_back(gameObject);
-	}
+	if (leafs)
+		_objects.push_back(this->makeObject(chunk, _leafObject, leafs, "chunk_leaf_%d_%d_%d"));
 
 	if (!_objects.empty())
 		return true;
@@ -363,12 +276,6 @@ TerrainTree::setActive(bool active) noexcept
 	return true;
 }
 
-bool
-TerrainTree::update(TerrainChunk& chunk) noexcept
-{
-	return true;
-}
-
 TerrainObjectPtr
 TerrainTree::clone() noexcept
 {
@@ -430,57 +337,24 @@ TerrainClound::create(TerrainChunk& chunk) noexcept
 	return true;
 }
 
+void
+TerrainClound::build(TerrainMesher& mesher) noexcept
+{
+	mesher.build(_clound->getInstance(), _cloundVertices);
+}
+
 bool
 TerrainClound::createObject(TerrainChunk& chunk) noexcept
 {
-	auto mesh = std::make_shared<ray::MeshProperty>();
-
-	for (auto& it : chunk.data())
-	{
-		if (it.empty())
-			continue;
-
-		if (it.instanceID != _clound->getInstance())
-			continue;
-
-		VisiableFaces faces;
-		int total = this->visiable(chunk, it, faces);
-		if (total)
-		{
-			int dx = it.x << 1;
-			int dy = it.y << 1;
-			int dz = it.z << 1;
-
-			this->makeCube(mesh, faces, dx, dy, dz, 1);
-		}
-	}
-
-	if (mesh->getNumVertices())
-	{
-		mesh->computeTangents();
-		mesh->computeTangentQuats();
-		mesh->computeBoundingBox();
+	auto mesh = this->makeMesh(_cloundVertices);
+	auto object = mesh ? this->makeObject(chunk, _cloundObject, mesh, "chunk_%d_%d_%d") : nullptr;
 
-		int mx, my, mz;
-		chunk.getPosition(mx, my, mz);
-
-		int size = chunk.size();
-
-		int offsetX = mx * size << 1;
-		int offsetY = my * size << 1;
-		int offsetZ = mz * size << 1;
-
-		auto gameObject = _cloundObject->clone();
-		gameObject->setName(ray::format("chunk_%d_%d_%d") % offsetX % offsetY % offsetZ);
-		gameObject->setTranslate(ray::Vector3(offsetX, offsetY, offsetZ));
-		gameObject->getComponent<ray::MeshComponent>()->setMesh(mesh);
-
-		_object = gameObject;
+	if (_object)
+		_object->destroy();
 
-		return true;
-	}
+	_object = object;
 
-	return false;
+	return _object ? true : false;
 }
 
 bool
@@ -502,12 +376,6 @@ TerrainClound::setActive(bool active) noexcept
 	return true;
 }
 
-bool
-TerrainClound::update(TerrainChunk& chunk) noexcept
-{
-	return true;
-}
-
 TerrainObjectPtr
 TerrainClound::clone() noexcept
 {
@@ -574,57 +442,24 @@ TerrainWater::create(TerrainChunk& chunk) noexcept
 	return true;
 }
 
+void
+TerrainWater::build(TerrainMesher& mesher) noexcept
+{
+	mesher.build(_water->getInstance(), _waterVertices);
+}
+
 bool
 TerrainWater::createObject(TerrainChunk& chunk) noexcept
 {
-	auto mesh = std::make_shared<ray::MeshProperty>();
-
-	for (auto& it : chunk.data())
-	{
-		if (it.empty())
-			continue;
-
-		if (it.instanceID != _water->getInstance())
-			continue;
-
-		VisiableFaces faces;
-		int total = this->visiable(chunk, it, faces);
-		if (total)
-		{
-			int dx = it.x << 1;
-			int dy = it.y << 1;
-			int dz = it.z << 1;
-
-			this->makeCube(mesh, faces, dx, dy, dz, 1);
-		}
-	}
-
-	if (mesh->getNumVertices())
-	{
-		mesh->computeTangents();
-		mesh->computeTangentQuats();
-		mesh->computeBoundingBox();
-
-		int mx, my, mz;
-		chunk.getPosition(mx, my, mz);
+	auto mesh = this->makeMesh(_waterVertices);
+	auto object = mesh ? this->makeObject(chunk, _waterObject, mesh, "chunk_%d_%d_%d") : nullptr;
 
-		int size = chunk.size();
-
-		int offsetX = mx * size << 1;
-		int offsetY = my * size << 1;
-		int offsetZ = mz * size << 1;
-
-		auto gameObject = _waterObject->clone();
-		gameObject->setName(ray::format("chunk_%d_%d_%d") % offsetX % offsetY % offsetZ);
-		gameObject->setTranslate(ray::Vector3(offsetX, offsetY, offsetZ));
-		gameObject->getComponent<ray::MeshComponent>()->setMesh(mesh);
-
-		_object = gameObject;
+	if (_object)
+		_object->destroy();
 
-		return true;
-	}
+	_object = object;
 
-	return false;
+	return _object ? true : false;
 }
 
 bool
@@ -646,12 +481,6 @@ TerrainWater::setActive(bool active) noexcept
 	return true;
 }
 
-bool
-TerrainWater::update(TerrainChunk& chunk) noexcept
-{
-	return false;
-}
-
 TerrainObjectPtr
 TerrainWater::clone() noexcept
 {
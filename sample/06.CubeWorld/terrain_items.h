@@ -46,12 +46,11 @@ public:
 	~TerrainGrass() noexcept;
 
 	bool create(TerrainChunk& chunk) noexcept;
+	void build(TerrainMesher& mesher) noexcept;
 	bool createObject(TerrainChunk& chunk) noexcept;
 
 	bool setActive(bool active) noexcept;
 
-	bool update(TerrainChunk& chunk) noexcept;
-
 	TerrainObjectPtr clone() noexcept;
 
 private:
@@ -60,6 +59,8 @@ private:
 
 	std::shared_ptr<Grass> _grass;
 
+	TerrainVertices _grassVertices;
+
 	ray::GameObjectPtr _grassObject;
 	ray::GameObjectPtr _object;
 };
@@ -71,12 +72,11 @@ public:
 	~TerrainTree() noexcept;
 
 	bool create(TerrainChunk& chunk) noexcept;
+	void build(TerrainMesher& mesher) noexcept;
 	bool createObject(TerrainChunk& chunk) noexcept;
 
 	bool setActive(bool active) noexcept;
 
-	bool update(TerrainChunk& chunk) noexcept;
-
 	TerrainObjectPtr clone() noexcept;
 
 private:
@@ -86,6 +86,9 @@ private:
 	std::shared_ptr<Wood> _wood;
 	std::shared_ptr<Leaf> _leaf;
 
+	TerrainVertices _woodVertices;
+	TerrainVertices _leafVertices;
+
 	ray::GameObjectPtr _woodObject;
 	ray::GameObjectPtr _leafObject;
 
@@ -99,18 +102,18 @@ public:
 	~TerrainClound() noexcept;
 
 	bool create(TerrainChunk& chunk) noexcept;
+	void build(TerrainMesher& mesher) noexcept;
 	bool createObject(TerrainChunk& chunk) noexcept;
 
 	bool setActive(bool active) noexcept;
 
-	bool update(TerrainChunk& chunk) noexcept;
-
 	TerrainObjectPtr clone() noexcept;
 
 private:
 	class Clound : public TerrainItem {};
 
 	std::shared_ptr<Clound> _clound;
+	TerrainVertices _cloundVertices;
 	ray::GameObjectPtr _cloundObject;
 
 	ray::GameObjectPtr _object;
@@ -123,12 +126,11 @@ public:
 	~TerrainWater() noexcept;
 
 	bool create(TerrainChunk& chunk) noexcept;
+	void build(TerrainMesher& mesher) noexcept;
 	bool createObject(TerrainChunk& chunk) noexcept;
 
 	bool setActive(bool active) noexcept;
 
-	bool update(TerrainChunk& chunk) noexcept;
-
 	TerrainObjectPtr clone() noexcept;
 
 private:
@@ -136,6 +138,8 @@ private:
 
 	std::shared_ptr<Water> _water;
 
+	TerrainVertices _waterVertices;
+
 	ray::GameObjectPtr _waterObject;
 	ray::GameObjectPtr _object;
 };
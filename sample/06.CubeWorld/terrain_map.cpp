@@ -36,14 +36,124 @@
 // +----------------------------------------------------------------------
 #include "terrain_map.h"
 
+namespace
+{
+	const std::int32_t brickShift = 4;
+	const std::int32_t brickSize = 1 << brickShift;
+	const std::int32_t brickMask = brickSize - 1;
+
+	// block positions are signed bytes, so nothing is ever stored above this
+	const std::int32_t maxHeight = std::numeric_limits<BlockPosition>::max() + 1;
+}
+
+TerrainBrick::TerrainBrick() noexcept
+	: _bits(0)
+{
+	_palette.push_back(0);
+}
+
+TerrainBrick::~TerrainBrick() noexcept
+{
+}
+
+InstanceID
+TerrainBrick::get(std::uint16_t index) const noexcept
+{
+	if (_bits == 0)
+		return _palette.front();
+
+	std::size_t bit = index * _bits;
+	std::uint64_t mask = (1ull << _bits) - 1;
+	return _palette[(_words[bit >> 6] >> (bit & 63)) & mask];
+}
+
+InstanceID
+TerrainBrick::set(std::uint16_t index, InstanceID instance) noexcept
+{
+	auto old = this->get(index);
+	if (old == instance)
+		return old;
+
+	auto it = std::find(_palette.begin(), _palette.end(), instance);
+	if (it == _palette.end())
+	{
+		_palette.push_back(instance);
+
+		if (_palette.size() > (1u << _bits))
+			this->grow(_bits == 0 ? 1 : _bits << 1);
+
+		it = _palette.end() - 1;
+	}
+
+	std::size_t bit = index * _bits;
+	std::uint64_t mask = (1ull << _bits) - 1;
+	std::uint64_t value = it - _palette.begin();
+
+	auto& word = _words[bit >> 6];
+	word = (word & ~(mask << (bit & 63))) | (value << (bit & 63));
+
+	return old;
+}
+
+void
+TerrainBrick::getRow(std::uint16_t index, InstanceID* row) const noexcept
+{
+	if (_bits == 0)
+	{
+		std::fill(row, row + brickSize, _palette.front());
+		return;
+	}
+
+	for (std::uint16_t i = 0; i < brickSize; i++)
+		row[i] = this->get(index + i);
+}
+
+std::size_t
+TerrainBrick::getMemoryUsage() const noexcept
+{
+	return sizeof(TerrainBrick) + _palette.capacity() * sizeof(InstanceID) + _words.capacity() * sizeof(std::uint64_t);
+}
+
+void
+TerrainBrick::grow(std::uint8_t bits) noexcept
+{
+	assert(bits <= 16);
+
+	const std::size_t count = brickSize * brickSize * brickSize;
+
+	std::vector<std::uint64_t> words((count * bits + 63) >> 6);
+
+	// the palette already holds the new instance, so the old indices are read with the old width
+	if (_bits > 0)
+	{
+		std::uint64_t mask = (1ull << _bits) - 1;
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			std::size_t from = i * _bits;
+			std::size_t to = i * bits;
+
+			std::uint64_t value = (_words[from >> 6] >> (from & 63)) & mask;
+			words[to >> 6] |= value << (to & 63);
+		}
+	}
+
+	_bits = bits;
+	_words.swap(words);
+}
+
 TerrainMap::TerrainMap() noexcept
-	: _mask(0)
+	: _size(0)
+	, _height(0)
+	, _count(0)
+	, _bricksX(0)
+	, _bricksZ(0)
 {
 }
 
-TerrainMap::TerrainMap(std::size_t mask) noexcept
+TerrainMap::TerrainMap(std::size_t size) noexcept
 {
-	this->create(mask);
+	this->create(size);
 }
 
 TerrainMap::~TerrainMap() noexcept
@@ -52,83 +162,100 @@ TerrainMap::~TerrainMap() noexcept
 }
 
 void
-TerrainMap::create(std::size_t mask) noexcept
+TerrainMap::create(std::size_t size) noexcept
 {
-	_mask = mask;
+	_size = static_cast<std::int32_t>(size);
+	_height = 0;
 	_count = 0;
-	_data.resize(mask + 1);
+	_bricksX = (size + brickMask) >> brickShift;
+	_bricksZ = (size + brickMask) >> brickShift;
+
+	_bricks.clear();
+	_bricks.resize(_bricksX * _bricksZ * (maxHeight >> brickShift));
 }
 
 void
 TerrainMap::clear() noexcept
 {
-	_data.clear();
+	_bricks.clear();
+	_height = 0;
+	_count = 0;
 }
 
 bool
 TerrainMap::set(const TerrainData& data) noexcept
 {
-	std::size_t index = ray::math::hash_int(data.x, data.y, data.z) & _mask;
+	if (data.x < 0 || data.x >= _size) return false;
+	if (data.y < 0 || data.y >= maxHeight) return false;
+	if (data.z < 0 || data.z >= _size) return false;
 
-	auto* entry = &_data[index];
+	auto& brick = _bricks[((data.y >> brickShift) * _bricksZ + (data.z >> brickShift)) * _bricksX + (data.x >> brickShift)];
+	auto index = ((data.y & brickMask) * brickSize + (data.z & brickMask)) * brickSize + (data.x & brickMask);
 
-	int overwrite = 0;
-	while (!entry->empty())
-	{
-		if (entry->x == data.x && entry->y == data.y && entry->z == data.z)
-		{
-			overwrite = 1;
-			break;
-		}
-
-		index = (index + 1) & _mask;
-		entry = &_data[index];
-	}
-
-	if (overwrite)
-	{
-		if (entry->instanceID != data.instanceID)
-		{
-			entry->instanceID = data.instanceID;
-			return true;
-		}
-	}
-	else if (data.instanceID)
-	{
-		*entry = data;
+	auto old = brick.set(index, data.instanceID);
+	if (old == data.instanceID)
+		return false;
 
+	if (old == 0)
 		_count++;
-		if (_count * 2 > _mask)
-			this->grow();
+	else if (data.instanceID == 0)
+		_count--;
 
-		return true;
-	}
+	if (data.instanceID && data.y >= _height)
+		_height = data.y + 1;
 
-	return false;
+	return true;
 }
 
 bool
-TerrainMap::get(TerrainData& data) noexcept
+TerrainMap::get(TerrainData& data) const noexcept
 {
-	std::size_t index = ray::math::hash_int(data.x, data.y, data.z) & _mask;
+	data.instanceID = this->get(data.x, data.y, data.z);
+	return data.instanceID != 0;
+}
 
-	TerrainData* entry = &_data[index];
+InstanceID
+TerrainMap::get(std::int32_t x, std::int32_t y, std::int32_t z) const noexcept
+{
+	if (x < 0 || x >= _size) return 0;
+	if (y < 0 || y >= _height) return 0;
+	if (z < 0 || z >= _size) return 0;
 
-	while (!entry->empty())
+	auto& brick = _bricks[((y >> brickShift) * _bricksZ + (z >> brickShift)) * _bricksX + (x >> brickShift)];
+	return brick.get(((y & brickMask) * brickSize + (z & brickMask)) * brickSize + (x & brickMask));
+}
+
+void
+TerrainMap::getRow(std::int32_t y, std::int32_t z, InstanceID* row) const noexcept
+{
+	assert(y >= 0 && y < maxHeight);
+	assert(z >= 0 && z < _size);
+
+	InstanceID bricks[brickSize];
+
+	auto first = ((y >> brickShift) * _bricksZ + (z >> brickShift)) * _bricksX;
+	auto index = ((y & brickMask) * brickSize + (z & brickMask)) * brickSize;
+
+	for (std::size_t i = 0; i < _bricksX; i++)
 	{
-		if (entry->x == data.x &&
-			entry->y == data.y &&
-			entry->z == data.z)
-		{
-			data.instanceID = entry->instanceID;
-			return true;
-		}
+		std::size_t x = i << brickShift;
+		std::size_t n = std::min<std::size_t>(brickSize, static_cast<std::size_t>(_size) - x);
 
-		index = (index + 1) & _mask;
-		entry = &_data[index];
+		_bricks[first + i].getRow(index, bricks);
+		std::copy(bricks, bricks + n, row + x);
 	}
+}
+
+std::size_t
+TerrainMap::size() const noexcept
+{
+	return _size;
+}
 
-	return false;
+std::size_t
+TerrainMap::height() const noexcept
+{
+	return _height;
 }
 
 std::size_t
@@ -137,27 +264,13 @@ TerrainMap::count() const noexcept
 	return _count;
 }
 
-void
-TerrainMap::grow() noexcept
+std::size_t
+TerrainMap::getMemoryUsage() const noexcept
 {
-	TerrainMap map;
-	map.create(_mask << 1 | 1);
+	std::size_t bytes = sizeof(TerrainMap);
 
-	for (auto& it : _data)
-	{
-		if (!it.empty())
-		{
-			map.set(it);
-		}
-	}
+	for (auto& it : _bricks)
+		bytes += it.getMemoryUsage();
 
-	_mask = map._mask;
-	_count = map._count;
-	_data.swap(map._data);
-}
-
-TerrainDatas&
-TerrainMap::data() noexcept
-{
-	return _data;
+	return bytes;
 }
\ No newline at end of file
@@ -75,35 +75,67 @@ public:
 	InstanceID instanceID;
 };
 
+// A 16x16x16 block of voxels that stores an index into its own palette of instances,
+// packed with as few bits as the palette needs. A uniform brick only keeps its palette.
+class TerrainBrick final
+{
+public:
+	TerrainBrick() noexcept;
+	~TerrainBrick() noexcept;
+
+	InstanceID get(std::uint16_t index) const noexcept;
+	InstanceID set(std::uint16_t index, InstanceID instance) noexcept;
+
+	void getRow(std::uint16_t index, InstanceID* row) const noexcept;
+
+	std::size_t getMemoryUsage() const noexcept;
+
+private:
+	void grow(std::uint8_t bits) noexcept;
+
+private:
+	std::uint8_t _bits;
+
+	std::vector<InstanceID> _palette;
+	std::vector<std::uint64_t> _words;
+};
+
 class TerrainMap final
 {
 public:
 	TerrainMap() noexcept;
-	TerrainMap(std::size_t mask) noexcept;
+	TerrainMap(std::size_t size) noexcept;
 	~TerrainMap() noexcept;
 
-	void create(std::size_t mask) noexcept;
+	void create(std::size_t size) noexcept;
 	void clear() noexcept;
 
 	bool set(const TerrainData& data) noexcept;
-	bool get(TerrainData& data) noexcept;
+	bool get(TerrainData& data) const noexcept;
 
-	void grow() noexcept;
+	InstanceID get(std::int32_t x, std::int32_t y, std::int32_t z) const noexcept;
+	void getRow(std::int32_t y, std::int32_t z, InstanceID* row) const noexcept;
 
+	std::size_t size() const noexcept;
+	std::size_t height() const noexcept;
 	std::size_t count() const noexcept;
 
-	TerrainDatas& data() noexcept;
+	std::size_t getMemoryUsage() const noexcept;
 
 private:
 	TerrainMap(const TerrainMap&) noexcept = delete;
 	TerrainMap& operator=(const TerrainMap&) noexcept = delete;
 
 private:
-
-	std::size_t _mask;
+	// signed, so the bounds tests against block coordinates need no casts
+	std::int32_t _size;
+	std::int32_t _height;
 	std::size_t _count;
 
-	std::vector<TerrainData> _data;
+	std::size_t _bricksX;
+	std::size_t _bricksZ;
+
+	std::vector<TerrainBrick> _bricks;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,419 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2015.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#include "terrain_mesher.h"
+#include "terrain_chunk.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#	include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#endif
+
+namespace
+{
+	// faces in the order left, right, top, bottom, front, back
+	const std::int32_t faceAxis[6] = { 0, 0, 1, 1, 2, 2 };
+
+	// axes along the bits and along the rows of the plane that is merged for each face
+	const std::int32_t planeBitAxis[6] = { 2, 2, 0, 0, 0, 0 };
+	const std::int32_t planeRowAxis[6] = { 1, 1, 2, 2, 1, 1 };
+
+	const std::int8_t positions[6][4][3] =
+	{
+		{ { -1, -1, -1 },{ -1, -1, +1 },{ -1, +1, -1 },{ -1, +1, +1 } },
+		{ { +1, -1, -1 },{ +1, -1, +1 },{ +1, +1, -1 },{ +1, +1, +1 } },
+		{ { -1, +1, -1 },{ -1, +1, +1 },{ +1, +1, -1 },{ +1, +1, +1 } },
+		{ { -1, -1, -1 },{ -1, -1, +1 },{ +1, -1, -1 },{ +1, -1, +1 } },
+		{ { -1, -1, -1 },{ -1, +1, -1 },{ +1, -1, -1 },{ +1, +1, -1 } },
+		{ { -1, -1, +1 },{ -1, +1, +1 },{ +1, -1, +1 },{ +1, +1, +1 } }
+	};
+
+	const float normals[6][3] =
+	{
+		{ -1, 0, 0 },
+		{ +1, 0, 0 },
+		{ 0, +1, 0 },
+		{ 0, -1, 0 },
+		{ 0, 0, -1 },
+		{ 0, 0, +1 }
+	};
+
+	const std::uint8_t uvs[6][4][2] =
+	{
+		{ { 0, 0 },{ 1, 0 },{ 0, 1 },{ 1, 1 } },
+		{ { 1, 0 },{ 0, 0 },{ 1, 1 },{ 0, 1 } },
+		{ { 0, 1 },{ 0, 0 },{ 1, 1 },{ 1, 0 } },
+		{ { 0, 0 },{ 0, 1 },{ 1, 0 },{ 1, 1 } },
+		{ { 0, 0 },{ 0, 1 },{ 1, 0 },{ 1, 1 } },
+		{ { 1, 0 },{ 1, 1 },{ 0, 0 },{ 0, 1 } }
+	};
+
+	const std::uint8_t indices[6][6] =
+	{
+		{ 0, 3, 2, 0, 1, 3 },
+		{ 0, 3, 1, 0, 2, 3 },
+		{ 0, 3, 2, 0, 1, 3 },
+		{ 0, 3, 1, 0, 2, 3 },
+		{ 0, 3, 2, 0, 1, 3 },
+		{ 0, 3, 1, 0, 2, 3 }
+	};
+	std::uint32_t countTrailingZeros(std::uint64_t value) noexcept
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return index;
+#else
+		return __builtin_ctzll(value);
+#endif
+	}
+
+	std::uint32_t countBits(std::uint64_t value) noexcept
+	{
+#if defined(_MSC_VER)
+		return static_cast<std::uint32_t>(__popcnt64(value));
+#else
+		return __builtin_popcountll(value);
+#endif
+	}
+
+	std::uint64_t matchRow(const InstanceID* row, std::int32_t count, InstanceID instance) noexcept
+	{
+		std::uint64_t mask = 0;
+		std::int32_t x = 0;
+
+#if defined(__SSE2__) || defined(_M_X64)
+		// compare sixteen blocks at once and squeeze the lanes down to one bit each
+		__m128i key = _mm_set1_epi16(instance);
+
+		for (; x + 16 <= count; x += 16)
+		{
+			__m128i lo = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)(row + x)), key);
+			__m128i hi = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)(row + x + 8)), key);
+
+			std::uint64_t bits = (std::uint32_t)_mm_movemask_epi8(_mm_packs_epi16(lo, hi));
+			mask |= bits << x;
+		}
+#endif
+
+		for (; x < count; x++)
+		{
+			if (row[x] == instance)
+				mask |= 1ull << x;
+		}
+
+		return mask;
+	}
+
+}
+
+TerrainMesher::TerrainMesher() noexcept
+	: _size(0)
+	, _height(0)
+	, _numFaces(0)
+	, _numQuads(0)
+{
+}
+
+TerrainMesher::~TerrainMesher() noexcept
+{
+}
+
+void
+TerrainMesher::setup(const TerrainChunk& chunk) noexcept
+{
+	assert(chunk.size() < 64);
+
+	auto& map = *chunk.getMap();
+
+	_size = chunk.size();
+	_height = std::max<std::int32_t>(map.height(), 1);
+	_numFaces = 0;
+	_numQuads = 0;
+
+	_voxels.resize(_size * _size * _height);
+	_rows.resize(_size * _height);
+	_faces.resize(_size * _height);
+	_plane.resize(std::max(_size, _height));
+
+	for (std::int32_t y = 0; y < _height; y++)
+	{
+		for (std::int32_t z = 0; z < _size; z++)
+			map.getRow(y, z, &_voxels[(y * _size + z) * _size]);
+	}
+
+	for (std::uint8_t side = 0; side < 4; side++)
+	{
+		_borders[side] = chunk.getNeighborBorder(side);
+		_borderRows[side].resize(_height);
+	}
+}
+
+void
+TerrainMesher::buildRows(InstanceID instance) noexcept
+{
+	for (std::int32_t i = 0; i < _size * _height; i++)
+		_rows[i] = matchRow(&_voxels[i * _size], _size, instance);
+
+	for (std::uint8_t side = 0; side < 4; side++)
+	{
+		auto& border = _borders[side];
+		auto borderHeight = static_cast<std::int32_t>(border.size()) / _size;
+
+		for (std::int32_t y = 0; y < _height; y++)
+			_borderRows[side][y] = y < borderHeight ? matchRow(&border[y * _size], _size, instance) : 0;
+	}
+}
+
+void
+TerrainMesher::buildFaces(std::uint8_t face, BlockPosition minHeight) noexcept
+{
+	for (std::int32_t y = 0; y < _height; y++)
+	{
+		for (std::int32_t z = 0; z < _size; z++)
+		{
+			std::uint64_t row = y >= minHeight ? _rows[y * _size + z] : 0;
+			std::uint64_t next = 0;
+
+			// a face is visible wherever the block in front of it is not the same instance
+			switch (face)
+			{
+			case 0:
+				next = (row << 1) | ((_borderRows[0][y] >> z) & 1);
+				break;
+			case 1:
+				next = (row >> 1) | (((_borderRows[1][y] >> z) & 1) << (_size - 1));
+				break;
+			case 2:
+				next = y + 1 < _height ? _rows[(y + 1) * _size + z] : 0;
+				break;
+			case 3:
+				next = y > 0 ? _rows[(y - 1) * _size + z] : 0;
+				break;
+			case 4:
+				next = z > 0 ? _rows[y * _size + z - 1] : _borderRows[2][y];
+				break;
+			case 5:
+				next = z + 1 < _size ? _rows[y * _size + z + 1] : _borderRows[3][y];
+				break;
+			}
+
+			_faces[y * _size + z] = row & ~next;
+			_numFaces += countBits(_faces[y * _size + z]);
+		}
+	}
+}
+
+std::size_t
+TerrainMesher::buildQuads(std::uint8_t face, std::int32_t slice, std::int32_t rows, TerrainVertices& vertices) noexcept
+{
+	std::size_t numQuads = 0;
+
+	std::int32_t d = faceAxis[face];
+	std::int32_t u = planeBitAxis[face];
+	std::int32_t v = planeRowAxis[face];
+
+	for (std::int32_t r = 0; r < rows; r++)
+	{
+		while (_plane[r])
+		{
+			// take the lowest run of bits and grow it over the next rows as long as they contain all of it
+			std::uint32_t b = countTrailingZeros(_plane[r]);
+			std::uint32_t w = countTrailingZeros(~(_plane[r] >> b));
+			std::uint64_t run = ((1ull << w) - 1) << b;
+
+			_plane[r] &= ~run;
+
+			std::int32_t h = 1;
+			for (; r + h < rows && (_plane[r + h] & run) == run; h++)
+				_plane[r + h] &= ~run;
+
+			std::int32_t c0[3];
+			c0[d] = slice;
+			c0[u] = b;
+			c0[v] = r;
+
+			std::int32_t c1[3];
+			c1[d] = slice + 1;
+			c1[u] = b + w;
+			c1[v] = r + h;
+
+			for (std::uint8_t corner = 0; corner < 4; corner++)
+			{
+				std::int32_t x = positions[face][corner][0] < 0 ? c0[0] : c1[0];
+				std::int32_t y = positions[face][corner][1] < 0 ? c0[1] : c1[1];
+				std::int32_t z = positions[face][corner][2] < 0 ? c0[2] : c1[2];
+
+				vertices.push_back(pack(x, y, z, face, corner));
+			}
+
+			numQuads++;
+		}
+	}
+
+	return numQuads;
+}
+
+std::size_t
+TerrainMesher::build(InstanceID instance, TerrainVertices& vertices, BlockPosition minHeight) noexcept
+{
+	std::size_t numQuads = 0;
+
+	this->buildRows(instance);
+
+	for (std::uint8_t face = 0; face < 6; face++)
+	{
+		this->buildFaces(face, minHeight);
+
+		if (faceAxis[face] == 0)
+		{
+			// the bits run along x, so each x slice is gathered into rows over z first
+			for (std::int32_t x = 0; x < _size; x++)
+			{
+				for (std::int32_t y = 0; y < _height; y++)
+				{
+					std::uint64_t bits = 0;
+					for (std::int32_t z = 0; z < _size; z++)
+						bits |= ((_faces[y * _size + z] >> x) & 1) << z;
+
+					_plane[y] = bits;
+				}
+
+				numQuads += this->buildQuads(face, x, _height, vertices);
+			}
+		}
+		else if (faceAxis[face] == 1)
+		{
+			for (std::int32_t y = 0; y < _height; y++)
+			{
+				std::copy(_faces.begin() + y * _size, _faces.begin() + (y + 1) * _size, _plane.begin());
+				numQuads += this->buildQuads(face, y, _size, vertices);
+			}
+		}
+		else
+		{
+			for (std::int32_t z = 0; z < _size; z++)
+			{
+				for (std::int32_t y = 0; y < _height; y++)
+					_plane[y] = _faces[y * _size + z];
+
+				numQuads += this->buildQuads(face, z, _height, vertices);
+			}
+		}
+	}
+
+	_numQuads += numQuads;
+	return numQuads;
+}
+
+std::size_t
+TerrainMesher::getNumFaces() const noexcept
+{
+	return _numFaces;
+}
+
+std::size_t
+TerrainMesher::getNumQuads() const noexcept
+{
+	return _numQuads;
+}
+
+TerrainVertex
+TerrainMesher::pack(std::int32_t x, std::int32_t y, std::int32_t z, std::uint8_t face, std::uint8_t corner) noexcept
+{
+	assert(x >= 0 && x < 64);
+	assert(y >= 0 && y < 256);
+	assert(z >= 0 && z < 64);
+	assert(face < 6 && corner < 4);
+
+	return x | y << 6 | z << 14 | face << 20 | corner << 23;
+}
+
+void
+TerrainMesher::unpack(const TerrainVertices& vertices, ray::MeshProperty& mesh) noexcept
+{
+	float s = 0.0625;
+	float a = 0 + 1 / 2048.0;
+	float b = s - 1 / 2048.0;
+
+	auto& vertex = mesh.getVertexArray();
+	auto& normal = mesh.getNormalArray();
+	auto& texcoord = mesh.getTexcoordArray();
+	auto& face = mesh.getIndicesArray();
+
+	vertex.reserve(vertex.size() + vertices.size());
+	normal.reserve(normal.size() + vertices.size());
+	texcoord.reserve(texcoord.size() + vertices.size());
+	face.reserve(face.size() + vertices.size() / 4 * 6);
+
+	for (std::size_t i = 0; i < vertices.size(); i += 4)
+	{
+		std::uint32_t base = vertex.size();
+		std::uint8_t side = (vertices[i] >> 20) & 7;
+
+		for (std::size_t j = i; j < i + 4; j++)
+		{
+			auto packed = vertices[j];
+
+			std::uint8_t corner = (packed >> 23) & 3;
+
+			// blocks are two units wide and centered on even coordinates
+			ray::Vector3 v;
+			v.x = (packed & 63) * 2.0f - 1.0f;
+			v.y = ((packed >> 6) & 255) * 2.0f - 1.0f;
+			v.z = ((packed >> 14) & 63) * 2.0f - 1.0f;
+
+			ray::Vector3 vn;
+			vn.x = normals[side][0];
+			vn.y = normals[side][1];
+			vn.z = normals[side][2];
+
+			ray::Vector2 uv;
+			uv.x = uvs[side][corner][0] ? b : a;
+			uv.y = uvs[side][corner][1] ? b : a;
+
+			vertex.push_back(v);
+			normal.push_back(vn);
+			texcoord.push_back(uv);
+		}
+
+		for (std::uint8_t j = 0; j < 6; j++)
+			face.push_back(base + indices[side][j]);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2015.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#ifndef _H_TERRAIN_MESHER_H_
+#define _H_TERRAIN_MESHER_H_
+
+#include "terrain_types.h"
+
+// A packed vertex keeps the quad corner in block units, so one chunk fits in 32 bits:
+// x : 6 bits, y : 8 bits, z : 6 bits, face : 3 bits, corner : 2 bits
+// Visibility works on whole rows of 64 bit masks, so a chunk is at most 63 blocks wide.
+class TerrainMesher final
+{
+public:
+	TerrainMesher() noexcept;
+	~TerrainMesher() noexcept;
+
+	void setup(const TerrainChunk& chunk) noexcept;
+
+	std::size_t build(InstanceID instance, TerrainVertices& vertices, BlockPosition minHeight = 0) noexcept;
+
+	std::size_t getNumFaces() const noexcept;
+	std::size_t getNumQuads() const noexcept;
+
+	static TerrainVertex pack(std::int32_t x, std::int32_t y, std::int32_t z, std::uint8_t face, std::uint8_t corner) noexcept;
+	static void unpack(const TerrainVertices& vertices, ray::MeshProperty& mesh) noexcept;
+
+private:
+	void buildRows(InstanceID instance) noexcept;
+	void buildFaces(std::uint8_t face, BlockPosition minHeight) noexcept;
+	std::size_t buildQuads(std::uint8_t face, std::int32_t slice, std::int32_t rows, TerrainVertices& vertices) noexcept;
+
+private:
+	TerrainMesher(const TerrainMesher&) noexcept = delete;
+	TerrainMesher& operator=(const TerrainMesher&) noexcept = delete;
+
+private:
+	std::int32_t _size;
+	std::int32_t _height;
+
+	std::size_t _numFaces;
+	std::size_t _numQuads;
+
+	std::vector<InstanceID> _voxels;
+
+	// one bit per block along x for every (y, z) row of the chunk
+	std::vector<std::uint64_t> _rows;
+	std::vector<std::uint64_t> _faces;
+	std::vector<std::uint64_t> _plane;
+
+	// rows of the neighbour chunks that touch this one, by side -x, +x, -z, +z
+	TerrainBorder _borders[4];
+	std::vector<std::uint64_t> _borderRows[4];
+};
+
+#endif
\ No newline at end of file
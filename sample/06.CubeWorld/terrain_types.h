@@ -55,6 +55,8 @@ typedef std::shared_ptr<class TerrainChunk> TerrainChunkPtr;
 typedef std::shared_ptr<class TerrainItem> TerrainItemPtr;
 typedef std::shared_ptr<class TerrainObject> TerrainObjectPtr;
 
+class TerrainMesher;
+
 typedef std::vector<TerrainItemPtr> TerrainItems;
 typedef std::vector<TerrainObjectPtr> TerrainObjects;
 typedef std::vector<class TerrainData> TerrainDatas;
@@ -62,4 +64,8 @@ typedef std::vector<class TerrainData> TerrainDatas;
 typedef std::int8_t BlockPosition;
 typedef std::int16_t InstanceID;
 
+typedef std::uint32_t TerrainVertex;
+typedef std::vector<TerrainVertex> TerrainVertices;
+typedef std::vector<InstanceID> TerrainBorder;
+
 #endif
\ No newline at end of file
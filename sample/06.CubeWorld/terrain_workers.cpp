@@ -0,0 +1,197 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2015.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#include "terrain_workers.h"
+#include "terrain_chunk.h"
+#include "terrain_mesher.h"
+
+#include <chrono>
+
+TerrainWorkers::TerrainWorkers() noexcept
+	: _numChunks(0)
+	, _numTriangles(0)
+	, _numCubeTriangles(0)
+	, _numGenerated(0)
+	, _buildTime(0)
+	, _generateTime(0)
+	, _meshTime(0)
+{
+}
+
+TerrainWorkers::~TerrainWorkers() noexcept
+{
+	this->stop();
+}
+
+void
+TerrainWorkers::start(std::size_t count) noexcept
+{
+	assert(_threads.empty());
+
+	// leave one core to the game thread that uploads the meshes
+	if (count == 0)
+		count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+	for (std::size_t i = 0; i < count; i++)
+		_threads.push_back(std::make_unique<std::thread>(std::bind(&TerrainWorkers::dispose, this)));
+}
+
+void
+TerrainWorkers::stop() noexcept
+{
+	TerrainChunkPtr chunk;
+	while (_pending.try_pop(chunk))
+		chunk->busy(false);
+
+	// an empty chunk tells a worker to quit
+	for (std::size_t i = 0; i < _threads.size(); i++)
+		_pending.push(nullptr);
+
+	for (auto& it : _threads)
+		it->join();
+
+	_threads.clear();
+
+	while (_finished.try_pop(chunk))
+		chunk->busy(false);
+}
+
+void
+TerrainWorkers::push(TerrainChunkPtr chunk) noexcept
+{
+	assert(chunk && !chunk->busy());
+
+	chunk->busy(true);
+	chunk->dirt(false);
+
+	_pending.push(chunk);
+}
+
+bool
+TerrainWorkers::pop(TerrainChunkPtr& chunk) noexcept
+{
+	return _finished.try_pop(chunk);
+}
+
+std::size_t
+TerrainWorkers::getNumThreads() const noexcept
+{
+	return _threads.size();
+}
+
+std::size_t
+TerrainWorkers::getNumChunks() const noexcept
+{
+	return _numChunks;
+}
+
+std::size_t
+TerrainWorkers::getNumTriangles() const noexcept
+{
+	return _numTriangles;
+}
+
+std::size_t
+TerrainWorkers::getNumCubeTriangles() const noexcept
+{
+	return _numCubeTriangles;
+}
+
+float
+TerrainWorkers::getChunksPerSecond() const noexcept
+{
+	if (_buildTime == 0)
+		return 0.0f;
+
+	// build time is summed over all workers, so this is the throughput of the whole pool
+	return _numChunks * _threads.size() * 1e6f / _buildTime;
+}
+
+float
+TerrainWorkers::getGenerateTime() const noexcept
+{
+	if (_numGenerated == 0)
+		return 0.0f;
+
+	// average milliseconds spent filling the map of a new chunk
+	return _generateTime / (_numGenerated * 1e3f);
+}
+
+float
+TerrainWorkers::getMeshTime() const noexcept
+{
+	if (_numChunks == 0)
+		return 0.0f;
+
+	// average milliseconds spent meshing a chunk, without the terrain generation
+	return _meshTime / (_numChunks * 1e3f);
+}
+
+void
+TerrainWorkers::dispose() noexcept
+{
+	TerrainMesher mesher;
+
+	for (;;)
+	{
+		auto chunk = _pending.wait_and_pop();
+		if (!chunk)
+			break;
+
+		auto begin = std::chrono::steady_clock::now();
+
+		if (!chunk->generated())
+		{
+			chunk->generate();
+			_numGenerated++;
+		}
+
+		auto middle = std::chrono::steady_clock::now();
+
+		chunk->build(mesher);
+
+		auto end = std::chrono::steady_clock::now();
+
+		_buildTime += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+		_generateTime += std::chrono::duration_cast<std::chrono::microseconds>(middle - begin).count();
+		_meshTime += std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count();
+		_numTriangles += mesher.getNumQuads() * 2;
+		_numCubeTriangles += mesher.getNumFaces() * 2;
+		_numChunks++;
+
+		_finished.push(chunk);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2015.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#ifndef _H_TERRAIN_WORKERS_H_
+#define _H_TERRAIN_WORKERS_H_
+
+#include "terrain_types.h"
+
+class TerrainWorkers final
+{
+public:
+	TerrainWorkers() noexcept;
+	~TerrainWorkers() noexcept;
+
+	void start(std::size_t count = 0) noexcept;
+	void stop() noexcept;
+
+	void push(TerrainChunkPtr chunk) noexcept;
+	bool pop(TerrainChunkPtr& chunk) noexcept;
+
+	std::size_t getNumThreads() const noexcept;
+	std::size_t getNumChunks() const noexcept;
+	std::size_t getNumTriangles() const noexcept;
+	std::size_t getNumCubeTriangles() const noexcept;
+
+	float getChunksPerSecond() const noexcept;
+	float getGenerateTime() const noexcept;
+	float getMeshTime() const noexcept;
+
+private:
+	void dispose() noexcept;
+
+private:
+	TerrainWorkers(const TerrainWorkers&) = delete;
+	TerrainWorkers& operator=(TerrainWorkers&) = delete;
+
+private:
+	std::atomic<std::size_t> _numChunks;
+	std::atomic<std::size_t> _numTriangles;
+	std::atomic<std::size_t> _numCubeTriangles;
+	std::atomic<std::size_t> _numGenerated;
+	std::atomic<std::uint64_t> _buildTime;
+	std::atomic<std::uint64_t> _generateTime;
+	std::atomic<std::uint64_t> _meshTime;
+
+	ray::threadsafe_queue<TerrainChunkPtr> _pending;
+	ray::threadsafe_queue<TerrainChunkPtr> _finished;
+
+	std::vector<std::unique_ptr<std::thread>> _threads;
+};
+
+#endif
\ No newline at end of file
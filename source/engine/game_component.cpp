@@ -35,6 +35,7 @@
 // | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // +----------------------------------------------------------------------
 #include <ray/game_component.h>
+#include <ray/game_object_manager.h>
 #include <ray/utf8.h>
 
 _NAME_BEGIN
@@ -45,15 +46,24 @@ GameComponent::GameComponent() noexcept
 	: _active(true)
 	, _gameObject(nullptr)
 {
+	std::fill(std::begin(_dispatchIndices), std::end(_dispatchIndices), dispatchNone);
+	std::fill(std::begin(_objectDispatchIndices), std::end(_objectDispatchIndices), dispatchNone);
 }
 
 GameComponent::GameComponent(const archivebuf& reader) noexcept
+	: _active(true)
+	, _gameObject(nullptr)
 {
+	std::fill(std::begin(_dispatchIndices), std::end(_dispatchIndices), dispatchNone);
+	std::fill(std::begin(_objectDispatchIndices), std::end(_objectDispatchIndices), dispatchNone);
+
 	this->load(reader);
 }
 
 GameComponent::~GameComponent() noexcept
 {
+	for (std::uint8_t i = GameDispatchType::GameDispatchTypeFrameBegin; i <= GameDispatchType::GameDispatchTypeFrameEnd; i++)
+		GameObjectManager::instance()->_removeComponentDispatch((GameDispatchType)i, this);
 }
 
 GameComponentPtr
@@ -170,6 +180,12 @@ GameComponent::save(archivebuf& write) noexcept
 	write["active"] << _active;
 }
 
+bool
+GameComponent::isThreadSafe() const noexcept
+{
+	return false;
+}
+
 void
 GameComponent::sendMessage(const MessagePtr& message) except
 {
@@ -42,6 +42,8 @@ _NAME_BEGIN
 
 __ImplementSubClass(GameObject, rtti::Interface, "Object")
 
+const std::size_t componentCacheSize = 8;
+
 GameObject::GameObject() noexcept
 	: _active(false)
 	, _layer(0)
@@ -607,6 +609,7 @@ GameObject::addComponent(const GameComponentPtr& gameComponent) except
 			component->onAttachComponent(gameComponent);
 
 		_components.push_back(gameComponent);
+		_componentCache.clear();
 	}
 }
 
@@ -626,6 +629,7 @@ GameObject::removeComponent(const GameComponentPtr& gameComponent) noexcept
 	if (it != _components.end())
 	{
 		_components.erase(it);
+		_componentCache.clear();
 
 		for (auto& compoent : _components)
 			compoent->onDetachComponent(gameComponent);
@@ -650,6 +654,7 @@ GameObject::cleanupComponents() noexcept
 	{
 		auto gameComponent = *it;
 		auto nextComponent = _components.erase(it);
+		_componentCache.clear();
 
 		for (auto& compoent : _components)
 			compoent->onDetachComponent(gameComponent);
@@ -674,13 +679,30 @@ GameObject::getComponent(const rtti::Rtti* type) const noexcept
 {
 	assert(type);
 
+	for (auto& it : _componentCache)
+	{
+		if (it.first == type)
+			return it.second;
+	}
+
+	GameComponentPtr result;
+
 	for (auto& it : _components)
 	{
 		if (it->isA(type))
-			return it;
+		{
+			result = it;
+			break;
+		}
 	}
 
-	return nullptr;
+	// misses are remembered as well, most lookups ask objects for components they do not have
+	if (_componentCache.size() >= componentCacheSize)
+		_componentCache.erase(_componentCache.begin());
+
+	_componentCache.emplace_back(type, result);
+
+	return result;
 }
 
 GameComponentPtr
@@ -696,13 +718,11 @@ GameObject::getComponentInChildren(const rtti::Rtti* type) const noexcept
 
 	for (auto& it : _children)
 	{
-		for (auto& component : it->_components)
-		{
-			if (component->isA(type))
-				return component;
-		}
+		auto component = it->getComponent(type);
+		if (component)
+			return component;
 
-		auto component = it->getComponentInChildren(type);
+		component = it->getComponentInChildren(type);
 		if (component)
 			return component;
 	}
@@ -729,7 +749,7 @@ GameObject::getComponentsInChildren(const rtti::Rtti* type, GameComponents& comp
 				components.push_back(component);
 		}
 
-		it->getComponentInChildren(type);
+		it->getComponentsInChildren(type, components);
 	}
 }
 
@@ -753,25 +773,16 @@ GameObject::addComponentDispatch(GameDispatchType type, const GameComponentPtr&
 	if (_dispatchComponents.empty())
 		_dispatchComponents.resize(GameDispatchType::GameDispatchTypeRangeSize);
 
-	if (std::find(_dispatchComponents[type].begin(), _dispatchComponents[type].end(), component) != _dispatchComponents[type].end())
+	if (component->_objectDispatchIndices[type] != GameComponent::dispatchNone)
 		return;
 
-	if (this->getActive())
-	{
-		if (type == GameDispatchType::GameDispatchTypeFrame ||
-			type == GameDispatchType::GameDispatchTypeFrameBegin ||
-			type == GameDispatchType::GameDispatchTypeFrameEnd)
-		{
-			if (_dispatchComponents[GameDispatchType::GameDispatchTypeFrame].empty() &&
-				_dispatchComponents[GameDispatchType::GameDispatchTypeFrameBegin].empty() &&
-				_dispatchComponents[GameDispatchType::GameDispatchTypeFrameEnd].empty())
-			{
-				GameObjectManager::instance()->_activeObject(this, true);
-			}
-		}
-	}
+	component->_objectDispatchIndices[type] = (std::uint32_t)_dispatchComponents[type].size();
 
 	_dispatchComponents[type].push_back(component);
+
+	// frame callbacks are driven by the manager, which only sees components of active objects
+	if (type <= GameDispatchType::GameDispatchTypeFrameEnd && this->getActive())
+		GameObjectManager::instance()->_addComponentDispatch(type, component.get());
 }
 
 void
@@ -779,29 +790,25 @@ GameObject::removeComponentDispatch(GameDispatchType type, const GameComponentPt
 {
 	assert(component);
 
-	if (_dispatchComponents.empty())
+	auto index = component->_objectDispatchIndices[type];
+	if (index == GameComponent::dispatchNone)
 		return;
 
-	auto it = std::find(_dispatchComponents[type].begin(), _dispatchComponents[type].end(), component);
-	if (it == _dispatchComponents[type].end())
-		return;
+	auto& components = _dispatchComponents[type];
+	assert(components[index] == component);
 
-	if (this->getActive())
+	if (type <= GameDispatchType::GameDispatchTypeFrameEnd)
+		GameObjectManager::instance()->_removeComponentDispatch(type, component.get());
+
+	component->_objectDispatchIndices[type] = GameComponent::dispatchNone;
+
+	if (index + 1 < components.size())
 	{
-		if (type == GameDispatchType::GameDispatchTypeFrame ||
-			type == GameDispatchType::GameDispatchTypeFrameBegin ||
-			type == GameDispatchType::GameDispatchTypeFrameEnd)
-		{
-			if (_dispatchComponents[GameDispatchType::GameDispatchTypeFrame].empty() &&
-				_dispatchComponents[GameDispatchType::GameDispatchTypeFrameBegin].empty() &&
-				_dispatchComponents[GameDispatchType::GameDispatchTypeFrameEnd].empty())
-			{
-				GameObjectManager::instance()->_activeObject(this, false);
-			}
-		}
+		components[index] = std::move(components.back());
+		components[index]->_objectDispatchIndices[type] = index;
 	}
 
-	_dispatchComponents[type].erase(it);
+	components.pop_back();
 }
 
 void
@@ -809,12 +816,8 @@ GameObject::removeComponentDispatchs(const GameComponentPtr& component) noexcept
 {
 	assert(component);
 
-	for (auto& dispatch : _dispatchComponents)
-	{
-		auto it = std::find(dispatch.begin(), dispatch.end(), component);
-		if (it != dispatch.end())
-			dispatch.erase(it);
-	}
+	for (std::size_t i = 0; i < _dispatchComponents.size(); i++)
+		this->removeComponentDispatch((GameDispatchType)i, component);
 }
 
 void
@@ -1046,36 +1049,6 @@ GameObject::clone() const except
 	return instance;
 }
 
-void
-GameObject::_onFrameBegin() except
-{
-	assert(!_dispatchComponents.empty());
-
-	auto& components = _dispatchComponents[GameDispatchType::GameDispatchTypeFrameBegin];
-	for (auto& it : components)
-		it->onFrameBegin();
-}
-
-void
-GameObject::_onFrame() except
-{
-	assert(!_dispatchComponents.empty());
-
-	auto& components = _dispatchComponents[GameDispatchType::GameDispatchTypeFrame];
-	for (auto& it : components)
-		it->onFrame();
-}
-
-void
-GameObject::_onFrameEnd() except
-{
-	assert(!_dispatchComponents.empty());
-
-	auto& components = _dispatchComponents[GameDispatchType::GameDispatchTypeFrameEnd];
-	for (auto& it : components)
-		it->onFrameEnd();
-}
-
 void
 GameObject::_onActivate() except
 {
@@ -1087,11 +1060,10 @@ GameObject::_onActivate() except
 
 	if (!_dispatchComponents.empty())
 	{
-		if (!_dispatchComponents[GameDispatchType::GameDispatchTypeFrame].empty() ||
-			!_dispatchComponents[GameDispatchType::GameDispatchTypeFrameBegin].empty() ||
-			!_dispatchComponents[GameDispatchType::GameDispatchTypeFrameEnd].empty())
+		for (std::uint8_t i = GameDispatchType::GameDispatchTypeFrameBegin; i <= GameDispatchType::GameDispatchTypeFrameEnd; i++)
 		{
-			GameObjectManager::instance()->_activeObject(this, true);
+			for (auto& it : _dispatchComponents[i])
+				GameObjectManager::instance()->_addComponentDispatch((GameDispatchType)i, it.get());
 		}
 	}
 }
@@ -1101,11 +1073,10 @@ GameObject::_onDeactivate() noexcept
 {
 	if (!_dispatchComponents.empty())
 	{
-		if (!_dispatchComponents[GameDispatchType::GameDispatchTypeFrame].empty() ||
-			!_dispatchComponents[GameDispatchType::GameDispatchTypeFrameBegin].empty() ||
-			!_dispatchComponents[GameDispatchType::GameDispatchTypeFrameEnd].empty())
+		for (std::uint8_t i = GameDispatchType::GameDispatchTypeFrameBegin; i <= GameDispatchType::GameDispatchTypeFrameEnd; i++)
 		{
-			GameObjectManager::instance()->_activeObject(this, false);
+			for (auto& it : _dispatchComponents[i])
+				GameObjectManager::instance()->_removeComponentDispatch((GameDispatchType)i, it.get());
 		}
 	}
 
@@ -36,6 +36,7 @@
 // +----------------------------------------------------------------------
 #include <ray/game_object_manager.h>
 #include <ray/game_object.h>
+#include <ray/game_component.h>
 
 #include <ray/res_loader.h>
 #include <ray/ioserver.h>
@@ -53,12 +54,34 @@ RaycastHit::RaycastHit() noexcept
 {
 }
 
+// a thread-safe group is only split when every helper gets at least this many components
+const std::size_t dispatchParallelGrain = 256;
+
 GameObjectManager::GameObjectManager() noexcept
+	: _isDispatching(false)
+	, _hasEmptyComponents(false)
+	, _quit(false)
+	, _generation(0)
+	, _numBusy(0)
+	, _nextComponent(0)
+	, _parallelType(GameDispatchType::GameDispatchTypeFrame)
+	, _parallelGroup(0)
 {
 }
 
 GameObjectManager::~GameObjectManager() noexcept
 {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+
+	_dispatch.notify_all();
+
+	for (auto& it : _threads)
+		it->join();
+
+	_threads.clear();
 }
 
 void
@@ -88,27 +111,213 @@ GameObjectManager::_unsetObject(GameObject* entity) noexcept
 	auto instanceID = entity->getInstanceID();
 	_instanceLists[instanceID - 1] = nullptr;
 	_emptyLists.push(instanceID);
-	this->_activeObject(entity, false);
 }
 
 void
-GameObjectManager::_activeObject(GameObject* entity, bool active) noexcept
+GameObjectManager::_addComponentDispatch(GameDispatchType type, GameComponent* component) noexcept
 {
-	if (active)
+	assert(component);
+	assert(type <= GameDispatchType::GameDispatchTypeFrameEnd);
+
+	if (component->_dispatchIndices[type] != GameComponent::dispatchNone)
+		return;
+
+	auto& list = _dispatchLists[type];
+
+	auto it = list.indices.find(component->rtti());
+	if (it == list.indices.end())
 	{
-		_activeActors.push_back(entity);
+		DispatchGroup group;
+		group.type = component->rtti();
+		group.threadSafe = component->isThreadSafe();
+
+		it = list.indices.insert(std::make_pair(group.type, (std::uint32_t)list.groups.size())).first;
+		list.groups.push_back(std::move(group));
 	}
-	else
+
+	auto& components = list.groups[it->second].components;
+
+	component->_dispatchGroups[type] = it->second;
+	component->_dispatchIndices[type] = (std::uint32_t)components.size();
+
+	components.push_back(component);
+}
+
+void
+GameObjectManager::_removeComponentDispatch(GameDispatchType type, GameComponent* component) noexcept
+{
+	assert(component);
+	assert(type <= GameDispatchType::GameDispatchTypeFrameEnd);
+
+	auto index = component->_dispatchIndices[type];
+	if (index == GameComponent::dispatchNone)
+		return;
+
+	auto& components = _dispatchLists[type].groups[component->_dispatchGroups[type]].components;
+	assert(components[index] == component);
+
+	component->_dispatchIndices[type] = GameComponent::dispatchNone;
+
+	// a loop may be walking this group right now, so leave a hole and close it up once the loop is done
+	if (_isDispatching)
+	{
+		components[index] = nullptr;
+		_hasEmptyComponents = true;
+		return;
+	}
+
+	if (index + 1 < components.size())
+	{
+		components[index] = components.back();
+		components[index]->_dispatchIndices[type] = index;
+	}
+
+	components.pop_back();
+}
+
+void
+GameObjectManager::dispatch(GameDispatchType type) noexcept
+{
+	_isDispatching = true;
+
+	auto& groups = _dispatchLists[type].groups;
+
+	for (std::size_t i = 0; i < groups.size(); i++)
+	{
+		std::size_t count = groups[i].components.size();
+		if (groups[i].threadSafe && count >= dispatchParallelGrain * 2)
+			this->dispatchParallel(type, i);
+		else
+			this->dispatchGroup(type, i, 0, count);
+	}
+
+	_isDispatching = false;
+
+	if (_hasEmptyComponents)
+	{
+		for (std::uint8_t i = GameDispatchType::GameDispatchTypeFrameBegin; i <= GameDispatchType::GameDispatchTypeFrameEnd; i++)
+			this->compact((GameDispatchType)i);
+
+		_hasEmptyComponents = false;
+	}
+}
+
+void
+GameObjectManager::dispatchGroup(GameDispatchType type, std::size_t group, std::size_t first, std::size_t last) noexcept
+{
+	auto& groups = _dispatchLists[type].groups;
+
+	// callbacks may register components and even new groups, so nothing is held across a call;
+	// components added this way are picked up next frame
+	for (std::size_t i = first; i < last; i++)
+	{
+		auto component = groups[group].components[i];
+		if (!component)
+			continue;
+
+		if (type == GameDispatchType::GameDispatchTypeFrameBegin)
+			component->onFrameBegin();
+		else if (type == GameDispatchType::GameDispatchTypeFrame)
+			component->onFrame();
+		else
+			component->onFrameEnd();
+	}
+}
+
+void
+GameObjectManager::dispatchParallel(GameDispatchType type, std::size_t group) noexcept
+{
+	if (_threads.empty())
 	{
-		for (auto& actor : _activeActors)
+		std::uint32_t numThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+		for (std::uint32_t i = 0; i < numThreads; i++)
+			_threads.push_back(std::make_unique<std::thread>(std::bind(&GameObjectManager::dispose, this)));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_parallelType = type;
+		_parallelGroup = group;
+		_nextComponent = 0;
+		_numBusy = (std::uint32_t)_threads.size();
+		_generation++;
+	}
+
+	_dispatch.notify_all();
+
+	// thread-safe components must not register or unregister from their callbacks, the group stays put
+	std::size_t count = _dispatchLists[type].groups[group].components.size();
+
+	for (;;)
+	{
+		std::size_t first = _nextComponent.fetch_add(dispatchParallelGrain);
+		if (first >= count)
+			break;
+
+		this->dispatchGroup(type, group, first, std::min(first + dispatchParallelGrain, count));
+	}
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_finish.wait(lock, [this]() { return _numBusy == 0; });
+}
+
+void
+GameObjectManager::compact(GameDispatchType type) noexcept
+{
+	for (auto& group : _dispatchLists[type].groups)
+	{
+		auto& components = group.components;
+
+		auto end = std::remove(components.begin(), components.end(), nullptr);
+		if (end == components.end())
+			continue;
+
+		components.erase(end, components.end());
+
+		for (std::size_t i = 0; i < components.size(); i++)
+			components[i]->_dispatchIndices[type] = (std::uint32_t)i;
+	}
+}
+
+void
+GameObjectManager::dispose() noexcept
+{
+	std::uint32_t generation = 0;
+
+	for (;;)
+	{
+		GameDispatchType type;
+		std::size_t group;
+
 		{
-			if (actor == entity)
-			{
-				actor = nullptr;
-				_hasEmptyActors = true;
+			std::unique_lock<std::mutex> lock(_mutex);
+			_dispatch.wait(lock, [&]() { return _quit || _generation != generation; });
+
+			if (_quit)
 				break;
-			}
+
+			generation = _generation;
+			type = _parallelType;
+			group = _parallelGroup;
+		}
+
+		std::size_t count = _dispatchLists[type].groups[group].components.size();
+
+		for (;;)
+		{
+			std::size_t first = _nextComponent.fetch_add(dispatchParallelGrain);
+			if (first >= count)
+				break;
+
+			this->dispatchGroup(type, group, first, std::min(first + dispatchParallelGrain, count));
 		}
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_numBusy--;
+		}
+
+		_finish.notify_one();
 	}
 }
 
@@ -130,7 +339,7 @@ GameObjectManager::findObject(const util::string& name) noexcept
 GameObjectPtr
 GameObjectManager::findActiveObject(const util::string& name) noexcept
 {
-	for (auto& it : _activeActors)
+	for (auto& it : _instanceLists)
 	{
 		if (!it)
 			continue;
@@ -235,44 +444,19 @@ GameObjectManager::raycastHit(const Vector3& orgin, const Vector3& end, RaycastH
 void
 GameObjectManager::onFrameBegin() noexcept
 {
-	for (std::size_t i = 0; i < _activeActors.size(); i++)
-	{
-		if (_activeActors[i])
-			_activeActors[i]->_onFrameBegin();
-	}
+	this->dispatch(GameDispatchType::GameDispatchTypeFrameBegin);
 }
 
 void
 GameObjectManager::onFrame() noexcept
 {
-	for (std::size_t i = 0; i < _activeActors.size(); i++)
-	{
-		if (_activeActors[i])
-			_activeActors[i]->_onFrame();
-	}
+	this->dispatch(GameDispatchType::GameDispatchTypeFrame);
 }
 
 void
 GameObjectManager::onFrameEnd() noexcept
 {
-	for (std::size_t i = 0; i < _activeActors.size(); i++)
-	{
-		if (_activeActors[i])
-			_activeActors[i]->_onFrameEnd();
-	}
-
-	if (_hasEmptyActors)
-	{
-		for (auto it = _activeActors.begin(); it != _activeActors.end();)
-		{
-			if (!(*it))
-				it = _activeActors.erase(it);
-			else
-				++it;
-		}
-
-		_hasEmptyActors = false;
-	}
+	this->dispatch(GameDispatchType::GameDispatchTypeFrameEnd);
 }
 
 _NAME_END
\ No newline at end of file
@@ -42,6 +42,7 @@
 #include <ray/rtti_factory.h>
 
 #include <ray/jsonreader.h>
+#include <ray/binaryreader.h>
 
 _NAME_BEGIN
 
@@ -182,6 +183,20 @@ GameScene::load(const util::string& sceneURL) noexcept
 			return false;
 		}
 
+		if (BinaryReader::canRead(*stream))
+		{
+			BinaryReader reader(*stream);
+			if (!reader.is_object())
+			{
+				if (_gameListener)
+					_gameListener->onMessage("Non readable Scene file : " + sceneURL);
+
+				return false;
+			}
+
+			return this->load(reader);
+		}
+
 		JsonReader reader(*stream);
 		if (!reader.is_object())
 		{
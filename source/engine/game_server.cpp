@@ -60,6 +60,9 @@ GameServer::~GameServer() noexcept
 bool
 GameServer::open() noexcept
 {
+	// messages posted during loading, before the first update, must not wait for a consumer that is this thread
+	_dispatcher.bindDispatchThread();
+
 	_timer = std::make_shared<Timer>();
 	_timer->open();
 	return true;
@@ -549,11 +552,16 @@ GameServer::update() noexcept
 	{
 		_timer->update();
 
-		MessagePtr event;
-		while (_dispatcher.pollMessages(event))
+		// drained a batch at a time, messages posted while handling one are picked up by the next pass
+		while (_dispatcher.pollMessages(_dispatchEvents))
 		{
-			if (!this->sendMessage(event))
-				_isQuitRequest = true;
+			for (auto& event : _dispatchEvents)
+			{
+				if (!this->sendMessage(event))
+					_isQuitRequest = true;
+			}
+
+			_dispatchEvents.clear();
 		}
 
 		if (!_isQuitRequest)
@@ -55,8 +55,10 @@
 
 #include <ray/ik_solver_component.h>
 #include <ray/image.h>
+#include <ray/ioserver.h>
 #include <ray/material.h>
 #include <ray/anim_component.h>
+#include <ray/thread.h>
 
 _NAME_BEGIN
 
@@ -97,9 +99,18 @@ ResManager::createTexture(const util::string& name, GraphicsTexturePtr& _texture
 		return false;
 
 	image::Image image;
-	if (!image.load(*stream))
+	if (!image.load(*stream, nullptr, image::LoadFlagRGBA8Bit))
 		return false;
 
+	return this->createTexture(name, image, _texture, dim, filter, warp, cache);
+}
+
+bool
+ResManager::createTexture(const util::string& name, const image::Image& image, GraphicsTexturePtr& _texture, GraphicsTextureDim dim, GraphicsSamplerFilter filter, GraphicsSamplerWrap warp, bool cache) noexcept
+{
+	assert(!name.empty());
+	assert(!image.empty());
+
 	GraphicsFormat format = GraphicsFormat::GraphicsFormatUndefined;
 	switch (image.format())
 	{
@@ -138,7 +149,7 @@ ResManager::createTexture(const util::string& name, GraphicsTexturePtr& _texture
 	case image::format_t::R32G32B32SFloat: format = GraphicsFormat::GraphicsFormatR32G32B32SFloat; break;
 	case image::format_t::R32G32B32A32SFloat: format = GraphicsFormat::GraphicsFormatR32G32B32A32SFloat; break;
 	default:
-		return nullptr;
+		return false;
 	}
 
 	GraphicsTextureDesc textureDesc;
@@ -168,6 +179,63 @@ ResManager::createTexture(const util::string& name, GraphicsTexturePtr& _texture
 	return true;
 }
 
+bool
+ResManager::createTextures(const std::vector<util::string>& names, GraphicsTextures& textures, GraphicsTextureDim dim, GraphicsSamplerFilter filter, GraphicsSamplerWrap warp, bool cache) noexcept
+{
+	textures.resize(names.size());
+
+	std::vector<std::size_t> pending;
+	for (std::size_t i = 0; i < names.size(); i++)
+	{
+		assert(!names[i].empty());
+
+		auto it = _textureCaches.find(names[i]);
+		if (it != _textureCaches.end())
+			textures[i] = (*it).second;
+		else
+			pending.push_back(i);
+	}
+
+	if (pending.empty())
+		return true;
+
+	// files are opened here so the IoServer state and its listeners stay on this thread,
+	// the decoding is cpu bound and independent per file and runs on the workers
+	std::vector<StreamReaderPtr> streams(pending.size());
+	for (std::size_t i = 0; i < pending.size(); i++)
+		IoServer::instance()->openFileURL(streams[i], names[pending[i]]);
+
+	std::vector<image::Image> images(pending.size());
+
+	parallelFor(static_cast<std::uint32_t>(pending.size()), [&](std::uint32_t i)
+	{
+		if (streams[i])
+			images[i].load(*streams[i], nullptr, image::LoadFlagRGBA8Bit);
+
+		streams[i] = nullptr;
+	});
+
+	bool result = true;
+
+	for (std::size_t i = 0; i < pending.size(); i++)
+	{
+		auto& name = names[pending[i]];
+
+		// the same file may be requested more than once in a batch
+		auto it = _textureCaches.find(name);
+		if (it != _textureCaches.end())
+		{
+			textures[pending[i]] = (*it).second;
+			continue;
+		}
+
+		if (images[i].empty() || !this->createTexture(name, images[i], textures[pending[i]], dim, filter, warp, cache))
+			result = false;
+	}
+
+	return result;
+}
+
 void
 ResManager::destroyTexture(GraphicsTexturePtr texture) noexcept
 {
@@ -536,6 +604,26 @@ ResManager::createMaterials(const Model& model, Materials& materials, bool skinn
 {
 	std::size_t numBones = model.getBonesList().size();
 
+	std::vector<util::string> diffuseTextures;
+	std::vector<util::string> normalTextures;
+
+	for (auto& materialProp : model.getMaterialsList())
+	{
+		util::string diffuseTexture;
+		util::string normalTexture;
+
+		if (materialProp->get(MATKEY_TEXTURE_DIFFUSE(0), diffuseTexture) && !diffuseTexture.empty())
+			diffuseTextures.push_back(model.getDirectory() + diffuseTexture);
+
+		if (materialProp->get(MATKEY_TEXTURE_NORMALS(0), normalTexture) && !normalTexture.empty())
+			normalTextures.push_back(model.getDirectory() + normalTexture);
+	}
+
+	// decode every texture of the model up front, _buildDefaultMaterials then only hits the cache
+	GraphicsTextures textures;
+	this->createTextures(diffuseTextures, textures, GraphicsTextureDim::GraphicsTextureDim2D, GraphicsSamplerFilter::GraphicsSamplerFilterLinear);
+	this->createTextures(normalTextures, textures, GraphicsTextureDim::GraphicsTextureDim2D, GraphicsSamplerFilter::GraphicsSamplerFilterNearest);
+
 	for (auto& materialProp : model.getMaterialsList())
 	{
 		float opacity = 1.0;
@@ -550,27 +638,15 @@ ResManager::createMaterials(const Model& model, Materials& materials, bool skinn
 			{
 				if (numBones == 0 || !skinned)
 					defaultMaterial = "sys:fx/opacity_skinning0.fxml";
-				else if (numBones <= 64)
-					defaultMaterial = "sys:fx/opacity_skinning64.fxml";
-				else if (numBones <= 128)
-					defaultMaterial = "sys:fx/opacity_skinning128.fxml";
-				else if (numBones <= 256)
-					defaultMaterial = "sys:fx/opacity_skinning256.fxml";
 				else
-					defaultMaterial = "sys:fx/opacity_skinning0.fxml";
+					defaultMaterial = "sys:fx/opacity_skinning.fxml";
 			}
 			else
 			{
 				if (numBones == 0 || !skinned)
 					defaultMaterial = "sys:fx/transparent_skinning0.fxml";
-				else if (numBones <= 64)
-					defaultMaterial = "sys:fx/transparent_skinning64.fxml";
-				else if (numBones <= 128)
-					defaultMaterial = "sys:fx/transparent_skinning128.fxml";
-				else if (numBones <= 256)
-					defaultMaterial = "sys:fx/transparent_skinning256.fxml";
 				else
-					defaultMaterial = "sys:fx/transparent_skinning0.fxml";
+					defaultMaterial = "sys:fx/transparent_skinning.fxml";
 			}
 		}
 
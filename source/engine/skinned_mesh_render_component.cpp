@@ -41,17 +41,147 @@
 #include <ray/mesh_component.h>
 #include <ray/material.h>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#	include <xmmintrin.h>
+#endif
+
 _NAME_BEGIN
 
 __ImplementSubClass(SkinnedMeshRenderComponent, MeshRenderComponent, "SkinnedMeshRender")
 
+namespace
+{
+	// Joint palettes of every skinned mesh in the frame, packed into one texel buffer.
+	// Each joint is stored as the three rows of its 3x4 skinning matrix.
+	class SkinningPalette
+	{
+	public:
+		SkinningPalette() noexcept
+			: _frame(0)
+			, _refCount(0)
+			, _uploaded(false)
+		{
+		}
+
+		void addRef() noexcept
+		{
+			_refCount++;
+		}
+
+		void release() noexcept
+		{
+			assert(_refCount > 0);
+
+			if (--_refCount == 0)
+			{
+				_rows.clear();
+				_rows.shrink_to_fit();
+				_data.reset();
+			}
+		}
+
+		// A component allocating twice for the same frame, or any allocation after the
+		// palette went to the gpu, starts a new frame.
+		std::size_t allocate(std::size_t& frame, std::size_t numJoints) noexcept
+		{
+			if (_uploaded || frame == _frame)
+			{
+				_frame++;
+				_rows.clear();
+				_uploaded = false;
+			}
+
+			frame = _frame;
+
+			std::size_t offset = _rows.size() / 3;
+			_rows.resize(_rows.size() + numJoints * 3);
+			return offset;
+		}
+
+		float4* getRows(std::size_t offset) noexcept
+		{
+			return _rows.data() + offset * 3;
+		}
+
+		const GraphicsDataPtr& upload() noexcept
+		{
+			if (_uploaded || _rows.empty())
+				return _data;
+
+			std::size_t size = _rows.size() * sizeof(float4);
+			if (!_data || _data->getGraphicsDataDesc().getStreamSize() < size)
+			{
+				if (_data)
+					size = std::max(size, _data->getGraphicsDataDesc().getStreamSize() * 2);
+
+				GraphicsDataDesc jointDesc;
+				jointDesc.setStreamSize(size);
+				jointDesc.setUsage(GraphicsUsageFlagBits::GraphicsUsageFlagWriteBit);
+				jointDesc.setType(GraphicsDataType::GraphicsDataTypeUniformTexelBuffer);
+
+				_data = RenderSystem::instance()->createGraphicsData(jointDesc);
+				if (!_data)
+					return _data;
+			}
+
+			void* data;
+			if (_data->map(0, _rows.size() * sizeof(float4), &data))
+				std::memcpy(data, _rows.data(), _rows.size() * sizeof(float4));
+
+			_data->unmap();
+
+			_uploaded = true;
+			return _data;
+		}
+
+	private:
+		std::size_t _frame;
+		std::size_t _refCount;
+		bool _uploaded;
+		std::vector<float4> _rows;
+		GraphicsDataPtr _data;
+	};
+
+	SkinningPalette palette;
+
+	// rows = transpose(transformMultiply(world, bindpose)), keeping only the first three rows
+	void buildJoint(const float4x4& world, const float4x4& bindpose, float4* rows) noexcept
+	{
+#if defined(__SSE2__) || defined(_M_X64)
+		__m128 a = _mm_loadu_ps(&world.a1);
+		__m128 b = _mm_loadu_ps(&world.b1);
+		__m128 c = _mm_loadu_ps(&world.c1);
+		__m128 d = _mm_loadu_ps(&world.d1);
+
+		__m128 x = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, _mm_set1_ps(bindpose.a1)), _mm_mul_ps(b, _mm_set1_ps(bindpose.a2))), _mm_mul_ps(c, _mm_set1_ps(bindpose.a3)));
+		__m128 y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, _mm_set1_ps(bindpose.b1)), _mm_mul_ps(b, _mm_set1_ps(bindpose.b2))), _mm_mul_ps(c, _mm_set1_ps(bindpose.b3)));
+		__m128 z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, _mm_set1_ps(bindpose.c1)), _mm_mul_ps(b, _mm_set1_ps(bindpose.c2))), _mm_mul_ps(c, _mm_set1_ps(bindpose.c3)));
+		__m128 w = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(a, _mm_set1_ps(bindpose.d1)), _mm_mul_ps(b, _mm_set1_ps(bindpose.d2))), _mm_mul_ps(c, _mm_set1_ps(bindpose.d3))), d);
+
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+
+		_mm_storeu_ps(&rows[0].x, x);
+		_mm_storeu_ps(&rows[1].x, y);
+		_mm_storeu_ps(&rows[2].x, z);
+#else
+		auto m = math::transformMultiply(world, bindpose);
+		rows[0].set(m.a1, m.b1, m.c1, m.d1);
+		rows[1].set(m.a2, m.b2, m.c2, m.d2);
+		rows[2].set(m.a3, m.b3, m.c3, m.d3);
+#endif
+	}
+}
+
 SkinnedMeshRenderComponent::SkinnedMeshRenderComponent() noexcept
-	: _onMeshChange(std::bind(&SkinnedMeshRenderComponent::onMeshChange, this))
+	: _jointOffset(0)
+	, _jointFrame(std::numeric_limits<std::size_t>::max())
+	, _onMeshChange(std::bind(&SkinnedMeshRenderComponent::onMeshChange, this))
 	, _onMeshWillRender(std::bind(&SkinnedMeshRenderComponent::onMeshWillRender, this, std::placeholders::_1))
 {
 }
 
 SkinnedMeshRenderComponent::SkinnedMeshRenderComponent(MaterialPtr& material, bool shared) noexcept
+	: SkinnedMeshRenderComponent()
 {
 	if (shared)
 		this->setSharedMaterial(material);
@@ -60,6 +190,7 @@ SkinnedMeshRenderComponent::SkinnedMeshRenderComponent(MaterialPtr& material, bo
 }
 
 SkinnedMeshRenderComponent::SkinnedMeshRenderComponent(MaterialPtr&& material, bool shared) noexcept
+	: SkinnedMeshRenderComponent()
 {
 	if (shared)
 		this->setSharedMaterial(material);
@@ -68,6 +199,7 @@ SkinnedMeshRenderComponent::SkinnedMeshRenderComponent(MaterialPtr&& material, b
 }
 
 SkinnedMeshRenderComponent::SkinnedMeshRenderComponent(const Materials& materials, bool shared) noexcept
+	: SkinnedMeshRenderComponent()
 {
 	if (shared)
 		this->setSharedMaterials(materials);
@@ -76,6 +208,7 @@ SkinnedMeshRenderComponent::SkinnedMeshRenderComponent(const Materials& material
 }
 
 SkinnedMeshRenderComponent::SkinnedMeshRenderComponent(Materials&& materials, bool shared) noexcept
+	: SkinnedMeshRenderComponent()
 {
 	if (shared)
 		this->setSharedMaterials(materials);
@@ -111,26 +244,7 @@ SkinnedMeshRenderComponent::onActivate() except
 	if (_transforms.empty())
 		return;
 
-	if (!_jointData)
-	{
-		GraphicsDataDesc jointDesc;
-		jointDesc.setStreamSize(sizeof(float4x4) * static_cast<std::uint16_t>(_transforms.size()));
-		jointDesc.setUsage(GraphicsUsageFlagBits::GraphicsUsageFlagWriteBit);
-		jointDesc.setType(GraphicsDataType::GraphicsDataTypeUniformBuffer);
-
-		_jointData = RenderSystem::instance()->createGraphicsData(jointDesc);
-	}
-
-	if (this->hasMaterial())
-	{
-		auto& materials = this->getMaterials();
-		for (auto& it : materials)
-		{
-			auto param = it->getParameter("joints");
-			if (param)
-				param->uniformBuffer(_jointData);
-		}
-	}
+	palette.addRef();
 
 	auto meshComponent = this->getComponent<MeshComponent>();
 	if (meshComponent)
@@ -151,7 +265,9 @@ SkinnedMeshRenderComponent::onDeactivate() noexcept
 	this->removePreRenderListener(&_onMeshWillRender);
 
 	_mesh.reset();
-	_jointData.reset();
+
+	if (!_transforms.empty())
+		palette.release();
 
 	this->removeComponentDispatch(GameDispatchType::GameDispatchTypeFrameEnd, this);
 }
@@ -185,42 +301,76 @@ SkinnedMeshRenderComponent::onMeshChange() noexcept
 void
 SkinnedMeshRenderComponent::onMeshWillRender(const Camera&) noexcept
 {
-	if (!_mesh)
+	if (!_mesh || _transforms.empty())
 		return;
 
-	if (_needUpdate)
+	auto& jointData = palette.upload();
+	if (!jointData)
+		return;
+
+	// every render object holds its own material instance, see _updateMaterial
+	for (auto& renderObject : _renderObjects)
 	{
-		if (!_jointData)
-			return;
+		auto& material = renderObject->getMaterial();
+		if (!material)
+			continue;
 
-		float4x4* data;
-		if (_jointData->map(0, _jointData->getGraphicsDataDesc().getStreamSize(), (void**)&data))
-		{
-			auto& bindposes = _mesh->getBindposes();
-			if (bindposes.size() != _transforms.size())
-			{
-				std::size_t size = _transforms.size();
-				for (std::size_t i = 0; i < size; ++i)
-					*data++ = float4x4::One;
-			}
-			else
-			{
-				std::size_t index = 0;
-				for (auto& transform : _transforms)
-					*data++ = math::transformMultiply(transform->getWorldTransform(), bindposes[index++]);
-			}
-		}
+		auto joints = material->getParameter("joints");
+		if (joints)
+			joints->uniformBuffer(jointData);
 
-		_jointData->unmap();
+		auto jointOffset = material->getParameter("jointOffset");
+		if (jointOffset)
+			jointOffset->uniform1i(static_cast<std::int32_t>(_jointOffset));
+	}
+}
+
+void
+SkinnedMeshRenderComponent::_updateMaterial(std::size_t n) noexcept
+{
+	MeshRenderComponent::_updateMaterial(n);
 
-		_needUpdate = false;
+	// the pre render hooks of all visible objects run before the first draw, so a material shared
+	// between skinned meshes would draw every one of them with the joint offset written last
+	auto& material = _renderObjects[n]->getMaterial();
+	if (material)
+	{
+		auto instance = material->clone();
+		if (instance)
+			_renderObjects[n]->setMaterial(instance);
 	}
 }
 
 void
 SkinnedMeshRenderComponent::onFrameEnd() noexcept
 {
-	_needUpdate = true;
+	if (_mesh && !_transforms.empty())
+	{
+		_jointOffset = palette.allocate(_jointFrame, _transforms.size());
+
+		float4* rows = palette.getRows(_jointOffset);
+
+		auto& bindposes = _mesh->getBindposes();
+		if (bindposes.size() != _transforms.size())
+		{
+			std::size_t size = _transforms.size();
+			for (std::size_t i = 0; i < size; ++i, rows += 3)
+			{
+				rows[0].set(1.0f, 0.0f, 0.0f, 0.0f);
+				rows[1].set(0.0f, 1.0f, 0.0f, 0.0f);
+				rows[2].set(0.0f, 0.0f, 1.0f, 0.0f);
+			}
+		}
+		else
+		{
+			std::size_t index = 0;
+			for (auto& transform : _transforms)
+			{
+				buildJoint(transform->getWorldTransform(), bindposes[index++], rows);
+				rows += 3;
+			}
+		}
+	}
 
 	AABB aabb;
 	for (auto& transform : _transforms)
@@ -197,7 +197,14 @@ OGLCoreDescriptorSet::apply(const OGLProgram& shaderObject) noexcept
 		case GraphicsUniformType::GraphicsUniformTypeStorageBufferDynamic:
 			break;
 		case GraphicsUniformType::GraphicsUniformTypeUniformTexelBuffer:
-			break;
+		{
+			auto& buffer = it->getBuffer();
+			if (buffer)
+				glBindTextureUnit(location, buffer->downcast<OGLCoreGraphicsData>()->getTextureID());
+			else
+				glBindTextureUnit(location, GL_NONE);
+		}
+		break;
 		case GraphicsUniformType::GraphicsUniformTypeUniformBuffer:
 		{
 			auto& buffer = it->getBuffer();
@@ -348,6 +355,7 @@ OGLCoreDescriptorSet::copy(std::uint32_t descriptorCopyCount, const GraphicsDesc
 			case GraphicsUniformType::GraphicsUniformTypeStorageBufferDynamic:
 				break;
 			case GraphicsUniformType::GraphicsUniformTypeUniformTexelBuffer:
+				(*it)->uniformBuffer(activeUniformSet->getBuffer());
 				break;
 			case GraphicsUniformType::GraphicsUniformTypeUniformBuffer:
 				(*it)->uniformBuffer(activeUniformSet->getBuffer());
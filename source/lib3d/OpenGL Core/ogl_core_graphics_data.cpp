@@ -43,6 +43,7 @@ __ImplementSubInterface(OGLCoreGraphicsData, GraphicsData, "OGLCoreGraphicsData"
 
 OGLCoreGraphicsData::OGLCoreGraphicsData() noexcept
 	: _buffer(GL_NONE)
+	, _texture(GL_NONE)
 	, _bufferAddr(GL_NONE)
 	, _data(nullptr)
 {
@@ -65,7 +66,7 @@ OGLCoreGraphicsData::setup(const GraphicsDataDesc& desc) noexcept
 		target = GL_ARRAY_BUFFER;
 	else if (type == GraphicsDataType::GraphicsDataTypeStorageIndexBuffer)
 		target = GL_ELEMENT_ARRAY_BUFFER;
-	else if (type == GraphicsDataType::GraphicsDataTypeStorageTexelBuffer)
+	else if (type == GraphicsDataType::GraphicsDataTypeUniformTexelBuffer || type == GraphicsDataType::GraphicsDataTypeStorageTexelBuffer)
 		target = GL_TEXTURE_BUFFER;
 	else if (type == GraphicsDataType::GraphicsDataTypeStorageBuffer)
 		target = GL_SHADER_STORAGE_BUFFER;
@@ -114,6 +115,12 @@ OGLCoreGraphicsData::setup(const GraphicsDataDesc& desc) noexcept
 		glMakeNamedBufferResidentNV(_buffer, GL_READ_ONLY);
 	}
 
+	if (target == GL_TEXTURE_BUFFER)
+	{
+		glCreateTextures(GL_TEXTURE_BUFFER, 1, &_texture);
+		glTextureBuffer(_texture, GL_RGBA32F, _buffer);
+	}
+
 	_desc = desc;
 	return true;
 }
@@ -124,6 +131,12 @@ OGLCoreGraphicsData::close() noexcept
 	if (_data)
 		glUnmapNamedBuffer(_buffer);
 
+	if (_texture)
+	{
+		glDeleteTextures(1, &_texture);
+		_texture = 0;
+	}
+
 	if (_buffer)
 	{
 		glDeleteBuffers(1, &_buffer);
@@ -164,7 +177,7 @@ OGLCoreGraphicsData::map(std::ptrdiff_t offset, std::ptrdiff_t count, void** dat
 		flags |= GL_MAP_FLUSH_EXPLICIT_BIT;
 
 	if (!_data && usage & GraphicsUsageFlagBits::GraphicsUsageFlagPersistentBit)
-		_data = glMapNamedBuffer(_buffer, flags);
+		_data = glMapNamedBufferRange(_buffer, 0, _desc.getStreamSize(), flags);
 
 	if (_data && usage & GraphicsUsageFlagBits::GraphicsUsageFlagPersistentBit)
 	{
@@ -191,6 +204,12 @@ OGLCoreGraphicsData::getInstanceID() const noexcept
 	return _buffer;
 }
 
+GLuint
+OGLCoreGraphicsData::getTextureID() const noexcept
+{
+	return _texture;
+}
+
 GLuint64
 OGLCoreGraphicsData::getInstanceAddr() const noexcept
 {
@@ -58,6 +58,7 @@ public:
 	void unmap() noexcept;
 
 	GLuint getInstanceID() const noexcept;
+	GLuint getTextureID() const noexcept;
 	GLuint64 getInstanceAddr() const noexcept;
 
 	const GraphicsDataDesc& getGraphicsDataDesc() const noexcept;
@@ -73,6 +74,7 @@ private:
 
 private:
 	GLuint _buffer;
+	GLuint _texture;
 	GLuint64 _bufferAddr;
 	GLvoid* _data;
 	GraphicsDataDesc _desc;
@@ -232,6 +232,18 @@ EGL2Device::createDescriptorPool(const GraphicsDescriptorPoolDesc& desc) noexcep
 	return nullptr;
 }
 
+GraphicsTransientBufferPtr
+EGL2Device::createTransientBuffer(const GraphicsTransientBufferDesc& desc) noexcept
+{
+	return nullptr;
+}
+
+GraphicsQueryPtr
+EGL2Device::createQuery(const GraphicsQueryDesc& desc) noexcept
+{
+	return nullptr;
+}
+
 void
 EGL2Device::enableDebugControl(bool enable) noexcept
 {
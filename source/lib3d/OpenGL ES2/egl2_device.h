@@ -66,6 +66,8 @@ public:
 	GraphicsDescriptorSetPtr createDescriptorSet(const GraphicsDescriptorSetDesc& desc) noexcept;
 	GraphicsDescriptorSetLayoutPtr createDescriptorSetLayout(const GraphicsDescriptorSetLayoutDesc& desc) noexcept;
 	GraphicsDescriptorPoolPtr createDescriptorPool(const GraphicsDescriptorPoolDesc& desc) noexcept;
+	GraphicsTransientBufferPtr createTransientBuffer(const GraphicsTransientBufferDesc& desc) noexcept;
+	GraphicsQueryPtr createQuery(const GraphicsQueryDesc& desc) noexcept;
 
 	void enableDebugControl(bool enable) noexcept;
 
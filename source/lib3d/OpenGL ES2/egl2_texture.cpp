@@ -227,6 +227,31 @@ EGL2Texture::unmap() noexcept
 {
 }
 
+bool
+EGL2Texture::update(std::uint32_t x, std::uint32_t y, std::uint32_t w, std::uint32_t h, std::uint32_t mipLevel, const void* data) noexcept
+{
+	assert(data);
+	assert(_target == GL_TEXTURE_2D);
+
+	GLenum format = EGL2Types::asTextureFormat(_textureDesc.getTexFormat());
+	if (format == GL_INVALID_ENUM)
+		return false;
+
+	GLenum type = EGL2Types::asTextureType(_textureDesc.getTexFormat());
+	if (type == GL_INVALID_ENUM)
+		return false;
+
+	GLint oldUnpackStore = 1;
+	GL_CHECK(glGetIntegerv(GL_UNPACK_ALIGNMENT, &oldUnpackStore));
+	GL_CHECK(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+	GL_CHECK(glBindTexture(_target, _texture));
+	GL_CHECK(glTexSubImage2D(_target, mipLevel, x, y, w, h, format, type, data));
+
+	GL_CHECK(glPixelStorei(GL_UNPACK_ALIGNMENT, oldUnpackStore));
+	return true;
+}
+
 bool
 EGL2Texture::applySamplerWrap(GLenum target, GraphicsSamplerWrap wrap) noexcept
 {
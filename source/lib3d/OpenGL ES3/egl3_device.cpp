@@ -233,6 +233,18 @@ EGL3Device::createDescriptorPool(const GraphicsDescriptorPoolDesc& desc) noexcep
 	return nullptr;
 }
 
+GraphicsTransientBufferPtr
+EGL3Device::createTransientBuffer(const GraphicsTransientBufferDesc& desc) noexcept
+{
+	return nullptr;
+}
+
+GraphicsQueryPtr
+EGL3Device::createQuery(const GraphicsQueryDesc& desc) noexcept
+{
+	return nullptr;
+}
+
 void
 EGL3Device::enableDebugControl(bool enable) noexcept
 {
@@ -272,6 +272,32 @@ EGL3Texture::unmap() noexcept
 	GL_CHECK(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
 }
 
+bool
+EGL3Texture::update(std::uint32_t x, std::uint32_t y, std::uint32_t w, std::uint32_t h, std::uint32_t mipLevel, const void* data) noexcept
+{
+	assert(data);
+	assert(_target == GL_TEXTURE_2D);
+
+	GLenum format = EGL3Types::asTextureFormat(_textureDesc.getTexFormat());
+	if (format == GL_INVALID_ENUM)
+		return false;
+
+	GLenum type = EGL3Types::asTextureType(_textureDesc.getTexFormat());
+	if (type == GL_INVALID_ENUM)
+		return false;
+
+	GLint oldUnpackStore = 1;
+	GL_CHECK(glGetIntegerv(GL_UNPACK_ALIGNMENT, &oldUnpackStore));
+	GL_CHECK(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+	GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GL_NONE));
+	GL_CHECK(glBindTexture(_target, _texture));
+	GL_CHECK(glTexSubImage2D(_target, mipLevel, x, y, w, h, format, type, data));
+
+	GL_CHECK(glPixelStorei(GL_UNPACK_ALIGNMENT, oldUnpackStore));
+	return true;
+}
+
 bool
 EGL3Texture::applyMipmapLimit(GLenum target, std::uint32_t min, std::uint32_t count) noexcept
 {
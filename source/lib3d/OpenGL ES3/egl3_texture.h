@@ -54,6 +54,8 @@ public:
 	bool map(std::uint32_t x, std::uint32_t y, std::uint32_t w, std::uint32_t h, std::uint32_t mipLevel, void** data) noexcept;
 	void unmap() noexcept;
 
+	bool update(std::uint32_t x, std::uint32_t y, std::uint32_t w, std::uint32_t h, std::uint32_t mipLevel, const void* data) noexcept;
+
 	GLenum getTarget() const noexcept;
 	GLuint getInstanceID() const noexcept;
 
@@ -890,7 +890,21 @@ OGLDescriptorSet::apply(const OGLProgram& shaderObject) noexcept
 		case GraphicsUniformType::GraphicsUniformTypeStorageBufferDynamic:
 			break;
 		case GraphicsUniformType::GraphicsUniformTypeUniformTexelBuffer:
-			break;
+		{
+			auto& buffer = it->getBuffer();
+			if (buffer)
+			{
+				auto tbo = buffer->downcast<OGLGraphicsData>();
+				glActiveTexture(GL_TEXTURE0 + location);
+				glBindTexture(GL_TEXTURE_BUFFER, tbo->getTextureID());
+			}
+			else
+			{
+				glActiveTexture(GL_TEXTURE0 + location);
+				glBindTexture(GL_TEXTURE_BUFFER, GL_NONE);
+			}
+		}
+		break;
 		case GraphicsUniformType::GraphicsUniformTypeUniformBuffer:
 		{
 			auto& buffer = it->getBuffer();
@@ -1041,6 +1055,7 @@ OGLDescriptorSet::copy(std::uint32_t descriptorCopyCount, const GraphicsDescript
 			case GraphicsUniformType::GraphicsUniformTypeStorageBufferDynamic:
 				break;
 			case GraphicsUniformType::GraphicsUniformTypeUniformTexelBuffer:
+				(*it)->uniformBuffer(activeUniformSet->getBuffer());
 				break;
 			case GraphicsUniformType::GraphicsUniformTypeUniformBuffer:
 				(*it)->uniformBuffer(activeUniformSet->getBuffer());
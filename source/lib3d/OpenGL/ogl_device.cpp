@@ -39,6 +39,7 @@
 #include "ogl_device_property.h"
 #include "ogl_swapchain.h"
 #include "ogl_shader.h"
+#include "ogl_shader_cache.h"
 #include "ogl_texture.h"
 #include "ogl_framebuffer.h"
 #include "ogl_input_layout.h"
@@ -47,6 +48,8 @@
 #include "ogl_state.h"
 #include "ogl_sampler.h"
 #include "ogl_pipeline.h"
+#include "ogl_transient_buffer.h"
+#include "ogl_query.h"
 
 #include "ogl_core_device_context.h"
 #include "ogl_core_texture.h"
@@ -76,6 +79,13 @@ OGLDevice::setup(const GraphicsDeviceDesc& desc) noexcept
 	if (!deviceProperty->setup())
 		return false;
 
+	if (!desc.getShaderCachePath().empty())
+	{
+		auto shaderCache = std::make_shared<OGLShaderCache>();
+		if (shaderCache->setup(desc.getShaderCachePath()))
+			_shaderCache = shaderCache;
+	}
+
 	_deviceProperty = deviceProperty;
 	_deviceDesc = desc;
 	return true;
@@ -84,6 +94,16 @@ OGLDevice::setup(const GraphicsDeviceDesc& desc) noexcept
 void
 OGLDevice::close() noexcept
 {
+	if (_shaderCache)
+	{
+		this->message(_shaderCache->getStatistics().c_str());
+
+		if (!_shaderCache->flush())
+			this->message("Can't write shader cache : %s", _deviceDesc.getShaderCachePath().c_str());
+
+		_shaderCache.reset();
+	}
+
 	_deviceProperty.reset();
 }
 
@@ -305,6 +325,26 @@ OGLDevice::createDescriptorPool(const GraphicsDescriptorPoolDesc& desc) noexcept
 	return nullptr;
 }
 
+GraphicsTransientBufferPtr
+OGLDevice::createTransientBuffer(const GraphicsTransientBufferDesc& desc) noexcept
+{
+	auto buffer = std::make_shared<OGLTransientBuffer>();
+	buffer->setDevice(this->downcast_pointer<OGLDevice>());
+	if (buffer->setup(desc))
+		return buffer;
+	return nullptr;
+}
+
+GraphicsQueryPtr
+OGLDevice::createQuery(const GraphicsQueryDesc& desc) noexcept
+{
+	auto query = std::make_shared<OGLQuery>();
+	query->setDevice(this->downcast_pointer<OGLDevice>());
+	if (query->setup(desc))
+		return query;
+	return nullptr;
+}
+
 void
 OGLDevice::enableDebugControl(bool enable) noexcept
 {
@@ -351,6 +391,12 @@ OGLDevice::getGraphicsDeviceDesc() const noexcept
 	return _deviceDesc;
 }
 
+const OGLShaderCachePtr&
+OGLDevice::getShaderCache() const noexcept
+{
+	return _shaderCache;
+}
+
 void
 OGLDevice::message(const char* message, ...) noexcept
 {
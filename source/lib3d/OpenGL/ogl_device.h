@@ -37,7 +37,7 @@
 #ifndef _H_OGL_DEVICE_H_
 #define _H_OGL_DEVICE_H_
 
-#include <ray/graphics_device.h>
+#include "ogl_types.h"
 
 _NAME_BEGIN
 
@@ -66,6 +66,8 @@ public:
 	GraphicsDescriptorSetPtr createDescriptorSet(const GraphicsDescriptorSetDesc& desc) noexcept;
 	GraphicsDescriptorSetLayoutPtr createDescriptorSetLayout(const GraphicsDescriptorSetLayoutDesc& desc) noexcept;
 	GraphicsDescriptorPoolPtr createDescriptorPool(const GraphicsDescriptorPoolDesc& desc) noexcept;
+	GraphicsTransientBufferPtr createTransientBuffer(const GraphicsTransientBufferDesc& desc) noexcept;
+	GraphicsQueryPtr createQuery(const GraphicsQueryDesc& desc) noexcept;
 
 	void enableDebugControl(bool enable) noexcept;
 
@@ -74,6 +76,8 @@ public:
 	const GraphicsDeviceProperty& getGraphicsDeviceProperty() const noexcept;
 	const GraphicsDeviceDesc& getGraphicsDeviceDesc() const noexcept;
 
+	const OGLShaderCachePtr& getShaderCache() const noexcept;
+
 	void message(const char* message, ...) noexcept;
 
 private:
@@ -84,6 +88,7 @@ private:
 	GraphicsDeviceDesc _deviceDesc;
 	GraphicsContextWeaks _deviceContexts;
 	GraphicsDevicePropertyPtr _deviceProperty;
+	OGLShaderCachePtr _shaderCache;
 };
 
 _NAME_END
@@ -43,6 +43,7 @@ __ImplementSubClass(OGLGraphicsData, GraphicsData, "OGLGraphicsData")
 
 OGLGraphicsData::OGLGraphicsData() noexcept
 	: _buffer(GL_NONE)
+	, _texture(GL_NONE)
 	, _data(nullptr)
 {
 }
@@ -66,7 +67,7 @@ OGLGraphicsData::setup(const GraphicsDataDesc& desc) noexcept
 		_target = GL_ARRAY_BUFFER;
 	else if (type == GraphicsDataType::GraphicsDataTypeStorageIndexBuffer)
 		_target = GL_ELEMENT_ARRAY_BUFFER;
-	else if (type == GraphicsDataType::GraphicsDataTypeStorageTexelBuffer)
+	else if (type == GraphicsDataType::GraphicsDataTypeUniformTexelBuffer || type == GraphicsDataType::GraphicsDataTypeStorageTexelBuffer)
 		_target = GL_TEXTURE_BUFFER;
 	else if (type == GraphicsDataType::GraphicsDataTypeStorageBuffer)
 		_target = GL_SHADER_STORAGE_BUFFER;
@@ -99,6 +100,14 @@ OGLGraphicsData::setup(const GraphicsDataDesc& desc) noexcept
 	glBindBuffer(_target, _buffer);
 	glBufferData(_target, desc.getStreamSize(), desc.getStream(), flags);
 
+	if (_target == GL_TEXTURE_BUFFER)
+	{
+		glGenTextures(1, &_texture);
+		glBindTexture(GL_TEXTURE_BUFFER, _texture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, _buffer);
+		glBindTexture(GL_TEXTURE_BUFFER, GL_NONE);
+	}
+
 	return true;
 }
 
@@ -116,6 +125,12 @@ OGLGraphicsData::close() noexcept
 	if (_data)
 		this->unmap();
 
+	if (_texture)
+	{
+		glDeleteTextures(1, &_texture);
+		_texture = 0;
+	}
+
 	if (_buffer)
 	{
 		glDeleteBuffers(1, &_buffer);
@@ -160,6 +175,12 @@ OGLGraphicsData::getInstanceID() const noexcept
 	return _buffer;
 }
 
+GLuint
+OGLGraphicsData::getTextureID() const noexcept
+{
+	return _texture;
+}
+
 const GraphicsDataDesc&
 OGLGraphicsData::getGraphicsDataDesc() const noexcept
 {
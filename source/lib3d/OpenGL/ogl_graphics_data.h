@@ -57,6 +57,7 @@ public:
 	void unmap() noexcept;
 
 	GLuint getInstanceID() const noexcept;
+	GLuint getTextureID() const noexcept;
 
 	const GraphicsDataDesc& getGraphicsDataDesc() const noexcept;
 
@@ -71,6 +72,7 @@ private:
 
 private:
 	GLuint _buffer;
+	GLuint _texture;
 	GLenum _target;
 	GLvoid* _data;
 	GraphicsDataDesc _desc;
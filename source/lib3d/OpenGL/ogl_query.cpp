@@ -2,7 +2,7 @@
 // | Project : ray.
 // | All rights reserved.
 // +----------------------------------------------------------------------
-// | Copyright (c) 2013-2014.
+// | Copyright (c) 2013-2017.
 // +----------------------------------------------------------------------
 // | * Redistribution and use of this software in source and binary forms,
 // |   with or without modification, are permitted provided that the following
@@ -34,94 +34,107 @@
 // | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // +----------------------------------------------------------------------
-#include <ray/occlusion_tree.h>
-#include <stack>
+#include "ogl_query.h"
 
 _NAME_BEGIN
 
-OcclusionObject::OcclusionObject() noexcept
-    : _isVirtualLeaf(false)
+__ImplementSubClass(OGLQuery, GraphicsQuery, "OGLQuery")
+
+OGLQuery::OGLQuery() noexcept
+	: _query(GL_NONE)
+	, _target(GL_SAMPLES_PASSED)
 {
 }
 
-bool
-OcclusionObject::isVirtualLeaf() const noexcept
+OGLQuery::~OGLQuery() noexcept
 {
-    return _isVirtualLeaf;
+	this->close();
 }
 
-const Bound&
-OcclusionObject::getBoundingxBox() const noexcept
+bool
+OGLQuery::setup(const GraphicsQueryDesc& desc) noexcept
 {
-    return _boundingBox;
+	assert(_query == GL_NONE);
+
+	_target = GL_SAMPLES_PASSED;
+
+	// a yes/no answer lets the driver stop counting at the first sample, fall back to counting where it is missing
+	if (desc.getType() == GraphicsQueryType::GraphicsQueryTypeAnySamplesPassed)
+	{
+		if (GLEW_ARB_ES3_compatibility)
+			_target = GL_ANY_SAMPLES_PASSED_CONSERVATIVE;
+		else if (GLEW_ARB_occlusion_query2)
+			_target = GL_ANY_SAMPLES_PASSED;
+	}
+
+	glGenQueries(1, &_query);
+	if (_query == GL_NONE)
+		return false;
+
+	_desc = desc;
+	return true;
 }
 
-void 
-OcclusionTree::addOcclusionObject(OcclusionObjectPtr object) noexcept
+void
+OGLQuery::close() noexcept
 {
-    _occlusionObjects.push_back(object);
-    _boundingBox.encapsulate(object->getBoundingxBox());
+	if (_query != GL_NONE)
+	{
+		glDeleteQueries(1, &_query);
+		_query = GL_NONE;
+	}
 }
 
-bool
-OcclusionTree::isVisiable(OcclusionObjectPtr object) noexcept
+void
+OGLQuery::queryBegin() noexcept
 {
-    return _frustum.contains(object->getBoundingxBox().sphere());
+	assert(_query != GL_NONE);
+	glBeginQuery(_target, _query);
 }
 
-void 
-OcclusionTree::collectObjects(OcclusionObjectPtr root, OcclusionObjectContainer& container) noexcept
+void
+OGLQuery::queryEnd() noexcept
 {
-    std::stack<OcclusionObject*> stack;
-
-    stack.push(root);
+	assert(_query != GL_NONE);
+	glEndQuery(_target);
+}
 
-    while (!stack.empty())
-    {
-        auto object = stack.top();
-        stack.pop();
+bool
+OGLQuery::isAvailable() const noexcept
+{
+	assert(_query != GL_NONE);
 
-        container.push_back(object);
+	GLuint available = GL_FALSE;
+	glGetQueryObjectuiv(_query, GL_QUERY_RESULT_AVAILABLE, &available);
+	return available ? true : false;
+}
 
-        if (!object->isVirtualLeaf())
-        {
-            OcclusionObjectIterator* iterator = dynamic_cast<OcclusionObjectIterator*>(object);
+std::uint32_t
+OGLQuery::getResult() const noexcept
+{
+	assert(_query != GL_NONE);
 
-            stack.push(iterator->frist());
-            stack.push(iterator->second());
-        }
-    }
+	GLuint result = 0;
+	glGetQueryObjectuiv(_query, GL_QUERY_RESULT, &result);
+	return result;
 }
 
-void 
-OcclusionTree::computeBounds(OcclusionObjectPtr root) noexcept
+const GraphicsQueryDesc&
+OGLQuery::getGraphicsQueryDesc() const noexcept
 {
-    OcclusionObjectContainer container;
-    this->collectObjects(_root, container);
-
-    for (auto& it : container)
-    {
+	return _desc;
+}
 
-    }
+void
+OGLQuery::setDevice(const GraphicsDevicePtr& device) noexcept
+{
+	_device = device;
 }
 
-void 
-OcclusionTree::computeLeaves(OcclusionObjectPtr node) noexcept
+GraphicsDevicePtr
+OGLQuery::getDevice() noexcept
 {
-    if (node->isLeaf())
-    {
-        node->_leaves = 1;
-    }
-    else
-    {
-        OcclusionObjectPtr f = dynamic_cast<OcclusionObjectIterator*>(node)->frist();
-        OcclusionObjectPtr s = dynamic_cast<OcclusionObjectIterator*>(node)->second();
-
-        computeLeaves(f);
-        computeLeaves(s);
-
-        node->_leaves = f->_leaves + s->_leaves;
-    }
+	return _device.lock();
 }
 
 _NAME_END
\ No newline at end of file
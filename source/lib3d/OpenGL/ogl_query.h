@@ -2,7 +2,7 @@
 // | Project : ray.
 // | All rights reserved.
 // +----------------------------------------------------------------------
-// | Copyright (c) 2013-2014.
+// | Copyright (c) 2013-2017.
 // +----------------------------------------------------------------------
 // | * Redistribution and use of this software in source and binary forms,
 // |   with or without modification, are permitted provided that the following
@@ -34,17 +34,49 @@
 // | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // +----------------------------------------------------------------------
-#ifndef _H_RENDER_TYPES_H_
-#define _H_RENDER_TYPES_H_
+#ifndef _H_OGL_QUERY_H_
+#define _H_OGL_QUERY_H_
 
-#include <ray/math.h>
+#include <ray/graphics_query.h>
+
+#include "ogl_types.h"
 
 _NAME_BEGIN
 
-typedef class OcclusionObject* OcclusionObjectPtr;
+class OGLQuery final : public GraphicsQuery
+{
+	__DeclareSubClass(OGLQuery, GraphicsQuery)
+public:
+	OGLQuery() noexcept;
+	virtual ~OGLQuery() noexcept;
+
+	bool setup(const GraphicsQueryDesc& desc) noexcept;
+	void close() noexcept;
+
+	void queryBegin() noexcept;
+	void queryEnd() noexcept;
+
+	bool isAvailable() const noexcept;
+	std::uint32_t getResult() const noexcept;
+
+	const GraphicsQueryDesc& getGraphicsQueryDesc() const noexcept;
+
+private:
+	friend class OGLDevice;
+	void setDevice(const GraphicsDevicePtr& device) noexcept;
+	GraphicsDevicePtr getDevice() noexcept;
+
+private:
+	OGLQuery(const OGLQuery&) noexcept = delete;
+	OGLQuery& operator=(const OGLQuery&) noexcept = delete;
+
+private:
+	GLuint _query;
+	GLenum _target;
 
-typedef std::vector<OcclusionObjectPtr> OcclusionObjectContainer;
-typedef std::vector<class OcclusionQuery*> OcclusionQueryContainer;
+	GraphicsQueryDesc _desc;
+	GraphicsDeviceWeakPtr _device;
+};
 
 _NAME_END
 
@@ -36,6 +36,7 @@
 // +----------------------------------------------------------------------
 #include "ogl_shader.h"
 #include "ogl_device.h"
+#include "ogl_shader_cache.h"
 
 #define EXCLUDE_PSTDINT
 #include <hlslcc.hpp>
@@ -290,6 +291,7 @@ OGLGraphicsUniformBlock::getBindingPoint() const noexcept
 
 OGLShader::OGLShader() noexcept
 	: _instance(GL_NONE)
+	, _cacheKey(0)
 {
 }
 
@@ -318,22 +320,32 @@ OGLShader::setup(const GraphicsShaderDesc& shaderDesc) noexcept
 		return false;
 	}
 
+	_cacheKey = makeCacheKey(shaderDesc);
+
+	auto& shaderCache = this->getDevice()->downcast<OGLDevice>()->getShaderCache();
+
 	std::string codes;
-	if (shaderDesc.getLanguage() == GraphicsShaderLang::GraphicsShaderLangHLSL)
+	if (!shaderCache || !shaderCache->getShaderSource(_cacheKey, codes))
 	{
-		if (!HlslCodes2GLSL(shaderDesc.getStage(), shaderDesc.getByteCodes().data(), shaderDesc.getEntryPoint().data(), codes))
+		if (shaderDesc.getLanguage() == GraphicsShaderLang::GraphicsShaderLangHLSL)
 		{
-			this->getDevice()->downcast<OGLDevice>()->message("Can't conv hlsl to glsl.");
-			return false;
+			if (!HlslCodes2GLSL(shaderDesc.getStage(), shaderDesc.getByteCodes().data(), shaderDesc.getEntryPoint().data(), codes))
+			{
+				this->getDevice()->downcast<OGLDevice>()->message("Can't conv hlsl to glsl.");
+				return false;
+			}
 		}
-	}
-	else if (shaderDesc.getLanguage() == GraphicsShaderLang::GraphicsShaderLangHLSLbytecodes)
-	{
-		if (!HlslByteCodes2GLSL(shaderDesc.getStage(), shaderDesc.getByteCodes().data(), codes))
+		else if (shaderDesc.getLanguage() == GraphicsShaderLang::GraphicsShaderLangHLSLbytecodes)
 		{
-			this->getDevice()->downcast<OGLDevice>()->message("Can't conv hlslbytecodes to glsl.");
-			return false;
+			if (!HlslByteCodes2GLSL(shaderDesc.getStage(), shaderDesc.getByteCodes().data(), codes))
+			{
+				this->getDevice()->downcast<OGLDevice>()->message("Can't conv hlslbytecodes to glsl.");
+				return false;
+			}
 		}
+
+		if (shaderCache)
+			shaderCache->addShaderSource(_cacheKey, codes);
 	}
 
 	const char* source = codes.data();
@@ -374,6 +386,28 @@ OGLShader::getInstanceID() const noexcept
 	return _instance;
 }
 
+std::uint64_t
+OGLShader::getCacheKey() const noexcept
+{
+	return _cacheKey;
+}
+
+std::uint64_t
+OGLShader::makeCacheKey(const GraphicsShaderDesc& shaderDesc) noexcept
+{
+	// the translator flags and output language follow from the stage, so they need no extra bits
+	auto stage = shaderDesc.getStage();
+	auto lang = shaderDesc.getLanguage();
+	auto& codes = shaderDesc.getByteCodes();
+	auto& main = shaderDesc.getEntryPoint();
+
+	std::uint64_t key = OGLShaderCache::hash(codes.data(), codes.size());
+	key = OGLShaderCache::hash(main.data(), main.size(), key);
+	key = OGLShaderCache::hash(&stage, sizeof(stage), key);
+	key = OGLShaderCache::hash(&lang, sizeof(lang), key);
+	return key;
+}
+
 bool
 OGLShader::HlslCodes2GLSL(GraphicsShaderStageFlags stage, const std::string& codes, const std::string& main, std::string& out)
 {
@@ -518,27 +552,46 @@ OGLProgram::setup(const GraphicsProgramDesc& programDesc) noexcept
 		return false;
 	}
 
+	std::uint64_t key = 0;
 	for (auto& shader : programDesc.getShaders())
 	{
 		auto glshader = shader->downcast<OGLShader>();
 		if (glshader)
-			glAttachShader(_program, glshader->getInstanceID());
+		{
+			auto shaderKey = glshader->getCacheKey();
+			key = OGLShaderCache::hash(&shaderKey, sizeof(shaderKey), key);
+		}
 	}
 
-	glLinkProgram(_program);
-
-	GLint status = GL_FALSE;
-	glGetProgramiv(_program, GL_LINK_STATUS, &status);
-	if (!status)
+	if (!this->_loadProgramBinary(key))
 	{
-		GLint length = 0;
-		glGetProgramiv(_program, GL_INFO_LOG_LENGTH, &length);
+		for (auto& shader : programDesc.getShaders())
+		{
+			auto glshader = shader->downcast<OGLShader>();
+			if (glshader)
+				glAttachShader(_program, glshader->getInstanceID());
+		}
 
-		std::string log((std::size_t)length, 0);
-		glGetProgramInfoLog(_program, length, &length, (GLchar*)log.data());
+		if (this->getDevice()->downcast<OGLDevice>()->getShaderCache() && GLEW_ARB_get_program_binary)
+			glProgramParameteri(_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 
-		this->getDevice()->downcast<OGLDevice>()->message(log.c_str());
-		return false;
+		glLinkProgram(_program);
+
+		GLint status = GL_FALSE;
+		glGetProgramiv(_program, GL_LINK_STATUS, &status);
+		if (!status)
+		{
+			GLint length = 0;
+			glGetProgramiv(_program, GL_INFO_LOG_LENGTH, &length);
+
+			std::string log((std::size_t)length, 0);
+			glGetProgramInfoLog(_program, length, &length, (GLchar*)log.data());
+
+			this->getDevice()->downcast<OGLDevice>()->message(log.c_str());
+			return false;
+		}
+
+		this->_saveProgramBinary(key);
 	}
 
 	_initActiveAttribute();
@@ -586,6 +639,55 @@ OGLProgram::getActiveParams() const noexcept
 	return _activeParams;
 }
 
+bool
+OGLProgram::_loadProgramBinary(std::uint64_t key) noexcept
+{
+	auto& shaderCache = this->getDevice()->downcast<OGLDevice>()->getShaderCache();
+	if (!shaderCache || !GLEW_ARB_get_program_binary)
+		return false;
+
+	GLenum format = GL_NONE;
+	std::string binary;
+	if (!shaderCache->getProgramBinary(key, format, binary))
+		return false;
+
+	glProgramBinary(_program, format, binary.data(), (GLsizei)binary.size());
+
+	GLint status = GL_FALSE;
+	glGetProgramiv(_program, GL_LINK_STATUS, &status);
+	if (status)
+		return true;
+
+	// the driver refused its own binary (e.g. after an update), relink from source
+	shaderCache->removeProgramBinary(key);
+
+	glDeleteProgram(_program);
+	_program = glCreateProgram();
+	return false;
+}
+
+void
+OGLProgram::_saveProgramBinary(std::uint64_t key) noexcept
+{
+	auto& shaderCache = this->getDevice()->downcast<OGLDevice>()->getShaderCache();
+	if (!shaderCache || !GLEW_ARB_get_program_binary)
+		return;
+
+	GLint length = 0;
+	glGetProgramiv(_program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return;
+
+	GLenum format = GL_NONE;
+	std::string binary((std::size_t)length, 0);
+	glGetProgramBinary(_program, length, &length, &format, (void*)binary.data());
+	if (length <= 0)
+		return;
+
+	binary.resize((std::size_t)length);
+	shaderCache->addProgramBinary(key, format, std::move(binary));
+}
+
 void
 OGLProgram::_initActiveAttribute() noexcept
 {
@@ -685,6 +787,12 @@ OGLProgram::_initActiveUniform() noexcept
 			uniform->setBindingPoint(textureUnit);
 			textureUnit++;
 		}
+		else if (type == GL_SAMPLER_BUFFER)
+		{
+			glProgramUniform1i(_program, location, textureUnit);
+			uniform->setBindingPoint(textureUnit);
+			textureUnit++;
+		}
 
 		_activeParams.push_back(uniform);
 	}
@@ -815,6 +923,10 @@ OGLProgram::toGraphicsUniformType(const std::string& name, GLenum type) noexcept
 	{
 		return GraphicsUniformType::GraphicsUniformTypeSamplerImage;
 	}
+	else if (type == GL_SAMPLER_BUFFER)
+	{
+		return GraphicsUniformType::GraphicsUniformTypeUniformTexelBuffer;
+	}
 	else
 	{
 		bool isArray = strstr(name.c_str(), "[") != nullptr;
@@ -160,9 +160,13 @@ public:
 
 	GLuint getInstanceID() const noexcept;
 
+	std::uint64_t getCacheKey() const noexcept;
+
 	const GraphicsShaderDesc& getGraphicsShaderDesc() const noexcept;
 
 private:
+	static std::uint64_t makeCacheKey(const GraphicsShaderDesc& shaderDesc) noexcept;
+
 	bool HlslCodes2GLSL(GraphicsShaderStageFlags stage, const std::string& codes, const std::string& main, std::string& out);
 	bool HlslByteCodes2GLSL(GraphicsShaderStageFlags stage, const char* codes, std::string& out);
 
@@ -177,6 +181,7 @@ private:
 
 private:
 	GLuint _instance;
+	std::uint64_t _cacheKey;
 
 	GraphicsShaderDesc _shaderDesc;
 	GraphicsDeviceWeakPtr _device;
@@ -206,6 +211,9 @@ private:
 	void _initActiveUniform() noexcept;
 	void _initActiveUniformBlock() noexcept;
 
+	bool _loadProgramBinary(std::uint64_t key) noexcept;
+	void _saveProgramBinary(std::uint64_t key) noexcept;
+
 private:
 	static GraphicsFormat toGraphicsFormat(GLenum type) noexcept;
 	static GraphicsUniformType toGraphicsUniformType(const std::string& name, GLenum type) noexcept;
@@ -0,0 +1,333 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#include "ogl_shader_cache.h"
+#include <ray/fstream.h>
+
+_NAME_BEGIN
+
+namespace
+{
+	const std::uint32_t OGL_SHADER_CACHE_MAGIC = 0x434C4752; // RGLC
+	const std::uint32_t OGL_SHADER_CACHE_VERSION = 1;
+
+	enum OGLShaderCacheKind : std::uint32_t
+	{
+		OGLShaderCacheKindSource = 0,
+		OGLShaderCacheKindProgram = 1
+	};
+
+	struct OGLShaderCacheHeader
+	{
+		std::uint32_t magic;
+		std::uint32_t version;
+		std::uint32_t driverSize;
+		std::uint32_t entryCount;
+	};
+
+	struct OGLShaderCacheEntry
+	{
+		std::uint64_t key;
+		std::uint32_t kind;
+		std::uint32_t format;
+		std::uint32_t size;
+		std::uint32_t reserved;
+	};
+
+	std::string getDriverString() noexcept
+	{
+		std::string driver;
+
+		GLenum names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION };
+		for (auto name : names)
+		{
+			auto str = (const char*)glGetString(name);
+			if (str)
+				driver += str;
+			driver += '\n';
+		}
+
+		return driver;
+	}
+}
+
+OGLShaderCache::OGLShaderCache() noexcept
+	: _loaded(false)
+	, _dirty(false)
+	, _sourceHits(0)
+	, _sourceMisses(0)
+	, _programHits(0)
+	, _programMisses(0)
+{
+}
+
+OGLShaderCache::~OGLShaderCache() noexcept
+{
+	this->close();
+}
+
+bool
+OGLShaderCache::setup(const std::string& path) noexcept
+{
+	assert(!path.empty());
+
+	// the driver string needs a current context, so the file is read on first use
+	_path = path;
+	_loaded = false;
+	_dirty = false;
+	return true;
+}
+
+void
+OGLShaderCache::close() noexcept
+{
+	this->flush();
+
+	_sources.clear();
+	_programs.clear();
+
+	_loaded = false;
+	_sourceHits = _sourceMisses = 0;
+	_programHits = _programMisses = 0;
+}
+
+bool
+OGLShaderCache::getShaderSource(std::uint64_t key, std::string& source) noexcept
+{
+	if (!_loaded)
+		this->load();
+
+	auto it = _sources.find(key);
+	if (it == _sources.end())
+	{
+		_sourceMisses++;
+		return false;
+	}
+
+	_sourceHits++;
+	source = (*it).second;
+	return true;
+}
+
+void
+OGLShaderCache::addShaderSource(std::uint64_t key, const std::string& source) noexcept
+{
+	if (!_loaded)
+		this->load();
+
+	_sources[key] = source;
+	_dirty = true;
+}
+
+bool
+OGLShaderCache::getProgramBinary(std::uint64_t key, GLenum& format, std::string& binary) noexcept
+{
+	if (!_loaded)
+		this->load();
+
+	auto it = _programs.find(key);
+	if (it == _programs.end())
+	{
+		_programMisses++;
+		return false;
+	}
+
+	_programHits++;
+	format = (*it).second.format;
+	binary = (*it).second.data;
+	return true;
+}
+
+void
+OGLShaderCache::addProgramBinary(std::uint64_t key, GLenum format, std::string&& binary) noexcept
+{
+	if (!_loaded)
+		this->load();
+
+	auto& entry = _programs[key];
+	entry.format = format;
+	entry.data = std::move(binary);
+	_dirty = true;
+}
+
+void
+OGLShaderCache::removeProgramBinary(std::uint64_t key) noexcept
+{
+	if (_programs.erase(key))
+		_dirty = true;
+}
+
+bool
+OGLShaderCache::flush() noexcept
+{
+	if (!_dirty || _path.empty())
+		return true;
+
+	if (!this->save())
+		return false;
+
+	_dirty = false;
+	return true;
+}
+
+std::string
+OGLShaderCache::getStatistics() const noexcept
+{
+	char buffer[128];
+	std::snprintf(buffer, sizeof(buffer), "shader cache : %u/%u sources, %u/%u programs (hits/misses)",
+		_sourceHits, _sourceMisses, _programHits, _programMisses);
+	return buffer;
+}
+
+std::uint64_t
+OGLShaderCache::hash(const void* data, std::size_t length, std::uint64_t seed) noexcept
+{
+	auto bytes = (const std::uint8_t*)data;
+
+	std::uint64_t value = seed;
+	for (std::size_t i = 0; i < length; i++)
+	{
+		value ^= bytes[i];
+		value *= 1099511628211ULL;
+	}
+
+	return value;
+}
+
+bool
+OGLShaderCache::load() noexcept
+{
+	_loaded = true;
+	_driver = getDriverString();
+
+	ifstream stream;
+	if (!stream.open(_path))
+		return false;
+
+	OGLShaderCacheHeader header;
+	if (!stream.read((char*)&header, sizeof(header)))
+		return false;
+
+	if (header.magic != OGL_SHADER_CACHE_MAGIC || header.version != OGL_SHADER_CACHE_VERSION)
+		return false;
+
+	if (header.driverSize != _driver.size())
+		return false;
+
+	std::string driver(header.driverSize, 0);
+	if (!stream.read((char*)driver.data(), driver.size()))
+		return false;
+
+	// binaries and translations from another driver are useless, drop the whole file
+	if (driver != _driver)
+		return false;
+
+	for (std::uint32_t i = 0; i < header.entryCount; i++)
+	{
+		OGLShaderCacheEntry entry;
+		if (!stream.read((char*)&entry, sizeof(entry)))
+			break;
+
+		std::string data(entry.size, 0);
+		if (!stream.read((char*)data.data(), data.size()))
+			break;
+
+		if (entry.kind == OGLShaderCacheKindSource)
+			_sources[entry.key] = std::move(data);
+		else if (entry.kind == OGLShaderCacheKindProgram)
+		{
+			auto& program = _programs[entry.key];
+			program.format = entry.format;
+			program.data = std::move(data);
+		}
+	}
+
+	return true;
+}
+
+bool
+OGLShaderCache::save() noexcept
+{
+	ofstream stream;
+	if (!stream.open(_path))
+		return false;
+
+	OGLShaderCacheHeader header;
+	header.magic = OGL_SHADER_CACHE_MAGIC;
+	header.version = OGL_SHADER_CACHE_VERSION;
+	header.driverSize = (std::uint32_t)_driver.size();
+	header.entryCount = (std::uint32_t)(_sources.size() + _programs.size());
+
+	if (!stream.write((const char*)&header, sizeof(header)))
+		return false;
+
+	if (!stream.write(_driver.data(), _driver.size()))
+		return false;
+
+	for (auto& it : _sources)
+	{
+		OGLShaderCacheEntry entry;
+		entry.key = it.first;
+		entry.kind = OGLShaderCacheKindSource;
+		entry.format = 0;
+		entry.size = (std::uint32_t)it.second.size();
+		entry.reserved = 0;
+
+		if (!stream.write((const char*)&entry, sizeof(entry)))
+			return false;
+		if (!stream.write(it.second.data(), it.second.size()))
+			return false;
+	}
+
+	for (auto& it : _programs)
+	{
+		OGLShaderCacheEntry entry;
+		entry.key = it.first;
+		entry.kind = OGLShaderCacheKindProgram;
+		entry.format = it.second.format;
+		entry.size = (std::uint32_t)it.second.data.size();
+		entry.reserved = 0;
+
+		if (!stream.write((const char*)&entry, sizeof(entry)))
+			return false;
+		if (!stream.write(it.second.data.data(), it.second.data.size()))
+			return false;
+	}
+
+	return true;
+}
+
+_NAME_END
@@ -0,0 +1,101 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#ifndef _H_OGL_SHADER_CACHE_H_
+#define _H_OGL_SHADER_CACHE_H_
+
+#include "ogl_types.h"
+
+_NAME_BEGIN
+
+// Persistent cache of HLSL->GLSL translations and linked program binaries.
+// The whole cache lives in one file that is read at device setup and rewritten on close when
+// new entries were added. Entries are dropped as a whole when the driver string changes.
+class OGLShaderCache final
+{
+public:
+	OGLShaderCache() noexcept;
+	~OGLShaderCache() noexcept;
+
+	bool setup(const std::string& path) noexcept;
+	void close() noexcept;
+
+	bool getShaderSource(std::uint64_t key, std::string& source) noexcept;
+	void addShaderSource(std::uint64_t key, const std::string& source) noexcept;
+
+	bool getProgramBinary(std::uint64_t key, GLenum& format, std::string& binary) noexcept;
+	void addProgramBinary(std::uint64_t key, GLenum format, std::string&& binary) noexcept;
+	void removeProgramBinary(std::uint64_t key) noexcept;
+
+	bool flush() noexcept;
+
+	std::string getStatistics() const noexcept;
+
+	static std::uint64_t hash(const void* data, std::size_t length, std::uint64_t seed = 14695981039346656037ULL) noexcept;
+
+private:
+	bool load() noexcept;
+	bool save() noexcept;
+
+private:
+	OGLShaderCache(const OGLShaderCache&) noexcept = delete;
+	OGLShaderCache& operator=(const OGLShaderCache&) noexcept = delete;
+
+private:
+	struct Entry
+	{
+		GLenum format;
+		std::string data;
+	};
+
+	bool _loaded;
+	bool _dirty;
+
+	std::string _path;
+	std::string _driver;
+
+	std::map<std::uint64_t, std::string> _sources;
+	std::map<std::uint64_t, Entry> _programs;
+
+	std::uint32_t _sourceHits;
+	std::uint32_t _sourceMisses;
+	std::uint32_t _programHits;
+	std::uint32_t _programMisses;
+};
+
+_NAME_END
+
+#endif
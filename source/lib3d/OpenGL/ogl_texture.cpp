@@ -296,6 +296,38 @@ OGLTexture::unmap() noexcept
 	glUnmapNamedBuffer(_pbo);
 }
 
+bool
+OGLTexture::update(std::uint32_t x, std::uint32_t y, std::uint32_t w, std::uint32_t h, std::uint32_t mipLevel, const void* data) noexcept
+{
+	assert(data);
+	assert(_target == GL_TEXTURE_2D);
+
+	GLenum format = OGLTypes::asTextureFormat(_textureDesc.getTexFormat());
+	if (format == GL_INVALID_ENUM)
+	{
+		this->getDevice()->downcast<OGLDevice>()->message("Invalid texture format");
+		return false;
+	}
+
+	GLenum type = OGLTypes::asTextureType(_textureDesc.getTexFormat());
+	if (type == GL_INVALID_ENUM)
+	{
+		this->getDevice()->downcast<OGLDevice>()->message("Invalid texture type");
+		return false;
+	}
+
+	GLint oldUnpackStore = 1;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &oldUnpackStore);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GL_NONE);
+	glBindTexture(_target, _texture);
+	glTexSubImage2D(_target, mipLevel, x, y, w, h, format, type, data);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, oldUnpackStore);
+	return true;
+}
+
 GLenum
 OGLTexture::getTarget() const noexcept
 {
@@ -0,0 +1,278 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#include "ogl_transient_buffer.h"
+#include "ogl_device.h"
+#include "ogl_graphics_data.h"
+#include "ogl_core_graphics_data.h"
+
+_NAME_BEGIN
+
+__ImplementSubClass(OGLTransientBuffer, GraphicsTransientBuffer, "OGLTransientBuffer")
+
+OGLTransientBuffer::OGLTransientBuffer() noexcept
+	: _persistent(false)
+	, _frameReady(false)
+	, _buffer(GL_NONE)
+	, _mapped(nullptr)
+	, _mapBegin(0)
+	, _offset(0)
+	, _frameIndex(0)
+	, _frameNumber(0)
+	, _waitCount(0)
+{
+}
+
+OGLTransientBuffer::~OGLTransientBuffer() noexcept
+{
+	this->close();
+}
+
+bool
+OGLTransientBuffer::setup(const GraphicsTransientBufferDesc& desc) noexcept
+{
+	assert(!_data);
+	assert(desc.getFrameSize() > 0);
+	assert(desc.getFrameCount() > 0);
+
+	auto device = this->getDevice()->downcast<OGLDevice>();
+
+	// GL 4.4 buffer storage keeps the whole ring mapped, otherwise every frame maps its own window unsynchronized
+	_persistent = device->getGraphicsDeviceDesc().getDeviceType() == GraphicsDeviceType::GraphicsDeviceTypeOpenGLCore;
+
+	GraphicsUsageFlags usage = GraphicsUsageFlagBits::GraphicsUsageFlagWriteBit;
+	if (_persistent)
+		usage |= GraphicsUsageFlagBits::GraphicsUsageFlagPersistentBit | GraphicsUsageFlagBits::GraphicsUsageFlagCoherentBit;
+
+	GraphicsDataDesc dataDesc;
+	dataDesc.setType(desc.getType());
+	dataDesc.setUsage(usage);
+	dataDesc.setStreamSize(desc.getFrameSize() * desc.getFrameCount());
+
+	_data = device->createGraphicsData(dataDesc);
+	if (!_data)
+		return false;
+
+	if (_persistent)
+	{
+		_buffer = _data->downcast<OGLCoreGraphicsData>()->getInstanceID();
+
+		if (!_data->map(0, dataDesc.getStreamSize(), (void**)&_mapped))
+		{
+			device->message("Cannot map the transient buffer.");
+			return false;
+		}
+	}
+	else
+	{
+		_buffer = _data->downcast<OGLGraphicsData>()->getInstanceID();
+	}
+
+	_fences.resize(desc.getFrameCount(), nullptr);
+
+	_desc = desc;
+	return true;
+}
+
+void
+OGLTransientBuffer::close() noexcept
+{
+	if (!_data)
+		return;
+
+	this->flush();
+
+	if (_persistent && _mapped)
+	{
+		_data->unmap();
+		_mapped = nullptr;
+	}
+
+	for (auto& fence : _fences)
+	{
+		if (fence)
+		{
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+	}
+
+	auto device = this->getDevice();
+	if (device)
+		device->downcast<OGLDevice>()->message("Transient buffer : %u frames, %u waits.", static_cast<unsigned>(_frameNumber), static_cast<unsigned>(_waitCount));
+
+	_data.reset();
+	_buffer = GL_NONE;
+}
+
+bool
+OGLTransientBuffer::allocate(std::size_t size, std::size_t alignment, std::size_t& offset, void** data) noexcept
+{
+	assert(data);
+	assert(_data);
+
+	if (!_frameReady)
+	{
+		this->waitFrame();
+		_frameReady = true;
+	}
+
+	std::size_t frameSize = _desc.getFrameSize();
+	std::size_t frameBase = _frameIndex * frameSize;
+
+	std::size_t begin = _offset;
+	if (alignment > 1)
+		begin = (begin + alignment - 1) / alignment * alignment;
+
+	if (begin + size > frameSize)
+		return false;
+
+	if (_persistent)
+	{
+		*data = _mapped + frameBase + begin;
+	}
+	else
+	{
+		if (!_mapped)
+		{
+			// the fence of this region was waited, so the driver does not need to synchronize the map
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
+
+			glBindBuffer(GL_COPY_WRITE_BUFFER, _buffer);
+			_mapped = (std::uint8_t*)glMapBufferRange(GL_COPY_WRITE_BUFFER, frameBase + begin, frameSize - begin, flags);
+			if (!_mapped)
+				return false;
+
+			_mapBegin = begin;
+		}
+
+		*data = _mapped + (begin - _mapBegin);
+	}
+
+	offset = frameBase + begin;
+	_offset = begin + size;
+	return true;
+}
+
+void
+OGLTransientBuffer::flush() noexcept
+{
+	if (_persistent || !_mapped)
+		return;
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, _buffer);
+	glFlushMappedBufferRange(GL_COPY_WRITE_BUFFER, 0, _offset - _mapBegin);
+	glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+
+	_mapped = nullptr;
+}
+
+void
+OGLTransientBuffer::frameEnd() noexcept
+{
+	this->flush();
+
+	auto& fence = _fences[_frameIndex];
+	if (fence)
+		glDeleteSync(fence);
+
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	_frameIndex = (_frameIndex + 1) % _fences.size();
+	_frameNumber++;
+	_frameReady = false;
+	_offset = 0;
+}
+
+void
+OGLTransientBuffer::waitFrame() noexcept
+{
+	auto& fence = _fences[_frameIndex];
+	if (!fence)
+		return;
+
+	GLenum result = glClientWaitSync(fence, 0, 0);
+	if (result == GL_TIMEOUT_EXPIRED)
+	{
+		_waitCount++;
+
+		do
+		{
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		} while (result == GL_TIMEOUT_EXPIRED);
+	}
+
+	glDeleteSync(fence);
+	fence = nullptr;
+}
+
+const GraphicsDataPtr&
+OGLTransientBuffer::getGraphicsData() const noexcept
+{
+	return _data;
+}
+
+std::size_t
+OGLTransientBuffer::getWaitCount() const noexcept
+{
+	return _waitCount;
+}
+
+std::size_t
+OGLTransientBuffer::getFrameNumber() const noexcept
+{
+	return _frameNumber;
+}
+
+const GraphicsTransientBufferDesc&
+OGLTransientBuffer::getGraphicsTransientBufferDesc() const noexcept
+{
+	return _desc;
+}
+
+void
+OGLTransientBuffer::setDevice(const GraphicsDevicePtr& device) noexcept
+{
+	_device = device;
+}
+
+GraphicsDevicePtr
+OGLTransientBuffer::getDevice() noexcept
+{
+	return _device.lock();
+}
+
+_NAME_END
\ No newline at end of file
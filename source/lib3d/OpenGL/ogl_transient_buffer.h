@@ -0,0 +1,102 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#ifndef _H_OGL_TRANSIENT_BUFFER_H_
+#define _H_OGL_TRANSIENT_BUFFER_H_
+
+#include <ray/graphics_transient_buffer.h>
+
+#include "ogl_types.h"
+
+_NAME_BEGIN
+
+class OGLTransientBuffer final : public GraphicsTransientBuffer
+{
+	__DeclareSubClass(OGLTransientBuffer, GraphicsTransientBuffer)
+public:
+	OGLTransientBuffer() noexcept;
+	virtual ~OGLTransientBuffer() noexcept;
+
+	bool setup(const GraphicsTransientBufferDesc& desc) noexcept;
+	void close() noexcept;
+
+	bool allocate(std::size_t size, std::size_t alignment, std::size_t& offset, void** data) noexcept;
+
+	void flush() noexcept;
+	void frameEnd() noexcept;
+
+	const GraphicsDataPtr& getGraphicsData() const noexcept;
+
+	std::size_t getWaitCount() const noexcept;
+	std::size_t getFrameNumber() const noexcept;
+
+	const GraphicsTransientBufferDesc& getGraphicsTransientBufferDesc() const noexcept;
+
+private:
+	void waitFrame() noexcept;
+
+private:
+	friend class OGLDevice;
+	void setDevice(const GraphicsDevicePtr& device) noexcept;
+	GraphicsDevicePtr getDevice() noexcept;
+
+private:
+	OGLTransientBuffer(const OGLTransientBuffer&) noexcept = delete;
+	OGLTransientBuffer& operator=(const OGLTransientBuffer&) noexcept = delete;
+
+private:
+	bool _persistent;
+	bool _frameReady;
+
+	GLuint _buffer;
+	std::uint8_t* _mapped;
+	std::size_t _mapBegin;
+
+	std::size_t _offset;
+	std::size_t _frameIndex;
+	std::size_t _frameNumber;
+	std::size_t _waitCount;
+
+	std::vector<GLsync> _fences;
+
+	GraphicsDataPtr _data;
+	GraphicsTransientBufferDesc _desc;
+	GraphicsDeviceWeakPtr _device;
+};
+
+_NAME_END
+
+#endif
\ No newline at end of file
@@ -111,6 +111,7 @@ typedef std::shared_ptr<class OGLDescriptorSetLayout> OGLDescriptorSetLayoutPtr;
 typedef std::shared_ptr<class OGLGraphicsAttribute> OGLGraphicsAttributePtr;
 typedef std::shared_ptr<class OGLGraphicsUniform> OGLGraphicsUniformPtr;
 typedef std::shared_ptr<class OGLGraphicsUniformBlock> OGLGraphicsUniformBlockPtr;
+typedef std::shared_ptr<class OGLShaderCache> OGLShaderCachePtr;
 
 typedef std::shared_ptr<class OGLCoreDeviceContext> OGLCoreDeviceContextPtr;
 typedef std::shared_ptr<class OGLCoreFramebuffer> OGLCoreFramebufferPtr;
@@ -302,6 +302,18 @@ VulkanDevice::createDescriptorPool(const GraphicsDescriptorPoolDesc& desc) noexc
 	return nullptr;
 }
 
+GraphicsTransientBufferPtr
+VulkanDevice::createTransientBuffer(const GraphicsTransientBufferDesc& desc) noexcept
+{
+	return nullptr;
+}
+
+GraphicsQueryPtr
+VulkanDevice::createQuery(const GraphicsQueryDesc& desc) noexcept
+{
+	return nullptr;
+}
+
 GraphicsCommandQueuePtr
 VulkanDevice::createCommandQueue(const GraphicsCommandQueueDesc& desc) noexcept
 {
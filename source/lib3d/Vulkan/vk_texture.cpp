@@ -230,6 +230,13 @@ VulkanTexture::unmap() noexcept
 	_vkMemory.unmap();
 }
 
+bool
+VulkanTexture::update(std::uint32_t x, std::uint32_t y, std::uint32_t w, std::uint32_t h, std::uint32_t mipLevel, const void* data) noexcept
+{
+	assert(false);
+	return false;
+}
+
 void
 VulkanTexture::setSwapchainImage(VkImage image) noexcept
 {
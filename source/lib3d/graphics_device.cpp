@@ -67,6 +67,18 @@ GraphicsDeviceDesc::getDeviceType() const noexcept
 	return _deviceType;
 }
 
+void
+GraphicsDeviceDesc::setShaderCachePath(const std::string& path) noexcept
+{
+	_shaderCachePath = path;
+}
+
+const std::string&
+GraphicsDeviceDesc::getShaderCachePath() const noexcept
+{
+	return _shaderCachePath;
+}
+
 GraphicsDevice::GraphicsDevice() noexcept
 {
 }
@@ -2,7 +2,7 @@
 // | Project : ray.
 // | All rights reserved.
 // +----------------------------------------------------------------------
-// | Copyright (c) 2013-2014.
+// | Copyright (c) 2013-2017.
 // +----------------------------------------------------------------------
 // | * Redistribution and use of this software in source and binary forms,
 // |   with or without modification, are permitted provided that the following
@@ -34,31 +34,44 @@
 // | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // +----------------------------------------------------------------------
-#include <ray/frustum_cull.h>
+#include <ray/graphics_query.h>
 
 _NAME_BEGIN
 
-FrustumCull::FrustumCull() noexcept
+__ImplementSubInterface(GraphicsQuery, GraphicsChild, "GraphicsQuery")
+
+GraphicsQueryDesc::GraphicsQueryDesc() noexcept
+	: _type(GraphicsQueryType::GraphicsQueryTypeSamplesPassed)
+{
+}
+
+GraphicsQueryDesc::GraphicsQueryDesc(GraphicsQueryType type) noexcept
+	: _type(type)
+{
+}
+
+GraphicsQueryDesc::~GraphicsQueryDesc() noexcept
 {
 }
 
 void
-FrustumCull::traverse() noexcept
+GraphicsQueryDesc::setType(GraphicsQueryType type) noexcept
 {
-    while (!_distanceQueue.empty())
-    {
-        OcclusionObjectPtr object = _distanceQueue.front();
-        _distanceQueue.pop();
+	_type = type;
+}
 
-        if (_tree->isVisiable(object))
-        {
-            this->traverseObject(object);
-        }
-        else
-        {
-            _frustumCulledCount++;
-        }
-    }
+GraphicsQueryType
+GraphicsQueryDesc::getType() const noexcept
+{
+	return _type;
+}
+
+GraphicsQuery::GraphicsQuery() noexcept
+{
+}
+
+GraphicsQuery::~GraphicsQuery() noexcept
+{
 }
 
 _NAME_END
\ No newline at end of file
@@ -0,0 +1,105 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#include <ray/graphics_transient_buffer.h>
+
+_NAME_BEGIN
+
+__ImplementSubInterface(GraphicsTransientBuffer, GraphicsChild, "GraphicsTransientBuffer")
+
+GraphicsTransientBufferDesc::GraphicsTransientBufferDesc() noexcept
+	: _type(GraphicsDataType::GraphicsDataTypeNone)
+	, _frameSize(0)
+	, _frameCount(3)
+{
+}
+
+GraphicsTransientBufferDesc::GraphicsTransientBufferDesc(GraphicsDataType type, std::size_t frameSize, std::uint32_t frameCount) noexcept
+	: _type(type)
+	, _frameSize(frameSize)
+	, _frameCount(frameCount)
+{
+}
+
+GraphicsTransientBufferDesc::~GraphicsTransientBufferDesc() noexcept
+{
+}
+
+void
+GraphicsTransientBufferDesc::setType(GraphicsDataType type) noexcept
+{
+	_type = type;
+}
+
+GraphicsDataType
+GraphicsTransientBufferDesc::getType() const noexcept
+{
+	return _type;
+}
+
+void
+GraphicsTransientBufferDesc::setFrameSize(std::size_t size) noexcept
+{
+	_frameSize = size;
+}
+
+std::size_t
+GraphicsTransientBufferDesc::getFrameSize() const noexcept
+{
+	return _frameSize;
+}
+
+void
+GraphicsTransientBufferDesc::setFrameCount(std::uint32_t count) noexcept
+{
+	_frameCount = count;
+}
+
+std::uint32_t
+GraphicsTransientBufferDesc::getFrameCount() const noexcept
+{
+	return _frameCount;
+}
+
+GraphicsTransientBuffer::GraphicsTransientBuffer() noexcept
+{
+}
+
+GraphicsTransientBuffer::~GraphicsTransientBuffer() noexcept
+{
+}
+
+_NAME_END
\ No newline at end of file
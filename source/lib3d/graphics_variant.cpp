@@ -144,7 +144,9 @@ GraphicsVariant::setType(GraphicsUniformType type) noexcept
 			delete _value.m4array;
 			_value.m4array = nullptr;
 		}
-		else if (_type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer)
+		else if (_type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer ||
+			_type == GraphicsUniformType::GraphicsUniformTypeUniformTexelBuffer ||
+			_type == GraphicsUniformType::GraphicsUniformTypeStorageTexelBuffer)
 		{
 			delete _value.ubo;
 			_value.ubo = nullptr;
@@ -196,7 +198,9 @@ GraphicsVariant::setType(GraphicsUniformType type) noexcept
 			_value.m3array = new std::vector<float3x3>;
 		else if (type == GraphicsUniformType::GraphicsUniformTypeFloat4x4Array)
 			_value.m4array = new std::vector<float4x4>;
-		else if (type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer)
+		else if (type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer ||
+			type == GraphicsUniformType::GraphicsUniformTypeUniformTexelBuffer ||
+			type == GraphicsUniformType::GraphicsUniformTypeStorageTexelBuffer)
 			_value.ubo = new GraphicsDataPtr;
 		else if (type == GraphicsUniformType::GraphicsUniformTypeSamplerImage ||
 			type == GraphicsUniformType::GraphicsUniformTypeStorageImage ||
@@ -696,7 +700,7 @@ GraphicsVariant::uniformTexture(GraphicsTexturePtr texture, GraphicsSamplerPtr s
 void
 GraphicsVariant::uniformBuffer(GraphicsDataPtr ubo) noexcept
 {
-	assert(_type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer);
+	assert(_type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer || _type == GraphicsUniformType::GraphicsUniformTypeUniformTexelBuffer || _type == GraphicsUniformType::GraphicsUniformTypeStorageTexelBuffer);
 	*_value.ubo = ubo;
 }
 
@@ -934,7 +938,7 @@ GraphicsVariant::getTextureSampler() const noexcept
 const GraphicsDataPtr&
 GraphicsVariant::getBuffer() const noexcept
 {
-	assert(_type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer);
+	assert(_type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer || _type == GraphicsUniformType::GraphicsUniformTypeUniformTexelBuffer || _type == GraphicsUniformType::GraphicsUniformTypeStorageTexelBuffer);
 	return *_value.ubo;
 }
 
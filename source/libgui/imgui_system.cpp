@@ -37,6 +37,7 @@
 #include <ray/imgui_system.h>
 #include <ray/render_system.h>
 #include <ray/graphics_data.h>
+#include <ray/graphics_transient_buffer.h>
 #include <ray/graphics_texture.h>
 #include <ray/material.h>
 #include <ray/ioserver.h>
@@ -47,6 +48,26 @@ _NAME_BEGIN
 
 __ImplementSingleton(IMGUISystem)
 
+namespace
+{
+	// Suballocates from a transient buffer, replacing it by one with twice the frame size when the frame is full
+	bool allocateTransient(GraphicsTransientBufferPtr& buffer, std::size_t size, std::size_t alignment, std::size_t& offset, void** data) noexcept
+	{
+		if (buffer->allocate(size, alignment, offset, data))
+			return true;
+
+		auto desc = buffer->getGraphicsTransientBufferDesc();
+		desc.setFrameSize(std::max(size, desc.getFrameSize() * 2));
+
+		auto transient = RenderSystem::instance()->createTransientBuffer(desc);
+		if (!transient)
+			return false;
+
+		buffer = std::move(transient);
+		return buffer->allocate(size, alignment, offset, data);
+	}
+}
+
 IMGUISystem::IMGUISystem() noexcept
 	: _initialize(false)
 {
@@ -150,6 +171,10 @@ IMGUISystem::open(void* _window, float dpi) except
 	if (!_ibo)
 		return false;
 
+	// backends without transient buffers keep mapping _vbo and _ibo every frame
+	_transientVbo = RenderSystem::instance()->createTransientBuffer(ray::GraphicsTransientBufferDesc(ray::GraphicsDataType::GraphicsDataTypeStorageVertexBuffer, 65536 * sizeof(ImDrawVert)));
+	_transientIbo = RenderSystem::instance()->createTransientBuffer(ray::GraphicsTransientBufferDesc(ray::GraphicsDataType::GraphicsDataTypeStorageIndexBuffer, 65536 * sizeof(ImDrawIdx)));
+
 	_material = RenderSystem::instance()->createMaterial("sys:fx/uilayout.fxml");
 	if (!_material)
 		return false;
@@ -171,6 +196,8 @@ IMGUISystem::close() noexcept
 {
 	_vbo.reset();
 	_ibo.reset();
+	_transientVbo.reset();
+	_transientIbo.reset();
 	_texture.reset();
 	_material.reset();
 
@@ -334,38 +361,62 @@ IMGUISystem::render(float delta) except
 	if (totalVertexSize == 0 || totalIndirectSize == 0)
 		return;
 
-	if (!_vbo || _vbo->getGraphicsDataDesc().getStreamSize() < totalVertexSize)
+	ImDrawVert* vbo;
+	ImDrawIdx* ibo;
+
+	GraphicsDataPtr vertexData;
+	GraphicsDataPtr indexData;
+
+	std::size_t vertexOffset = 0;
+	std::size_t indexOffset = 0;
+
+	bool transient = _transientVbo && _transientIbo;
+	if (transient)
 	{
-		ray::GraphicsDataDesc dataDesc;
-		dataDesc.setType(ray::GraphicsDataType::GraphicsDataTypeStorageVertexBuffer);
-		dataDesc.setStream(0);
-		dataDesc.setStreamSize(totalVertexSize);
-		dataDesc.setUsage(_vbo->getGraphicsDataDesc().getUsage());
-		_vbo = renderer->createGraphicsData(dataDesc);
-		if (!_vbo)
+		if (!allocateTransient(_transientVbo, totalVertexSize, sizeof(ImDrawVert), vertexOffset, (void**)&vbo))
 			return;
-	}
 
-	if (!_ibo || _ibo->getGraphicsDataDesc().getStreamSize() < totalIndirectSize)
-	{
-		ray::GraphicsDataDesc elementDesc;
-		elementDesc.setType(ray::GraphicsDataType::GraphicsDataTypeStorageIndexBuffer);
-		elementDesc.setStream(0);
-		elementDesc.setStreamSize(totalIndirectSize);
-		elementDesc.setUsage(_ibo->getGraphicsDataDesc().getUsage());
-		_ibo = renderer->createGraphicsData(elementDesc);
-		if (!_ibo)
+		if (!allocateTransient(_transientIbo, totalIndirectSize, sizeof(ImDrawIdx), indexOffset, (void**)&ibo))
 			return;
+
+		vertexData = _transientVbo->getGraphicsData();
+		indexData = _transientIbo->getGraphicsData();
 	}
+	else
+	{
+		if (_vbo->getGraphicsDataDesc().getStreamSize() < totalVertexSize)
+		{
+			ray::GraphicsDataDesc dataDesc;
+			dataDesc.setType(ray::GraphicsDataType::GraphicsDataTypeStorageVertexBuffer);
+			dataDesc.setStream(0);
+			dataDesc.setStreamSize(totalVertexSize);
+			dataDesc.setUsage(_vbo->getGraphicsDataDesc().getUsage());
+			_vbo = renderer->createGraphicsData(dataDesc);
+			if (!_vbo)
+				return;
+		}
 
-	ImDrawVert* vbo;
-	ImDrawIdx* ibo;
+		if (_ibo->getGraphicsDataDesc().getStreamSize() < totalIndirectSize)
+		{
+			ray::GraphicsDataDesc elementDesc;
+			elementDesc.setType(ray::GraphicsDataType::GraphicsDataTypeStorageIndexBuffer);
+			elementDesc.setStream(0);
+			elementDesc.setStreamSize(totalIndirectSize);
+			elementDesc.setUsage(_ibo->getGraphicsDataDesc().getUsage());
+			_ibo = renderer->createGraphicsData(elementDesc);
+			if (!_ibo)
+				return;
+		}
 
-	if (!_vbo->map(0, totalVertexSize, (void**)&vbo))
-		return;
+		if (!_vbo->map(0, totalVertexSize, (void**)&vbo))
+			return;
 
-	if (!_ibo->map(0, totalIndirectSize, (void**)&ibo))
-		return;
+		if (!_ibo->map(0, totalIndirectSize, (void**)&ibo))
+			return;
+
+		vertexData = _vbo;
+		indexData = _ibo;
+	}
 
 	for (int n = 0; n < drawData->CmdListsCount; n++)
 	{
@@ -376,8 +427,16 @@ IMGUISystem::render(float delta) except
 		ibo += cmd_list->IdxBuffer.size();
 	}
 
-	_vbo->unmap();
-	_ibo->unmap();
+	if (transient)
+	{
+		_transientVbo->flush();
+		_transientIbo->flush();
+	}
+	else
+	{
+		_vbo->unmap();
+		_ibo->unmap();
+	}
 
 	auto& io = ImGui::GetIO();
 
@@ -385,8 +444,8 @@ IMGUISystem::render(float delta) except
 	renderer->setViewport(0, ray::Viewport(0, 0, io.DisplayFramebufferScale.x, io.DisplayFramebufferScale.y));
 	renderer->setScissor(0, ray::Scissor(0, 0, io.DisplayFramebufferScale.x, io.DisplayFramebufferScale.y));
 
-	renderer->setVertexBuffer(0, _vbo, 0);
-	renderer->setIndexBuffer(_ibo, 0, ray::GraphicsIndexType::GraphicsIndexTypeUInt16);
+	renderer->setVertexBuffer(0, vertexData, vertexOffset);
+	renderer->setIndexBuffer(indexData, indexOffset, ray::GraphicsIndexType::GraphicsIndexTypeUInt16);
 
 	std::uint32_t vdx_buffer_offset = 0;
 	std::uint32_t idx_buffer_offset = 0;
@@ -415,6 +474,12 @@ IMGUISystem::render(float delta) except
 
 		vdx_buffer_offset += cmd_list->VtxBuffer.size();
 	}
+
+	if (transient)
+	{
+		_transientVbo->frameEnd();
+		_transientIbo->frameEnd();
+	}
 }
 
 _NAME_END
\ No newline at end of file
@@ -36,6 +36,11 @@
 // +----------------------------------------------------------------------
 #include <ray/imagcubemap.h>
 #include <ray/SH.h>
+#include <ray/thread.h>
+
+#if defined(__SSE2__)
+#	include <emmintrin.h>
+#endif
 
 _NAME_BEGIN
 
@@ -458,6 +463,426 @@ namespace image
 			return false;
 		}
 	}
+
+	struct SH9Accumulator
+	{
+		double coeff[9][3];
+		double weight;
+	};
+
+	static inline void accumulateSH9(SH9Accumulator& accum, const float dir[3], const float* color, float weight) noexcept
+	{
+		const float x = dir[0];
+		const float y = dir[1];
+		const float z = dir[2];
+
+		const float basis[9] =
+		{
+			0.282095f,
+			-0.488603f * y,
+			0.488603f * z,
+			-0.488603f * x,
+			1.092548f * x * y,
+			-1.092548f * y * z,
+			0.315392f * (3.0f * z * z - 1.0f),
+			-1.092548f * x * z,
+			0.546274f * (x * x - y * y),
+		};
+
+		for (std::uint8_t i = 0; i < 9; i++)
+		{
+			accum.coeff[i][0] += color[0] * basis[i] * weight;
+			accum.coeff[i][1] += color[1] * basis[i] * weight;
+			accum.coeff[i][2] += color[2] * basis[i] * weight;
+		}
+
+		accum.weight += weight;
+	}
+
+	static void projectCubefaceRowToSH9(SH9Accumulator& accum, const float* row, std::uint32_t size, std::uint8_t channel, std::uint8_t face, float v) noexcept
+	{
+		const float* uAxis = s_faceUvVectors[face][0];
+		const float* vAxis = s_faceUvVectors[face][1];
+		const float* axis = s_faceUvVectors[face][2];
+
+		const float invSize = 2.0f / size;
+
+		std::uint32_t x = 0;
+
+#if defined(__SSE2__)
+		__m128 sum[27];
+		for (std::uint8_t i = 0; i < 27; i++)
+			sum[i] = _mm_setzero_ps();
+
+		__m128 weightSum = _mm_setzero_ps();
+
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 vv = _mm_set1_ps(v);
+
+		for (; x + 4 <= size; x += 4)
+		{
+			const __m128 u = _mm_sub_ps(_mm_mul_ps(_mm_set_ps(x + 3.5f, x + 2.5f, x + 1.5f, x + 0.5f), _mm_set1_ps(invSize)), one);
+
+			const __m128 temp = _mm_add_ps(one, _mm_add_ps(_mm_mul_ps(u, u), _mm_mul_ps(vv, vv)));
+			const __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(temp));
+			const __m128 weight = _mm_div_ps(_mm_mul_ps(_mm_set1_ps(4.0f), invLength), temp);
+
+			__m128 dir[3];
+			for (std::uint8_t i = 0; i < 3; i++)
+			{
+				dir[i] = _mm_add_ps(_mm_set1_ps(axis[i]), _mm_add_ps(_mm_mul_ps(u, _mm_set1_ps(uAxis[i])), _mm_mul_ps(vv, _mm_set1_ps(vAxis[i]))));
+				dir[i] = _mm_mul_ps(dir[i], invLength);
+			}
+
+			const __m128 basis[9] =
+			{
+				_mm_set1_ps(0.282095f),
+				_mm_mul_ps(_mm_set1_ps(-0.488603f), dir[1]),
+				_mm_mul_ps(_mm_set1_ps(0.488603f), dir[2]),
+				_mm_mul_ps(_mm_set1_ps(-0.488603f), dir[0]),
+				_mm_mul_ps(_mm_set1_ps(1.092548f), _mm_mul_ps(dir[0], dir[1])),
+				_mm_mul_ps(_mm_set1_ps(-1.092548f), _mm_mul_ps(dir[1], dir[2])),
+				_mm_mul_ps(_mm_set1_ps(0.315392f), _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(3.0f), _mm_mul_ps(dir[2], dir[2])), one)),
+				_mm_mul_ps(_mm_set1_ps(-1.092548f), _mm_mul_ps(dir[0], dir[2])),
+				_mm_mul_ps(_mm_set1_ps(0.546274f), _mm_sub_ps(_mm_mul_ps(dir[0], dir[0]), _mm_mul_ps(dir[1], dir[1]))),
+			};
+
+			const float* p0 = row + (x + 0) * channel;
+			const float* p1 = row + (x + 1) * channel;
+			const float* p2 = row + (x + 2) * channel;
+			const float* p3 = row + (x + 3) * channel;
+
+			const __m128 color[3] =
+			{
+				_mm_mul_ps(_mm_set_ps(p3[0], p2[0], p1[0], p0[0]), weight),
+				_mm_mul_ps(_mm_set_ps(p3[1], p2[1], p1[1], p0[1]), weight),
+				_mm_mul_ps(_mm_set_ps(p3[2], p2[2], p1[2], p0[2]), weight),
+			};
+
+			for (std::uint8_t i = 0; i < 9; i++)
+			{
+				sum[i * 3 + 0] = _mm_add_ps(sum[i * 3 + 0], _mm_mul_ps(color[0], basis[i]));
+				sum[i * 3 + 1] = _mm_add_ps(sum[i * 3 + 1], _mm_mul_ps(color[1], basis[i]));
+				sum[i * 3 + 2] = _mm_add_ps(sum[i * 3 + 2], _mm_mul_ps(color[2], basis[i]));
+			}
+
+			weightSum = _mm_add_ps(weightSum, weight);
+		}
+
+		float lanes[4];
+		for (std::uint8_t i = 0; i < 27; i++)
+		{
+			_mm_storeu_ps(lanes, sum[i]);
+			accum.coeff[i / 3][i % 3] += (double)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+		}
+
+		_mm_storeu_ps(lanes, weightSum);
+		accum.weight += (double)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+
+		for (; x < size; x++)
+		{
+			const float u = (x + 0.5f) * invSize - 1.0f;
+			const float temp = 1.0f + u * u + v * v;
+			const float invLength = 1.0f / std::sqrt(temp);
+
+			float dir[3];
+			for (std::uint8_t i = 0; i < 3; i++)
+				dir[i] = (axis[i] + u * uAxis[i] + v * vAxis[i]) * invLength;
+
+			accumulateSH9(accum, dir, row + x * channel, 4.0f * invLength / temp);
+		}
+	}
+
+	bool makeSH9FromCubemap(SH9Color& dst, const Image& src) noexcept
+	{
+		if (!isCubemap(src))
+			return false;
+
+		if (src.value_type() != image::value_t::Float || src.type_size() != 4)
+			return false;
+
+		if (src.channel() != 3 && src.channel() != 4)
+			return false;
+
+		const std::uint8_t channel = src.channel();
+		const std::uint32_t size = src.width();
+		const std::uint32_t bandRows = 16;
+		const std::uint32_t numBands = (size + bandRows - 1) / bandRows;
+
+		try
+		{
+			std::vector<SH9Accumulator> accums(6 * numBands);
+			std::memset(accums.data(), 0, accums.size() * sizeof(SH9Accumulator));
+
+			parallelFor(6 * numBands, [&](std::uint32_t task)
+			{
+				const std::uint8_t face = task / numBands;
+				const std::uint32_t band = task % numBands;
+				const float* faceData = (const float*)src.data() + face * size * size * channel;
+
+				for (std::uint32_t y = band * bandRows; y < std::min(band * bandRows + bandRows, size); y++)
+				{
+					const float v = (y + 0.5f) * 2.0f / size - 1.0f;
+					projectCubefaceRowToSH9(accums[task], faceData + y * size * channel, size, channel, face, v);
+				}
+			});
+
+			SH9Accumulator result;
+			std::memset(&result, 0, sizeof(result));
+
+			for (auto& it : accums)
+			{
+				for (std::uint8_t i = 0; i < 9; i++)
+				{
+					result.coeff[i][0] += it.coeff[i][0];
+					result.coeff[i][1] += it.coeff[i][1];
+					result.coeff[i][2] += it.coeff[i][2];
+				}
+
+				result.weight += it.weight;
+			}
+
+			const double norm = (4.0 * M_PI) / result.weight;
+
+			for (std::uint8_t i = 0; i < 9; i++)
+				dst.coeff[i].set(float(result.coeff[i][0] * norm), float(result.coeff[i][1] * norm), float(result.coeff[i][2] * norm));
+
+			return true;
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
+
+	struct CubemapLevel
+	{
+		const float* data;
+		std::uint32_t size;
+	};
+
+	static inline void sampleCubemapLevel(float result[3], const CubemapLevel& level, const float dir[3]) noexcept
+	{
+		float u;
+		float v;
+		std::uint8_t face;
+		vecToTexelCoord(u, v, face, dir);
+
+		const float xf = std::max(u * level.size - 0.5f, 0.0f);
+		const float yf = std::max(v * level.size - 0.5f, 0.0f);
+
+		const std::uint32_t x0 = std::min((std::uint32_t)xf, level.size - 1);
+		const std::uint32_t y0 = std::min((std::uint32_t)yf, level.size - 1);
+		const std::uint32_t x1 = std::min(x0 + 1, level.size - 1);
+		const std::uint32_t y1 = std::min(y0 + 1, level.size - 1);
+
+		const float tx = math::clamp(xf - x0, 0.0f, 1.0f);
+		const float ty = math::clamp(yf - y0, 0.0f, 1.0f);
+
+		const float* faceData = level.data + face * level.size * level.size * 3;
+		const float* p0 = faceData + (y0 * level.size + x0) * 3;
+		const float* p1 = faceData + (y0 * level.size + x1) * 3;
+		const float* p2 = faceData + (y1 * level.size + x0) * 3;
+		const float* p3 = faceData + (y1 * level.size + x1) * 3;
+
+		for (std::uint8_t i = 0; i < 3; i++)
+			result[i] = (p0[i] * (1.0f - tx) + p1[i] * tx) * (1.0f - ty) + (p2[i] * (1.0f - tx) + p3[i] * tx) * ty;
+	}
+
+	static inline float radicalInverse(std::uint32_t bits) noexcept
+	{
+		bits = (bits << 16u) | (bits >> 16u);
+		bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+		bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+		bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+		bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+		return float(bits) * 2.3283064365386963e-10f;
+	}
+
+	bool makePrefilteredCubemap(Image& dst, const Image& src, std::uint32_t sampleCount) noexcept
+	{
+		assert(sampleCount > 0);
+
+		if (!isCubemap(src))
+			return false;
+
+		if (src.value_type() != image::value_t::Float || src.type_size() != 4)
+			return false;
+
+		if (src.channel() != 3 && src.channel() != 4)
+			return false;
+
+		const std::uint8_t channel = src.channel();
+		const std::uint32_t size = src.width();
+		const std::uint32_t numLevels = (std::uint32_t)std::floor(std::log2(size)) + 1;
+		const std::uint32_t numSamples = (sampleCount + 3) & ~3u;
+		const std::uint32_t bandRows = 16;
+
+		Image radiance;
+		if (!radiance.create(size, size, 6, image::format_t::R32G32B32SFloat, false))
+			return false;
+
+		const float* srcData = (const float*)src.data();
+		float* radianceData = (float*)radiance.data();
+		for (std::size_t i = 0; i < size * size * 6; i++)
+		{
+			radianceData[i * 3 + 0] = srcData[i * channel + 0];
+			radianceData[i * 3 + 1] = srcData[i * channel + 1];
+			radianceData[i * 3 + 2] = srcData[i * channel + 2];
+		}
+
+		if (!radiance.generateMipmaps(filter_t::Box))
+			return false;
+
+		if (!dst.create(size, size, 6, image::format_t::R32G32B32SFloat, numLevels, 1, 0, 0, false))
+			return false;
+
+		std::vector<CubemapLevel> levels(numLevels);
+		std::vector<float*> dstLevels(numLevels);
+
+		std::size_t offset = 0;
+		for (std::uint32_t mip = 0; mip < numLevels; mip++)
+		{
+			levels[mip].data = (const float*)radiance.data() + offset;
+			levels[mip].size = std::max(size >> mip, 1u);
+			dstLevels[mip] = (float*)dst.data() + offset;
+			offset += levels[mip].size * levels[mip].size * 6 * 3;
+		}
+
+		std::memcpy(dstLevels[0], levels[0].data, size * size * 6 * 3 * sizeof(float));
+
+		try
+		{
+			std::vector<float> samples(numSamples * 5);
+
+			for (std::uint32_t mip = 1; mip < numLevels; mip++)
+			{
+				const float roughness = float(mip) / (numLevels - 1);
+				const float alpha = roughness * roughness;
+				const float alpha2 = alpha * alpha;
+				const float texelSolidAngle = 4.0f * M_PI / (6.0f * size * size);
+
+				float* sampleX = samples.data();
+				float* sampleY = sampleX + numSamples;
+				float* sampleZ = sampleY + numSamples;
+				float* sampleWeight = sampleZ + numSamples;
+				float* sampleLod = sampleWeight + numSamples;
+
+				for (std::uint32_t i = 0; i < numSamples; i++)
+				{
+					sampleX[i] = sampleY[i] = sampleZ[i] = sampleWeight[i] = sampleLod[i] = 0.0f;
+					if (i >= sampleCount)
+						continue;
+
+					const float e1 = float(i) / sampleCount;
+					const float e2 = radicalInverse(i);
+
+					const float phi = M_TWO_PI * e1;
+					const float cosTheta = std::sqrt((1.0f - e2) / (1.0f + (alpha2 - 1.0f) * e2));
+					const float sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+
+					const float hx = sinTheta * std::cos(phi);
+					const float hy = sinTheta * std::sin(phi);
+					const float hz = cosTheta;
+
+					const float nl = 2.0f * hz * hz - 1.0f;
+					if (nl <= 0.0f)
+						continue;
+
+					const float denom = (alpha2 - 1.0f) * hz * hz + 1.0f;
+					const float d = alpha2 / (M_PI * denom * denom);
+					const float pdf = d * 0.25f;
+					const float sampleSolidAngle = 1.0f / (sampleCount * pdf + 1e-6f);
+
+					sampleX[i] = 2.0f * hz * hx;
+					sampleY[i] = 2.0f * hz * hy;
+					sampleZ[i] = nl;
+					sampleWeight[i] = nl;
+					sampleLod[i] = math::clamp(0.5f * std::log2(sampleSolidAngle / texelSolidAngle) + 1.0f, 0.0f, float(numLevels - 1));
+				}
+
+				const std::uint32_t dstSize = levels[mip].size;
+				const std::uint32_t numBands = (dstSize + bandRows - 1) / bandRows;
+
+				parallelFor(6 * numBands, [&](std::uint32_t task)
+				{
+					const std::uint8_t face = task / numBands;
+					const std::uint32_t band = task % numBands;
+
+					float* faceData = dstLevels[mip] + face * dstSize * dstSize * 3;
+
+					for (std::uint32_t y = band * bandRows; y < std::min(band * bandRows + bandRows, dstSize); y++)
+					{
+						for (std::uint32_t x = 0; x < dstSize; x++)
+						{
+							const float3 n = math::CalcCubeNormal<float>(x, y, dstSize, dstSize, (SHCubeFace)face);
+							const float3 up = std::abs(n.z) < 0.999f ? float3::UnitZ : float3::UnitX;
+							const float3 t = math::normalize(math::cross(up, n));
+							const float3 b = math::cross(n, t);
+
+							float color[3] = { 0.0f, 0.0f, 0.0f };
+							float weight = 0.0f;
+
+							for (std::uint32_t i = 0; i < numSamples; i += 4)
+							{
+								float dir[3][4];
+#if defined(__SSE2__)
+								const __m128 lx = _mm_loadu_ps(sampleX + i);
+								const __m128 ly = _mm_loadu_ps(sampleY + i);
+								const __m128 lz = _mm_loadu_ps(sampleZ + i);
+
+								_mm_storeu_ps(dir[0], _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, _mm_set1_ps(t.x)), _mm_mul_ps(ly, _mm_set1_ps(b.x))), _mm_mul_ps(lz, _mm_set1_ps(n.x))));
+								_mm_storeu_ps(dir[1], _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, _mm_set1_ps(t.y)), _mm_mul_ps(ly, _mm_set1_ps(b.y))), _mm_mul_ps(lz, _mm_set1_ps(n.y))));
+								_mm_storeu_ps(dir[2], _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, _mm_set1_ps(t.z)), _mm_mul_ps(ly, _mm_set1_ps(b.z))), _mm_mul_ps(lz, _mm_set1_ps(n.z))));
+#else
+								for (std::uint8_t k = 0; k < 4; k++)
+								{
+									dir[0][k] = sampleX[i + k] * t.x + sampleY[i + k] * b.x + sampleZ[i + k] * n.x;
+									dir[1][k] = sampleX[i + k] * t.y + sampleY[i + k] * b.y + sampleZ[i + k] * n.y;
+									dir[2][k] = sampleX[i + k] * t.z + sampleY[i + k] * b.z + sampleZ[i + k] * n.z;
+								}
+#endif
+								for (std::uint8_t k = 0; k < 4; k++)
+								{
+									const float nl = sampleWeight[i + k];
+									if (nl <= 0.0f)
+										continue;
+
+									const float l[3] = { dir[0][k], dir[1][k], dir[2][k] };
+									const float lod = sampleLod[i + k];
+									const std::uint32_t lod0 = (std::uint32_t)lod;
+									const std::uint32_t lod1 = std::min(lod0 + 1, numLevels - 1);
+									const float lodFrac = lod - lod0;
+
+									float sample0[3];
+									float sample1[3];
+									sampleCubemapLevel(sample0, levels[lod0], l);
+									sampleCubemapLevel(sample1, levels[lod1], l);
+
+									color[0] += (sample0[0] + (sample1[0] - sample0[0]) * lodFrac) * nl;
+									color[1] += (sample0[1] + (sample1[1] - sample0[1]) * lodFrac) * nl;
+									color[2] += (sample0[2] + (sample1[2] - sample0[2]) * lodFrac) * nl;
+									weight += nl;
+								}
+							}
+
+							float* pixel = faceData + (y * dstSize + x) * 3;
+							pixel[0] = weight > 0.0f ? color[0] / weight : 0.0f;
+							pixel[1] = weight > 0.0f ? color[1] / weight : 0.0f;
+							pixel[2] = weight > 0.0f ? color[2] / weight : 0.0f;
+						}
+					}
+				});
+			}
+
+			return true;
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
 }
 
 _NAME_END
\ No newline at end of file
@@ -1037,6 +1037,22 @@ DDSHandler::doLoad(StreamReader& stream, Image& image) noexcept
 	{
 		auto length = (std::size_t)(stream.size() - offset);
 
+		// faces are gathered straight out of a mapped stream instead of a temporary copy of the file
+		StreamMapping mapping(stream);
+		if (mapping.data())
+		{
+			if (!image.create(info.width, info.height, info.depth * faceCount, format, info.mip_level, info10.arraySize))
+				return false;
+
+			if (length < image.size())
+				return false;
+
+			if (!DDStoCubeMap((char*)image.data(), 0, info.mip_level, info.width, info.height, faceCount, info.format.bpp, mapping.data() + offset))
+				return false;
+
+			return true;
+		}
+
 		auto data = std::make_unique<char[]>(length);
 		if (!stream.read((char*)data.get(), length))
 			return false;
@@ -68,6 +68,24 @@ Image::~Image() noexcept
 	this->clear();
 }
 
+Image&
+Image::operator=(Image&& move) noexcept
+{
+	_format = move._format;
+	_width = move._width;
+	_height = move._height;
+	_depth = move._depth;
+	_mipLevel = move._mipLevel;
+	_mipBase = move._mipBase;
+	_layerBase = move._layerBase;
+	_layerLevel = move._layerLevel;
+	_size = move._size;
+	_data = std::move(move._data);
+
+	move._init();
+	return *this;
+}
+
 bool
 Image::create(std::uint32_t width, std::uint32_t height, format_t format, bool clear) noexcept
 {
@@ -190,22 +208,28 @@ Image::create(const Image& image, format_t format) noexcept
 		if (!this->create(image.width(), image.height(), image.depth(), format, image.mipLevel(), image.layerLevel(), image.mipBase(), image.layerBase(), true))
 			return false;
 
-		if (_format == format_t::R32G32B32SFloat && format == format_t::R8G8B8UInt)
+		auto srcFormat = image.format();
+		auto srcValueType = image.value_type();
+
+		if (srcFormat == format_t::R32G32B32SFloat && format == format_t::R8G8B8UInt)
 			rgb32f_to_rgb8uint(image, *this);
-		else if (_format == format_t::R32G32B32A32SFloat && format == format_t::R8G8B8A8UInt)
+		else if (srcFormat == format_t::R32G32B32A32SFloat && format == format_t::R8G8B8A8UInt)
 			rgba32f_to_rgba8uint(image, *this);
-		else if (_format == format_t::R64G64B64A64SFloat && format == format_t::R8G8B8UInt)
+		else if (srcFormat == format_t::R64G64B64A64SFloat && format == format_t::R8G8B8UInt)
 			rgb64f_to_rgb8uint(image, *this);
-		else if (_format == format_t::R64G64B64A64SFloat && format == format_t::R8G8B8A8UInt)
+		else if (srcFormat == format_t::R64G64B64A64SFloat && format == format_t::R8G8B8A8UInt)
 			rgba64f_to_rgba8uint(image, *this);
-		else if (_format == format_t::R32G32B32SFloat && format == format_t::R8G8B8SInt)
+		else if (srcFormat == format_t::R32G32B32SFloat && format == format_t::R8G8B8SInt)
 			rgb32f_to_rgb8sint(image, *this);
-		else if (_format == format_t::R32G32B32A32SFloat && format == format_t::R8G8B8A8SInt)
+		else if (srcFormat == format_t::R32G32B32A32SFloat && format == format_t::R8G8B8A8SInt)
 			rgba32f_to_rgba8sint(image, *this);
-		else if (_format == format_t::R64G64B64A64SFloat && format == format_t::R8G8B8SInt)
+		else if (srcFormat == format_t::R64G64B64A64SFloat && format == format_t::R8G8B8SInt)
 			rgb64f_to_rgb8sint(image, *this);
-		else if (_format == format_t::R64G64B64A64SFloat && format == format_t::R8G8B8A8SInt)
+		else if (srcFormat == format_t::R64G64B64A64SFloat && format == format_t::R8G8B8A8SInt)
 			rgba64f_to_rgba8sint(image, *this);
+		else if ((format == format_t::R8G8B8A8UNorm || format == format_t::R8G8B8A8SRGB) && image.type_size() == 1 &&
+			(srcValueType == value_t::UNorm || srcValueType == value_t::SRGB) && image.swizzle_type() != swizzle_t::ABGR)
+			rgb8_to_rgba8(image, *this);
 		else
 			return false;
 
@@ -312,33 +336,51 @@ Image::data() const noexcept
 }
 
 bool
-Image::load(StreamReader& stream, const char* type) noexcept
+Image::load(StreamReader& stream, const char* type, LoadFlags flags) noexcept
 {
 	ImageHandlerPtr impl = image::findHandler(stream, type);
-	if (image::findHandler(stream, type))
+	if (impl)
 	{
-		if (impl->doLoad(stream, *this))
-			return true;
+		if (!impl->doLoad(stream, *this, flags))
+			return false;
+
+		if (flags & LoadFlagRGBA8Bit)
+		{
+			// fallback for handlers that can't decode straight into RGBA, only 8-bit RGB/BGR is expanded,
+			// compressed and one or two channel formats are kept as they are
+			bool isRGB8 = _format == format_t::R8G8B8UNorm || _format == format_t::B8G8R8UNorm;
+			bool isSRGB8 = _format == format_t::R8G8B8SRGB || _format == format_t::B8G8R8SRGB;
+			if (isRGB8 || isSRGB8)
+			{
+				Image rgba;
+				if (rgba.create(*this, isSRGB8 ? format_t::R8G8B8A8SRGB : format_t::R8G8B8A8UNorm))
+					*this = std::move(rgba);
+			}
+		}
+
+		return true;
 	}
 
 	return false;
 }
 
 bool
-Image::load(const std::string& filename, const char* type) noexcept
+Image::load(const std::string& filename, const char* type, LoadFlags flags) noexcept
 {
 	StreamReaderPtr stream;
-	if (IoServer::instance()->openFileURL(stream, filename))
-		return this->load(*stream, type);
+	IoServer::instance()->openFileURL(stream, filename);
+	if (stream)
+		return this->load(*stream, type, flags);
 	return false;
 }
 
 bool
-Image::load(std::string::const_pointer filename, const char* type) noexcept
+Image::load(std::string::const_pointer filename, const char* type, LoadFlags flags) noexcept
 {
 	StreamReaderPtr stream;
-	if (IoServer::instance()->openFileURL(stream, filename))
-		return this->load(*stream, type);
+	IoServer::instance()->openFileURL(stream, filename);
+	if (stream)
+		return this->load(*stream, type, flags);
 	return false;
 }
 
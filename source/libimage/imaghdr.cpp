@@ -187,29 +187,31 @@ int RGBE_ReadHeader(StreamReader& stream, rgbe_header_info* info)
 	return RGBE_RETURN_SUCCESS;
 }
 
-int RGBE_ReadPixels(StreamReader& stream, float* data, std::size_t numpixels)
+int RGBE_ReadPixels(const std::uint8_t* src, std::size_t length, float* data, std::size_t numpixels)
 {
-	auto rgbe = std::make_unique<std::uint8_t[]>(numpixels * 4);
-
-	if (!stream.read((char*)rgbe.get(), numpixels * 4))
+	if (length < numpixels * 4)
 		return rgbe_error(rgbe_read_error, NULL);
 
-	for (std::size_t i = 0; i < numpixels; i++) 
+	for (std::size_t i = 0; i < numpixels; i++, src += 4)
 	{
-		RGBE_decode(&rgbe[i], &data[RGBE_DATA_RED], &data[RGBE_DATA_GREEN], &data[RGBE_DATA_BLUE]);
+		RGBE_decode(src, &data[RGBE_DATA_RED], &data[RGBE_DATA_GREEN], &data[RGBE_DATA_BLUE]);
 		data += RGBE_DATA_SIZE;
 	}
 
 	return RGBE_RETURN_SUCCESS;
 }
 
-int RGBE_ReadPixels_RLE(StreamReader& stream, float *data, std::uint32_t wdith, std::uint32_t height)
+int RGBE_ReadPixels_RLE(const std::uint8_t* src, std::size_t length, float *data, std::uint32_t wdith, std::uint32_t height)
 {
-	std::uint8_t rgbe[4];
+	const std::uint8_t* end = src + length;
 
-	if (!stream.read((char*)rgbe, sizeof(rgbe), 1))
+	std::uint8_t rgbe[4];
+	if (length < sizeof(rgbe))
 		return rgbe_error(rgbe_read_error, NULL);
 
+	std::memcpy(rgbe, src, sizeof(rgbe));
+	src += sizeof(rgbe);
+
 	if ((((int)rgbe[2]) << 8 | rgbe[3]) != wdith)
 		return rgbe_error(rgbe_format_error, "wrong scanline width");
 
@@ -218,7 +220,7 @@ int RGBE_ReadPixels_RLE(StreamReader& stream, float *data, std::uint32_t wdith,
 		RGBE_decode(rgbe, &data[0], &data[1], &data[2]);
 		data += RGBE_DATA_SIZE;
 
-		return RGBE_ReadPixels(stream, data, wdith*height - 1);
+		return RGBE_ReadPixels(src, end - src, data, wdith*height - 1);
 	}
 	else
 	{
@@ -236,10 +238,12 @@ int RGBE_ReadPixels_RLE(StreamReader& stream, float *data, std::uint32_t wdith,
 				auto ptr_end = &scanline_buffer[(i + 1)*wdith];
 				while (ptr < ptr_end)
 				{
-					std::uint8_t buf[2];
-					if (!stream.read((char*)buf, sizeof(buf), 1))
+					if (end - src < 2)
 						return rgbe_error(rgbe_read_error, NULL);
 
+					std::uint8_t buf[2] = { src[0], src[1] };
+					src += 2;
+
 					if (buf[0] > 128)
 					{
 						std::uint8_t count = buf[0] - 128;
@@ -258,9 +262,11 @@ int RGBE_ReadPixels_RLE(StreamReader& stream, float *data, std::uint32_t wdith,
 						*ptr++ = buf[1];
 						if (--count > 0)
 						{
-							if (!stream.read((char*)ptr, sizeof(*ptr)*count, 1))
+							if (end - src < count)
 								return rgbe_error(rgbe_read_error, NULL);
 
+							std::memcpy(ptr, src, count);
+							src += count;
 							ptr += count;
 						}
 					}
@@ -278,8 +284,14 @@ int RGBE_ReadPixels_RLE(StreamReader& stream, float *data, std::uint32_t wdith,
 				data += RGBE_DATA_SIZE;
 			}
 
-			if (!stream.read((char*)rgbe, sizeof(rgbe), 1))
-				return rgbe_error(rgbe_read_error, NULL);
+			if (i + 1 < height)
+			{
+				if (end - src < (std::ptrdiff_t)sizeof(rgbe))
+					return rgbe_error(rgbe_read_error, NULL);
+
+				std::memcpy(rgbe, src, sizeof(rgbe));
+				src += sizeof(rgbe);
+			}
 		}
 	}
 
@@ -475,7 +487,26 @@ HDRHandler::doLoad(StreamReader& stream, Image& image) noexcept
 	if (!image.create(hdr.width, hdr.height, ray::image::format_t::R32G32B32SFloat))
 		return false;
 
-	if (RGBE_ReadPixels_RLE(stream, (float*)image.data(), hdr.width, hdr.height) != RGBE_RETURN_SUCCESS)
+	auto offset = stream.tellg();
+	auto length = (std::size_t)(stream.size() - offset);
+
+	// the pixels are decoded straight from a mapped stream, other streams are read once into memory first
+	StreamMapping mapping(stream);
+	std::unique_ptr<std::uint8_t[]> buffer;
+
+	auto src = (const std::uint8_t*)mapping.data();
+	if (src)
+		src += offset;
+	else
+	{
+		buffer = std::make_unique<std::uint8_t[]>(length);
+		if (!stream.read((char*)buffer.get(), length))
+			return false;
+
+		src = buffer.get();
+	}
+
+	if (RGBE_ReadPixels_RLE(src, length, (float*)image.data(), hdr.width, hdr.height) != RGBE_RETURN_SUCCESS)
 		return false;
 
 	return true;
@@ -36,6 +36,7 @@
 // +----------------------------------------------------------------------
 #include "imagjpeg.h"
 #include <ray/dccmn.h>
+#include <ray/imagutil.h>
 
 #include <setjmp.h>
 #include <jpeglib.h>
@@ -46,7 +47,7 @@ namespace image
 {
 
 #define JPEG_LENGTH_MAX 200
-#define JPEG_IO_BUFFER_SIZE 4096
+#define JPEG_IO_BUFFER_SIZE 65536
 
 struct jpeg_error_manager : public jpeg_error_mgr
 {
@@ -170,11 +171,20 @@ JPEGHandler::doCanRead(const char* type_name) const noexcept
 
 bool
 JPEGHandler::doLoad(StreamReader& stream, Image& image) noexcept
+{
+	return this->doLoad(stream, image, 0);
+}
+
+bool
+JPEGHandler::doLoad(StreamReader& stream, Image& image, LoadFlags flags) noexcept
 {
 	jpeg_decompress_struct cinfo;
 
 	jpeg_error_manager jerrmgr;
 
+	// a mapped stream is handed to libjpeg as one buffer, so no refill ever copies through src->buffer
+	StreamMapping mapping(stream);
+
 	cinfo.err = ::jpeg_std_error(&jerrmgr);
 
 	jerrmgr.error_exit = jpeg_error_exit;
@@ -205,61 +215,81 @@ JPEGHandler::doLoad(StreamReader& stream, Image& image) noexcept
 	src->pub.bytes_in_buffer = 0;
 	src->pub.next_input_byte = 0;
 
+	if (mapping.data())
+	{
+		auto offset = stream.tellg();
+		src->pub.next_input_byte = (const JOCTET*)mapping.data() + offset;
+		src->pub.bytes_in_buffer = (std::size_t)(stream.size() - offset);
+
+		// running past the end falls back to fill_input_buffer, which then inserts the fake EOI marker
+		stream.seekg(0, ios_base::end);
+	}
+
 	// read jpeg handle parameters*/
 	::jpeg_read_header(&cinfo, TRUE);
 
-	if (!image.create(cinfo.image_width, cinfo.image_height, image::format_t::R8G8B8SRGB))
+	// grayscale is expanded by libjpeg itself, so every image comes out as RGB or CMYK
+	if (cinfo.out_color_space == JCS_GRAYSCALE)
+		cinfo.out_color_space = JCS_RGB;
+
+	if (cinfo.out_color_space != JCS_RGB && cinfo.out_color_space != JCS_CMYK)
+	{
+		::jpeg_destroy_decompress(&cinfo);
 		return false;
+	}
 
-	RGB* data = (RGB*)image.data();
-	JDIMENSION stride = cinfo.image_width * cinfo.num_components;
+	bool expandRGBA = (flags & LoadFlagRGBA8Bit) ? true : false;
 
-	if (cinfo.out_color_space == JCS_RGB)
+	if (!image.create(cinfo.image_width, cinfo.image_height, expandRGBA ? image::format_t::R8G8B8A8SRGB : image::format_t::R8G8B8SRGB, false))
 	{
-		::jpeg_start_decompress(&cinfo);
+		::jpeg_destroy_decompress(&cinfo);
+		return false;
+	}
+
+	::jpeg_start_decompress(&cinfo);
 
-		while (cinfo.output_scanline < cinfo.image_height)
+	std::uint8_t* data = (std::uint8_t*)image.data();
+	std::size_t pitch = cinfo.output_width * (expandRGBA ? 4 : 3);
+
+	if (cinfo.out_color_space == JCS_RGB && !expandRGBA)
+	{
+		// decode straight into the image
+		while (cinfo.output_scanline < cinfo.output_height)
 		{
 			::jpeg_read_scanlines(&cinfo, (JSAMPARRAY)&data, 1);
-			data += cinfo.image_width;
+			data += pitch;
 		}
 	}
 	else
 	{
+		JDIMENSION stride = cinfo.output_width * cinfo.output_components;
 		JSAMPARRAY row_pointer = (*cinfo.mem->alloc_sarray)((j_common_ptr)&cinfo, JPOOL_IMAGE, stride, 1);
 
-		::jpeg_start_decompress(&cinfo);
-
-		while (cinfo.output_scanline < cinfo.image_height)
+		while (cinfo.output_scanline < cinfo.output_height)
 		{
 			::jpeg_read_scanlines(&cinfo, row_pointer, 1);
 
-			switch (cinfo.out_color_space)
-			{
-			case JCS_RGB:
+			const std::uint8_t* inptr = (const std::uint8_t*)row_pointer[0];
+
+			if (cinfo.out_color_space == JCS_RGB)
 			{
-				std::memcpy(data, row_pointer[0], stride);
-				data += cinfo.image_width;
+				rgb8_to_rgba8(inptr, data, cinfo.output_width, 1, 3);
 			}
-			break;
-			case JCS_CMYK:
+			else
 			{
-				std::uint8_t* inptr = (std::uint8_t*)row_pointer[0];
-				for (size_t i = 0; i < cinfo.output_width; i++)
+				std::uint8_t* outptr = data;
+				for (std::size_t i = 0; i < cinfo.output_width; i++)
 				{
-					cmyk_to_rgb((std::uint8_t*)data, inptr);
-					data += 3;
+					cmyk_to_rgb(outptr, inptr);
+					if (expandRGBA)
+						outptr[3] = 0xFF;
+
+					outptr += expandRGBA ? 4 : 3;
 					inptr += 4;
 				}
 			}
-			break;
-			case JCS_GRAYSCALE:
-			case JCS_UNKNOWN:
-			case JCS_YCbCr:
-			case JCS_YCCK:
-			default:
-				assert(false);
-			}
+
+			data += pitch;
 		}
 	}
 
@@ -54,6 +54,7 @@ public:
 	bool doCanRead(const char* type_name) const noexcept;
 
 	bool doLoad(StreamReader& stream, Image& image) noexcept;
+	bool doLoad(StreamReader& stream, Image& image, LoadFlags flags) noexcept;
 	bool doSave(StreamWrite& stream, const Image& image) noexcept;
 
 private:
@@ -0,0 +1,497 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2015.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#include <ray/image.h>
+#include <ray/math.h>
+#include <ray/thread.h>
+
+#if defined(__SSE2__)
+#	include <emmintrin.h>
+#endif
+
+_NAME_BEGIN
+
+namespace image
+{
+	struct MipmapKernel
+	{
+		std::uint32_t taps;
+		std::vector<std::uint32_t> indices;
+		std::vector<float> weights;
+	};
+
+	static float sinc(float x) noexcept
+	{
+		if (std::abs(x) < 1e-6f)
+			return 1.0f;
+		x *= M_PI;
+		return std::sin(x) / x;
+	}
+
+	static float bessel0(float x) noexcept
+	{
+		float sum = 1.0f;
+		float term = 1.0f;
+		float halfx = x * 0.5f;
+
+		for (std::uint32_t i = 1; i < 32; i++)
+		{
+			term *= halfx / i;
+			term *= halfx / i;
+			sum += term;
+			if (term < 1e-6f * sum)
+				break;
+		}
+
+		return sum;
+	}
+
+	static float filterSupport(filter_t filter) noexcept
+	{
+		switch (filter)
+		{
+		case filter_t::Box:
+			return 0.5f;
+		case filter_t::Kaiser:
+		case filter_t::Lanczos:
+			return 3.0f;
+		default:
+			assert(false);
+			return 0.5f;
+		}
+	}
+
+	static float filterWeight(filter_t filter, float x) noexcept
+	{
+		switch (filter)
+		{
+		case filter_t::Box:
+		{
+			return (x >= -0.5f && x < 0.5f) ? 1.0f : 0.0f;
+		}
+		case filter_t::Kaiser:
+		{
+			const float width = 3.0f;
+			const float alpha = 4.0f;
+			float t = x / width;
+			if (t * t >= 1.0f)
+				return 0.0f;
+			return sinc(x) * bessel0(alpha * std::sqrt(1.0f - t * t)) / bessel0(alpha);
+		}
+		case filter_t::Lanczos:
+		{
+			if (std::abs(x) >= 3.0f)
+				return 0.0f;
+			return sinc(x) * sinc(x / 3.0f);
+		}
+		default:
+			assert(false);
+			return 0.0f;
+		}
+	}
+
+	static void makeMipmapKernel(MipmapKernel& kernel, std::uint32_t srcSize, std::uint32_t dstSize, filter_t filter) noexcept
+	{
+		const float scale = float(srcSize) / dstSize;
+		const float support = filterSupport(filter) * scale;
+
+		kernel.taps = (std::uint32_t)std::ceil(support * 2.0f) + 1;
+		kernel.indices.resize(dstSize * kernel.taps);
+		kernel.weights.resize(dstSize * kernel.taps);
+
+		for (std::uint32_t x = 0; x < dstSize; x++)
+		{
+			const float center = (x + 0.5f) * scale;
+			const std::int32_t start = (std::int32_t)std::floor(center - support);
+
+			std::uint32_t* indices = &kernel.indices[x * kernel.taps];
+			float* weights = &kernel.weights[x * kernel.taps];
+
+			float sum = 0.0f;
+			for (std::uint32_t k = 0; k < kernel.taps; k++)
+			{
+				std::int32_t i = start + (std::int32_t)k;
+				indices[k] = (std::uint32_t)math::clamp<std::int32_t>(i, 0, (std::int32_t)srcSize - 1);
+				weights[k] = filterWeight(filter, (i + 0.5f - center) / scale);
+				sum += weights[k];
+			}
+
+			if (sum != 0.0f)
+			{
+				for (std::uint32_t k = 0; k < kernel.taps; k++)
+					weights[k] /= sum;
+			}
+		}
+	}
+
+	static void filterRows(const float* src, float* dst, std::uint32_t srcWidth, std::uint32_t dstWidth, std::uint32_t rowBegin, std::uint32_t rowEnd, std::uint8_t channel, const MipmapKernel& kernel) noexcept
+	{
+		for (std::uint32_t y = rowBegin; y < rowEnd; y++)
+		{
+			const float* srcRow = src + y * srcWidth * channel;
+			float* dstRow = dst + y * dstWidth * channel;
+
+			for (std::uint32_t x = 0; x < dstWidth; x++)
+			{
+				const std::uint32_t* indices = &kernel.indices[x * kernel.taps];
+				const float* weights = &kernel.weights[x * kernel.taps];
+
+#if defined(__SSE2__)
+				if (channel == 4)
+				{
+					__m128 acc = _mm_setzero_ps();
+					for (std::uint32_t k = 0; k < kernel.taps; k++)
+						acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(srcRow + indices[k] * 4)));
+					_mm_storeu_ps(dstRow + x * 4, acc);
+					continue;
+				}
+#endif
+				float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+				for (std::uint32_t k = 0; k < kernel.taps; k++)
+				{
+					const float* pixel = srcRow + indices[k] * channel;
+					for (std::uint8_t c = 0; c < channel; c++)
+						acc[c] += weights[k] * pixel[c];
+				}
+
+				for (std::uint8_t c = 0; c < channel; c++)
+					dstRow[x * channel + c] = acc[c];
+			}
+		}
+	}
+
+	static void filterColumns(const float* src, float* dst, std::uint32_t width, std::uint32_t rowBegin, std::uint32_t rowEnd, std::uint8_t channel, const MipmapKernel& kernel) noexcept
+	{
+		const std::uint32_t pitch = width * channel;
+
+		for (std::uint32_t y = rowBegin; y < rowEnd; y++)
+		{
+			const std::uint32_t* indices = &kernel.indices[y * kernel.taps];
+			const float* weights = &kernel.weights[y * kernel.taps];
+
+			float* dstRow = dst + y * pitch;
+			std::memset(dstRow, 0, pitch * sizeof(float));
+
+			for (std::uint32_t k = 0; k < kernel.taps; k++)
+			{
+				const float weight = weights[k];
+				if (weight == 0.0f)
+					continue;
+
+				const float* srcRow = src + indices[k] * pitch;
+
+				std::uint32_t i = 0;
+#if defined(__SSE2__)
+				const __m128 w = _mm_set1_ps(weight);
+				for (; i + 4 <= pitch; i += 4)
+					_mm_storeu_ps(dstRow + i, _mm_add_ps(_mm_loadu_ps(dstRow + i), _mm_mul_ps(w, _mm_loadu_ps(srcRow + i))));
+#endif
+				for (; i < pitch; i++)
+					dstRow[i] += weight * srcRow[i];
+			}
+		}
+	}
+
+	static float srgbToLinear(std::uint8_t value) noexcept
+	{
+		static const struct SRGBTable
+		{
+			SRGBTable() noexcept
+			{
+				for (std::uint32_t i = 0; i < 256; i++)
+				{
+					float c = i / 255.0f;
+					table[i] = (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+				}
+			}
+
+			float table[256];
+		} s_srgbTable;
+
+		return s_srgbTable.table[value];
+	}
+
+	static float linearToSrgb(float value) noexcept
+	{
+		value = math::clamp(value, 0.0f, 1.0f);
+		return (value <= 0.0031308f) ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+	}
+
+	static void normalizeVectors(float* data, std::size_t count, std::uint8_t channel) noexcept
+	{
+		for (std::size_t i = 0; i < count; i++)
+		{
+			float* n = data + i * channel;
+			float length = 0.0f;
+			for (std::uint8_t c = 0; c < 3; c++)
+				length += n[c] * n[c];
+
+			if (length > 0.0f)
+			{
+				length = 1.0f / std::sqrt(length);
+				for (std::uint8_t c = 0; c < 3; c++)
+					n[c] *= length;
+			}
+		}
+	}
+
+	static float alphaCoverage(const float* data, std::size_t count, std::uint8_t channel, std::uint8_t alpha, float alphaRef, float scale) noexcept
+	{
+		std::size_t covered = 0;
+		for (std::size_t i = 0; i < count; i++)
+		{
+			if (data[i * channel + alpha] * scale > alphaRef)
+				covered++;
+		}
+
+		return float(covered) / count;
+	}
+
+	static float alphaCoverageScale(const float* data, std::size_t count, std::uint8_t channel, std::uint8_t alpha, float alphaRef, float coverage) noexcept
+	{
+		float minAlphaRef = 0.0f;
+		float maxAlphaRef = 1.0f;
+		float midAlphaRef = alphaRef;
+
+		for (std::uint32_t i = 0; i < 10; i++)
+		{
+			float current = alphaCoverage(data, count, channel, alpha, midAlphaRef, 1.0f);
+			if (current > coverage)
+				minAlphaRef = midAlphaRef;
+			else if (current < coverage)
+				maxAlphaRef = midAlphaRef;
+			else
+				break;
+
+			midAlphaRef = (minAlphaRef + maxAlphaRef) * 0.5f;
+		}
+
+		return midAlphaRef > 0.0f ? alphaRef / midAlphaRef : 1.0f;
+	}
+}
+
+using namespace image;
+
+bool
+Image::generateMipmaps(filter_t filter, MipmapFlags flags, float alphaRef) noexcept
+{
+	assert(filter >= filter_t::BeginRange && filter <= filter_t::EndRange);
+
+	if (this->empty())
+		return false;
+
+	const value_t valueType = this->value_type();
+	const std::uint8_t typeSize = this->type_size();
+	const std::uint8_t channel = this->channel();
+
+	if (valueType == value_t::Float)
+	{
+		if (typeSize != 4)
+			return false;
+	}
+	else if (valueType == value_t::UNorm || valueType == value_t::SRGB)
+	{
+		if (typeSize != 1 || this->swizzle_type() == swizzle_t::ABGR)
+			return false;
+	}
+	else
+	{
+		return false;
+	}
+
+	const bool isUnsigned = valueType != value_t::Float;
+	const bool isNormalMap = (flags & MipmapFlagNormalMapBit) ? true : false;
+	const bool isSRGB = valueType == value_t::SRGB && !isNormalMap;
+	const bool hasAlpha = channel == 4 || (_format >= format_t::L8A8UNorm && _format <= format_t::L8A8SRGB);
+	const bool isAlphaCoverage = (flags & MipmapFlagAlphaCoverageBit) && hasAlpha;
+	const std::uint8_t alpha = hasAlpha ? channel - 1 : channel;
+
+	const std::uint32_t numSlices = _depth * _layerLevel;
+	const std::uint32_t numLevels = (std::uint32_t)std::floor(std::log2(std::max(_width, _height))) + 1;
+	const std::uint32_t pixelSize = channel * typeSize;
+	const std::uint32_t bandRows = 32;
+
+	std::size_t destLength = 0;
+	for (std::uint32_t mip = 0, w = _width, h = _height; mip < numLevels; mip++)
+	{
+		destLength += w * h * pixelSize * numSlices;
+		w = std::max(w >> 1, (std::uint32_t)1);
+		h = std::max(h >> 1, (std::uint32_t)1);
+	}
+
+	try
+	{
+		auto data = std::make_unique<std::uint8_t[]>(destLength);
+		std::memcpy(data.get(), _data.get(), _width * _height * pixelSize * numSlices);
+
+		std::vector<std::vector<float>> levels(numSlices);
+		std::vector<std::vector<float>> temps(numSlices);
+		std::vector<float> coverages(numSlices);
+
+		parallelFor(numSlices, [&](std::uint32_t slice)
+		{
+			const std::size_t count = _width * _height;
+			const std::uint8_t* src = _data.get() + count * pixelSize * slice;
+
+			auto& level = levels[slice];
+			level.resize(count * channel);
+
+			if (isUnsigned)
+			{
+				for (std::size_t i = 0; i < count * channel; i++)
+				{
+					if (hasAlpha && (i % channel) == alpha)
+						level[i] = src[i] / 255.0f;
+					else if (isSRGB)
+						level[i] = srgbToLinear(src[i]);
+					else if (isNormalMap)
+						level[i] = src[i] / 255.0f * 2.0f - 1.0f;
+					else
+						level[i] = src[i] / 255.0f;
+				}
+			}
+			else
+			{
+				std::memcpy(level.data(), src, count * pixelSize);
+			}
+
+			if (isAlphaCoverage)
+				coverages[slice] = alphaCoverage(level.data(), count, channel, alpha, alphaRef, 1.0f);
+		});
+
+		MipmapKernel kernelX;
+		MipmapKernel kernelY;
+
+		std::uint32_t srcWidth = _width;
+		std::uint32_t srcHeight = _height;
+		std::size_t offset = _width * _height * pixelSize * numSlices;
+
+		for (std::uint32_t mip = 1; mip < numLevels; mip++)
+		{
+			const std::uint32_t dstWidth = std::max(srcWidth >> 1, (std::uint32_t)1);
+			const std::uint32_t dstHeight = std::max(srcHeight >> 1, (std::uint32_t)1);
+
+			makeMipmapKernel(kernelX, srcWidth, dstWidth, filter);
+			makeMipmapKernel(kernelY, srcHeight, dstHeight, filter);
+
+			const std::uint32_t srcBands = (srcHeight + bandRows - 1) / bandRows;
+			const std::uint32_t dstBands = (dstHeight + bandRows - 1) / bandRows;
+
+			parallelFor(numSlices, [&](std::uint32_t slice)
+			{
+				temps[slice].resize(dstWidth * srcHeight * channel);
+			});
+
+			parallelFor(numSlices * srcBands, [&](std::uint32_t task)
+			{
+				const std::uint32_t slice = task / srcBands;
+				const std::uint32_t band = task % srcBands;
+				filterRows(levels[slice].data(), temps[slice].data(), srcWidth, dstWidth, band * bandRows, std::min(band * bandRows + bandRows, srcHeight), channel, kernelX);
+			});
+
+			parallelFor(numSlices, [&](std::uint32_t slice)
+			{
+				levels[slice].resize(dstWidth * dstHeight * channel);
+			});
+
+			parallelFor(numSlices * dstBands, [&](std::uint32_t task)
+			{
+				const std::uint32_t slice = task / dstBands;
+				const std::uint32_t band = task % dstBands;
+				filterColumns(temps[slice].data(), levels[slice].data(), dstWidth, band * bandRows, std::min(band * bandRows + bandRows, dstHeight), channel, kernelY);
+			});
+
+			parallelFor(numSlices, [&](std::uint32_t slice)
+			{
+				const std::size_t count = dstWidth * dstHeight;
+				const float* level = levels[slice].data();
+				std::uint8_t* dst = data.get() + offset + count * pixelSize * slice;
+
+				if (isNormalMap && channel >= 3)
+					normalizeVectors(levels[slice].data(), count, channel);
+
+				float alphaScale = 1.0f;
+				if (isAlphaCoverage)
+					alphaScale = alphaCoverageScale(level, count, channel, alpha, alphaRef, coverages[slice]);
+
+				if (isUnsigned)
+				{
+					for (std::size_t i = 0; i < count * channel; i++)
+					{
+						float value = level[i];
+						if (hasAlpha && (i % channel) == alpha)
+							value *= alphaScale;
+						else if (isSRGB)
+							value = linearToSrgb(value);
+						else if (isNormalMap)
+							value = value * 0.5f + 0.5f;
+
+						dst[i] = (std::uint8_t)math::clamp(value * 255.0f + 0.5f, 0.0f, 255.0f);
+					}
+				}
+				else
+				{
+					float* dstFloat = (float*)dst;
+					for (std::size_t i = 0; i < count * channel; i++)
+					{
+						if (hasAlpha && (i % channel) == alpha)
+							dstFloat[i] = level[i] * alphaScale;
+						else
+							dstFloat[i] = level[i];
+					}
+				}
+			});
+
+			offset += dstWidth * dstHeight * pixelSize * numSlices;
+
+			srcWidth = dstWidth;
+			srcHeight = dstHeight;
+		}
+
+		_data = std::move(data);
+		_size = destLength;
+		_mipBase = 0;
+		_mipLevel = numLevels;
+
+		return true;
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+_NAME_END
@@ -43,6 +43,8 @@ _NAME_BEGIN
 namespace image
 {
 
+#define PNG_IO_BUFFER_SIZE 262144
+
 struct PNGInfoStruct
 {
 	jmp_buf jmpbuf;
@@ -101,6 +103,12 @@ PNGHandler::doCanRead(const char* type_name) const noexcept
 
 bool
 PNGHandler::doLoad(StreamReader& stream, Image& image) noexcept
+{
+	return this->doLoad(stream, image, 0);
+}
+
+bool
+PNGHandler::doLoad(StreamReader& stream, Image& image, LoadFlags flags) noexcept
 {
 	PNGInfoStruct info;
 	info.stream.in = &stream;
@@ -119,10 +127,10 @@ PNGHandler::doLoad(StreamReader& stream, Image& image) noexcept
 		return false;
 	}
 
-	::png_set_strip_16(png_ptr);
-	::png_set_packing(png_ptr);
+	// fewer, larger reads of the IDAT stream instead of the default 8K chunks
+	::png_set_compression_buffer_size(png_ptr, PNG_IO_BUFFER_SIZE);
+
 	::png_set_read_fn(png_ptr, &info, &PNG_stream_reader);
-	::png_set_filler(png_ptr, 0xff, PNG_FILLER_AFTER);
 	::png_set_benign_errors(png_ptr, 1);
 	::png_read_info(png_ptr, info_ptr);
 
@@ -135,6 +143,10 @@ PNGHandler::doLoad(StreamReader& stream, Image& image) noexcept
 		return false;
 	}
 
+	// let libpng produce 8 bit pixels of the final layout so no post pass is required
+	::png_set_strip_16(png_ptr);
+	::png_set_packing(png_ptr);
+
 	if (color_type == PNG_COLOR_TYPE_PALETTE)
 		::png_set_expand(png_ptr);
 
@@ -144,41 +156,61 @@ PNGHandler::doLoad(StreamReader& stream, Image& image) noexcept
 	if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
 		::png_set_expand(png_ptr);
 
+	if (interlace_type != PNG_INTERLACE_NONE)
+		::png_set_interlace_handling(png_ptr);
+
+	if (flags & LoadFlagRGBA8Bit)
+	{
+		if (color_type == PNG_COLOR_TYPE_GRAY || color_type == PNG_COLOR_TYPE_GRAY_ALPHA)
+			::png_set_gray_to_rgb(png_ptr);
+
+		::png_set_filler(png_ptr, 0xff, PNG_FILLER_AFTER);
+	}
+
 	int intent;
 	if (png_get_sRGB(png_ptr, info_ptr, &intent))
 		png_set_sRGB(png_ptr, info_ptr, intent);
 
-	if (color_type & PNG_COLOR_TYPE_RGBA ||
-		color_type & PNG_COLOR_TYPE_RGB)
+	::png_read_update_info(png_ptr, info_ptr);
+
+	image::format_t format;
+	switch (::png_get_channels(png_ptr, info_ptr))
+	{
+	case 1:
+		format = image::format_t::R8SRGB;
+		break;
+	case 2:
+		format = image::format_t::R8G8SRGB;
+		break;
+	case 3:
+		format = image::format_t::R8G8B8SRGB;
+		break;
+	case 4:
+		format = image::format_t::R8G8B8A8SRGB;
+		break;
+	default:
+		::png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+		return false;
+	}
+
+	if (!image.create(width, height, format, false))
 	{
-		png_uint_32 pixelSize;
-		image::format_t format;
-		if (color_type & PNG_COLOR_TYPE_RGBA)
-		{
-			format = image::format_t::R8G8B8A8SRGB;
-			pixelSize = 4;
-		}
-		else if (color_type & PNG_COLOR_TYPE_RGB)
-		{
-			format = image::format_t::R8G8B8SRGB;
-			pixelSize = 3;
-		}
-
-		if (!image.create(width, height, format))
-			return false;
-
-		std::size_t columnLength = width * pixelSize;
-		std::uint8_t* pixel = (std::uint8_t*)image.data();
-
-		std::vector<png_bytep> pointers(height, 0);
-		for (std::size_t i = 0; i < height; i++)
-			pointers[i] = pixel + i * columnLength;
-
-		::png_start_read_image(png_ptr);
-		::png_read_image(png_ptr, pointers.data());
-		::png_read_end(png_ptr, info_ptr);
+		::png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+		return false;
 	}
 
+	std::size_t columnLength = ::png_get_rowbytes(png_ptr, info_ptr);
+	std::uint8_t* pixel = (std::uint8_t*)image.data();
+
+	assert(columnLength * height == image.size());
+
+	std::vector<png_bytep> pointers(height, 0);
+	for (std::size_t i = 0; i < height; i++)
+		pointers[i] = pixel + i * columnLength;
+
+	::png_read_image(png_ptr, pointers.data());
+	::png_read_end(png_ptr, info_ptr);
+
 	::png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
 	return true;
 }
@@ -171,11 +171,20 @@ TGAHandler::doLoad(StreamReader& stream, Image& image) noexcept
 	break;
 	case TGA_TYPE_RGB_RLE:
 	{
-		std::vector<std::uint8_t> buffers(stream.size() - sizeof(TGAHeader));
-		std::uint8_t* buf = (std::uint8_t*)buffers.data();
+		StreamMapping mapping(stream);
+		std::vector<std::uint8_t> buffers;
 
-		if (!stream.read((char*)buf, buffers.size()))
-			return false;
+		std::uint8_t* buf = (std::uint8_t*)mapping.data();
+		if (buf)
+			buf += stream.tellg();
+		else
+		{
+			buffers.resize(stream.size() - sizeof(TGAHeader));
+			buf = (std::uint8_t*)buffers.data();
+
+			if (!stream.read((char*)buf, buffers.size()))
+				return false;
+		}
 
 		switch (hdr.pixel_size)
 		{
@@ -290,11 +299,20 @@ TGAHandler::doLoad(StreamReader& stream, Image& image) noexcept
 	break;
 	case TGA_TYPE_GRAY_RLE:
 	{
-		std::vector<std::uint8_t> buffers(stream.size() - sizeof(TGAHeader));
-		std::uint8_t* buf = (std::uint8_t*)buffers.data();
+		StreamMapping mapping(stream);
+		std::vector<std::uint8_t> buffers;
 
-		if (!stream.read((char*)buf, buffers.size()))
-			return false;
+		std::uint8_t* buf = (std::uint8_t*)mapping.data();
+		if (buf)
+			buf += stream.tellg();
+		else
+		{
+			buffers.resize(stream.size() - sizeof(TGAHeader));
+			buf = (std::uint8_t*)buffers.data();
+
+			if (!stream.read((char*)buf, buffers.size()))
+				return false;
+		}
 
 		if (!image.create(columns, rows, image::format_t::R8SRGB))
 			return false;
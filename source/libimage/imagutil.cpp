@@ -321,6 +321,89 @@ namespace image
 		}
 	}
 
+	void rgb8_to_rgba8(const std::uint8_t* src, std::uint8_t* dst, std::uint32_t w, std::uint32_t h, std::uint8_t channel, swizzle_t swizzle) noexcept
+	{
+		assert(src && dst && src != dst);
+		assert(w > 0 && h > 0 && channel > 0 && channel <= 4);
+
+		std::size_t count = (std::size_t)w * h;
+
+		switch (channel)
+		{
+		case 1:
+		{
+			// single channel images are treated as luminance
+			for (std::size_t i = 0; i < count; i++, dst += 4)
+			{
+				dst[0] = dst[1] = dst[2] = src[i];
+				dst[3] = 0xFF;
+			}
+		}
+		break;
+		case 2:
+		{
+			// luminance + alpha
+			for (std::size_t i = 0; i < count; i++, src += 2, dst += 4)
+			{
+				dst[0] = dst[1] = dst[2] = src[0];
+				dst[3] = src[1];
+			}
+		}
+		break;
+		case 3:
+		{
+			const std::uint8_t r = swizzle == swizzle_t::BGR ? 2 : 0;
+			const std::uint8_t b = swizzle == swizzle_t::BGR ? 0 : 2;
+
+			for (std::size_t i = 0; i < count; i++, src += 3, dst += 4)
+			{
+				dst[0] = src[r];
+				dst[1] = src[1];
+				dst[2] = src[b];
+				dst[3] = 0xFF;
+			}
+		}
+		break;
+		case 4:
+		{
+			if (swizzle == swizzle_t::BGRA)
+			{
+				for (std::size_t i = 0; i < count; i++, src += 4, dst += 4)
+				{
+					dst[0] = src[2];
+					dst[1] = src[1];
+					dst[2] = src[0];
+					dst[3] = src[3];
+				}
+			}
+			else
+			{
+				std::memcpy(dst, src, count * 4);
+			}
+		}
+		break;
+		default:
+			assert(false);
+		}
+	}
+
+	void rgb8_to_rgba8(const Image& srcImage, Image& dstImage) noexcept
+	{
+		assert(srcImage.type_size() == 1);
+		assert(dstImage.format() == image::format_t::R8G8B8A8UNorm || dstImage.format() == image::format_t::R8G8B8A8SRGB);
+
+		assert(dstImage.width() == srcImage.width());
+		assert(dstImage.height() == srcImage.height());
+		assert(dstImage.depth() == srcImage.depth());
+
+		std::uint8_t channel = srcImage.channel();
+		std::size_t count = srcImage.size() / channel;
+
+		assert(dstImage.size() == count * 4);
+
+		rgb8_to_rgba8((const std::uint8_t*)srcImage.data(), (std::uint8_t*)dstImage.data(), (std::uint32_t)count, 1, channel, srcImage.swizzle_type());
+	}
+
 	void dilateFilter(const float* image, float* outImage, std::uint32_t w, std::uint32_t h, std::uint8_t c) noexcept
 	{
 		assert(image && outImage);
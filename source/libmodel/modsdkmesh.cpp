@@ -228,6 +228,10 @@ SDKMeshHandler::doLoad(StreamReader& stream, Model& model) noexcept
 
 	MeshPropertyPtr root = nullptr;
 
+	// vertices and indices are decoded in place when the stream is mapped instead of one read per element
+	StreamMapping mapping(stream);
+	auto streamSize = (std::uint64_t)stream.size();
+
 	for (auto& it : materials)
 	{
 		auto material = std::make_shared<MaterialProperty>();
@@ -261,13 +265,20 @@ SDKMeshHandler::doLoad(StreamReader& stream, Model& model) noexcept
 	{
 		for (std::size_t i = 0; i < mesh.NumVertexBuffers; i++)
 		{
-			stream.seekg(vbs[i].DataOffset, ios_base::beg);
+			const std::uint8_t* mapped = nullptr;
+			if (mapping.data() && vbs[i].DataOffset + vbs[i].NumVertices * vbs[i].StrideBytes <= streamSize)
+				mapped = (const std::uint8_t*)mapping.data() + vbs[i].DataOffset;
+			else
+				stream.seekg(vbs[i].DataOffset, ios_base::beg);
 
 			for (std::size_t j = 0; j < vbs[i].NumVertices; j++)
 			{
 				std::uint8_t offset = 0;
 				std::uint8_t buffer[MAX_VERTEX_BUFFER];
-				stream.read((char*)buffer, vbs[i].StrideBytes);
+				if (mapped)
+					std::memcpy(buffer, mapped + j * vbs[i].StrideBytes, vbs[i].StrideBytes);
+				else
+					stream.read((char*)buffer, vbs[i].StrideBytes);
 
 				for (std::size_t element = 0; element < MAX_VERTEX_ELEMENTS; element++)
 				{
@@ -301,14 +312,23 @@ SDKMeshHandler::doLoad(StreamReader& stream, Model& model) noexcept
 			}
 		}
 
-		stream.seekg(ibs[mesh.IndexBuffer].DataOffset, ios_base::beg);
-
 		auto sizeOfData = ibs[mesh.IndexBuffer].SizeBytes / ibs[mesh.IndexBuffer].NumIndices;
 
+		const std::uint8_t* mapped = nullptr;
+		if (mapping.data() && ibs[mesh.IndexBuffer].DataOffset + ibs[mesh.IndexBuffer].NumIndices * sizeOfData <= streamSize)
+			mapped = (const std::uint8_t*)mapping.data() + ibs[mesh.IndexBuffer].DataOffset;
+		else
+			stream.seekg(ibs[mesh.IndexBuffer].DataOffset, ios_base::beg);
+
+		faces.reserve(faces.size() + ibs[mesh.IndexBuffer].NumIndices);
+
 		for (std::size_t j = 0; j < ibs[mesh.IndexBuffer].NumIndices; j++)
 		{
 			std::uint32_t buffer = 0;
-			stream.read((char*)&buffer, sizeOfData);
+			if (mapped)
+				std::memcpy(&buffer, mapped + j * sizeOfData, sizeOfData);
+			else
+				stream.read((char*)&buffer, sizeOfData);
 
 			faces.push_back(buffer);
 		}
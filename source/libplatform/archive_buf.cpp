@@ -104,9 +104,9 @@ archivebuf::at(const string_t& key)
 	{
 		auto& data = std::get<archivebuf::type_t::object>(_data);
 
-		for (auto& it : *data)
-			if (it.first == key)
-				return it.second;
+		auto it = data->find(key);
+		if (it)
+			return it->second;
 
 		data->push_back(std::make_pair(key, archivebuf::null));
 		return data->back().second;
@@ -127,9 +127,9 @@ archivebuf::at(const string_t::value_type* key)
 	{
 		auto& data = std::get<archivebuf::type_t::object>(_data);
 
-		for (auto& it : *data)
-			if (it.first == key)
-				return it.second;
+		auto it = data->find(key);
+		if (it)
+			return it->second;
 
 		data->push_back(std::make_pair(key, archivebuf::null));
 		return data->back().second;
@@ -163,9 +163,9 @@ archivebuf::at(const string_t& key) const
 	{
 		auto& data = std::get<archivebuf::type_t::object>(_data);
 
-		for (auto& it : *data)
-			if (it.first == key)
-				return it.second;
+		auto it = data->find(key);
+		if (it)
+			return it->second;
 
 		return archivebuf::nil;
 	}
@@ -182,9 +182,9 @@ archivebuf::at(const string_t::value_type* key) const
 	{
 		auto& data = std::get<archivebuf::type_t::object>(_data);
 
-		for (auto& it : *data)
-			if (it.first == key)
-				return it.second;
+		auto it = data->find(key);
+		if (it)
+			return it->second;
 
 		return archivebuf::nil;
 	}
@@ -633,9 +633,9 @@ archivebuf::operator[](const char* key)
 	{
 		auto& data = std::get<archivebuf::type_t::object>(_data);
 
-		for (auto& it : *data)
-			if (it.first == key)
-				return it.second;
+		auto it = data->find(key);
+		if (it)
+			return it->second;
 
 		data->push_back(std::make_pair(key, archivebuf::null));
 		return data->back().second;
@@ -656,9 +656,9 @@ archivebuf::operator[](const string_t& key)
 	{
 		auto& data = std::get<archivebuf::type_t::object>(_data);
 
-		for (auto& it : *data)
-			if (it.first == key)
-				return it.second;
+		auto it = data->find(key);
+		if (it)
+			return it->second;
 
 		data->push_back(std::make_pair(key, null));
 		return data->back().second;
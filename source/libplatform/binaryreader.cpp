@@ -0,0 +1,599 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#include <ray/binaryreader.h>
+#include <ray/fstream.h>
+
+#include <unordered_map>
+
+_NAME_BEGIN
+
+namespace binary
+{
+	const std::uint8_t magic[4] = { 'R', 'A', 'Y', 'B' };
+	const std::uint32_t version = 1;
+
+	// arrays holding only floats (vectors, quaternions, matrices) are stored as one contiguous block
+	const std::uint32_t float_array = archivebuf::type_t::object + 1;
+
+	// deeper trees than this only come from corrupt files, and would otherwise run the reader out of stack
+	const std::uint32_t max_depth = 256;
+
+	struct header
+	{
+		std::uint8_t magic[4];
+		std::uint32_t version;
+		std::uint32_t stringCount;
+		std::uint32_t stringSize;
+	};
+
+	class decoder
+	{
+	public:
+		decoder(const char* data, std::size_t length) noexcept
+			: _data(data)
+			, _end(data + length)
+		{
+		}
+
+		std::uint32_t readUInt32() except
+		{
+			this->check(sizeof(std::uint32_t));
+
+			std::uint32_t value;
+			std::memcpy(&value, _data, sizeof(value));
+			_data += sizeof(value);
+
+			return value;
+		}
+
+		float readFloat() except
+		{
+			this->check(sizeof(float));
+
+			float value;
+			std::memcpy(&value, _data, sizeof(value));
+			_data += sizeof(value);
+
+			return value;
+		}
+
+		const char* readBytes(std::size_t length) except
+		{
+			std::size_t padded = (length + 3) & ~(std::size_t)3;
+			this->check(padded);
+
+			const char* data = _data;
+			_data += padded;
+
+			return data;
+		}
+
+		void checkCount(std::uint32_t count, std::size_t size) except
+		{
+			// every element takes at least size bytes, so a larger count can never be satisfied by the rest of the data
+			if (count > (std::size_t)(_end - _data) / size)
+				throw failure("binary archive has an invalid count");
+		}
+
+	private:
+		void check(std::size_t length) except
+		{
+			if ((std::size_t)(_end - _data) < length)
+				throw failure("binary archive is truncated");
+		}
+
+	private:
+		const char* _data;
+		const char* _end;
+	};
+
+	class encoder
+	{
+	public:
+		void writeUInt32(std::uint32_t value) noexcept
+		{
+			auto offset = _data.size();
+			_data.resize(offset + sizeof(value));
+			std::memcpy(&_data[offset], &value, sizeof(value));
+		}
+
+		void writeFloat(float value) noexcept
+		{
+			auto offset = _data.size();
+			_data.resize(offset + sizeof(value));
+			std::memcpy(&_data[offset], &value, sizeof(value));
+		}
+
+		void writeBytes(const char* data, std::size_t length) noexcept
+		{
+			auto offset = _data.size();
+			_data.resize(offset + ((length + 3) & ~(std::size_t)3), 0);
+			std::memcpy(&_data[offset], data, length);
+		}
+
+		void patch(std::size_t offset, std::uint32_t value) noexcept
+		{
+			std::memcpy(&_data[offset], &value, sizeof(value));
+		}
+
+		std::size_t size() const noexcept
+		{
+			return _data.size();
+		}
+
+		const char* data() const noexcept
+		{
+			return _data.data();
+		}
+
+	private:
+		std::vector<char> _data;
+	};
+
+	class stringtable
+	{
+	public:
+		std::uint32_t intern(const std::string& key) noexcept
+		{
+			auto it = _index.find(key);
+			if (it != _index.end())
+				return (*it).second;
+
+			auto index = static_cast<std::uint32_t>(_strings.size());
+			_index[key] = index;
+			_strings.push_back(&key);
+
+			return index;
+		}
+
+		void write(encoder& out) const noexcept
+		{
+			for (auto& it : _strings)
+			{
+				out.writeUInt32(static_cast<std::uint32_t>(it->size()));
+				out.writeBytes(it->data(), it->size());
+			}
+		}
+
+		std::size_t size() const noexcept
+		{
+			return _strings.size();
+		}
+
+	private:
+		std::unordered_map<std::string, std::uint32_t> _index;
+		std::vector<const std::string*> _strings;
+	};
+
+	void read(decoder& in, const std::vector<std::string>& strings, archivebuf& node, std::uint32_t depth) except
+	{
+		if (depth > max_depth)
+			throw failure("binary archive is nested too deeply");
+
+		auto type = in.readUInt32();
+		switch (type)
+		{
+		case archivebuf::type_t::null:
+			node.emplace(archivebuf::type_t::null);
+			break;
+		case archivebuf::type_t::boolean:
+			node = (archivebuf::boolean_t)(in.readUInt32() ? true : false);
+			break;
+		case archivebuf::type_t::number_integer:
+			node = (archivebuf::number_integer_t)in.readUInt32();
+			break;
+		case archivebuf::type_t::number_unsigned:
+			node = (archivebuf::number_unsigned_t)in.readUInt32();
+			break;
+		case archivebuf::type_t::number_float:
+			node = (archivebuf::number_float_t)in.readFloat();
+			break;
+		case archivebuf::type_t::string:
+		{
+			auto length = in.readUInt32();
+			node = archivebuf::string_t(in.readBytes(length), length);
+		}
+		break;
+		case archivebuf::type_t::array:
+		{
+			in.readUInt32();
+
+			auto count = in.readUInt32();
+			in.checkCount(count, sizeof(std::uint32_t));
+
+			node.emplace(archivebuf::type_t::array);
+
+			auto& values = node.get<archivebuf::array_t>();
+			values.resize(count);
+
+			for (auto& value : values)
+				read(in, strings, value, depth + 1);
+		}
+		break;
+		case float_array:
+		{
+			auto count = in.readUInt32();
+			in.checkCount(count, sizeof(archivebuf::number_float_t));
+
+			auto floats = reinterpret_cast<const archivebuf::number_float_t*>(in.readBytes(count * sizeof(archivebuf::number_float_t)));
+
+			node.emplace(archivebuf::type_t::array);
+
+			auto& values = node.get<archivebuf::array_t>();
+			values.reserve(count);
+
+			for (std::uint32_t i = 0; i < count; i++)
+				values.emplace_back(floats[i]);
+		}
+		break;
+		case archivebuf::type_t::object:
+		{
+			in.readUInt32();
+
+			auto count = in.readUInt32();
+			in.checkCount(count, sizeof(std::uint32_t) * 2);
+
+			node.emplace(archivebuf::type_t::object);
+
+			for (std::uint32_t i = 0; i < count; i++)
+			{
+				auto key = in.readUInt32();
+				if (key >= strings.size())
+					throw failure("binary archive has an invalid key");
+
+				node.push_back(strings[key], archivebuf());
+				read(in, strings, node.back(), depth + 1);
+			}
+		}
+		break;
+		default:
+			throw failure("binary archive has an unknown node type");
+		}
+	}
+
+	void write(encoder& out, stringtable& strings, const archivebuf& node) noexcept
+	{
+		switch (node.type())
+		{
+		case archivebuf::type_t::null:
+			out.writeUInt32(archivebuf::type_t::null);
+			break;
+		case archivebuf::type_t::boolean:
+			out.writeUInt32(archivebuf::type_t::boolean);
+			out.writeUInt32(node.get<archivebuf::boolean_t>() ? 1 : 0);
+			break;
+		case archivebuf::type_t::number_integer:
+			out.writeUInt32(archivebuf::type_t::number_integer);
+			out.writeUInt32((std::uint32_t)node.get<archivebuf::number_integer_t>());
+			break;
+		case archivebuf::type_t::number_unsigned:
+			out.writeUInt32(archivebuf::type_t::number_unsigned);
+			out.writeUInt32(node.get<archivebuf::number_unsigned_t>());
+			break;
+		case archivebuf::type_t::number_float:
+			out.writeUInt32(archivebuf::type_t::number_float);
+			out.writeFloat(node.get<archivebuf::number_float_t>());
+			break;
+		case archivebuf::type_t::string:
+		{
+			auto& value = node.get<archivebuf::string_t>();
+			out.writeUInt32(archivebuf::type_t::string);
+			out.writeUInt32(static_cast<std::uint32_t>(value.size()));
+			out.writeBytes(value.data(), value.size());
+		}
+		break;
+		case archivebuf::type_t::array:
+		{
+			auto& values = node.get<archivebuf::array_t>();
+
+			bool isFloatArray = !values.empty();
+			for (auto& value : values)
+				isFloatArray &= value.is_float();
+
+			if (isFloatArray)
+			{
+				out.writeUInt32(float_array);
+				out.writeUInt32(static_cast<std::uint32_t>(values.size()));
+
+				for (auto& value : values)
+					out.writeFloat(value.get<archivebuf::number_float_t>());
+			}
+			else
+			{
+				out.writeUInt32(archivebuf::type_t::array);
+
+				auto offset = out.size();
+				out.writeUInt32(0);
+				out.writeUInt32(static_cast<std::uint32_t>(values.size()));
+
+				for (auto& value : values)
+					write(out, strings, value);
+
+				out.patch(offset, static_cast<std::uint32_t>(out.size() - offset - sizeof(std::uint32_t)));
+			}
+		}
+		break;
+		case archivebuf::type_t::object:
+		{
+			out.writeUInt32(archivebuf::type_t::object);
+
+			auto offset = out.size();
+			out.writeUInt32(0);
+			out.writeUInt32(static_cast<std::uint32_t>(std::distance(node.begin(), node.end())));
+
+			for (auto& it : node)
+			{
+				out.writeUInt32(strings.intern(it.first));
+				write(out, strings, it.second);
+			}
+
+			out.patch(offset, static_cast<std::uint32_t>(out.size() - offset - sizeof(std::uint32_t)));
+		}
+		break;
+		default:
+			break;
+		}
+	}
+
+	bool save(StreamWrite& stream, const archivebuf& root) noexcept
+	{
+		stringtable strings;
+
+		encoder nodes;
+		write(nodes, strings, root);
+
+		encoder table;
+		strings.write(table);
+
+		header hdr;
+		std::memcpy(hdr.magic, magic, sizeof(magic));
+		hdr.version = version;
+		hdr.stringCount = static_cast<std::uint32_t>(strings.size());
+		hdr.stringSize = static_cast<std::uint32_t>(table.size());
+
+		if (!stream.write((const char*)&hdr, sizeof(hdr)))
+			return false;
+
+		if (!stream.write(table.data(), table.size()))
+			return false;
+
+		if (!stream.write(nodes.data(), nodes.size()))
+			return false;
+
+		return true;
+	}
+}
+
+BinaryReader::BinaryReader() noexcept
+	: iarchive(&_binary)
+{
+}
+
+BinaryReader::BinaryReader(StreamReader& stream) except
+	: iarchive(&_binary)
+{
+	this->open(stream);
+}
+
+BinaryReader::BinaryReader(const std::string& path) except
+	: iarchive(&_binary)
+{
+	this->open(path);
+}
+
+BinaryReader::~BinaryReader() noexcept
+{
+	this->close();
+}
+
+BinaryReader&
+BinaryReader::open(StreamReader& stream) except
+{
+	auto length = stream.size();
+	if (length == 0)
+	{
+		this->setstate(ios_base::failbit);
+		return *this;
+	}
+
+	// word storage keeps the float blocks aligned for in place reads
+	std::vector<std::uint32_t> data((std::size_t)(length + 3) / 4);
+
+	if (!stream.read((char*)data.data(), length))
+	{
+		this->setstate(ios_base::failbit);
+		return *this;
+	}
+
+	return this->open((const char*)data.data(), (std::size_t)length);
+}
+
+BinaryReader&
+BinaryReader::open(const std::string& path) except
+{
+	ifstream stream;
+	if (stream.open(path))
+		return this->open(stream);
+	else
+	{
+		this->setstate(ios_base::failbit);
+		return *this;
+	}
+}
+
+BinaryReader&
+BinaryReader::open(const char* data, std::size_t length) except
+{
+	assert(data);
+	assert(((std::uintptr_t)data & 3) == 0);
+
+	try
+	{
+		_binary.clear();
+
+		binary::decoder in(data, length);
+
+		binary::header hdr;
+		std::memcpy(&hdr, in.readBytes(sizeof(hdr)), sizeof(hdr));
+
+		if (std::memcmp(hdr.magic, binary::magic, sizeof(binary::magic)) != 0)
+			throw failure("binary archive has an invalid magic");
+
+		if (hdr.version != binary::version)
+			throw failure("binary archive has an unsupported version");
+
+		in.checkCount(hdr.stringCount, sizeof(std::uint32_t));
+
+		std::vector<std::string> strings(hdr.stringCount);
+		for (auto& it : strings)
+		{
+			auto size = in.readUInt32();
+			it.assign(in.readBytes(size), size);
+		}
+
+		binary::read(in, strings, _binary, 0);
+
+		this->clear(ios_base::goodbit);
+		return *this;
+	}
+	catch (const failure&)
+	{
+		_binary.clear();
+		this->setstate(ios_base::failbit);
+		throw;
+	}
+}
+
+bool
+BinaryReader::is_open() const noexcept
+{
+	return _binary.size();
+}
+
+void
+BinaryReader::close() noexcept
+{
+	_binary.clear();
+}
+
+bool
+BinaryReader::canRead(StreamReader& stream) noexcept
+{
+	std::uint8_t hdr[sizeof(binary::magic)];
+
+	auto pos = stream.tellg();
+	bool result = stream.read((char*)hdr, sizeof(hdr)) && std::memcmp(hdr, binary::magic, sizeof(binary::magic)) == 0;
+
+	stream.clear();
+	stream.seekg(pos);
+
+	return result;
+}
+
+BinaryWrite::BinaryWrite() noexcept
+	: oarchive(&_binary)
+{
+}
+
+BinaryWrite::~BinaryWrite() noexcept
+{
+	this->close();
+}
+
+BinaryWrite&
+BinaryWrite::save(StreamWrite& stream) except
+{
+	if (binary::save(stream, _binary))
+		ios_base::clear(ios_base::goodbit);
+	else
+		this->setstate(ios_base::failbit);
+
+	return *this;
+}
+
+BinaryWrite&
+BinaryWrite::save(const std::string& path) except
+{
+	ofstream stream;
+	if (stream.open(path))
+		return this->save(stream);
+	else
+	{
+		this->setstate(ios_base::failbit);
+		return *this;
+	}
+}
+
+BinaryWrite&
+BinaryWrite::save(StreamWrite& stream, const iarchive& archive) except
+{
+	assert(archive.rdbuf());
+
+	if (binary::save(stream, *archive.rdbuf()))
+		ios_base::clear(ios_base::goodbit);
+	else
+		this->setstate(ios_base::failbit);
+
+	return *this;
+}
+
+BinaryWrite&
+BinaryWrite::save(const std::string& path, const iarchive& archive) except
+{
+	ofstream stream;
+	if (stream.open(path))
+		return this->save(stream, archive);
+	else
+	{
+		this->setstate(ios_base::failbit);
+		return *this;
+	}
+}
+
+void
+BinaryWrite::close() noexcept
+{
+	_binary.clear();
+}
+
+bool
+BinaryWrite::is_open() const noexcept
+{
+	return _binary.size();
+}
+
+_NAME_END
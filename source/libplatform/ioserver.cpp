@@ -37,6 +37,7 @@
 #include <ray/ioserver.h>
 #include <ray/iolistener.h>
 #include <ray/fstream.h>
+#include <ray/mapstream.h>
 #include <ray/utf8.h>
 
 _NAME_BEGIN
@@ -76,6 +77,9 @@ IoServer::mountArchives() noexcept
 {
 	_enablePackage = true;
 
+	for (auto& it : _assignTable)
+		this->_addAssignArchive(it.first, it.second);
+
 	this->setstate(ios_base::goodbit);
 	return *this;
 }
@@ -89,6 +93,102 @@ IoServer::unmountArchives() noexcept
 	return *this;
 }
 
+IoServer&
+IoServer::addArchive(const util::string& name, const util::string& path) noexcept
+{
+	assert(!path.empty());
+
+	for (auto& it : _archives)
+	{
+		if (it.first == name && it.second->getPath() == path)
+		{
+			this->setstate(ios_base::goodbit);
+			return *this;
+		}
+	}
+
+	auto package = std::make_shared<Package>();
+	if (!package->open(path))
+	{
+		this->setstate(ios_base::failbit);
+		return *this;
+	}
+
+	for (auto& listener : _ioListener)
+		listener->onMessage("mounting archive : " + path);
+
+	_archives.emplace_back(name, std::move(package));
+
+	this->setstate(ios_base::goodbit);
+	return *this;
+}
+
+IoServer&
+IoServer::removeArchive(const util::string& name) noexcept
+{
+	auto it = std::remove_if(_archives.begin(), _archives.end(), [&](const std::pair<util::string, PackagePtr>& archive) { return archive.first == name; });
+	if (it != _archives.end())
+	{
+		_archives.erase(it, _archives.end());
+
+		this->setstate(ios_base::goodbit);
+		return *this;
+	}
+
+	this->setstate(ios_base::failbit);
+	return *this;
+}
+
+void
+IoServer::_addAssignArchive(const util::string& name, const util::string& path) noexcept
+{
+	// an assign such as "sys" -> "engine/" picks up "engine.pak" beside the directory
+	auto archive = path;
+	while (!archive.empty() && ray::util::isSeparator(*archive.rbegin()))
+		archive.pop_back();
+
+	if (archive.empty())
+		return;
+
+	archive += ".pak";
+
+	if (faccess(archive.c_str(), 0) == 0)
+		this->addArchive(name, archive);
+}
+
+const Package*
+IoServer::_findArchiveFile(util::string::const_pointer url, util::string::const_pointer& name) const noexcept
+{
+	assert(url);
+
+	if (!_enablePackage || _archives.empty())
+		return nullptr;
+
+	// "name:path" with more than one letter before the colon, so drive letters stay on disk
+	std::size_t length = 0;
+	auto index = std::strchr(url, ':');
+	if (index && index - url > 1)
+	{
+		length = index - url;
+		name = index + 1;
+	}
+	else
+	{
+		name = url;
+	}
+
+	for (auto it = _archives.rbegin(); it != _archives.rend(); ++it)
+	{
+		if ((*it).first.size() == length && std::strncmp((*it).first.c_str(), url, length) == 0)
+		{
+			if ((*it).second->exists(name))
+				return (*it).second.get();
+		}
+	}
+
+	return nullptr;
+}
+
 IoServer&
 IoServer::addAssign(IoAssign&& assign) noexcept
 {
@@ -105,9 +205,12 @@ IoServer::addAssign(IoAssign&& assign) noexcept
 	}
 
 	if (ray::util::isSeparator(*assign.path.rbegin()))
-		_assignTable[std::move(assign.name)] = std::move(assign.path);
+		_assignTable[assign.name] = std::move(assign.path);
 	else
-		_assignTable[std::move(assign.name)] = std::move(assign.path) + SEPARATOR;
+		_assignTable[assign.name] = std::move(assign.path) + SEPARATOR;
+
+	if (_enablePackage)
+		this->_addAssignArchive(assign.name, _assignTable[assign.name]);
 
 	this->setstate(ios_base::goodbit);
 	return *this;
@@ -133,6 +236,9 @@ IoServer::addAssign(const IoAssign& assign) noexcept
 	else
 		_assignTable[assign.name] = assign.path + SEPARATOR;
 
+	if (_enablePackage)
+		this->_addAssignArchive(assign.name, _assignTable[assign.name]);
+
 	this->setstate(ios_base::goodbit);
 	return *this;
 }
@@ -215,18 +321,23 @@ IoServer::getResolveAssign(util::string::const_pointer url, util::string& resolv
 IoServer&
 IoServer::openFileURL(StreamReaderPtr& stream, const util::string& path, open_mode mode) noexcept
 {
-	bool result = this->openFileFromFileSystem(stream, path, mode);
-	if (!result)
-		result = this->openFileFromDiskURL(stream, path, mode);
+	// the stream is only assigned on success; unlike the shared stream state it can be trusted across threads
+	std::lock_guard<std::mutex> lock(_openLock);
+	stream = nullptr;
+	this->openFileFromFileSystem(stream, path, mode);
+	if (!stream)
+		this->openFileFromDiskURL(stream, path, mode);
 	return *this;
 }
 
 IoServer&
 IoServer::openFileURL(StreamReaderPtr& stream, util::string::const_pointer path, open_mode mode) noexcept
 {
-	bool result = this->openFileFromFileSystem(stream, path, mode);
-	if (!result)
-		result = this->openFileFromDiskURL(stream, path, mode);
+	std::lock_guard<std::mutex> lock(_openLock);
+	stream = nullptr;
+	this->openFileFromFileSystem(stream, path, mode);
+	if (!stream)
+		this->openFileFromDiskURL(stream, path, mode);
 	return *this;
 }
 
@@ -240,6 +351,17 @@ IoServer::openFileFromDisk(StreamReaderPtr& result, std::string::const_pointer r
 
 	if (this->existsFileFromDisk(resolvePath, mode))
 	{
+		if (mode == ios_base::in)
+		{
+			auto stream = std::make_shared<MappingReader>();
+			if (stream->open(resolvePath))
+			{
+				result = stream;
+				this->setstate(ios_base::goodbit);
+				return *this;
+			}
+		}
+
 		auto stream = std::make_shared<fstream>();
 		stream->setOpenMode(mode);
 		if (stream->open(resolvePath))
@@ -264,6 +386,17 @@ IoServer::openFileFromDisk(StreamReaderPtr& result, const std::string& resolvePa
 
 	if (this->existsFileFromDisk(resolvePath, mode))
 	{
+		if (mode == ios_base::in)
+		{
+			auto stream = std::make_shared<MappingReader>();
+			if (stream->open(resolvePath))
+			{
+				result = stream;
+				this->setstate(ios_base::goodbit);
+				return *this;
+			}
+		}
+
 		auto stream = std::make_shared<fstream>();
 		stream->setOpenMode(mode);
 		if (stream->open(resolvePath))
@@ -285,6 +418,17 @@ IoServer::openFileFromDisk(StreamReaderPtr& result, std::wstring::const_pointer
 
 	if (this->existsFileFromDisk(resolvePath, mode))
 	{
+		if (mode == ios_base::in)
+		{
+			auto stream = std::make_shared<MappingReader>();
+			if (stream->open(resolvePath))
+			{
+				result = stream;
+				this->setstate(ios_base::goodbit);
+				return *this;
+			}
+		}
+
 		auto stream = std::make_shared<fstream>();
 		stream->setOpenMode(mode);
 		if (stream->open(resolvePath))
@@ -306,6 +450,17 @@ IoServer::openFileFromDisk(StreamReaderPtr& result, const std::wstring& resolveP
 
 	if (this->existsFileFromDisk(resolvePath, mode))
 	{
+		if (mode == ios_base::in)
+		{
+			auto stream = std::make_shared<MappingReader>();
+			if (stream->open(resolvePath))
+			{
+				result = stream;
+				this->setstate(ios_base::goodbit);
+				return *this;
+			}
+		}
+
 		auto stream = std::make_shared<fstream>();
 		stream->setOpenMode(mode);
 		if (stream->open(resolvePath))
@@ -387,13 +542,28 @@ IoServer::openFileFromDiskURL(StreamReaderPtr& result, util::string::const_point
 IoServer&
 IoServer::openFileFromFileSystem(StreamReaderPtr& stream, const util::string& path, open_mode mode) noexcept
 {
-	this->setstate(ios_base::failbit);
-	return *this;
+	return this->openFileFromFileSystem(stream, path.c_str(), mode);
 }
 
 IoServer&
 IoServer::openFileFromFileSystem(StreamReaderPtr& stream, util::string::const_pointer path, open_mode mode) noexcept
 {
+	assert(path);
+
+	if (!(mode & ios_base::out))
+	{
+		util::string::const_pointer name = nullptr;
+		auto package = this->_findArchiveFile(path, name);
+		if (package && package->openFile(stream, name))
+		{
+			for (auto& listener : _ioListener)
+				listener->onMessage(std::string("loading resource : ") + path);
+
+			this->clear(ios_base::goodbit);
+			return *this;
+		}
+	}
+
 	this->setstate(ios_base::failbit);
 	return *this;
 }
@@ -608,6 +778,13 @@ IoServer::existsFile(const util::string& path) noexcept
 IoServer&
 IoServer::existsFileFromFileSystem(const util::string& path) noexcept
 {
+	util::string::const_pointer name = nullptr;
+	if (this->_findArchiveFile(path.c_str(), name))
+	{
+		this->clear(ios_base::goodbit);
+		return *this;
+	}
+
 	this->setstate(ios_base::failbit);
 	return *this;
 }
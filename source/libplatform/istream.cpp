@@ -174,4 +174,43 @@ StreamReader::gcount() const noexcept
 	return _count;
 }
 
+char*
+StreamReader::map() noexcept
+{
+	assert(this->rdbuf() != 0);
+	return this->rdbuf()->map();
+}
+
+void
+StreamReader::unmap() noexcept
+{
+	assert(this->rdbuf() != 0);
+	this->rdbuf()->unmap();
+}
+
+bool
+StreamReader::isMapping() const noexcept
+{
+	assert(this->rdbuf() != 0);
+	return this->rdbuf()->isMapping();
+}
+
+StreamMapping::StreamMapping(StreamReader& stream) noexcept
+	: _data(stream.map())
+	, _stream(stream)
+{
+}
+
+StreamMapping::~StreamMapping() noexcept
+{
+	if (_data)
+		_stream.unmap();
+}
+
+char*
+StreamMapping::data() const noexcept
+{
+	return _data;
+}
+
 _NAME_END
\ No newline at end of file
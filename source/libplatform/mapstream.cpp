@@ -0,0 +1,274 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#include <ray/mapstream.h>
+#include <ray/utf8.h>
+
+#if !defined(__WINDOWS__)
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+_NAME_BEGIN
+
+namespace
+{
+	// reads files below MappingReader::mapThreshold into buf when one is given and maps everything else
+#if defined(__WINDOWS__)
+	bool loadFile(const wchar_t* filename, MemoryBuf* buf, std::shared_ptr<const char>& mapping, std::uint64_t& size) noexcept
+	{
+		HANDLE file = ::CreateFileW(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER length;
+		if (!::GetFileSizeEx(file, &length))
+		{
+			::CloseHandle(file);
+			return false;
+		}
+
+		size = length.QuadPart;
+
+		if (buf && size < MappingReader::mapThreshold)
+		{
+			buf->resize(size);
+
+			DWORD count = 0;
+			bool result = size == 0 || (::ReadFile(file, buf->map(), (DWORD)size, &count, nullptr) && count == size);
+			if (size > 0)
+				buf->unmap();
+
+			::CloseHandle(file);
+			return result;
+		}
+
+		HANDLE handle = size > 0 ? ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+		::CloseHandle(file);
+
+		if (!handle)
+			return false;
+
+		// the view keeps the mapping object alive after its handle is closed
+		auto data = (const char*)::MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+		::CloseHandle(handle);
+
+		if (!data)
+			return false;
+
+		mapping = std::shared_ptr<const char>(data, [](const char* data) { ::UnmapViewOfFile(data); });
+		return buf ? buf->open(data, size, mapping) : true;
+	}
+
+	bool loadFile(const char* filename, MemoryBuf* buf, std::shared_ptr<const char>& mapping, std::uint64_t& size) noexcept
+	{
+		wchar_t filepath[PATHLIMIT];
+		if (!utf8_to_utf16(filename, std::strlen(filename), filepath, PATHLIMIT))
+			return false;
+
+		return loadFile(filepath, buf, mapping, size);
+	}
+#else
+	bool loadFile(const char* filename, MemoryBuf* buf, std::shared_ptr<const char>& mapping, std::uint64_t& size) noexcept
+	{
+		int file = ::open(filename, O_RDONLY);
+		if (file == -1)
+			return false;
+
+		struct stat st;
+		if (::fstat(file, &st) != 0)
+		{
+			::close(file);
+			return false;
+		}
+
+		size = st.st_size;
+
+		if (buf && size < MappingReader::mapThreshold)
+		{
+			buf->resize(size);
+
+			bool result = true;
+			if (size > 0)
+			{
+				auto data = buf->map();
+				for (std::uint64_t offset = 0; offset < size;)
+				{
+					auto count = ::read(file, data + offset, size - offset);
+					if (count <= 0)
+					{
+						result = false;
+						break;
+					}
+
+					offset += count;
+				}
+
+				buf->unmap();
+			}
+
+			::close(file);
+			return result;
+		}
+
+		auto length = (std::size_t)size;
+		auto data = length > 0 ? ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0) : MAP_FAILED;
+		::close(file);
+
+		if (data == MAP_FAILED)
+			return false;
+
+		mapping = std::shared_ptr<const char>((const char*)data, [length](const char* data) { ::munmap((void*)data, length); });
+		return buf ? buf->open(mapping.get(), size, mapping) : true;
+	}
+
+	bool loadFile(const wchar_t* filename, MemoryBuf* buf, std::shared_ptr<const char>& mapping, std::uint64_t& size) noexcept
+	{
+		char filepath[PATHLIMIT];
+		if (::wcstombs(filepath, filename, PATHLIMIT) == (std::size_t)-1)
+			return false;
+
+		return loadFile(filepath, buf, mapping, size);
+	}
+#endif
+}
+
+MappingReader::MappingReader() noexcept
+	: StreamReader(&_buf)
+{
+}
+
+MappingReader::~MappingReader() noexcept
+{
+	this->close();
+}
+
+MappingReader&
+MappingReader::open(const char* filename) noexcept
+{
+	assert(filename);
+
+	std::uint64_t size = 0;
+	std::shared_ptr<const char> mapping;
+
+	_buf.close();
+	_buf.open(ios_base::in);
+
+	if (loadFile(filename, &_buf, mapping, size))
+		this->clear(ios_base::goodbit);
+	else
+	{
+		_buf.close();
+		this->setstate(ios_base::failbit);
+	}
+
+	return *this;
+}
+
+MappingReader&
+MappingReader::open(const wchar_t* filename) noexcept
+{
+	assert(filename);
+
+	std::uint64_t size = 0;
+	std::shared_ptr<const char> mapping;
+
+	_buf.close();
+	_buf.open(ios_base::in);
+
+	if (loadFile(filename, &_buf, mapping, size))
+		this->clear(ios_base::goodbit);
+	else
+	{
+		_buf.close();
+		this->setstate(ios_base::failbit);
+	}
+
+	return *this;
+}
+
+MappingReader&
+MappingReader::open(const std::string& filename) noexcept
+{
+	return this->open(filename.c_str());
+}
+
+MappingReader&
+MappingReader::open(const std::wstring& filename) noexcept
+{
+	return this->open(filename.c_str());
+}
+
+MappingReader&
+MappingReader::close() noexcept
+{
+	_buf.close();
+	return *this;
+}
+
+bool
+MappingReader::is_open() const noexcept
+{
+	return _buf.is_open();
+}
+
+std::shared_ptr<const char>
+MappingReader::mapFile(const char* filename, std::uint64_t& size) noexcept
+{
+	assert(filename);
+
+	std::shared_ptr<const char> mapping;
+	if (loadFile(filename, nullptr, mapping, size))
+		return mapping;
+
+	return nullptr;
+}
+
+std::shared_ptr<const char>
+MappingReader::mapFile(const wchar_t* filename, std::uint64_t& size) noexcept
+{
+	assert(filename);
+
+	std::shared_ptr<const char> mapping;
+	if (loadFile(filename, nullptr, mapping, size))
+		return mapping;
+
+	return nullptr;
+}
+
+_NAME_END
\ No newline at end of file
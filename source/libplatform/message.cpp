@@ -109,8 +109,129 @@ MessageListener::onMessage(const MessagePtr& message) except
 {
 }
 
+namespace
+{
+	const std::size_t MESSAGE_POOL_GRANULARITY = 64;
+	const std::size_t MESSAGE_POOL_CLASSES = 8;
+	const std::size_t MESSAGE_POOL_THREAD_CACHE = 256;
+	const std::size_t MESSAGE_QUEUE_CAPACITY = 4096;
+
+	struct MessageBlock
+	{
+		MessageBlock* next;
+	};
+
+	// blocks a thread could not keep in its own cache, taken back in one exchange so the stack never pops a single node
+	std::atomic<MessageBlock*> _messageSharedBlocks[MESSAGE_POOL_CLASSES];
+
+	void pushSharedBlocks(std::size_t index, MessageBlock* first, MessageBlock* last) noexcept
+	{
+		MessageBlock* head = _messageSharedBlocks[index].load(std::memory_order_relaxed);
+		do
+		{
+			last->next = head;
+		} while (!_messageSharedBlocks[index].compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	struct MessageThreadCache
+	{
+		MessageBlock* blocks[MESSAGE_POOL_CLASSES];
+		std::size_t counts[MESSAGE_POOL_CLASSES];
+
+		MessageThreadCache() noexcept
+			: blocks()
+			, counts()
+		{
+		}
+
+		~MessageThreadCache() noexcept
+		{
+			for (std::size_t i = 0; i < MESSAGE_POOL_CLASSES; i++)
+			{
+				if (!blocks[i])
+				{
+					counts[i] = MESSAGE_POOL_THREAD_CACHE;
+					continue;
+				}
+
+				MessageBlock* last = blocks[i];
+				while (last->next)
+					last = last->next;
+
+				pushSharedBlocks(i, blocks[i], last);
+
+				// anything released after the cache is gone goes straight to the shared stack
+				blocks[i] = nullptr;
+				counts[i] = MESSAGE_POOL_THREAD_CACHE;
+			}
+		}
+	};
+
+	thread_local MessageThreadCache _messageThreadCache;
+}
+
+void*
+MessagePool::allocate(std::size_t size) except
+{
+	std::size_t index = (size + MESSAGE_POOL_GRANULARITY - 1) / MESSAGE_POOL_GRANULARITY - 1;
+	if (size == 0 || index >= MESSAGE_POOL_CLASSES)
+		return ::operator new(size);
+
+	auto& cache = _messageThreadCache;
+	if (!cache.blocks[index])
+	{
+		MessageBlock* blocks = _messageSharedBlocks[index].exchange(nullptr, std::memory_order_acquire);
+		if (!blocks)
+			return ::operator new((index + 1) * MESSAGE_POOL_GRANULARITY);
+
+		// the whole chain now belongs to this thread, recount it once
+		std::size_t count = 0;
+		for (MessageBlock* it = blocks; it; it = it->next)
+			count++;
+
+		cache.blocks[index] = blocks;
+		cache.counts[index] = count;
+	}
+
+	MessageBlock* block = cache.blocks[index];
+	cache.blocks[index] = block->next;
+	cache.counts[index]--;
+	return block;
+}
+
+void
+MessagePool::deallocate(void* ptr, std::size_t size) noexcept
+{
+	if (!ptr)
+		return;
+
+	std::size_t index = (size + MESSAGE_POOL_GRANULARITY - 1) / MESSAGE_POOL_GRANULARITY - 1;
+	if (size == 0 || index >= MESSAGE_POOL_CLASSES)
+	{
+		::operator delete(ptr);
+		return;
+	}
+
+	auto block = static_cast<MessageBlock*>(ptr);
+
+	auto& cache = _messageThreadCache;
+	if (cache.counts[index] < MESSAGE_POOL_THREAD_CACHE)
+	{
+		block->next = cache.blocks[index];
+		cache.blocks[index] = block;
+		cache.counts[index]++;
+	}
+	else
+	{
+		pushSharedBlocks(index, block, block);
+	}
+}
+
 MessageDispatcher::MessageDispatcher() noexcept
 	: _enableMessagePosting(true)
+	, _events(MESSAGE_QUEUE_CAPACITY)
+	, _dispatchThread(std::this_thread::get_id())
+	, _waiting(false)
 {
 }
 
@@ -161,10 +282,26 @@ MessageDispatcher::sendMessage(const MessagePtr& event) except
 void
 MessageDispatcher::postMessage(const MessagePtr& event) except
 {
-	if (_enableMessagePosting)
+	if (!_enableMessagePosting.load(std::memory_order_relaxed))
+		return;
+
+	if (_dispatchThread.load(std::memory_order_relaxed) == std::this_thread::get_id())
+	{
+		// the dispatching thread cannot wait for itself to make room, park the message until the next poll
+		if (!_pendingEvents.empty() || !_events.try_push(event))
+			_pendingEvents.push(event);
+	}
+	else
+	{
+		while (!_events.try_push(event))
+			std::this_thread::yield();
+	}
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (_waiting.load(std::memory_order_relaxed))
 	{
 		_mutex.lock();
-		_events.push(event);
 		_mutex.unlock();
 
 		_dispose.notify_one();
@@ -174,33 +311,50 @@ MessageDispatcher::postMessage(const MessagePtr& event) except
 void
 MessageDispatcher::peekMessages(MessagePtr& event) noexcept
 {
+	this->bindDispatchThread();
+	this->_flushPendingMessages();
+
+	if (!_events.try_peek(event))
+		event = nullptr;
 }
 
 bool
 MessageDispatcher::pollMessages(MessagePtr& event) noexcept
 {
-	std::unique_lock<std::mutex> lock(_mutex);
-	if (lock)
+	this->bindDispatchThread();
+	this->_flushPendingMessages();
+
+	return _events.try_pop(event);
+}
+
+bool
+MessageDispatcher::pollMessages(Messages& events) noexcept
+{
+	this->bindDispatchThread();
+
+	std::size_t count = _events.try_pop_all(events);
+
+	while (!_pendingEvents.empty())
 	{
-		if (!_events.empty())
-		{
-			event = _events.front();
-			_events.pop();
-			return true;
-		}
+		this->_flushPendingMessages();
+		count += _events.try_pop_all(events);
 	}
 
-	return false;
+	return count > 0;
 }
 
 bool
 MessageDispatcher::waitMessages(MessagePtr& event) noexcept
 {
+	if (this->pollMessages(event))
+		return true;
+
 	std::unique_lock<std::mutex> lock(_mutex);
-	if (_events.empty())
-	{
-		_dispose.wait(lock);
-	}
+	_waiting.store(true);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	_dispose.wait(lock, [this]() { return !_events.empty(); });
+	_waiting.store(false);
+	lock.unlock();
 
 	return this->pollMessages(event);
 }
@@ -208,11 +362,15 @@ MessageDispatcher::waitMessages(MessagePtr& event) noexcept
 bool
 MessageDispatcher::waitMessages(MessagePtr& event, int timeout) noexcept
 {
+	if (this->pollMessages(event))
+		return true;
+
 	std::unique_lock<std::mutex> lock(_mutex);
-	if (_events.empty())
-	{
-		_dispose.wait_for(lock, std::chrono::milliseconds(timeout));
-	}
+	_waiting.store(true);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	_dispose.wait_for(lock, std::chrono::milliseconds(timeout), [this]() { return !_events.empty(); });
+	_waiting.store(false);
+	lock.unlock();
 
 	return this->pollMessages(event);
 }
@@ -220,9 +378,31 @@ MessageDispatcher::waitMessages(MessagePtr& event, int timeout) noexcept
 void
 MessageDispatcher::flushMessage() noexcept
 {
-	_mutex.lock();
-	_events = std::queue<MessagePtr>();
-	_mutex.unlock();
+	this->bindDispatchThread();
+
+	_pendingEvents = std::queue<MessagePtr>();
+
+	MessagePtr event;
+	while (_events.try_pop(event))
+		event = nullptr;
+}
+
+void
+MessageDispatcher::bindDispatchThread() noexcept
+{
+	_dispatchThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+}
+
+void
+MessageDispatcher::_flushPendingMessages() noexcept
+{
+	while (!_pendingEvents.empty())
+	{
+		if (!_events.try_push(_pendingEvents.front()))
+			break;
+
+		_pendingEvents.pop();
+	}
 }
 
 _NAME_END
\ No newline at end of file
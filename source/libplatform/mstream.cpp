@@ -41,6 +41,8 @@ _NAME_BEGIN
 MemoryBuf::MemoryBuf() noexcept
 	: _isMappinged(false)
 	, _next(0)
+	, _view(nullptr)
+	, _viewSize(0)
 {
 }
 
@@ -56,24 +58,56 @@ MemoryBuf::open(ios_base::openmode mode) noexcept
 	return true;
 }
 
+bool
+MemoryBuf::open(const char* data, streamsize size, const std::shared_ptr<const void>& owner) noexcept
+{
+	assert(data || size == 0);
+	assert(!_isMappinged);
+
+	_data.clear();
+	_next = 0;
+	_view = data;
+	_viewSize = size;
+	_owner = owner;
+	return true;
+}
+
 bool
 MemoryBuf::close() noexcept
 {
 	_data.clear();
+	_view = nullptr;
+	_viewSize = 0;
+	_owner.reset();
 	return true;
 }
 
+void
+MemoryBuf::detach() noexcept
+{
+	if (_view)
+	{
+		_data.assign(_view, _view + _viewSize);
+		_view = nullptr;
+		_viewSize = 0;
+		_owner.reset();
+	}
+}
+
 streamsize
 MemoryBuf::read(char* src, std::streamsize cnt) noexcept
 {
-	if (_data.size() < _next + cnt)
+	auto data = _view ? _view : _data.data();
+	auto size = this->size();
+
+	if (size < _next + cnt)
 	{
-		cnt = _data.size() - _next;
+		cnt = size - _next;
 		if (cnt == 0)
 			return 0;
 	}
 
-	std::memcpy(src, _data.data() + _next, cnt);
+	std::memcpy(src, data + _next, cnt);
 	_next += cnt;
 
 	return cnt;
@@ -82,6 +116,8 @@ MemoryBuf::read(char* src, std::streamsize cnt) noexcept
 streamsize
 MemoryBuf::write(const char* src, std::streamsize cnt) noexcept
 {
+	this->detach();
+
 	if (_data.size() < _next + cnt)
 		_data.resize(_next + cnt);
 
@@ -103,17 +139,17 @@ MemoryBuf::seekg(ios_base::off_type pos, ios_base::seekdir dir) noexcept
 	else if (dir == ios_base::cur)
 	{
 		_next = _next + pos;
-		if (_next > _data.size())
+		if (_next > this->size())
 		{
-			pos = _data.size() - _next;
-			_next = _data.size();
+			pos = this->size() - _next;
+			_next = this->size();
 		}
 
 		return pos;
 	}
 	else if (dir == ios_base::end)
 	{
-		std::size_t size = _data.size();
+		std::size_t size = this->size();
 		pos = size + pos;
 		if (pos > size)
 			_next = size;
@@ -134,13 +170,13 @@ MemoryBuf::tellg() noexcept
 streamsize
 MemoryBuf::size() const noexcept
 {
-	return _data.size();
+	return _view ? _viewSize : _data.size();
 }
 
 bool
 MemoryBuf::is_open() const noexcept
 {
-	return !_data.empty();
+	return _view || !_data.empty();
 }
 
 int
@@ -152,6 +188,7 @@ MemoryBuf::flush() noexcept
 void
 MemoryBuf::resize(streamsize size) noexcept
 {
+	this->detach();
 	_data.resize(size);
 }
 
@@ -159,6 +196,12 @@ char*
 MemoryBuf::map() noexcept
 {
 	assert(!_isMappinged);
+	if (_view)
+	{
+		_isMappinged = true;
+		return const_cast<char*>(_view);
+	}
+
 	if (_data.size())
 	{
 		_isMappinged = true;
@@ -190,28 +233,23 @@ MemoryReader::~MemoryReader() noexcept
 {
 }
 
-void
-MemoryReader::resize(streamsize size) noexcept
+bool
+MemoryReader::open(const char* data, streamsize size, const std::shared_ptr<const void>& owner) noexcept
 {
-	_buf.resize(size);
-}
+	if (!_buf.open(data, size, owner))
+	{
+		this->setstate(ios_base::failbit);
+		return false;
+	}
 
-char*
-MemoryReader::map() noexcept
-{
-	return _buf.map();
+	this->clear(ios_base::goodbit);
+	return true;
 }
 
 void
-MemoryReader::unmap() noexcept
-{
-	return _buf.unmap();
-}
-
-bool
-MemoryReader::isMapping() const noexcept
+MemoryReader::resize(streamsize size) noexcept
 {
-	return _buf.isMapping();
+	_buf.resize(size);
 }
 
 MemoryWrite::MemoryWrite() noexcept
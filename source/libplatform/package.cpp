@@ -34,4 +34,484 @@
 // | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // +----------------------------------------------------------------------
-#include <ray/package.h>
\ No newline at end of file
+#include <ray/package.h>
+#include <ray/mapstream.h>
+#include <ray/fstream.h>
+
+#include <limits>
+#include <zlib.h>
+
+#if !defined(__WINDOWS__)
+#	include <sys/mman.h>
+#endif
+
+_NAME_BEGIN
+
+static_assert(sizeof(PackageHeader) == 32, "PackageHeader must match the on-disk layout");
+static_assert(sizeof(PackageEntry) == 40, "PackageEntry must match the on-disk layout");
+
+namespace
+{
+	inline char normalizeChar(char c) noexcept
+	{
+		if (c == '\\')
+			return '/';
+		if (c >= 'A' && c <= 'Z')
+			return c - 'A' + 'a';
+		return c;
+	}
+
+	inline bool equalName(const char* a, const char* b, std::size_t length) noexcept
+	{
+		for (std::size_t i = 0; i < length; i++)
+		{
+			if (a[i] != normalizeChar(b[i]))
+				return false;
+		}
+
+		return true;
+	}
+
+	inline void skipSeparators(util::string::const_pointer& name, std::size_t& length) noexcept
+	{
+		while (length > 0 && util::isSeparator(*name))
+		{
+			name++;
+			length--;
+		}
+	}
+}
+
+Package::Package() noexcept
+	: _size(0)
+	, _header(nullptr)
+	, _entries(nullptr)
+	, _buckets(nullptr)
+	, _names(nullptr)
+	, _namesSize(0)
+{
+}
+
+Package::~Package() noexcept
+{
+	this->close();
+}
+
+bool
+Package::open(const util::string& path) noexcept
+{
+	assert(!this->is_open());
+
+	std::uint64_t size = 0;
+	auto mapping = MappingReader::mapFile(path.c_str(), size);
+	if (!mapping || size < sizeof(PackageHeader))
+		return false;
+
+#if !defined(__WINDOWS__)
+	// entries are touched in no particular order, read ahead is requested per entry in openFile
+	::posix_madvise((void*)mapping.get(), size, POSIX_MADV_RANDOM);
+#endif
+
+	_size = size;
+	_mapping = std::move(mapping);
+
+	auto base = _mapping.get();
+
+	_header = (const PackageHeader*)base;
+	if (!this->validate())
+	{
+		this->close();
+		return false;
+	}
+
+	_entries = (const PackageEntry*)(base + _header->tocOffset);
+	_buckets = (const std::uint32_t*)(_entries + _header->numEntries);
+	_names = (const char*)(_buckets + _header->numBuckets);
+	_namesSize = _header->tocSize - ((const char*)_names - (base + _header->tocOffset));
+
+	for (std::size_t i = 0; i < _header->numEntries; i++)
+	{
+		auto& entry = _entries[i];
+		if (entry.compression > PackageCompressionEndRange ||
+			entry.offset > _size || entry.packedSize > _size - entry.offset ||
+			entry.nameOffset > _namesSize || entry.nameLength > _namesSize - entry.nameOffset ||
+			(entry.compression == PackageCompressionNone && entry.packedSize != entry.size))
+		{
+			this->close();
+			return false;
+		}
+	}
+
+	for (std::size_t i = 0; i < _header->numBuckets; i++)
+	{
+		if (_buckets[i] != invalidIndex && _buckets[i] >= _header->numEntries)
+		{
+			this->close();
+			return false;
+		}
+	}
+
+	_path = path;
+	return true;
+}
+
+bool
+Package::validate() const noexcept
+{
+	if (_header->magic != magic || _header->version != version)
+		return false;
+
+	// a power of two bucket count with at least one free bucket keeps every probe finite
+	if (_header->numBuckets == 0 || (_header->numBuckets & (_header->numBuckets - 1)) || _header->numBuckets <= _header->numEntries)
+		return false;
+
+	if (_header->tocOffset % sizeof(std::uint64_t) || _header->tocOffset > _size || _header->tocSize > _size - _header->tocOffset)
+		return false;
+
+	std::uint64_t tableSize = _header->numEntries * sizeof(PackageEntry) + _header->numBuckets * sizeof(std::uint32_t);
+	if (tableSize > _header->tocSize)
+		return false;
+
+	return true;
+}
+
+void
+Package::close() noexcept
+{
+	_mapping.reset();
+	_path.clear();
+	_size = 0;
+	_header = nullptr;
+	_entries = nullptr;
+	_buckets = nullptr;
+	_names = nullptr;
+	_namesSize = 0;
+}
+
+bool
+Package::is_open() const noexcept
+{
+	return _mapping != nullptr;
+}
+
+const util::string&
+Package::getPath() const noexcept
+{
+	return _path;
+}
+
+std::size_t
+Package::size() const noexcept
+{
+	return _header ? _header->numEntries : 0;
+}
+
+const PackageEntry&
+Package::getEntry(std::size_t index) const noexcept
+{
+	assert(index < this->size());
+	return _entries[index];
+}
+
+util::string
+Package::getEntryName(std::size_t index) const noexcept
+{
+	assert(index < this->size());
+	return util::string(_names + _entries[index].nameOffset, _entries[index].nameLength);
+}
+
+bool
+Package::exists(const util::string& name) const noexcept
+{
+	return this->find(name.c_str(), name.size()) != nullptr;
+}
+
+bool
+Package::exists(util::string::const_pointer name) const noexcept
+{
+	assert(name);
+	return this->find(name, std::strlen(name)) != nullptr;
+}
+
+bool
+Package::openFile(StreamReaderPtr& stream, const util::string& name) const noexcept
+{
+	auto entry = this->find(name.c_str(), name.size());
+	if (entry)
+		return this->openFile(stream, *entry);
+	return false;
+}
+
+bool
+Package::openFile(StreamReaderPtr& stream, util::string::const_pointer name) const noexcept
+{
+	assert(name);
+
+	auto entry = this->find(name, std::strlen(name));
+	if (entry)
+		return this->openFile(stream, *entry);
+	return false;
+}
+
+bool
+Package::openFile(StreamReaderPtr& stream, const PackageEntry& entry) const noexcept
+{
+	auto data = _mapping.get() + entry.offset;
+	auto reader = std::make_shared<MemoryReader>();
+
+	if (entry.compression == PackageCompressionNone)
+	{
+#if !defined(__WINDOWS__)
+		if (entry.size > 0)
+			::posix_madvise((void*)data, entry.size, POSIX_MADV_WILLNEED);
+#endif
+		if (!reader->open(data, entry.size, _mapping))
+			return false;
+	}
+	else if (entry.compression == PackageCompressionZlib)
+	{
+		if (entry.size > std::numeric_limits<uLong>::max() || entry.packedSize > std::numeric_limits<uLong>::max())
+			return false;
+
+		reader->resize(entry.size);
+
+		uLongf length = (uLongf)entry.size;
+		int result = ::uncompress((Bytef*)reader->map(), &length, (const Bytef*)data, (uLong)entry.packedSize);
+		reader->unmap();
+
+		if (result != Z_OK || length != entry.size)
+			return false;
+	}
+	else
+	{
+		return false;
+	}
+
+	stream = reader;
+	return true;
+}
+
+const PackageEntry*
+Package::find(util::string::const_pointer name, std::size_t length) const noexcept
+{
+	if (!_header)
+		return nullptr;
+
+	skipSeparators(name, length);
+
+	std::uint64_t hash = Package::hash(name, length);
+	std::uint32_t mask = _header->numBuckets - 1;
+
+	for (std::uint32_t i = hash & mask; ; i = (i + 1) & mask)
+	{
+		std::uint32_t index = _buckets[i];
+		if (index == invalidIndex)
+			return nullptr;
+
+		auto& entry = _entries[index];
+		if (entry.hash == hash && entry.nameLength == length && equalName(_names + entry.nameOffset, name, length))
+			return &entry;
+	}
+}
+
+std::uint64_t
+Package::hash(util::string::const_pointer name, std::size_t length) noexcept
+{
+	std::uint64_t hash = 14695981039346656037ULL;
+	for (std::size_t i = 0; i < length; i++)
+	{
+		hash ^= (std::uint8_t)normalizeChar(name[i]);
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+util::string
+Package::normalize(const util::string& name) noexcept
+{
+	auto first = name.c_str();
+	auto length = name.size();
+
+	skipSeparators(first, length);
+
+	util::string result(first, length);
+	for (auto& it : result)
+		it = normalizeChar(it);
+
+	return result;
+}
+
+PackageWriter::PackageWriter() noexcept
+	: _offset(0)
+{
+}
+
+PackageWriter::~PackageWriter() noexcept
+{
+	this->close();
+}
+
+bool
+PackageWriter::open(const util::string& path) noexcept
+{
+	assert(!_stream);
+
+	auto stream = std::make_shared<ofstream>();
+	if (!stream->open(path))
+		return false;
+
+	_stream = stream;
+	_offset = 0;
+	_names.clear();
+	_entries.clear();
+	_entryNames.clear();
+
+	// the header is written last, reserve its page for now
+	return this->pad();
+}
+
+bool
+PackageWriter::close() noexcept
+{
+	if (!_stream)
+		return false;
+
+	std::uint32_t numBuckets = 1;
+	while (numBuckets < _entries.size() * 2 + 1)
+		numBuckets <<= 1;
+
+	std::vector<std::uint32_t> buckets(numBuckets, Package::invalidIndex);
+	for (std::uint32_t i = 0; i < _entries.size(); i++)
+	{
+		std::uint32_t bucket = _entries[i].hash & (numBuckets - 1);
+		while (buckets[bucket] != Package::invalidIndex)
+			bucket = (bucket + 1) & (numBuckets - 1);
+		buckets[bucket] = i;
+	}
+
+	PackageHeader header;
+	header.magic = Package::magic;
+	header.version = Package::version;
+	header.numEntries = (std::uint32_t)_entries.size();
+	header.numBuckets = numBuckets;
+	header.tocOffset = _offset;
+	header.tocSize = _entries.size() * sizeof(PackageEntry) + buckets.size() * sizeof(std::uint32_t) + _names.size();
+
+	bool result = true;
+	if (!_entries.empty())
+		result &= (bool)_stream->write((const char*)_entries.data(), _entries.size() * sizeof(PackageEntry));
+	result &= (bool)_stream->write((const char*)buckets.data(), buckets.size() * sizeof(std::uint32_t));
+	if (!_names.empty())
+		result &= (bool)_stream->write(_names.data(), _names.size());
+	result &= (bool)_stream->seekg(0, ios_base::beg);
+	result &= (bool)_stream->write((const char*)&header, sizeof(header));
+	result &= (bool)_stream->flush();
+
+	_stream.reset();
+	_entries.clear();
+	_entryNames.clear();
+	_names.clear();
+	_packed.clear();
+	_packed.shrink_to_fit();
+
+	return result;
+}
+
+bool
+PackageWriter::is_open() const noexcept
+{
+	return _stream != nullptr;
+}
+
+bool
+PackageWriter::addFile(const util::string& name, const char* data, std::size_t size, bool compress) noexcept
+{
+	assert(_stream);
+	assert(data || size == 0);
+
+	auto normalized = Package::normalize(name);
+	if (normalized.empty() || normalized.size() > std::numeric_limits<std::uint16_t>::max())
+		return false;
+
+	if (_entryNames.count(normalized))
+		return false;
+
+	PackageEntry entry;
+	entry.hash = Package::hash(normalized.c_str(), normalized.size());
+	entry.offset = _offset;
+	entry.size = size;
+	entry.packedSize = size;
+	entry.nameOffset = (std::uint32_t)_names.size();
+	entry.nameLength = (std::uint16_t)normalized.size();
+	entry.compression = PackageCompressionNone;
+	entry.reserved = 0;
+
+	const char* packed = data;
+
+	if (compress && size > 0 && size <= std::numeric_limits<uLong>::max())
+	{
+		_packed.resize(::compressBound((uLong)size));
+
+		uLongf length = (uLongf)_packed.size();
+		if (::compress2((Bytef*)_packed.data(), &length, (const Bytef*)data, (uLong)size, Z_BEST_COMPRESSION) == Z_OK)
+		{
+			if (length < size - size / 8)
+			{
+				entry.packedSize = length;
+				entry.compression = PackageCompressionZlib;
+				packed = _packed.data();
+			}
+		}
+	}
+
+	if (entry.packedSize > 0)
+	{
+		if (!_stream->write(packed, entry.packedSize))
+			return false;
+	}
+
+	_offset += entry.packedSize;
+
+	if (!this->pad())
+		return false;
+
+	_names.append(normalized);
+	_entries.push_back(entry);
+	_entryNames.insert(std::move(normalized));
+	return true;
+}
+
+std::size_t
+PackageWriter::size() const noexcept
+{
+	return _entries.size();
+}
+
+const PackageEntry&
+PackageWriter::getEntry(std::size_t index) const noexcept
+{
+	assert(index < _entries.size());
+	return _entries[index];
+}
+
+bool
+PackageWriter::pad() noexcept
+{
+	static const char zeros[Package::alignment] = { 0 };
+
+	std::size_t count = (Package::alignment - _offset % Package::alignment) % Package::alignment;
+	if (_offset == 0)
+		count = Package::alignment;
+
+	if (count > 0)
+	{
+		if (!_stream->write(zeros, count))
+			return false;
+	}
+
+	_offset += count;
+	return true;
+}
+
+_NAME_END
\ No newline at end of file
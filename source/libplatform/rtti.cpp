@@ -47,6 +47,8 @@ Rtti::Rtti(const std::string& name, RttiConstruct creator, const Rtti* parent) n
 	: _name(name)
 	, _parent(parent)
 	, _construct(creator)
+	, _intervalBegin(0)
+	, _intervalEnd(0)
 {
 	Factory::instance()->add(this);
 }
@@ -79,6 +81,9 @@ Rtti::isDerivedFrom(const Rtti* other) const
 {
 	assert(other);
 
+	if (_intervalBegin && other->_intervalBegin)
+		return other->_intervalBegin <= _intervalBegin && _intervalBegin <= other->_intervalEnd;
+
 	for (const Rtti* cur = this; cur != 0; cur = cur->getParent())
 	{
 		if (cur == other)
@@ -99,6 +104,7 @@ Rtti::isDerivedFrom(const Rtti& other) const
 bool
 Rtti::isDerivedFrom(const std::string& name) const
 {
+	// several types share a name (Light, Camera, ...), the factory can only map it to one of them
 	for (const Rtti* cur = this; cur != 0; cur = cur->getParent())
 	{
 		if (cur->_name == name)
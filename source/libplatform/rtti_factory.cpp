@@ -42,7 +42,23 @@ using namespace rtti;
 
 __ImplementSingleton(Factory)
 
+// Rtti objects are statics that register themselves during static initialization, possibly before the
+// factory singleton is constructed, so the list they are kept in is created on first use instead.
+static std::vector<Rtti*>& getRegistry() noexcept
+{
+	static std::vector<Rtti*> rttis;
+	return rttis;
+}
+
+// guards the registry and the name table, the intervals read by isA are only safe under the rule in rtti_factory.h
+static std::mutex& getRegistryLock() noexcept
+{
+	static std::mutex lock;
+	return lock;
+}
+
 Factory::Factory() noexcept
+	: _isOpened(false)
 {
 }
 
@@ -53,51 +69,105 @@ Factory::~Factory() noexcept
 bool
 Factory::open() noexcept
 {
-	for (auto& it : _rttis)
+	std::lock_guard<std::mutex> lock(getRegistryLock());
+
+	_openThread = std::this_thread::get_id();
+
+	for (auto& it : getRegistry())
 	{
 		if (it)
 			_rtti_lists[it->type_name()] = it;
 	}
+
+	this->buildIntervals();
+
+	_isOpened = true;
 	return true;
 }
 
 bool
 Factory::add(Rtti* rtti) noexcept
 {
-	_rttis.push_back(rtti);
+	std::lock_guard<std::mutex> lock(getRegistryLock());
+
+	getRegistry().push_back(rtti);
+
+	// types registered late, from a module loaded after startup, renumber the whole hierarchy
+	if (_isOpened)
+	{
+		assert(std::this_thread::get_id() == _openThread);
+
+		_rtti_lists[rtti->type_name()] = rtti;
+		this->buildIntervals();
+	}
+
 	return true;
 }
 
 Rtti*
 Factory::getRTTI(const std::string& name) noexcept
 {
-	return _rtti_lists[name];
+	std::lock_guard<std::mutex> lock(getRegistryLock());
+
+	auto it = _rtti_lists.find(name);
+	if (it != _rtti_lists.end())
+		return (*it).second;
+	return nullptr;
 }
 
 Rtti*
 Factory::getRTTI(const char* name) noexcept
 {
-	return _rtti_lists[name];
+	return this->getRTTI(std::string(name));
 }
 
 const Rtti*
 Factory::getRTTI(const std::string& name) const noexcept
 {
-	auto it = _rtti_lists.lower_bound(name);
-	for (; it != _rtti_lists.end(); ++it)
-		if ((*it).first == name)
-			return (*it).second;
+	std::lock_guard<std::mutex> lock(getRegistryLock());
+
+	auto it = _rtti_lists.find(name);
+	if (it != _rtti_lists.end())
+		return (*it).second;
 	return nullptr;
 }
 
 const Rtti*
 Factory::getRTTI(const char* name) const noexcept
 {
-	auto it = _rtti_lists.lower_bound(name);
-	for (; it != _rtti_lists.end(); ++it)
-		if ((*it).first == name)
-			return (*it).second;
-	return nullptr;
+	return this->getRTTI(std::string(name));
+}
+
+void
+Factory::buildIntervals() noexcept
+{
+	RttiChildren children;
+
+	for (auto& it : getRegistry())
+	{
+		if (it)
+			children[it->getParent()].push_back(it);
+	}
+
+	std::uint32_t order = 0;
+
+	for (auto& it : children[nullptr])
+		this->buildIntervals(it, children, order);
+}
+
+void
+Factory::buildIntervals(Rtti* rtti, const RttiChildren& children, std::uint32_t& order) noexcept
+{
+	rtti->_intervalBegin = ++order;
+
+	auto it = children.find(rtti);
+	if (it != children.end())
+	{
+		for (auto& child : (*it).second)
+			this->buildIntervals(child, children, order);
+	}
+
+	rtti->_intervalEnd = order;
 }
 
 InterfacePtr
@@ -46,6 +46,23 @@ StreamBuf::~StreamBuf() noexcept
 {
 }
 
+char*
+StreamBuf::map() noexcept
+{
+	return nullptr;
+}
+
+void
+StreamBuf::unmap() noexcept
+{
+}
+
+bool
+StreamBuf::isMapping() const noexcept
+{
+	return false;
+}
+
 void
 StreamBuf::lock() noexcept
 {
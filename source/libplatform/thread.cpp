@@ -207,4 +207,122 @@ ThreadLambda::dispose() noexcept
 	}
 }
 
+__ImplementSingleton(ParallelFor)
+
+ParallelFor::ParallelFor() noexcept
+	: _quit(false)
+	, _generation(0)
+	, _numBusy(0)
+	, _count(0)
+	, _next(0)
+	, _running(false)
+	, _func(nullptr)
+{
+}
+
+ParallelFor::~ParallelFor() noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+
+	_dispatch.notify_all();
+
+	for (auto& it : _threads)
+		it->join();
+
+	_threads.clear();
+}
+
+void
+ParallelFor::run(std::uint32_t count, const std::function<void(std::uint32_t)>& func) noexcept
+{
+	bool running = false;
+
+	if (count <= 1 || !_running.compare_exchange_strong(running, true))
+	{
+		for (std::uint32_t i = 0; i < count; i++)
+			func(i);
+		return;
+	}
+
+	this->start();
+
+	if (_threads.empty())
+	{
+		for (std::uint32_t i = 0; i < count; i++)
+			func(i);
+
+		_running = false;
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_func = &func;
+		_count = count;
+		_next = 0;
+		_numBusy = static_cast<std::uint32_t>(_threads.size());
+		_generation++;
+	}
+
+	_dispatch.notify_all();
+
+	this->runTasks();
+
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_finish.wait(lock, [this]() { return _numBusy == 0; });
+		_func = nullptr;
+	}
+
+	_running = false;
+}
+
+void
+ParallelFor::start() noexcept
+{
+	// only the caller that owns the running flag gets here, so the helpers are created once without a lock
+	if (!_threads.empty())
+		return;
+
+	std::uint32_t numThreads = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+
+	for (std::uint32_t i = 0; i < numThreads; i++)
+		_threads.push_back(std::make_unique<std::thread>(std::bind(&ParallelFor::dispose, this)));
+}
+
+void
+ParallelFor::runTasks() noexcept
+{
+	for (std::uint32_t i = _next++; i < _count; i = _next++)
+		(*_func)(i);
+}
+
+void
+ParallelFor::dispose() noexcept
+{
+	std::uint32_t generation = 0;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_dispatch.wait(lock, [&]() { return _quit || _generation != generation; });
+
+			if (_quit)
+				break;
+
+			generation = _generation;
+		}
+
+		this->runTasks();
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (--_numBusy == 0)
+			_finish.notify_one();
+	}
+}
+
 _NAME_END
\ No newline at end of file
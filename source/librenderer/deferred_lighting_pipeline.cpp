@@ -40,6 +40,7 @@
 #include <ray/render_pipeline_manager.h>
 #include <ray/render_pipeline_framebuffer.h>
 #include <ray/render_object_manager.h>
+#include <ray/occlusion_query_queue.h>
 #include <ray/camera.h>
 #include <ray/light.h>
 #include <ray/render_scene.h>
@@ -52,6 +53,12 @@
 
 _NAME_BEGIN
 
+namespace
+{
+	// a handful of light volumes is still cheaper than binning and a full screen pass
+	const std::size_t clusterLightThreshold = 8;
+}
+
 DeferredLightingPipeline::DeferredLightingPipeline() noexcept
 	: _mrsiiDerivMipBase(0)
 	, _mrsiiDerivMipCount(4)
@@ -157,6 +164,11 @@ DeferredLightingPipeline::renderOpaques(RenderPipeline& pipeline, const Graphics
 
 	pipeline.drawRenderQueue(RenderQueue::RenderQueueOpaque);
 	pipeline.drawRenderQueue(RenderQueue::RenderQueueOpaqueBatch);
+
+	// the boxes are tested against the depth just written, results come back in a later frame
+	auto& occlusionQueryQueue = pipeline.getCamera()->getRenderDataManager()->getOcclusionQueryQueue();
+	if (occlusionQueryQueue)
+		occlusionQueryQueue->renderQueries(pipeline);
 }
 
 void
@@ -316,9 +328,16 @@ DeferredLightingPipeline::renderDirectLights(RenderPipeline& pipeline, const Gra
 	pipeline.setFramebuffer(target);
 
 	auto& lights = pipeline.getCamera()->getRenderDataManager()->getRenderData(RenderQueue::RenderQueueLights);
+
+	std::uint8_t clusterLayer = 0;
+	bool clustered = this->buildLightCluster(pipeline, lights, clusterLayer);
+
 	for (auto& it : lights)
 	{
 		auto light = it->downcast<Light>();
+		if (clustered && this->isClusteredLight(*light, clusterLayer))
+			continue;
+
 		switch (light->getLightType())
 		{
 		case LightType::LightTypeSun:
@@ -337,6 +356,21 @@ DeferredLightingPipeline::renderDirectLights(RenderPipeline& pipeline, const Gra
 			break;
 		}
 	}
+
+	if (clustered)
+		this->renderClusteredLights(pipeline, clusterLayer);
+}
+
+void
+DeferredLightingPipeline::renderClusteredLights(RenderPipeline& pipeline, std::uint8_t layer) noexcept
+{
+	_clusterLights->uniformBuffer(_lightCluster.getLightData());
+	_clusterIndices->uniformBuffer(_lightCluster.getClusterData());
+	_clusterSize->uniform3f(float(_lightCluster.getGridSizeX()), float(_lightCluster.getGridSizeY()), float(_lightCluster.getGridSizeZ()));
+	_clusterProject->uniform2f(_lightCluster.getClusterProject());
+	_clusterDepth->uniform2f(_lightCluster.getClusterDepth());
+
+	pipeline.drawScreenQuadLayer(*_deferredClusteredLights, layer);
 }
 
 void
@@ -347,7 +381,31 @@ DeferredLightingPipeline::renderSunLight(RenderPipeline& pipeline, const Light&
 	_lightAttenuation->uniform3f(light.getLightAttenuation());
 
 	auto& shadowMap = light.getCamera()->getRenderPipelineFramebuffer()->downcast<ShadowRenderFramebuffer>()->getFramebuffer()->getGraphicsFramebufferDesc().getColorAttachment().getBindingTexture();
-	if (shadowMap)
+	if (shadowMap && !light.getShadowCascadeCameras().empty())
+	{
+		auto& cascades = light.getShadowCascadeCameras();
+
+		float4 cascadeFactors = float4::Zero;
+		std::vector<float4> cascadeViews(LightShadowCascade::LightShadowCascadeMax, float4::Zero);
+		std::vector<float4x4> cascadeViewProjects(LightShadowCascade::LightShadowCascadeMax, float4x4::One);
+
+		for (std::uint8_t i = 0; i < cascades.size(); i++)
+		{
+			cascadeFactors[i] = light.getShadowFactor() / (cascades[i]->getFar() - cascades[i]->getNear());
+			cascadeViews[i] = cascades[i]->getView().getAxisZ() * pipeline.getCamera()->getViewInverse();
+			cascadeViewProjects[i] = cascades[i]->getViewProject() * pipeline.getCamera()->getViewInverse();
+		}
+
+		_shadowMap->uniformTexture(shadowMap);
+		_shadowFactor->uniform2f(0.0f, light.getShadowBias());
+		_shadowCascadeSplits->uniform4f(light.getShadowCascadeSplits());
+		_shadowCascadeFactors->uniform4f(cascadeFactors);
+		_shadowCascadeView2LightView->uniform4fv(cascadeViews);
+		_shadowCascadeView2LightViewProject->uniform4fmatv(cascadeViewProjects);
+
+		pipeline.drawScreenQuadLayer(*_deferredSunLightCascadeShadow, light.getLayer());
+	}
+	else if (shadowMap)
 	{
 		float shadowFactor = light.getShadowFactor() / (light.getCamera()->getFar() - light.getCamera()->getNear());
 		float shaodwBias = light.getShadowBias();
@@ -563,6 +621,73 @@ DeferredLightingPipeline::renderIndirectLights(RenderPipeline& pipeline, const G
 	this->computeUpsamplingMultiresBuffer(pipeline, _mrsiiGaterIndirectMap, _mrsiiGaterIndirectViews, target);
 }
 
+bool
+DeferredLightingPipeline::buildLightCluster(RenderPipeline& pipeline, const RenderObjectRaws& lights, std::uint8_t& layer) noexcept
+{
+	auto camera = pipeline.getCamera();
+	if (camera->getCameraType() != CameraType::CameraTypePerspective)
+		return false;
+
+	// the full screen pass is stencilled to one layer, lights on the other layers keep their own draws
+	std::size_t numCandidates = 0;
+	for (auto& it : lights)
+	{
+		auto light = it->downcast<Light>();
+		if (numCandidates == 0)
+			layer = light->getLayer();
+
+		if (this->isClusteredLight(*light, layer))
+			numCandidates++;
+	}
+
+	if (numCandidates < clusterLightThreshold)
+		return false;
+
+	_lightCluster.clear();
+
+	for (auto& it : lights)
+	{
+		auto light = it->downcast<Light>();
+		if (!this->isClusteredLight(*light, layer))
+			continue;
+
+		auto color = light->getLightColor() * light->getLightIntensity();
+		auto position = math::invTranslateVector3(camera->getTransform(), light->getTranslate());
+
+		if (light->getLightType() == LightType::LightTypeSpot)
+		{
+			auto direction = math::invRotateVector3(camera->getTransform(), light->getForward());
+			auto outerInner = float2(light->getSpotOuterCone().y, light->getSpotInnerCone().y);
+			_lightCluster.addSpotLight(position, direction, light->getLightRange(), color, light->getLightAttenuation(), outerInner);
+		}
+		else
+		{
+			_lightCluster.addPointLight(position, light->getLightRange(), color, light->getLightAttenuation());
+		}
+	}
+
+	_lightCluster.build(*camera);
+
+	return _lightCluster.upload(pipeline);
+}
+
+bool
+DeferredLightingPipeline::isClusteredLight(const Light& light, std::uint8_t layer) const noexcept
+{
+	if (light.getLayer() != layer)
+		return false;
+
+	switch (light.getLightType())
+	{
+	case LightType::LightTypePoint:
+		return true;
+	case LightType::LightTypeSpot:
+		return light.getShadowMode() == ShadowMode::ShadowModeNone;
+	default:
+		return false;
+	}
+}
+
 void
 DeferredLightingPipeline::computeSpotVPLBuffers(RenderPipeline& pipeline, const Light& light) noexcept
 {
@@ -731,8 +856,10 @@ DeferredLightingPipeline::setupDeferredMaterials(RenderPipeline& pipeline) noexc
 	_deferredDepthLinear = _deferredLighting->getTech("DeferredDepthLinear"); if (!_deferredDepthLinear) return false;
 	_deferredPointLight = _deferredLighting->getTech("DeferredPointLight"); if (!_deferredPointLight) return false;
 	_deferredAmbientLight = _deferredLighting->getTech("DeferredAmbientLight"); if (!_deferredAmbientLight) return false;
+	_deferredClusteredLights = _deferredLighting->getTech("DeferredClusteredLights"); if (!_deferredClusteredLights) return false;
 	_deferredSunLight = _deferredLighting->getTech("DeferredSunLight"); if (!_deferredSunLight) return false;
 	_deferredSunLightShadow = _deferredLighting->getTech("DeferredSunLightShadow"); if (!_deferredSunLightShadow) return false;
+	_deferredSunLightCascadeShadow = _deferredLighting->getTech("DeferredSunLightCascadeShadow"); if (!_deferredSunLightCascadeShadow) return false;
 	_deferredDirectionalLight = _deferredLighting->getTech("DeferredDirectionalLight"); if (!_deferredDirectionalLight) return false;
 	_deferredDirectionalLightShadow = _deferredLighting->getTech("DeferredDirectionalLightShadow"); if (!_deferredDirectionalLightShadow) return false;
 	_deferredSpotLight = _deferredLighting->getTech("DeferredSpotLight"); if (!_deferredSpotLight) return false;
@@ -760,10 +887,20 @@ DeferredLightingPipeline::setupDeferredMaterials(RenderPipeline& pipeline) noexc
 	_lightOuterInner = _deferredLighting->getParameter("lightOuterInner"); if (!_lightOuterInner) return false;
 	_lightAttenuation = _deferredLighting->getParameter("lightAttenuation"); if (!_lightAttenuation) return false;
 
+	_clusterLights = _deferredLighting->getParameter("clusterLights"); if (!_clusterLights) return false;
+	_clusterIndices = _deferredLighting->getParameter("clusterIndices"); if (!_clusterIndices) return false;
+	_clusterSize = _deferredLighting->getParameter("clusterSize"); if (!_clusterSize) return false;
+	_clusterProject = _deferredLighting->getParameter("clusterProject"); if (!_clusterProject) return false;
+	_clusterDepth = _deferredLighting->getParameter("clusterDepth"); if (!_clusterDepth) return false;
+
 	_shadowMap = _deferredLighting->getParameter("shadowMap"); if (!_shadowMap) return false;
 	_shadowFactor = _deferredLighting->getParameter("shadowFactor"); if (!_shadowFactor) return false;
 	_shadowView2LightView = _deferredLighting->getParameter("shadowView2LightView"); if (!_shadowView2LightView) return false;
 	_shadowView2LightViewProject = _deferredLighting->getParameter("shadowView2LightViewProject"); if (!_shadowView2LightViewProject) return false;
+	_shadowCascadeSplits = _deferredLighting->getParameter("shadowCascadeSplits"); if (!_shadowCascadeSplits) return false;
+	_shadowCascadeFactors = _deferredLighting->getParameter("shadowCascadeFactors"); if (!_shadowCascadeFactors) return false;
+	_shadowCascadeView2LightView = _deferredLighting->getParameter("shadowCascadeView2LightView"); if (!_shadowCascadeView2LightView) return false;
+	_shadowCascadeView2LightViewProject = _deferredLighting->getParameter("shadowCascadeView2LightViewProject"); if (!_shadowCascadeView2LightViewProject) return false;
 
 	_envDiffuse = _deferredLighting->getParameter("envDiffuse");
 	_envSpecular = _deferredLighting->getParameter("envSpecular");
@@ -1063,12 +1200,14 @@ DeferredLightingPipeline::destroyDeferredMaterials() noexcept
 	_deferredDepthLinear.reset();
 	_deferredSunLight.reset();
 	_deferredSunLightShadow.reset();
+	_deferredSunLightCascadeShadow.reset();
 	_deferredDirectionalLight.reset();
 	_deferredDirectionalLightShadow.reset();
 	_deferredSpotLight.reset();
 	_deferredSpotLightShadow.reset();
 	_deferredPointLight.reset();
 	_deferredAmbientLight.reset();
+	_deferredClusteredLights.reset();
 	_deferredShadingOpaques.reset();
 	_deferredShadingTransparents.reset();
 	_deferredDebugLayer.reset();
@@ -1091,12 +1230,24 @@ DeferredLightingPipeline::destroyDeferredMaterials() noexcept
 	_shadowFactor.reset();
 	_shadowView2LightView.reset();
 	_shadowView2LightViewProject.reset();
+	_shadowCascadeSplits.reset();
+	_shadowCascadeFactors.reset();
+	_shadowCascadeView2LightView.reset();
+	_shadowCascadeView2LightViewProject.reset();
 
 	_lightColor.reset();
 	_lightEyePosition.reset();
 	_lightEyeDirection.reset();
 	_lightAttenuation.reset();
 	_lightOuterInner.reset();
+
+	_clusterLights.reset();
+	_clusterIndices.reset();
+	_clusterSize.reset();
+	_clusterProject.reset();
+	_clusterDepth.reset();
+
+	_lightCluster.close();
 }
 
 void
@@ -38,6 +38,7 @@
 #define _H_DEFERRED_LIGHTING_PIPELINE_H_
 
 #include <ray/render_pipeline_controller.h>
+#include "light_cluster.h"
 
 _NAME_BEGIN
 
@@ -77,6 +78,7 @@ public:
 
 	void renderAmbientLights(RenderPipeline& pipeline, const GraphicsFramebufferPtr& target) noexcept;
 	void renderDirectLights(RenderPipeline& pipeline, const GraphicsFramebufferPtr& target) noexcept;
+	void renderClusteredLights(RenderPipeline& pipeline, std::uint8_t layer) noexcept;
 	void renderIndirectSpotLight(RenderPipeline& pipeline, const Light& light) noexcept;
 	void renderIndirectLights(RenderPipeline& pipeline, const GraphicsFramebufferPtr& target) noexcept;
 
@@ -90,6 +92,9 @@ private:
 	void computeSubsplatStencil(RenderPipeline& pipeline, const GraphicsTexturePtr& depth, const GraphicsTexturePtr& normal, const GraphicsFramebuffers& dst);
 	void computeUpsamplingMultiresBuffer(RenderPipeline& pipeline, GraphicsTexturePtr src, const GraphicsFramebuffers& srcviews, const GraphicsFramebufferPtr& dst);
 
+	bool buildLightCluster(RenderPipeline& pipeline, const RenderObjectRaws& lights, std::uint8_t& layer) noexcept;
+	bool isClusteredLight(const Light& light, std::uint8_t layer) const noexcept;
+
 private:
 	bool initTextureFormat(RenderPipeline& pipeline) noexcept;
 
@@ -181,12 +186,14 @@ private:
 	MaterialTechPtr _deferredDepthLinear;
 	MaterialTechPtr _deferredSunLight;
 	MaterialTechPtr _deferredSunLightShadow;
+	MaterialTechPtr _deferredSunLightCascadeShadow;
 	MaterialTechPtr _deferredDirectionalLight;
 	MaterialTechPtr _deferredDirectionalLightShadow;
 	MaterialTechPtr _deferredSpotLight;
 	MaterialTechPtr _deferredSpotLightShadow;
 	MaterialTechPtr _deferredPointLight;
 	MaterialTechPtr _deferredAmbientLight;
+	MaterialTechPtr _deferredClusteredLights;
 	MaterialTechPtr _deferredEnvironmentLighting;
 	MaterialTechPtr _deferredShadingOpaques;
 	MaterialTechPtr _deferredShadingTransparents;
@@ -211,6 +218,10 @@ private:
 	MaterialParamPtr _shadowFactor;
 	MaterialParamPtr _shadowView2LightView;
 	MaterialParamPtr _shadowView2LightViewProject;
+	MaterialParamPtr _shadowCascadeSplits;
+	MaterialParamPtr _shadowCascadeFactors;
+	MaterialParamPtr _shadowCascadeView2LightView;
+	MaterialParamPtr _shadowCascadeView2LightViewProject;
 
 	MaterialParamPtr _lightColor;
 	MaterialParamPtr _lightEyePosition;
@@ -218,6 +229,12 @@ private:
 	MaterialParamPtr _lightAttenuation;
 	MaterialParamPtr _lightOuterInner;
 
+	MaterialParamPtr _clusterLights;
+	MaterialParamPtr _clusterIndices;
+	MaterialParamPtr _clusterSize;
+	MaterialParamPtr _clusterProject;
+	MaterialParamPtr _clusterDepth;
+
 	MaterialParamPtr _envBoxMax;
 	MaterialParamPtr _envBoxMin;
 	MaterialParamPtr _envBoxCenter;
@@ -230,6 +247,8 @@ private:
 	MaterialSemanticPtr _materialDeferredLightMap;
 	MaterialSemanticPtr _materialDeferredOpaqueShadingMap;
 
+	LightCluster _lightCluster;
+
 	RenderPipelinePtr _pipeline;
 };
 
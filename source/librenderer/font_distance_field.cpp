@@ -47,6 +47,10 @@
 
 #include <thread>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#	include <emmintrin.h>
+#endif
+
 _NAME_BEGIN
 
 int getGrayBitmap(const FT_BitmapGlyph bitmapGlyph, int x, int y)
@@ -368,9 +372,13 @@ FontDistanceField::computeBitmaps(FT_Library library, FT_Face face, std::size_t
 	assert(startCode <= _bitmapGlyphs.size());
 	assert(endCode <= _bitmapGlyphs.size());
 
-	KdimensionTree<short2> nodes;
+	FontDistanceWorkspace workspace;
+
+	std::size_t cells = _bitmapSize / _distanceSize;
+	std::size_t sampleSize = std::max<std::size_t>(internalSize / _distanceSize, 1);
+	std::size_t gridSize = sampleSize * _distanceSize;
 
-	std::vector<float> distance(_distanceSize * _distanceSize);
+	float spread = std::max(_fontSize / 8.0f, 1.0f);
 
 	for (std::size_t i = startCode; i < endCode; i++)
 	{
@@ -386,24 +394,21 @@ FontDistanceField::computeBitmaps(FT_Library library, FT_Face face, std::size_t
 
 		if (bitmapGlyph->bitmap.buffer)
 		{
-			std::size_t offsetY = (i / (_bitmapSize / _distanceSize));
-			std::size_t offsetX = (i - offsetY * _bitmapSize / _distanceSize);
+			std::size_t offsetY = i / cells;
+			std::size_t offsetX = i % cells;
 
 			_bitmapGlyphs[i].advanceX = glyph->advance.x;
 			_bitmapGlyphs[i].advanceY = glyph->advance.y;
 			_bitmapGlyphs[i].left = bitmapGlyph->left / (float)internalSize;
 			_bitmapGlyphs[i].top = (_fontSize - bitmapGlyph->top) / (float)internalSize;
-			_bitmapGlyphs[i].width = (bitmapGlyph->bitmap.pitch << 3) / (float)internalSize;
+			_bitmapGlyphs[i].width = bitmapGlyph->bitmap.width / (float)internalSize;
 			_bitmapGlyphs[i].height = bitmapGlyph->bitmap.rows / (float)internalSize;
 			_bitmapGlyphs[i].offsetX = offsetX;
 			_bitmapGlyphs[i].offsetY = offsetY;
 
-			nodes.clear();
-			std::memset(distance.data(), 0, distance.size());
+			auto cell = &_bitmap[_bitmapSize * offsetY * _distanceSize + offsetX * _distanceSize];
 
-			computeEdge(bitmapGlyph, _fontSize, internalSize, nodes);
-			computeDistance(bitmapGlyph, nodes, _fontSize, internalSize, _distanceSize, distance);
-			computeDistanceField(distance, _bitmap, _fontSize, _bitmapSize, _distanceSize, offsetX, offsetY);
+			computeDistanceField(bitmapGlyph, bitmapGlyph->left, (std::int32_t)_fontSize - bitmapGlyph->top, gridSize, gridSize, sampleSize, spread, cell, _bitmapSize, workspace);
 		}
 
 		FT_Done_Glyph(glyph);
@@ -411,94 +416,154 @@ FontDistanceField::computeBitmaps(FT_Library library, FT_Face face, std::size_t
 }
 
 void
-FontDistanceField::computeEdge(const FT_BitmapGlyph bitmapGlyph, std::size_t fontSize, std::size_t internalSize, KdimensionTree<short2>& nodes)
+FontDistanceField::computeDistanceField(const FT_BitmapGlyph bitmapGlyph, std::int32_t originX, std::int32_t originY, std::size_t gridWidth, std::size_t gridHeight, std::size_t sampleSize, float spread, std::uint8_t* bitmap, std::size_t pitch, FontDistanceWorkspace& workspace) noexcept
 {
-	std::size_t height = bitmapGlyph->bitmap.rows;
-	std::size_t width = bitmapGlyph->bitmap.pitch << 3;
+	assert(bitmapGlyph && bitmap);
+	assert(sampleSize > 0 && spread > 0.0f);
+	assert(gridWidth % sampleSize == 0 && gridHeight % sampleSize == 0);
 
-	std::size_t offsetX = bitmapGlyph->left;
-	std::size_t offsetY = fontSize - bitmapGlyph->top;
+	// longer than any path through the grid, yet small enough that its square stays finite
+	float far = (float)(gridWidth + gridHeight);
 
-	for (std::size_t y = 0; y < height; y++)
+	workspace.inside.assign(gridWidth * gridHeight, 0.0f);
+	workspace.outside.assign(gridWidth * gridHeight, far);
+
+	const FT_Bitmap& source = bitmapGlyph->bitmap;
+
+	for (std::int32_t y = 0; y < (std::int32_t)source.rows; y++)
 	{
-		for (std::size_t x = 0; x < width; x++)
+		std::int32_t gridY = originY + y;
+		if (gridY < 0 || gridY >= (std::int32_t)gridHeight)
+			continue;
+
+		const std::uint8_t* row = source.buffer + y * source.pitch;
+
+		for (std::int32_t x = 0; x < (std::int32_t)source.width; x++)
 		{
-			auto center = getGrayBitmap(bitmapGlyph, x, y);
-			auto left = getGrayBitmap(bitmapGlyph, x + 1, y);
-			auto right = getGrayBitmap(bitmapGlyph, x - 1, y);
-			auto up = getGrayBitmap(bitmapGlyph, x, y + 1);
-			auto down = getGrayBitmap(bitmapGlyph, x, y - 1);
+			std::int32_t gridX = originX + x;
+			if (gridX < 0 || gridX >= (std::int32_t)gridWidth)
+				continue;
 
-			if ((center & (center ^ (center & up & down & left & right))))
+			if (row[x >> 3] & (0x80 >> (x & 7)))
 			{
-				nodes.insert(short2(x + offsetX, y + offsetY));
+				workspace.inside[gridY * gridWidth + gridX] = far;
+				workspace.outside[gridY * gridWidth + gridX] = 0.0f;
 			}
 		}
 	}
-}
 
-void
-FontDistanceField::computeDistance(const FT_BitmapGlyph bitmapGlyph, KdimensionTree<short2>& nodes, std::size_t fontSize, std::size_t internalSize, std::size_t distanceSize, std::vector<float>& distance)
-{
-	std::size_t _sampleSize = internalSize / distanceSize;
-	std::size_t _sampleHalf = _sampleSize >> 1;
+	computeColumns(workspace.inside.data(), gridWidth, gridHeight);
+	computeColumns(workspace.outside.data(), gridWidth, gridHeight);
+
+	computeRows(workspace.inside.data(), gridWidth, gridHeight, workspace);
+	computeRows(workspace.outside.data(), gridWidth, gridHeight, workspace);
 
-	std::size_t offsetX = bitmapGlyph->left;
-	std::size_t offsetY = (fontSize - bitmapGlyph->top);
+	float scale = 0.5f / spread;
+	std::size_t sampleHalf = sampleSize >> 1;
 
-	for (std::size_t y = 0; y < distanceSize; y++)
+	for (std::size_t y = 0; y < gridHeight / sampleSize; y++)
 	{
-		for (std::size_t x = 0; x < distanceSize; x++)
+		for (std::size_t x = 0; x < gridWidth / sampleSize; x++)
 		{
-			std::size_t ix = _sampleHalf + x * _sampleSize;
-			std::size_t iy = _sampleHalf + y * _sampleSize;
-
-			KdimensionNearest<short2> result;
-			nodes.search(result, short2(ix, iy), fontSize);
-
-			std::size_t index = y * distanceSize + x;
+			std::size_t index = (y * sampleSize + sampleHalf) * gridWidth + x * sampleSize + sampleHalf;
 
-			std::size_t dx = ix - offsetX;
-			std::size_t dy = iy - offsetY;
+			float distance = std::sqrt(workspace.outside[index]) - std::sqrt(workspace.inside[index]);
 
-			if (getGrayBitmap(bitmapGlyph, dx, dy))
-				distance[index] = sqrt(result.getDistanceSqrt()) + EPSILON;
+			// both transforms measure between pixel centres, the contour runs half a pixel closer
+			if (distance > 0.0f)
+				distance -= 0.5f;
 			else
-				distance[index] = -sqrt(result.getDistanceSqrt());
+				distance += 0.5f;
+
+			bitmap[y * pitch + x] = (std::uint8_t)(math::clamp(0.5f - distance * scale, 0.0f, 1.0f) * 255.0f + 0.5f);
 		}
 	}
 }
 
 void
-FontDistanceField::computeDistanceField(const std::vector<float>& distanceArray, std::vector<std::uint8_t>& bitmap, std::size_t fontSize, std::size_t bitmapSize, std::size_t distanceSize, std::size_t offsetX, std::size_t offsetY)
+FontDistanceField::computeColumns(float* grid, std::size_t width, std::size_t height) noexcept
 {
-	float total = 0;
-	for (auto& distance : distanceArray)
+	// a downward and an upward sweep leave the distance to the nearest seed in the same column,
+	// and every column is independent, so four of them are carried along per instruction
+	for (std::size_t y = 1; y < height; y++)
 	{
-		if (distance > 0)
-			total += distance;
-		else
-			total += -distance;
+		const float* above = grid + (y - 1) * width;
+		float* row = grid + y * width;
+
+		std::size_t x = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+		const __m128 one = _mm_set1_ps(1.0f);
+		for (; x + 4 <= width; x += 4)
+			_mm_storeu_ps(row + x, _mm_min_ps(_mm_loadu_ps(row + x), _mm_add_ps(_mm_loadu_ps(above + x), one)));
+#endif
+		for (; x < width; x++)
+			row[x] = std::min(row[x], above[x] + 1.0f);
 	}
 
-	float invSqr = 1.0f / sqrt(total);
+	for (std::size_t y = height - 1; y > 0; y--)
+	{
+		const float* below = grid + y * width;
+		float* row = grid + (y - 1) * width;
+
+		std::size_t x = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+		const __m128 one = _mm_set1_ps(1.0f);
+		for (; x + 4 <= width; x += 4)
+			_mm_storeu_ps(row + x, _mm_min_ps(_mm_loadu_ps(row + x), _mm_add_ps(_mm_loadu_ps(below + x), one)));
+#endif
+		for (; x < width; x++)
+			row[x] = std::min(row[x], below[x] + 1.0f);
+	}
+}
+
+void
+FontDistanceField::computeRows(float* grid, std::size_t width, std::size_t height, FontDistanceWorkspace& workspace) noexcept
+{
+	// lower envelope of the parabolas (x - q)^2 + column(q)^2, Felzenszwalb & Huttenlocher
+	workspace.parabola.resize(width);
+	workspace.boundary.resize(width + 1);
+	workspace.vertex.resize(width);
 
-	for (std::size_t y = 0; y < distanceSize; y++)
+	float* f = workspace.parabola.data();
+	float* z = workspace.boundary.data();
+	std::int32_t* v = workspace.vertex.data();
+
+	for (std::size_t y = 0; y < height; y++)
 	{
-		for (std::size_t x = 0; x < distanceSize; x++)
+		float* row = grid + y * width;
+
+		for (std::size_t q = 0; q < width; q++)
+			f[q] = row[q] * row[q];
+
+		std::int32_t k = 0;
+
+		v[0] = 0;
+		z[0] = -std::numeric_limits<float>::infinity();
+		z[1] = std::numeric_limits<float>::infinity();
+
+		for (std::int32_t q = 1; q < (std::int32_t)width; q++)
 		{
-			std::size_t index = distanceSize * y + x;
+			float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+			while (s <= z[k])
+			{
+				k--;
+				s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+			}
 
-			float value = distanceArray[index];
+			k++;
+			v[k] = q;
+			z[k] = s;
+			z[k + 1] = std::numeric_limits<float>::infinity();
+		}
 
-			if (value >= 0)
-				value = 255;
-			else if (value == 0)
-				value = 0;
-			else
-				value = math::lerp(255.0f, 0.0f, math::clamp(-value * invSqr, 0.0f, 1.0f));
+		k = 0;
+
+		for (std::int32_t q = 0; q < (std::int32_t)width; q++)
+		{
+			while (z[k + 1] < q)
+				k++;
 
-			bitmap[bitmapSize * (y + offsetY * distanceSize) + offsetX * distanceSize + x] = (std::uint8_t)value;
+			row[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
 		}
 	}
 }
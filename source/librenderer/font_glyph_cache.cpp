@@ -0,0 +1,550 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#include <ray/font_glyph_cache.h>
+#include <ray/render_system.h>
+#include <ray/graphics_texture.h>
+#include <ray/ioserver.h>
+
+#include <ft2build.h>
+#include <freetype/freetype.h>
+#include <freetype/ftglyph.h>
+
+#include <chrono>
+
+_NAME_BEGIN
+
+FontGlyphCache::FontGlyphCache() noexcept
+	: _fontSize(64)
+	, _sampleSize(2)
+	, _atlasSize(1024)
+	, _padding(0)
+	, _spread(8.0f)
+	, _shelfTop(0)
+	, _numRasterized(0)
+	, _numUploads(0)
+	, _numUploadedBytes(0)
+	, _numFlushes(0)
+	, _startupTime(0.0f)
+	, _rasterTime(0.0f)
+	, _quit(false)
+{
+	_dirty[0] = _dirty[1] = _dirty[2] = _dirty[3] = 0;
+}
+
+FontGlyphCache::~FontGlyphCache() noexcept
+{
+	this->close();
+}
+
+bool
+FontGlyphCache::setup(StreamReader& stream, std::uint32_t fontSize, std::uint32_t sampleSize, std::uint32_t atlasSize, std::uint32_t numThreads) noexcept
+{
+	assert(_threads.empty());
+	assert(fontSize > 0 && sampleSize > 0 && atlasSize > 0);
+
+	auto begin = std::chrono::high_resolution_clock::now();
+
+	std::size_t streamSize = stream.size();
+	if (streamSize == 0)
+		return false;
+
+	_fontData.resize(streamSize);
+	if (!stream.read((char*)_fontData.data(), _fontData.size()))
+		return false;
+
+	if (numThreads == 0)
+		numThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+	// every worker owns a face of its own, freetype faces must not be shared between threads
+	_faces.resize(numThreads);
+	_librarys.resize(numThreads);
+
+	for (std::uint32_t i = 0; i < numThreads; i++)
+	{
+		FT_Library& library = (FT_Library&)_librarys[i];
+		FT_Face& face = (FT_Face&)_faces[i];
+
+		if (FT_Init_FreeType(&library)) { this->close(); return false; }
+		if (FT_New_Memory_Face(library, _fontData.data(), _fontData.size(), 0, &face)) { this->close(); return false; }
+		if (FT_Select_Charmap(face, FT_ENCODING_UNICODE)) { this->close(); return false; }
+		if (FT_Set_Pixel_Sizes(face, fontSize, fontSize)) { this->close(); return false; }
+	}
+
+	_fontSize = fontSize;
+	_sampleSize = sampleSize;
+	_atlasSize = atlasSize;
+	_spread = std::max(fontSize / 8.0f, 1.0f);
+	_padding = ((std::uint32_t)std::ceil(_spread) + sampleSize - 1) / sampleSize * sampleSize;
+
+	_bitmap.assign(atlasSize * atlasSize, 0);
+	this->flush();
+	_numFlushes = 0;
+
+	for (std::uint32_t i = 0; i < numThreads; i++)
+		_threads.push_back(std::make_unique<std::thread>(std::bind(&FontGlyphCache::dispose, this, i)));
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	_startupTime = std::chrono::duration<float, std::milli>(end - begin).count();
+
+	return true;
+}
+
+bool
+FontGlyphCache::setup(const std::string& fontpath, std::uint32_t fontSize, std::uint32_t sampleSize, std::uint32_t atlasSize, std::uint32_t numThreads) noexcept
+{
+	StreamReaderPtr stream;
+	if (IoServer::instance()->openFileURL(stream, fontpath, ios_base::in))
+		return this->setup(*stream, fontSize, sampleSize, atlasSize, numThreads);
+	return false;
+}
+
+void
+FontGlyphCache::close() noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+
+	_dispatch.notify_all();
+
+	for (auto& it : _threads)
+		it->join();
+
+	_threads.clear();
+	_quit = false;
+
+	for (auto& it : _faces)
+	{
+		if (it)
+			FT_Done_Face(it);
+	}
+
+	for (auto& it : _librarys)
+	{
+		if (it)
+			FT_Done_FreeType(it);
+	}
+
+	_faces.clear();
+	_librarys.clear();
+	_fontData.clear();
+
+	_requests.clear();
+	_results.clear();
+	_finished.clear();
+
+	_glyphs.clear();
+	_requested.clear();
+	_shelves.clear();
+	_bitmap.clear();
+	_staging.clear();
+
+	_texture.reset();
+}
+
+void
+FontGlyphCache::preload(const std::wstring& charsets) noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		for (auto& ch : charsets)
+		{
+			if (_glyphs.find(ch) == _glyphs.end() && _requested.insert(ch).second)
+				_requests.push_back(ch);
+		}
+	}
+
+	_dispatch.notify_all();
+}
+
+const FontGlyph*
+FontGlyphCache::getGlyph(std::uint32_t code) noexcept
+{
+	auto it = _glyphs.find(code);
+	if (it != _glyphs.end())
+		return &it->second;
+
+	if (_requested.insert(code).second)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_requests.push_back(code);
+		}
+
+		_dispatch.notify_one();
+	}
+
+	return nullptr;
+}
+
+void
+FontGlyphCache::update() noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_finished.swap(_results);
+	}
+
+	for (auto& it : _finished)
+	{
+		std::uint32_t code = it.glyph.glyph;
+
+		_requested.erase(code);
+
+		_numRasterized++;
+		_rasterTime += it.time;
+
+		if (_glyphs.find(code) != _glyphs.end())
+			continue;
+
+		if (it.width > 0 && it.height > 0)
+		{
+			std::uint32_t x, y;
+			if (!this->pack(it.width, it.height, x, y))
+			{
+				this->flush();
+
+				if (!this->pack(it.width, it.height, x, y))
+					continue;
+			}
+
+			for (std::uint32_t row = 0; row < it.height; row++)
+				std::memcpy(&_bitmap[(y + row) * _atlasSize + x], &it.field[row * it.width], it.width);
+
+			_dirty[0] = std::min(_dirty[0], x);
+			_dirty[1] = std::min(_dirty[1], y);
+			_dirty[2] = std::max(_dirty[2], x + it.width);
+			_dirty[3] = std::max(_dirty[3], y + it.height);
+
+			it.glyph.offsetX = x;
+			it.glyph.offsetY = y;
+		}
+
+		_glyphs[code] = it.glyph;
+	}
+
+	_finished.clear();
+
+	this->upload();
+}
+
+void
+FontGlyphCache::flush() noexcept
+{
+	_glyphs.clear();
+	_shelves.clear();
+	_shelfTop = 0;
+
+	std::fill(_bitmap.begin(), _bitmap.end(), 0);
+
+	_dirty[0] = 0;
+	_dirty[1] = 0;
+	_dirty[2] = _atlasSize;
+	_dirty[3] = _atlasSize;
+
+	_numFlushes++;
+}
+
+bool
+FontGlyphCache::pack(std::uint32_t width, std::uint32_t height, std::uint32_t& x, std::uint32_t& y) noexcept
+{
+	if (width > _atlasSize || height > _atlasSize)
+		return false;
+
+	// the lowest shelf the glyph fits on wastes the least space, otherwise a new shelf is opened
+	Shelf* best = nullptr;
+
+	for (auto& shelf : _shelves)
+	{
+		if (height <= shelf.height && shelf.x + width <= _atlasSize)
+		{
+			if (!best || shelf.height < best->height)
+				best = &shelf;
+		}
+	}
+
+	if (!best)
+	{
+		if (_shelfTop + height > _atlasSize)
+			return false;
+
+		Shelf shelf;
+		shelf.x = 0;
+		shelf.y = _shelfTop;
+		shelf.height = height;
+
+		_shelves.push_back(shelf);
+		_shelfTop += height;
+
+		best = &_shelves.back();
+	}
+
+	x = best->x;
+	y = best->y;
+
+	best->x += width;
+
+	return true;
+}
+
+void
+FontGlyphCache::upload() noexcept
+{
+	if (_dirty[0] >= _dirty[2] || _dirty[1] >= _dirty[3])
+		return;
+
+	if (!_texture)
+	{
+		_texture = RenderSystem::instance()->createTexture(_atlasSize, _atlasSize, GraphicsTextureDim::GraphicsTextureDim2D, GraphicsFormat::GraphicsFormatR8UNorm, GraphicsSamplerFilter::GraphicsSamplerFilterLinear, GraphicsSamplerWrap::GraphicsSamplerWrapClampToEdge);
+		if (!_texture)
+			return;
+
+		_dirty[0] = 0;
+		_dirty[1] = 0;
+		_dirty[2] = _atlasSize;
+		_dirty[3] = _atlasSize;
+	}
+
+	std::uint32_t x = _dirty[0];
+	std::uint32_t y = _dirty[1];
+	std::uint32_t w = _dirty[2] - _dirty[0];
+	std::uint32_t h = _dirty[3] - _dirty[1];
+
+	// only the rectangle touched since the last update goes to the gpu, gathered into a tight block first
+	const std::uint8_t* data = &_bitmap[y * _atlasSize + x];
+
+	if (w != _atlasSize)
+	{
+		_staging.resize(w * h);
+
+		for (std::uint32_t row = 0; row < h; row++)
+			std::memcpy(&_staging[row * w], &_bitmap[(y + row) * _atlasSize + x], w);
+
+		data = _staging.data();
+	}
+
+	if (_texture->update(x, y, w, h, 0, data))
+	{
+		_numUploads++;
+		_numUploadedBytes += w * h;
+	}
+
+	_dirty[0] = _dirty[1] = _atlasSize;
+	_dirty[2] = _dirty[3] = 0;
+}
+
+void
+FontGlyphCache::rasterize(FT_Face face, std::uint32_t code, Rasterized& result, FontDistanceWorkspace& workspace) noexcept
+{
+	std::memset(&result.glyph, 0, sizeof(FontGlyph));
+
+	result.glyph.glyph = code;
+	result.width = 0;
+	result.height = 0;
+	result.field.clear();
+
+	FT_UInt index = FT_Get_Char_Index(face, code);
+	if (index == 0)
+		return;
+
+	if (FT_Load_Glyph(face, index, FT_LOAD_DEFAULT))
+		return;
+
+	FT_Glyph glyph;
+	if (FT_Get_Glyph(face->glyph, &glyph))
+		return;
+
+	result.glyph.advanceX = face->glyph->advance.x >> 6;
+	result.glyph.advanceY = face->glyph->advance.y >> 6;
+
+	if (!FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_MONO, 0, true))
+	{
+		FT_BitmapGlyph bitmapGlyph = (FT_BitmapGlyph)glyph;
+
+		if (bitmapGlyph->bitmap.buffer && bitmapGlyph->bitmap.width > 0 && bitmapGlyph->bitmap.rows > 0)
+		{
+			// the padding holds the part of the field that falls off outside the outline
+			std::uint32_t gridWidth = (bitmapGlyph->bitmap.width + _padding * 2 + _sampleSize - 1) / _sampleSize * _sampleSize;
+			std::uint32_t gridHeight = (bitmapGlyph->bitmap.rows + _padding * 2 + _sampleSize - 1) / _sampleSize * _sampleSize;
+
+			result.width = gridWidth / _sampleSize;
+			result.height = gridHeight / _sampleSize;
+			result.field.resize(result.width * result.height);
+
+			FontDistanceField::computeDistanceField(bitmapGlyph, _padding, _padding, gridWidth, gridHeight, _sampleSize, _spread, result.field.data(), result.width, workspace);
+
+			result.glyph.left = (float)bitmapGlyph->left - _padding;
+			result.glyph.top = (float)bitmapGlyph->top + _padding;
+			result.glyph.width = (float)gridWidth;
+			result.glyph.height = (float)gridHeight;
+		}
+	}
+
+	FT_Done_Glyph(glyph);
+}
+
+void
+FontGlyphCache::dispose(std::size_t thread) noexcept
+{
+	FontDistanceWorkspace workspace;
+
+	for (;;)
+	{
+		std::uint32_t code;
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_dispatch.wait(lock, [this]() { return _quit || !_requests.empty(); });
+
+			if (_quit)
+				break;
+
+			code = _requests.front();
+			_requests.pop_front();
+		}
+
+		auto begin = std::chrono::high_resolution_clock::now();
+
+		Rasterized result;
+		this->rasterize(_faces[thread], code, result, workspace);
+
+		auto end = std::chrono::high_resolution_clock::now();
+
+		result.time = std::chrono::duration<float, std::milli>(end - begin).count();
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		_results.push_back(std::move(result));
+	}
+}
+
+std::uint32_t
+FontGlyphCache::getFontSize() const noexcept
+{
+	return _fontSize;
+}
+
+std::uint32_t
+FontGlyphCache::getSampleSize() const noexcept
+{
+	return _sampleSize;
+}
+
+std::uint32_t
+FontGlyphCache::getAtlasSize() const noexcept
+{
+	return _atlasSize;
+}
+
+float
+FontGlyphCache::getSpread() const noexcept
+{
+	return _spread;
+}
+
+const FontBitmaps&
+FontGlyphCache::getBitmapData() const noexcept
+{
+	return _bitmap;
+}
+
+const GraphicsTexturePtr&
+FontGlyphCache::getTexture() const noexcept
+{
+	return _texture;
+}
+
+std::size_t
+FontGlyphCache::getNumGlyphs() const noexcept
+{
+	return _glyphs.size();
+}
+
+std::size_t
+FontGlyphCache::getNumPending() const noexcept
+{
+	return _requested.size();
+}
+
+std::size_t
+FontGlyphCache::getNumRasterized() const noexcept
+{
+	return _numRasterized;
+}
+
+std::size_t
+FontGlyphCache::getNumUploads() const noexcept
+{
+	return _numUploads;
+}
+
+std::size_t
+FontGlyphCache::getNumUploadedBytes() const noexcept
+{
+	return _numUploadedBytes;
+}
+
+std::size_t
+FontGlyphCache::getNumFlushes() const noexcept
+{
+	return _numFlushes;
+}
+
+float
+FontGlyphCache::getStartupTime() const noexcept
+{
+	return _startupTime;
+}
+
+float
+FontGlyphCache::getRasterTime() const noexcept
+{
+	return _rasterTime;
+}
+
+float
+FontGlyphCache::getGlyphsPerSecond() const noexcept
+{
+	// per worker thread, measured around rasterization and the distance transform only
+	if (_rasterTime > 0.0f)
+		return _numRasterized * 1000.0f / _rasterTime;
+	return 0.0f;
+}
+
+_NAME_END
\ No newline at end of file
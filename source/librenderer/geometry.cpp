@@ -40,9 +40,16 @@
 #include <ray/material.h>
 #include <ray/graphics_data.h>
 #include <ray/camera.h>
+#include <ray/render_scene.h>
 
 _NAME_BEGIN
 
+namespace
+{
+	// number of frames a caster has to stay still before shadow caches treat it as static
+	const std::uint32_t shadowStaticFrames = 60;
+}
+
 __ImplementSubClass(Geometry, RenderObject, "Geometry")
 
 GraphicsIndirect::GraphicsIndirect() noexcept
@@ -68,6 +75,7 @@ GraphicsIndirect::GraphicsIndirect(std::uint32_t _numVertices, std::uint32_t _nu
 Geometry::Geometry() noexcept
 	: _isCastShadow(true)
 	, _isReceiveShadow(true)
+	, _moveFrame(0)
 	, _indexType(GraphicsIndexType::GraphicsIndexTypeUInt32)
 	, _vertexOffset(0)
 	, _indexOffset(0)
@@ -93,7 +101,14 @@ Geometry::getReceiveShadow() const noexcept
 void
 Geometry::setCastShadow(bool value) noexcept
 {
-	_isCastShadow = value;
+	if (_isCastShadow != value)
+	{
+		auto& scene = this->getRenderScene();
+		if (scene)
+			scene->addShadowCasterChanged(this->getBoundingBoxInWorld());
+
+		_isCastShadow = value;
+	}
 }
 
 bool
@@ -102,6 +117,22 @@ Geometry::getCastShadow()  const noexcept
 	return _isCastShadow;
 }
 
+std::uint32_t
+Geometry::getShadowStaticFrame() const noexcept
+{
+	return _moveFrame > 0 ? _moveFrame + shadowStaticFrames : 0;
+}
+
+bool
+Geometry::getShadowStatic() const noexcept
+{
+	auto& scene = this->getRenderScene();
+	if (!scene)
+		return true;
+
+	return this->getShadowStaticFrame() <= scene->getFrameIndex();
+}
+
 void
 Geometry::setMaterial(const MaterialPtr& material) noexcept
 {
@@ -182,6 +213,27 @@ Geometry::getGraphicsIndirect() noexcept
 	return _renderable;
 }
 
+void
+Geometry::onMoveBefore() noexcept
+{
+	auto& scene = this->getRenderScene();
+	if (!scene)
+		return;
+
+	// a caster that has been still long enough is baked into the static shadow caches,
+	// so the area it leaves has to be invalidated. moving casters are drawn every frame anyway.
+	if (this->getCastShadow() && this->getShadowStatic())
+		scene->addShadowCasterChanged(this->getBoundingBoxInWorld());
+}
+
+void
+Geometry::onMoveAfter() noexcept
+{
+	auto& scene = this->getRenderScene();
+	if (scene)
+		_moveFrame = scene->getFrameIndex();
+}
+
 bool
 Geometry::onVisiableTest(const Camera& camera, const Frustum& fru) noexcept
 {
@@ -41,6 +41,8 @@
 #include <ray/shadow_render_framebuffer.h>
 #include <ray/reflective_shadow_render_framebuffer.h>
 
+#include <chrono>
+
 _NAME_BEGIN
 
 __ImplementSubClass(Light, RenderObject, "Light")
@@ -58,6 +60,11 @@ Light::Light() noexcept
 	, _shadowMode(ShadowMode::ShadowModeNone)
 	, _shadowBias(0.1f)
 	, _shadowFactor(600.0f)
+	, _shadowCascades(LightShadowCascade::LightShadowCascadeMin)
+	, _shadowCascadeLambda(0.75f)
+	, _shadowCascadeFitTime(0.0f)
+	, _shadowDistance(200.0f)
+	, _shadowCascadeSplits(float4::Zero)
 {
 }
 
@@ -70,7 +77,19 @@ Light::~Light() noexcept
 void
 Light::setLightType(LightType type) noexcept
 {
-	_lightType = type;
+	if (_lightType != type)
+	{
+		bool cascaded = _lightType == LightType::LightTypeSun || type == LightType::LightTypeSun;
+
+		_lightType = type;
+
+		if (cascaded && _shadowCascades > 1 && _shadowMode != ShadowMode::ShadowModeNone)
+		{
+			this->destroyShadowMap();
+			this->setupShadowMap();
+		}
+	}
+
 	this->_updateBoundingBox();
 }
 
@@ -182,6 +201,53 @@ Light::getShadowMode() const noexcept
 	return _shadowMode;
 }
 
+void
+Light::setShadowCascades(std::uint8_t cascades) noexcept
+{
+	cascades = std::max<std::uint8_t>(LightShadowCascade::LightShadowCascadeMin, std::min<std::uint8_t>(cascades, LightShadowCascade::LightShadowCascadeMax));
+
+	if (_shadowCascades != cascades)
+	{
+		_shadowCascades = cascades;
+
+		if (_lightType == LightType::LightTypeSun && _shadowMode != ShadowMode::ShadowModeNone)
+		{
+			this->destroyShadowMap();
+			this->setupShadowMap();
+		}
+	}
+}
+
+std::uint8_t
+Light::getShadowCascades() const noexcept
+{
+	return _shadowCascades;
+}
+
+void
+Light::setShadowCascadeLambda(float lambda) noexcept
+{
+	_shadowCascadeLambda = math::clamp(lambda, 0.0f, 1.0f);
+}
+
+float
+Light::getShadowCascadeLambda() const noexcept
+{
+	return _shadowCascadeLambda;
+}
+
+void
+Light::setShadowDistance(float distance) noexcept
+{
+	_shadowDistance = distance;
+}
+
+float
+Light::getShadowDistance() const noexcept
+{
+	return _shadowDistance;
+}
+
 void
 Light::setGlobalIllumination(bool enable) noexcept
 {
@@ -208,6 +274,132 @@ Light::getCamera() const noexcept
 	return _shadowCamera;
 }
 
+const Cameras&
+Light::getShadowCascadeCameras() const noexcept
+{
+	return _shadowCascadeCameras;
+}
+
+const float4&
+Light::getShadowCascadeSplits() const noexcept
+{
+	return _shadowCascadeSplits;
+}
+
+Viewport
+Light::getShadowCascadeViewport(std::uint8_t cascade) const noexcept
+{
+	assert(cascade < _shadowCascadeCameras.size());
+
+	auto framebuffer = _shadowCamera->getRenderPipelineFramebuffer()->downcast<ShadowRenderFramebuffer>();
+	float size = framebuffer->getShadowMapSize();
+
+	return Viewport((cascade % 2) * size, (cascade / 2) * size, size, size);
+}
+
+std::size_t
+Light::getShadowCascadeDrawCount(std::uint8_t cascade) const noexcept
+{
+	assert(cascade < _shadowCascadeCameras.size());
+	return _shadowCascadeCameras[cascade]->getRenderDataManager()->getRenderData(RenderQueue::RenderQueueShadow).size();
+}
+
+float
+Light::getShadowCascadeFitTime() const noexcept
+{
+	return _shadowCascadeFitTime;
+}
+
+void
+Light::updateShadowCascades(const Camera& camera) noexcept
+{
+	assert(!_shadowCascadeCameras.empty());
+
+	auto begin = std::chrono::high_resolution_clock::now();
+
+	std::size_t cascades = _shadowCascadeCameras.size();
+
+	float znear = camera.getNear();
+	float zfar = std::max(std::min(camera.getFar(), _shadowDistance), znear * 2.0f);
+
+	// practical split scheme, blending logarithmic and uniform split distances
+	float splits[LightShadowCascade::LightShadowCascadeMax + 1];
+	splits[0] = znear;
+
+	for (std::size_t i = 1; i <= cascades; i++)
+	{
+		float t = float(i) / cascades;
+		float logSplit = znear * std::pow(zfar / znear, t);
+		float uniformSplit = znear + (zfar - znear) * t;
+		splits[i] = math::lerp(uniformSplit, logSplit, _shadowCascadeLambda);
+	}
+
+	for (std::size_t i = 0; i < 3; i++)
+		_shadowCascadeSplits[i] = i + 1 < cascades ? splits[i + 1] : std::numeric_limits<float>::max();
+
+	_shadowCascadeSplits.w = zfar;
+
+	float2 extent;
+	if (camera.getCameraType() == CameraType::CameraTypePerspective)
+		extent.set(1.0f / camera.getProject().a1, 1.0f / camera.getProject().b2);
+
+	auto framebuffer = _shadowCamera->getRenderPipelineFramebuffer()->downcast<ShadowRenderFramebuffer>();
+	float shadowMapSize = framebuffer->getShadowMapSize();
+
+	auto& right = this->getRight();
+	auto& up = this->getUpVector();
+	auto& forward = this->getForward();
+
+	for (std::size_t i = 0; i < cascades; i++)
+	{
+		float3 corners[8];
+
+		for (std::size_t j = 0; j < 8; j++)
+		{
+			float z = (j & 4) ? splits[i + 1] : splits[i];
+
+			float3 corner;
+			if (camera.getCameraType() == CameraType::CameraTypePerspective)
+				corner.set((j & 1) ? extent.x * z : -extent.x * z, (j & 2) ? extent.y * z : -extent.y * z, z);
+			else
+				corner.set((j & 1) ? camera.getOrtho().y : camera.getOrtho().x, (j & 2) ? camera.getOrtho().w : camera.getOrtho().z, z);
+
+			corners[j] = camera.getViewInverse() * corner;
+		}
+
+		// a bounding sphere keeps the projection size constant while the view rotates
+		float3 center = float3::Zero;
+		for (auto& corner : corners)
+			center += corner;
+		center /= 8.0f;
+
+		float radius = 0.0f;
+		for (auto& corner : corners)
+			radius = std::max(radius, math::distance(center, corner));
+		radius = std::ceil(radius * 16.0f) / 16.0f;
+
+		// snap the center to whole shadow map texels so the cascade does not shimmer when moving
+		float texelSize = radius * 2.0f / shadowMapSize;
+		float x = math::dot(center, right);
+		float y = math::dot(center, up);
+		center += right * (std::floor(x / texelSize) * texelSize - x);
+		center += up * (std::floor(y / texelSize) * texelSize - y);
+
+		float backDistance = std::max(_lightRange, radius);
+
+		float4x4 transform = this->getTransform();
+		transform.setTranslate(center - forward * backDistance);
+
+		auto& cascade = _shadowCascadeCameras[i];
+		cascade->setTransform(transform, math::transformInverse(transform));
+		cascade->setOrtho(float4(-radius, radius, -radius, radius));
+		cascade->setFar(backDistance + radius);
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	_shadowCascadeFitTime = std::chrono::duration<float, std::milli>(end - begin).count();
+}
+
 void
 Light::setShadowBias(float bias) noexcept
 {
@@ -274,8 +466,11 @@ Light::getSkyLightingSpecular() const noexcept
 bool
 Light::setupShadowMap() noexcept
 {
+	// every cascade renders into its own tile of a 2x2 atlas
+	bool cascaded = _lightType == LightType::LightTypeSun && _shadowCascades > 1;
+
 	auto framebuffer = std::make_shared<ray::ShadowRenderFramebuffer>();
-	if (!framebuffer->setup())
+	if (!framebuffer->setup(cascaded ? 2 : 1))
 		return false;
 
 	_shadowCamera = std::make_shared<Camera>();
@@ -287,6 +482,30 @@ Light::setupShadowMap() noexcept
 	_shadowCamera->setRatio(1.0f);
 	_shadowCamera->setRenderPipelineFramebuffer(framebuffer);
 
+	if (cascaded)
+		return this->setupShadowCascades(framebuffer);
+
+	return true;
+}
+
+bool
+Light::setupShadowCascades(const RenderPipelineFramebufferPtr& framebuffer) noexcept
+{
+	for (std::uint8_t i = 0; i < _shadowCascades; i++)
+	{
+		auto camera = std::make_shared<Camera>();
+		camera->setOwnerListener(this);
+		camera->setCameraOrder(CameraOrder::CameraOrderShadow);
+		camera->setCameraRenderFlags(CameraRenderFlagBits::CameraRenderTextureBit);
+		camera->setCameraType(CameraType::CameraTypeOrtho);
+		camera->setNear(0.1f);
+		camera->setRatio(1.0f);
+		camera->setRenderPipelineFramebuffer(framebuffer);
+		camera->setRenderScene(this->getRenderScene());
+
+		_shadowCascadeCameras.push_back(camera);
+	}
+
 	return true;
 }
 
@@ -314,6 +533,11 @@ Light::destroyShadowMap() noexcept
 {
 	if (_shadowCamera)
 		_shadowCamera->getRenderPipelineFramebuffer()->setFramebuffer(nullptr);
+
+	for (auto& it : _shadowCascadeCameras)
+		it->setRenderScene(nullptr);
+
+	_shadowCascadeCameras.clear();
 }
 
 void
@@ -414,6 +638,9 @@ Light::onSceneChangeBefore() noexcept
 	{
 		if (_shadowCamera)
 			_shadowCamera->setRenderScene(nullptr);
+
+		for (auto& it : _shadowCascadeCameras)
+			it->setRenderScene(nullptr);
 	}
 }
 
@@ -425,6 +652,9 @@ Light::onSceneChangeAfter() noexcept
 	{
 		if (_shadowCamera)
 			_shadowCamera->setRenderScene(renderScene);
+
+		for (auto& it : _shadowCascadeCameras)
+			it->setRenderScene(renderScene);
 	}
 }
 
@@ -0,0 +1,429 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#include "light_cluster.h"
+#include <ray/render_pipeline.h>
+#include <ray/camera.h>
+#include <ray/graphics_data.h>
+#include <ray/thread.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#	include <xmmintrin.h>
+#endif
+
+_NAME_BEGIN
+
+namespace
+{
+	// below this many lights the binning is cheaper than waking the workers
+	const std::size_t parallelLightThreshold = 64;
+
+	// lights that are padded in to fill the last simd lane never touch a cluster
+	const float paddingDepth = -1e18f;
+}
+
+LightCluster::LightCluster() noexcept
+	: _gridX(16)
+	, _gridY(8)
+	, _gridZ(24)
+	, _near(0.1f)
+	, _far(1000.0f)
+	, _clusterProject(1.0f, 1.0f)
+	, _clusterDepth(0.0f, 0.0f)
+	, _numIndices(0)
+{
+}
+
+LightCluster::~LightCluster() noexcept
+{
+}
+
+void
+LightCluster::setGridSize(std::uint32_t x, std::uint32_t y, std::uint32_t z) noexcept
+{
+	assert(x > 0 && y > 0 && z > 0);
+	_gridX = x;
+	_gridY = y;
+	_gridZ = z;
+}
+
+std::uint32_t
+LightCluster::getGridSizeX() const noexcept
+{
+	return _gridX;
+}
+
+std::uint32_t
+LightCluster::getGridSizeY() const noexcept
+{
+	return _gridY;
+}
+
+std::uint32_t
+LightCluster::getGridSizeZ() const noexcept
+{
+	return _gridZ;
+}
+
+void
+LightCluster::clear() noexcept
+{
+	_lights.clear();
+	_boundX.clear();
+	_boundY.clear();
+	_boundZ.clear();
+	_boundRadius.clear();
+	_numIndices = 0;
+}
+
+void
+LightCluster::close() noexcept
+{
+	this->clear();
+
+	_clusters.clear();
+	_clusters.shrink_to_fit();
+	_sliceCounts.clear();
+	_sliceIndices.clear();
+
+	_lightData.reset();
+	_clusterData.reset();
+}
+
+void
+LightCluster::addPointLight(const float3& position, float range, const float3& color, const float3& attenuation) noexcept
+{
+	_lights.push_back(float4(position, range));
+	_lights.push_back(float4(color, 1.0f));
+	_lights.push_back(float4(0.0f, 0.0f, 1.0f, -1.0f));
+	_lights.push_back(float4(attenuation, 0.0f));
+
+	_boundX.push_back(position.x);
+	_boundY.push_back(position.y);
+	_boundZ.push_back(position.z);
+	_boundRadius.push_back(range);
+}
+
+void
+LightCluster::addSpotLight(const float3& position, const float3& direction, float range, const float3& color, const float3& attenuation, const float2& outerInner) noexcept
+{
+	_lights.push_back(float4(position, range));
+	_lights.push_back(float4(color, outerInner.y));
+	_lights.push_back(float4(direction, outerInner.x));
+	_lights.push_back(float4(attenuation, 1.0f));
+
+	// tightest sphere around the cone, the whole range sphere for cones wider than a hemisphere
+	float cosAngle = outerInner.x;
+	float3 center = position;
+	float radius = range;
+
+	if (cosAngle > 0.70710678f)
+	{
+		radius = range * 0.5f / cosAngle;
+		center = position + direction * radius;
+	}
+	else if (cosAngle > 0.0f)
+	{
+		radius = range * std::sqrt(1.0f - cosAngle * cosAngle);
+		center = position + direction * (range * cosAngle);
+	}
+
+	_boundX.push_back(center.x);
+	_boundY.push_back(center.y);
+	_boundZ.push_back(center.z);
+	_boundRadius.push_back(radius);
+}
+
+std::size_t
+LightCluster::getNumLights() const noexcept
+{
+	return _boundRadius.size();
+}
+
+std::size_t
+LightCluster::getNumIndices() const noexcept
+{
+	return _numIndices;
+}
+
+void
+LightCluster::build(const Camera& camera) noexcept
+{
+	assert(camera.getCameraType() == CameraType::CameraTypePerspective);
+
+	_near = std::max(camera.getNear(), 1e-4f);
+	_far = std::max(camera.getFar(), _near * 2.0f);
+
+	auto& project = camera.getProject();
+	_clusterProject.set(project.a1, project.b2);
+
+	float scale = _gridZ / std::log(_far / _near);
+	_clusterDepth.set(scale, -std::log(_near) * scale);
+
+	_sliceCounts.resize(_gridZ);
+	_sliceIndices.resize(_gridZ);
+
+	if (this->getNumLights() >= parallelLightThreshold)
+	{
+		parallelFor(_gridZ, [this](std::uint32_t i)
+		{
+			this->buildSlice(i, _sliceCounts[i], _sliceIndices[i]);
+		});
+	}
+	else
+	{
+		for (std::uint32_t i = 0; i < _gridZ; i++)
+			this->buildSlice(i, _sliceCounts[i], _sliceIndices[i]);
+	}
+
+	std::size_t numClusters = _gridX * _gridY * _gridZ;
+
+	_numIndices = 0;
+	for (auto& it : _sliceIndices)
+		_numIndices += it.size();
+
+	_clusters.resize(numClusters + (_numIndices + 3) / 4);
+
+	// offsets address the buffer as a flat array of scalars, counting from its first texel
+	float* packed = _clusters.front().ptr() + numClusters * 4;
+	std::size_t offset = 0;
+
+	for (std::uint32_t z = 0; z < _gridZ; z++)
+	{
+		auto& counts = _sliceCounts[z];
+		auto& indices = _sliceIndices[z];
+
+		std::size_t base = z * _gridX * _gridY;
+		std::size_t first = 0;
+
+		for (std::size_t i = 0; i < counts.size(); i++)
+		{
+			_clusters[base + i].set(float(numClusters * 4 + offset + first), float(counts[i]), 0.0f, 0.0f);
+			first += counts[i];
+		}
+
+		for (std::size_t i = 0; i < indices.size(); i++)
+			packed[offset + i] = float(indices[i]);
+
+		offset += indices.size();
+	}
+
+	for (std::size_t i = offset; i < (_clusters.size() - numClusters) * 4; i++)
+		packed[i] = 0.0f;
+}
+
+void
+LightCluster::buildSlice(std::uint32_t slice, std::vector<std::uint32_t>& counts, std::vector<std::uint32_t>& indices) const noexcept
+{
+	float z0 = _near * std::pow(_far / _near, float(slice) / _gridZ);
+	float z1 = _near * std::pow(_far / _near, float(slice + 1) / _gridZ);
+
+	counts.assign(_gridX * _gridY, 0);
+	indices.clear();
+
+	std::vector<std::uint32_t> candidates;
+	std::vector<float> cx, cy, cz, cr;
+
+	for (std::uint32_t i = 0; i < _boundRadius.size(); i++)
+	{
+		if (_boundZ[i] + _boundRadius[i] < z0 || _boundZ[i] - _boundRadius[i] > z1)
+			continue;
+
+		candidates.push_back(i);
+		cx.push_back(_boundX[i]);
+		cy.push_back(_boundY[i]);
+		cz.push_back(_boundZ[i]);
+		cr.push_back(_boundRadius[i] * _boundRadius[i]);
+	}
+
+	if (candidates.empty())
+		return;
+
+	while (cx.size() % 4)
+	{
+		cx.push_back(0.0f);
+		cy.push_back(0.0f);
+		cz.push_back(paddingDepth);
+		cr.push_back(0.0f);
+	}
+
+	for (std::uint32_t y = 0; y < _gridY; y++)
+	{
+		float sy0 = (-1.0f + 2.0f * y / _gridY) / _clusterProject.y;
+		float sy1 = (-1.0f + 2.0f * (y + 1) / _gridY) / _clusterProject.y;
+		float minY = std::min(sy0 * z0, sy0 * z1);
+		float maxY = std::max(sy1 * z0, sy1 * z1);
+
+		for (std::uint32_t x = 0; x < _gridX; x++)
+		{
+			float sx0 = (-1.0f + 2.0f * x / _gridX) / _clusterProject.x;
+			float sx1 = (-1.0f + 2.0f * (x + 1) / _gridX) / _clusterProject.x;
+			float minX = std::min(sx0 * z0, sx0 * z1);
+			float maxX = std::max(sx1 * z0, sx1 * z1);
+
+			float3 boxCenter((minX + maxX) * 0.5f, (minY + maxY) * 0.5f, (z0 + z1) * 0.5f);
+			float boxRadius = math::length(float3(maxX - minX, maxY - minY, z1 - z0)) * 0.5f;
+
+			std::uint32_t count = 0;
+
+			for (std::size_t j = 0; j < cx.size(); j += 4)
+			{
+				// squared distance from each bounding sphere center to the cluster box
+#if defined(__SSE2__) || defined(_M_X64)
+				__m128 zero = _mm_setzero_ps();
+				__m128 px = _mm_loadu_ps(&cx[j]);
+				__m128 py = _mm_loadu_ps(&cy[j]);
+				__m128 pz = _mm_loadu_ps(&cz[j]);
+
+				__m128 dx = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(minX), px), zero), _mm_max_ps(_mm_sub_ps(px, _mm_set1_ps(maxX)), zero));
+				__m128 dy = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(minY), py), zero), _mm_max_ps(_mm_sub_ps(py, _mm_set1_ps(maxY)), zero));
+				__m128 dz = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(z0), pz), zero), _mm_max_ps(_mm_sub_ps(pz, _mm_set1_ps(z1)), zero));
+				__m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+				int mask = _mm_movemask_ps(_mm_cmple_ps(d2, _mm_loadu_ps(&cr[j])));
+#else
+				int mask = 0;
+				for (std::size_t k = 0; k < 4; k++)
+				{
+					float dx = std::max(minX - cx[j + k], 0.0f) + std::max(cx[j + k] - maxX, 0.0f);
+					float dy = std::max(minY - cy[j + k], 0.0f) + std::max(cy[j + k] - maxY, 0.0f);
+					float dz = std::max(z0 - cz[j + k], 0.0f) + std::max(cz[j + k] - z1, 0.0f);
+					if (dx * dx + dy * dy + dz * dz <= cr[j + k])
+						mask |= 1 << k;
+				}
+#endif
+				for (std::size_t k = 0; mask; k++, mask >>= 1)
+				{
+					if (!(mask & 1))
+						continue;
+
+					std::uint32_t index = candidates[j + k];
+
+					auto& position = _lights[index * 4];
+					auto& direction = _lights[index * 4 + 2];
+
+					// spot lights are also tested as a cone against the sphere around the cluster
+					if (_lights[index * 4 + 3].w > 0.0f && direction.w > 0.0f)
+					{
+						float3 v = boxCenter - position.xyz();
+						float lenSq = math::dot(v, v);
+						float v1 = math::dot(v, direction.xyz());
+						float sinAngle = std::sqrt(1.0f - direction.w * direction.w);
+						float closest = direction.w * std::sqrt(std::max(lenSq - v1 * v1, 0.0f)) - v1 * sinAngle;
+
+						if (closest > boxRadius || v1 > boxRadius + position.w || v1 < -boxRadius)
+							continue;
+					}
+
+					indices.push_back(index);
+					count++;
+				}
+			}
+
+			counts[y * _gridX + x] = count;
+		}
+	}
+}
+
+bool
+LightCluster::upload(RenderPipeline& pipeline) noexcept
+{
+	if (_lights.empty() || _clusters.empty())
+		return false;
+
+	if (!updateGraphicsData(pipeline, _lightData, _lights.data(), _lights.size()))
+		return false;
+
+	if (!updateGraphicsData(pipeline, _clusterData, _clusters.data(), _clusters.size()))
+		return false;
+
+	return true;
+}
+
+bool
+LightCluster::updateGraphicsData(RenderPipeline& pipeline, GraphicsDataPtr& data, const float4* rows, std::size_t count) noexcept
+{
+	std::size_t size = count * sizeof(float4);
+	if (!data || data->getGraphicsDataDesc().getStreamSize() < size)
+	{
+		if (data)
+			size = std::max(size, data->getGraphicsDataDesc().getStreamSize() * 2);
+
+		GraphicsDataDesc dataDesc;
+		dataDesc.setStreamSize(size);
+		dataDesc.setUsage(GraphicsUsageFlagBits::GraphicsUsageFlagWriteBit);
+		dataDesc.setType(GraphicsDataType::GraphicsDataTypeUniformTexelBuffer);
+
+		data = pipeline.createGraphicsData(dataDesc);
+		if (!data)
+			return false;
+	}
+
+	void* buffer;
+	if (!data->map(0, count * sizeof(float4), &buffer))
+		return false;
+
+	std::memcpy(buffer, rows, count * sizeof(float4));
+	data->unmap();
+
+	return true;
+}
+
+const float2&
+LightCluster::getClusterProject() const noexcept
+{
+	return _clusterProject;
+}
+
+const float2&
+LightCluster::getClusterDepth() const noexcept
+{
+	return _clusterDepth;
+}
+
+const GraphicsDataPtr&
+LightCluster::getLightData() const noexcept
+{
+	return _lightData;
+}
+
+const GraphicsDataPtr&
+LightCluster::getClusterData() const noexcept
+{
+	return _clusterData;
+}
+
+_NAME_END
\ No newline at end of file
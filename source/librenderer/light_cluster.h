@@ -0,0 +1,116 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#ifndef _H_LIGHT_CLUSTER_H_
+#define _H_LIGHT_CLUSTER_H_
+
+#include <ray/render_types.h>
+
+_NAME_BEGIN
+
+// Assigns point and spot lights to a view space froxel grid so that every light
+// can be shaded by a single full screen pass.
+class LightCluster final
+{
+public:
+	LightCluster() noexcept;
+	~LightCluster() noexcept;
+
+	void setGridSize(std::uint32_t x, std::uint32_t y, std::uint32_t z) noexcept;
+	std::uint32_t getGridSizeX() const noexcept;
+	std::uint32_t getGridSizeY() const noexcept;
+	std::uint32_t getGridSizeZ() const noexcept;
+
+	void clear() noexcept;
+	void close() noexcept;
+
+	void addPointLight(const float3& position, float range, const float3& color, const float3& attenuation) noexcept;
+	void addSpotLight(const float3& position, const float3& direction, float range, const float3& color, const float3& attenuation, const float2& outerInner) noexcept;
+
+	std::size_t getNumLights() const noexcept;
+	std::size_t getNumIndices() const noexcept;
+
+	void build(const Camera& camera) noexcept;
+	bool upload(RenderPipeline& pipeline) noexcept;
+
+	const float2& getClusterProject() const noexcept;
+	const float2& getClusterDepth() const noexcept;
+
+	const GraphicsDataPtr& getLightData() const noexcept;
+	const GraphicsDataPtr& getClusterData() const noexcept;
+
+private:
+	void buildSlice(std::uint32_t slice, std::vector<std::uint32_t>& counts, std::vector<std::uint32_t>& indices) const noexcept;
+
+	static bool updateGraphicsData(RenderPipeline& pipeline, GraphicsDataPtr& data, const float4* rows, std::size_t count) noexcept;
+
+private:
+	LightCluster(const LightCluster&) = delete;
+	LightCluster& operator=(const LightCluster&) = delete;
+
+private:
+	std::uint32_t _gridX;
+	std::uint32_t _gridY;
+	std::uint32_t _gridZ;
+
+	float _near;
+	float _far;
+	float2 _clusterProject;
+	float2 _clusterDepth;
+
+	// four rows per light:
+	// (position, range) (color, cosInner) (direction, cosOuter) (attenuation, spot)
+	std::vector<float4> _lights;
+
+	// bounding spheres of the lights, split by component for the simd tests
+	std::vector<float> _boundX;
+	std::vector<float> _boundY;
+	std::vector<float> _boundZ;
+	std::vector<float> _boundRadius;
+
+	// (offset, count) of every cluster followed by the packed light indices
+	std::vector<float4> _clusters;
+	std::vector<std::vector<std::uint32_t>> _sliceCounts;
+	std::vector<std::vector<std::uint32_t>> _sliceIndices;
+	std::size_t _numIndices;
+
+	GraphicsDataPtr _lightData;
+	GraphicsDataPtr _clusterData;
+};
+
+_NAME_END
+
+#endif
\ No newline at end of file
@@ -49,6 +49,7 @@
 
 #include <ray/render_system.h>
 #include <ray/ioserver.h>
+#include <ray/mstream.h>
 #include <ray/xmlreader.h>
 #include <ray/parse.h>
 #include <ray/except.h>
@@ -98,10 +99,8 @@ MaterialMaker::instanceInputLayout(MaterialManager& manager, Material& material,
 	GraphicsInputLayoutDesc inputLayoutDesc;
 
 	std::string inputLayoutName = reader.getValue<std::string>("name");
-
-	auto inputLayout = manager.getInputLayout(inputLayoutName);
-	if (inputLayout)
-		return;
+	if (inputLayoutName.empty())
+		throw failure(__TEXT("Empty input layout name : ") + reader.getCurrentNodePath());
 
 	if (!reader.setToFirstChild())
 		throw failure(__TEXT("Empty child : ") + reader.getCurrentNodePath());
@@ -135,9 +134,7 @@ MaterialMaker::instanceInputLayout(MaterialManager& manager, Material& material,
 	} while (reader.setToNextChild());
 
 	inputLayoutDesc.addVertexBinding(GraphicsVertexBinding(0, inputLayoutDesc.getVertexSize(0)));
-	inputLayout = manager.createInputLayout(inputLayoutName, inputLayoutDesc);
-	if (!inputLayout)
-		throw failure(__TEXT("Can't create input layout") + reader.getCurrentNodeName());
+	_inputLayouts.push_back(std::make_pair(std::move(inputLayoutName), std::move(inputLayoutDesc)));
 }
 
 void
@@ -159,7 +156,7 @@ MaterialMaker::instanceCodes(MaterialManager& manager, ixmlarchive& reader) exce
 }
 
 void
-MaterialMaker::instanceShader(MaterialManager& manager, Material& material, GraphicsProgramDesc& programDesc, ixmlarchive& reader) except
+MaterialMaker::instanceShader(MaterialManager& manager, Material& material, std::vector<GraphicsShaderDesc>& shaders, ixmlarchive& reader) except
 {
 	std::string type = reader.getValue<std::string>("name");
 	std::string value = reader.getValue<std::string>("value");
@@ -193,11 +190,7 @@ MaterialMaker::instanceShader(MaterialManager& manager, Material& material, Grap
 		shaderDesc.setByteCodes(std::string(codes.data(), codes.size()));
 	}
 
-	auto shaderModule = manager.createShader(shaderDesc);
-	if (!shaderModule)
-		throw failure(__TEXT("Can't create shader : ") + reader.getCurrentNodePath());
-
-	programDesc.addShader(std::move(shaderModule));
+	shaders.push_back(std::move(shaderDesc));
 }
 
 void
@@ -212,9 +205,10 @@ MaterialMaker::instancePass(MaterialManager& manager, Material& material, Materi
 
 	std::string name;
 
-	GraphicsStateDesc stateDesc;
-	GraphicsProgramDesc programDesc;
-	GraphicsInputLayoutPtr inputLayout;
+	PassDesc passDesc;
+	passDesc.path = reader.getCurrentNodePath();
+
+	auto& stateDesc = passDesc.stateDesc;
 
 	GraphicsColorBlends blends;
 
@@ -228,11 +222,11 @@ MaterialMaker::instancePass(MaterialManager& manager, Material& material, Materi
 			throw failure(__TEXT("Empty state name : ") + reader.getCurrentNodePath());
 
 		if (name == "vertex")
-			this->instanceShader(manager, material, programDesc, reader);
+			this->instanceShader(manager, material, passDesc.shaders, reader);
 		else if (name == "fragment")
-			this->instanceShader(manager, material, programDesc, reader);
+			this->instanceShader(manager, material, passDesc.shaders, reader);
 		else if (name == "inputlayout")
-			inputLayout = manager.getInputLayout(reader.getValue<std::string>("value"));
+			passDesc.inputLayout = reader.getValue<std::string>("value");
 		else if (name == "cullmode")
 		{
 			GraphicsCullMode cullMode;
@@ -466,21 +460,13 @@ MaterialMaker::instancePass(MaterialManager& manager, Material& material, Materi
 	else
 		stateDesc.setFrontFace(GraphicsFrontFace::GraphicsFrontFaceCW);
 
-	auto state = manager.createRenderState(stateDesc);
-	if (!state)
-		throw failure(__TEXT("Can't create render state : ") + reader.getCurrentNodePath());
+	// the graphics objects are created later by instance(), on the device thread
+	passDesc.pass = std::make_shared<MaterialPass>();
+	passDesc.pass->setName(std::move(passName));
 
-	auto program = manager.createProgram(programDesc);
-	if (!state)
-		throw failure(__TEXT("Can't create program : ") + reader.getCurrentNodePath());
+	tech->addPass(passDesc.pass);
 
-	auto pass = std::make_shared<MaterialPass>();
-	pass->setName(std::move(passName));
-	pass->setGraphicsState(std::move(state));
-	pass->setGraphicsProgram(std::move(program));
-	pass->setGraphicsInputLayout(std::move(inputLayout));
-
-	tech->addPass(std::move(pass));
+	_passes.push_back(std::move(passDesc));
 }
 
 void
@@ -525,8 +511,13 @@ MaterialMaker::instanceParameter(MaterialManager& manager, Material& material, i
 
 	if (_isHlsl)
 	{
-		type = type.substr(0, type.find_first_of('['));
-		_hlslCodes += "uniform " + type + " " + name + ";\n";
+		if (uniformType == GraphicsUniformType::GraphicsUniformTypeUniformTexelBuffer)
+			_hlslCodes += "Buffer<float4> " + name + ";\n";
+		else
+		{
+			type = type.substr(0, type.find_first_of('['));
+			_hlslCodes += "uniform " + type + " " + name + ";\n";
+		}
 	}
 
 	auto pos = name.find_first_of('[');
@@ -735,13 +726,7 @@ MaterialMaker::instanceSampler(MaterialManager& manager, Material& material, ixm
 	if (_isHlsl)
 		_hlslCodes += "};\n";
 
-	auto sampler = manager.getSampler(samplerName);
-	if (sampler)
-		return;
-
-	sampler = manager.createSampler(samplerName, samplerDesc);
-	if (!sampler)
-		throw failure(__TEXT("Can't create sampler ") + reader.getCurrentNodePath());
+	_samplers.push_back(std::make_pair(std::move(samplerName), std::move(samplerDesc)));
 }
 
 void
@@ -803,12 +788,20 @@ MaterialMaker::instanceInclude(MaterialManager& manager, Material& material, ixm
 	if (_onceInclude[filename])
 		return true;
 
-	StreamReaderPtr stream;
-	if (!IoServer::instance()->openFileURL(stream, filename, ios_base::in))
+	auto data = manager.getIncludeFile(filename);
+	if (!data)
 		throw failure(__TEXT("Opening file fail:") + filename);
 
+	if (data->empty())
+		throw failure(__TEXT("Empty file:") + filename);
+
+	MemoryReader stream;
+	stream.resize(data->size());
+	std::memcpy(stream.map(), data->data(), data->size());
+	stream.unmap();
+
 	XMLReader xml;
-	if (!xml.open(*stream))
+	if (!xml.open(stream))
 		return false;
 
 	xml.setToFirstChild();
@@ -821,20 +814,50 @@ MaterialMaker::instanceInclude(MaterialManager& manager, Material& material, ixm
 
 bool
 MaterialMaker::load(MaterialManager& manager, Material& material, const std::string& filename) noexcept
+{
+	if (!this->parse(manager, material, filename))
+		return false;
+
+	return this->instance(manager, material);
+}
+
+bool
+MaterialMaker::load(MaterialManager& manager, Material& material, StreamReader& stream) noexcept
 {
 	try
 	{
+		XMLReader reader;
+		if (reader.open(stream))
+		{
+			reader.setToFirstChild();
+			return this->load(manager, material, reader);
+		}
+
+		return false;
+	}
+	catch (const failure& e)
+	{
+		std::cout << e.message() << e.stack();
+		return false;
+	}
+}
+
+bool
+MaterialMaker::parse(MaterialManager& manager, Material& material, const std::string& filename) noexcept
+{
+	try
+	{
+		// parse() may run on several threads at once, so test the stream instead of the server state
 		StreamReaderPtr stream;
-		if (!IoServer::instance()->openFileURL(stream, filename, ios_base::in))
+		IoServer::instance()->openFileURL(stream, filename, ios_base::in);
+		if (!stream)
 			throw failure(__TEXT("Opening file fail:") + filename);
 
 		XMLReader reader;
 		if (reader.open(*stream))
 		{
 			reader.setToFirstChild();
-			if (!this->load(manager, material, reader))
-				return false;
-			return true;
+			return this->parse(manager, material, reader);
 		}
 
 		return false;
@@ -847,22 +870,78 @@ MaterialMaker::load(MaterialManager& manager, Material& material, const std::str
 }
 
 bool
-MaterialMaker::load(MaterialManager& manager, Material& material, StreamReader& stream) noexcept
+MaterialMaker::parse(MaterialManager& manager, Material& material, ixmlarchive& reader) except
+{
+	std::string nodeName = reader.getCurrentNodeName();
+	if (nodeName == "material")
+		return this->loadMaterial(manager, material, reader);
+	else if (nodeName == "effect")
+		return this->loadEffect(manager, material, reader);
+	else
+		throw failure(__TEXT("Unknown node name " + nodeName));
+}
+
+bool
+MaterialMaker::instance(MaterialManager& manager, Material& material) noexcept
 {
 	try
 	{
-		XMLReader reader;
-		if (reader.open(stream))
+		for (auto& it : _inputLayouts)
 		{
-			reader.setToFirstChild();
-			return this->load(manager, material, reader);
+			if (manager.getInputLayout(it.first))
+				continue;
+
+			if (!manager.createInputLayout(it.first, it.second))
+				throw failure(__TEXT("Can't create input layout : ") + it.first);
 		}
 
-		return false;
+		for (auto& it : _samplers)
+		{
+			if (manager.getSampler(it.first))
+				continue;
+
+			if (!manager.createSampler(it.first, it.second))
+				throw failure(__TEXT("Can't create sampler : ") + it.first);
+		}
+
+		for (auto& it : _passes)
+		{
+			GraphicsProgramDesc programDesc;
+			for (auto& shaderDesc : it.shaders)
+			{
+				auto shader = manager.createShader(shaderDesc);
+				if (!shader)
+					throw failure(__TEXT("Can't create shader : ") + it.path);
+
+				programDesc.addShader(std::move(shader));
+			}
+
+			auto state = manager.createRenderState(it.stateDesc);
+			if (!state)
+				throw failure(__TEXT("Can't create render state : ") + it.path);
+
+			auto program = manager.createProgram(programDesc);
+			if (!program)
+				throw failure(__TEXT("Can't create program : ") + it.path);
+
+			GraphicsInputLayoutPtr inputLayout;
+			if (!it.inputLayout.empty())
+				inputLayout = manager.getInputLayout(it.inputLayout);
+
+			it.pass->setGraphicsState(std::move(state));
+			it.pass->setGraphicsProgram(std::move(program));
+			it.pass->setGraphicsInputLayout(std::move(inputLayout));
+		}
+
+		_passes.clear();
+		_samplers.clear();
+		_inputLayouts.clear();
+
+		return material.setup();
 	}
 	catch (const failure& e)
 	{
-		std::cout << e.message() << e.stack();
+		std::cout << __TEXT("in ") + material.getName() + __TEXT(" ") + e.message() + e.stack();
 		return false;
 	}
 }
@@ -936,9 +1015,13 @@ MaterialMaker::loadMaterial(MaterialManager& manager, Material& material, ixmlar
 		throw failure(__TEXT("Shader name cannot be empty"));
 
 	MaterialMaker maker;
-	if (!maker.load(manager, material, name))
+	if (!maker.parse(manager, material, name))
 		return false;
 
+	_passes.insert(_passes.end(), std::make_move_iterator(maker._passes.begin()), std::make_move_iterator(maker._passes.end()));
+	_samplers.insert(_samplers.end(), std::make_move_iterator(maker._samplers.begin()), std::make_move_iterator(maker._samplers.end()));
+	_inputLayouts.insert(_inputLayouts.end(), std::make_move_iterator(maker._inputLayouts.begin()), std::make_move_iterator(maker._inputLayouts.end()));
+
 	for (auto& arg : args)
 	{
 		auto param = material.getParameter(arg.first);
@@ -971,23 +1054,10 @@ MaterialMaker::loadMaterial(MaterialManager& manager, Material& material, ixmlar
 bool
 MaterialMaker::load(MaterialManager& manager, Material& material, ixmlarchive& reader) except
 {
-	std::string nodeName = reader.getCurrentNodeName();
-	if (nodeName == "material")
-	{
-		if (loadMaterial(manager, material, reader))
-			return true;
-	}
-	else if (nodeName == "effect")
-	{
-		if (loadEffect(manager, material, reader))
-			return material.setup();
-	}
-	else
-	{
-		throw failure(__TEXT("Unknown node name " + nodeName));
-	}
+	if (!this->parse(manager, material, reader))
+		return false;
 
-	return false;
+	return this->instance(manager, material);
 }
 
 bool
@@ -1046,6 +1116,7 @@ MaterialMaker::GetUniformType(const std::string& string, GraphicsUniformType& ty
 	if (string == "texture3D") { type = GraphicsUniformType::GraphicsUniformTypeSamplerImage; return true; }
 	if (string == "textureCUBE") { type = GraphicsUniformType::GraphicsUniformTypeSamplerImage; return true; }
 	if (string == "buffer") { type = GraphicsUniformType::GraphicsUniformTypeUniformBuffer; return true; }
+	if (string == "texelbuffer") { type = GraphicsUniformType::GraphicsUniformTypeUniformTexelBuffer; return true; }
 
 	assert(false);
 	return false;
@@ -42,12 +42,94 @@
 #include <ray/graphics_sampler.h>
 #include <ray/graphics_texture.h>
 #include <ray/graphics_device.h>
+#include <ray/graphics_state.h>
+#include <ray/graphics_shader.h>
 
 #include <ray/image.h>
 #include <ray/ioserver.h>
+#include <ray/thread.h>
 
 _NAME_BEGIN
 
+namespace
+{
+	std::uint64_t hashBytes(const void* data, std::size_t length, std::uint64_t seed = 14695981039346656037ULL) noexcept
+	{
+		auto bytes = (const std::uint8_t*)data;
+		for (std::size_t i = 0; i < length; i++)
+		{
+			seed ^= bytes[i];
+			seed *= 1099511628211ULL;
+		}
+
+		return seed;
+	}
+
+	std::uint32_t asKey(float value) noexcept
+	{
+		std::uint32_t key;
+		std::memcpy(&key, &value, sizeof(key));
+		return key;
+	}
+
+	template<typename T>
+	std::uint32_t asKey(T value) noexcept
+	{
+		return static_cast<std::uint32_t>(value);
+	}
+
+	// the descriptors have padding and no comparison operators, so compare them through their values
+	std::vector<std::uint32_t> makeStateKey(const GraphicsStateDesc& desc) noexcept
+	{
+		std::vector<std::uint32_t> key =
+		{
+			asKey(desc.getCullMode()), asKey(desc.getPolygonMode()), asKey(desc.getPrimitiveType()), asKey(desc.getFrontFace()),
+			asKey(desc.getScissorTestEnable()), asKey(desc.getLinear2sRGBEnable()), asKey(desc.getMultisampleEnable()),
+			asKey(desc.getRasterizerDiscardEnable()), asKey(desc.getLineWidth()),
+			asKey(desc.getDepthEnable()), asKey(desc.getDepthWriteEnable()), asKey(desc.getDepthBoundsEnable()),
+			asKey(desc.getDepthBiasEnable()), asKey(desc.getDepthBiasClamp()), asKey(desc.getDepthClampEnable()),
+			asKey(desc.getDepthMin()), asKey(desc.getDepthMax()), asKey(desc.getDepthBias()), asKey(desc.getDepthSlopeScaleBias()),
+			asKey(desc.getDepthFunc()),
+			asKey(desc.getStencilEnable()),
+			asKey(desc.getStencilFrontFunc()), desc.getStencilFrontRef(), desc.getStencilFrontReadMask(), desc.getStencilFrontWriteMask(),
+			asKey(desc.getStencilFrontFail()), asKey(desc.getStencilFrontZFail()), asKey(desc.getStencilFrontPass()),
+			asKey(desc.getStencilBackFunc()), desc.getStencilBackRef(), desc.getStencilBackReadMask(), desc.getStencilBackWriteMask(),
+			asKey(desc.getStencilBackFail()), asKey(desc.getStencilBackZFail()), asKey(desc.getStencilBackPass())
+		};
+
+		for (auto& blend : desc.getColorBlends())
+		{
+			key.push_back(asKey(blend.getBlendEnable()));
+			key.push_back(asKey(blend.getBlendOp()));
+			key.push_back(asKey(blend.getBlendSrc()));
+			key.push_back(asKey(blend.getBlendDest()));
+			key.push_back(asKey(blend.getBlendAlphaOp()));
+			key.push_back(asKey(blend.getBlendAlphaSrc()));
+			key.push_back(asKey(blend.getBlendAlphaDest()));
+			key.push_back(asKey(blend.getColorWriteMask()));
+		}
+
+		return key;
+	}
+
+	std::vector<std::uint32_t> makeSamplerKey(const GraphicsSamplerDesc& desc) noexcept
+	{
+		return { asKey(desc.getSamplerWrap()), asKey(desc.getSamplerAnis()), asKey(desc.getSamplerFilter()) };
+	}
+
+	std::uint64_t makeShaderKey(const GraphicsShaderDesc& desc) noexcept
+	{
+		auto stage = desc.getStage();
+		auto lang = desc.getLanguage();
+
+		std::uint64_t key = hashBytes(desc.getByteCodes().data(), desc.getByteCodes().size());
+		key = hashBytes(desc.getEntryPoint().data(), desc.getEntryPoint().size(), key);
+		key = hashBytes(&stage, sizeof(stage), key);
+		key = hashBytes(&lang, sizeof(lang), key);
+		return key;
+	}
+}
+
 MaterialManager::MaterialManager() noexcept
 {
 }
@@ -73,28 +155,74 @@ MaterialManager::getDeviceType() const noexcept
 void
 MaterialManager::close() noexcept
 {
+	_materials.clear();
+	_programs.clear();
 	_shaders.clear();
+	_states.clear();
 	_samplers.clear();
+	_samplerObjects.clear();
 	_inputLayouts.clear();
-	_materials.clear();
+	_includes.clear();
 }
 
 GraphicsStatePtr
-MaterialManager::createRenderState(const GraphicsStateDesc& shaderDesc) noexcept
+MaterialManager::createRenderState(const GraphicsStateDesc& stateDesc) noexcept
 {
-	return _graphicsDevice->createRenderState(shaderDesc);
+	auto key = makeStateKey(stateDesc);
+
+	auto it = _states.find(key);
+	if (it != _states.end())
+		return (*it).second;
+
+	auto state = _graphicsDevice->createRenderState(stateDesc);
+	if (state)
+		_states.insert(std::make_pair(std::move(key), state));
+
+	return state;
 }
 
 GraphicsShaderPtr
 MaterialManager::createShader(const GraphicsShaderDesc& shaderDesc) noexcept
 {
-	return _graphicsDevice->createShader(shaderDesc);
+	auto key = makeShaderKey(shaderDesc);
+
+	auto range = _shaders.equal_range(key);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		auto& desc = (*it).second->getGraphicsShaderDesc();
+		if (desc.getStage() == shaderDesc.getStage() &&
+			desc.getLanguage() == shaderDesc.getLanguage() &&
+			desc.getEntryPoint() == shaderDesc.getEntryPoint() &&
+			desc.getByteCodes() == shaderDesc.getByteCodes())
+		{
+			return (*it).second;
+		}
+	}
+
+	auto shader = _graphicsDevice->createShader(shaderDesc);
+	if (shader)
+		_shaders.insert(std::make_pair(key, shader));
+
+	return shader;
 }
 
 GraphicsProgramPtr
 MaterialManager::createProgram(const GraphicsProgramDesc& programDesc) noexcept
 {
-	return _graphicsDevice->createProgram(programDesc);
+	// shaders are shared through createShader, so the shader objects identify the program
+	std::vector<std::uintptr_t> key;
+	for (auto& shader : programDesc.getShaders())
+		key.push_back((std::uintptr_t)shader.get());
+
+	auto it = _programs.find(key);
+	if (it != _programs.end())
+		return (*it).second;
+
+	auto program = _graphicsDevice->createProgram(programDesc);
+	if (program)
+		_programs.insert(std::make_pair(std::move(key), program));
+
+	return program;
 }
 
 GraphicsSamplerPtr
@@ -107,9 +235,19 @@ MaterialManager::createSampler(const std::string& name, const GraphicsSamplerDes
 	if (sampler)
 		return nullptr;
 
-	sampler = _graphicsDevice->createSampler(samplerDesc);
-	if (!sampler)
-		return nullptr;
+	auto key = makeSamplerKey(samplerDesc);
+
+	auto it = _samplerObjects.find(key);
+	if (it != _samplerObjects.end())
+		sampler = (*it).second;
+	else
+	{
+		sampler = _graphicsDevice->createSampler(samplerDesc);
+		if (!sampler)
+			return nullptr;
+
+		_samplerObjects.insert(std::make_pair(std::move(key), sampler));
+	}
 
 	_samplers[name] = sampler;
 	return sampler;
@@ -188,6 +326,28 @@ MaterialManager::getInputLayout(const std::string& name) noexcept
 	return _inputLayouts[name];
 }
 
+std::shared_ptr<const std::string>
+MaterialManager::getIncludeFile(const std::string& filename) noexcept
+{
+	std::lock_guard<std::mutex> lock(_includeLock);
+
+	auto it = _includes.find(filename);
+	if (it != _includes.end())
+		return (*it).second;
+
+	StreamReaderPtr stream;
+	IoServer::instance()->openFileURL(stream, filename, ios_base::in);
+	if (!stream)
+		return nullptr;
+
+	auto data = std::make_shared<std::string>((std::size_t)stream->size(), 0);
+	if (!stream->read((char*)data->data(), data->size()))
+		return nullptr;
+
+	_includes[filename] = data;
+	return data;
+}
+
 MaterialPtr
 MaterialManager::createMaterial(const std::string& name) noexcept
 {
@@ -205,6 +365,67 @@ MaterialManager::createMaterial(const std::string& name) noexcept
 	return newMaterial;
 }
 
+bool
+MaterialManager::createMaterials(const std::vector<std::string>& names, Materials& materials) noexcept
+{
+	materials.resize(names.size());
+
+	std::vector<std::size_t> pending;
+	for (std::size_t i = 0; i < names.size(); i++)
+	{
+		auto it = _materials.find(names[i]);
+		if (it != _materials.end())
+			materials[i] = (*it).second->clone();
+		else
+			pending.push_back(i);
+	}
+
+	if (pending.empty())
+		return true;
+
+	// parsing touches no graphics objects, only the instancing below needs the device thread
+	std::vector<std::unique_ptr<MaterialMaker>> makers(pending.size());
+	std::vector<MaterialPtr> parsed(pending.size());
+
+	parallelFor(static_cast<std::uint32_t>(pending.size()), [&](std::uint32_t i)
+	{
+		auto& name = names[pending[i]];
+		auto maker = std::make_unique<MaterialMaker>();
+		auto material = std::make_shared<Material>(name);
+		if (maker->parse(*this, *material, name))
+		{
+			makers[i] = std::move(maker);
+			parsed[i] = std::move(material);
+		}
+	});
+
+	bool result = true;
+
+	for (std::size_t i = 0; i < pending.size(); i++)
+	{
+		auto& name = names[pending[i]];
+
+		// the same file may be requested more than once in a batch
+		auto it = _materials.find(name);
+		if (it != _materials.end())
+		{
+			materials[pending[i]] = (*it).second->clone();
+			continue;
+		}
+
+		if (!parsed[i] || !makers[i]->instance(*this, *parsed[i]))
+		{
+			result = false;
+			continue;
+		}
+
+		_materials.insert(std::make_pair(name, parsed[i]));
+		materials[pending[i]] = parsed[i];
+	}
+
+	return result;
+}
+
 MaterialPtr
 MaterialManager::getMaterial(const std::string& name) noexcept
 {
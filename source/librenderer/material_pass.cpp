@@ -507,7 +507,8 @@ MaterialPass::setup(Material& material) noexcept
 			if (type == GraphicsUniformType::GraphicsUniformTypeSamplerImage ||
 				type == GraphicsUniformType::GraphicsUniformTypeSamplerImage ||
 				type == GraphicsUniformType::GraphicsUniformTypeCombinedImageSampler ||
-				type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer)
+				type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer ||
+				type == GraphicsUniformType::GraphicsUniformTypeUniformTexelBuffer)
 			{
 				descriptorPoolDesc.addGraphicsDescriptorPoolComponent(GraphicsDescriptorPoolComponent(activeUniform->getType(), 1));
 			}
@@ -149,7 +149,9 @@ MaterialVariant::setType(GraphicsUniformType type) noexcept
 			delete _value.m4array;
 			_value.m4array = nullptr;
 		}
-		else if (_type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer)
+		else if (_type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer ||
+			_type == GraphicsUniformType::GraphicsUniformTypeUniformTexelBuffer ||
+			_type == GraphicsUniformType::GraphicsUniformTypeStorageTexelBuffer)
 		{
 			delete _value.buffer;
 			_value.buffer = nullptr;
@@ -201,7 +203,9 @@ MaterialVariant::setType(GraphicsUniformType type) noexcept
 			_value.m3array = new std::vector<float3x3>;
 		else if (type == GraphicsUniformType::GraphicsUniformTypeFloat4x4Array)
 			_value.m4array = new std::vector<float4x4>;
-		else if (type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer)
+		else if (type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer ||
+			type == GraphicsUniformType::GraphicsUniformTypeUniformTexelBuffer ||
+			type == GraphicsUniformType::GraphicsUniformTypeStorageTexelBuffer)
 			_value.buffer = new GraphicsDataPtr;
 		else if (type == GraphicsUniformType::GraphicsUniformTypeSamplerImage ||
 			type == GraphicsUniformType::GraphicsUniformTypeStorageImage ||
@@ -701,7 +705,7 @@ MaterialVariant::uniformTexture(GraphicsTexturePtr texture, GraphicsSamplerPtr s
 void
 MaterialVariant::uniformBuffer(GraphicsDataPtr buffer) noexcept
 {
-	assert(_type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer);
+	assert(_type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer || _type == GraphicsUniformType::GraphicsUniformTypeUniformTexelBuffer || _type == GraphicsUniformType::GraphicsUniformTypeStorageTexelBuffer);
 	*_value.buffer = buffer;
 }
 
@@ -939,7 +943,7 @@ MaterialVariant::getTextureSampler() const noexcept
 const GraphicsDataPtr&
 MaterialVariant::getBuffer() const noexcept
 {
-	assert(_type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer);
+	assert(_type == GraphicsUniformType::GraphicsUniformTypeUniformBuffer || _type == GraphicsUniformType::GraphicsUniformTypeUniformTexelBuffer || _type == GraphicsUniformType::GraphicsUniformTypeStorageTexelBuffer);
 	return *_value.buffer;
 }
 
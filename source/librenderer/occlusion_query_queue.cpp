@@ -33,4 +33,543 @@
 // | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 // | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-// +----------------------------------------------------------------------
\ No newline at end of file
+// +----------------------------------------------------------------------
+#include <ray/occlusion_query_queue.h>
+#include <ray/render_system.h>
+#include <ray/render_pipeline.h>
+#include <ray/camera.h>
+#include <ray/geometry.h>
+#include <ray/material.h>
+#include <ray/graphics_query.h>
+
+#include <queue>
+
+_NAME_BEGIN
+
+OcclusionQueryQueue::OcclusionQueryQueue() noexcept
+	: _maxLatency(3)
+	, _visibleQueryInterval(8)
+	, _batchSize(8)
+	, _leafSize(4)
+	, _frame(0)
+	, _build(0)
+	, _seed(0x9E3779B9)
+	, _numQueries(0)
+	, _numBatchedNodes(0)
+	, _numCulled(0)
+	, _numStalls(0)
+	, _numResults(0)
+	, _totalLatency(0)
+{
+}
+
+OcclusionQueryQueue::~OcclusionQueryQueue() noexcept
+{
+	this->close();
+}
+
+bool
+OcclusionQueryQueue::setup() noexcept
+{
+	_material = RenderSystem::instance()->createMaterial("sys:fx/occlusion_query.fxml");
+	if (!_material)
+		return false;
+
+	_technique = _material->getTech("OcclusionQuery");
+	if (!_technique)
+		return false;
+
+	// devices without query support hand back nothing, the caller then keeps rendering everything
+	auto query = this->allocQuery();
+	if (!query)
+		return false;
+
+	_freeQueries.push_back(query);
+	return true;
+}
+
+void
+OcclusionQueryQueue::close() noexcept
+{
+	_pendingQueries.clear();
+	_freeQueries.clear();
+
+	_visibleQueries.clear();
+	_invisibleQueries.clear();
+
+	_objects.clear();
+	_nodes.clear();
+	_rendered.clear();
+	_slots.clear();
+
+	_technique.reset();
+	_material.reset();
+}
+
+void
+OcclusionQueryQueue::setMaxLatency(std::uint32_t frames) noexcept
+{
+	assert(frames > 0);
+	_maxLatency = frames;
+}
+
+std::uint32_t
+OcclusionQueryQueue::getMaxLatency() const noexcept
+{
+	return _maxLatency;
+}
+
+void
+OcclusionQueryQueue::setVisibleQueryInterval(std::uint32_t frames) noexcept
+{
+	assert(frames > 0);
+	_visibleQueryInterval = frames;
+}
+
+std::uint32_t
+OcclusionQueryQueue::getVisibleQueryInterval() const noexcept
+{
+	return _visibleQueryInterval;
+}
+
+void
+OcclusionQueryQueue::setBatchSize(std::uint32_t count) noexcept
+{
+	assert(count > 0);
+	_batchSize = count;
+}
+
+std::uint32_t
+OcclusionQueryQueue::getBatchSize() const noexcept
+{
+	return _batchSize;
+}
+
+void
+OcclusionQueryQueue::setLeafSize(std::uint32_t count) noexcept
+{
+	assert(count > 0);
+
+	if (_leafSize != count)
+	{
+		_leafSize = count;
+		_objects.clear();
+	}
+}
+
+std::uint32_t
+OcclusionQueryQueue::getLeafSize() const noexcept
+{
+	return _leafSize;
+}
+
+void
+OcclusionQueryQueue::traverse(const Camera& camera, OcclusionCullList& list) noexcept
+{
+	auto scene = camera.getRenderScene();
+	if (!scene)
+		return;
+
+	_frame++;
+	_numCulled = 0;
+
+	if (this->updateObjects(*scene))
+		this->buildHierarchy();
+	else
+		this->refitHierarchy();
+
+	this->fetchResults();
+
+	_visibleQueries.clear();
+	_invisibleQueries.clear();
+
+	if (_nodes.empty())
+		return;
+
+	std::fill(_rendered.begin(), _rendered.end(), false);
+
+	Frustum fru(camera.getViewProject());
+
+	auto& eye = camera.getTranslate();
+	auto nearDistance = camera.getNear() * 2.0f;
+
+	typedef std::pair<float, std::uint32_t> TraversalNode;
+	std::priority_queue<TraversalNode, std::vector<TraversalNode>, std::greater<TraversalNode>> traversal;
+	traversal.push(std::make_pair(0.0f, 0u));
+
+	while (!traversal.empty())
+	{
+		auto index = traversal.top().second;
+		traversal.pop();
+
+		auto& node = _nodes[index];
+		if (!fru.contains(node.bound))
+			continue;
+
+		// a box around the camera is clipped by the near plane and would read back as hidden
+		bool inside = math::sqrDistance(node.bound.closestPoint(eye), eye) <= nearDistance * nearDistance;
+		if (inside)
+		{
+			if (!node.visible)
+				this->setSubtreeVisible(index, true);
+		}
+		else if (!node.visible)
+		{
+			if (!node.pending)
+				_invisibleQueries.push_back(index);
+			continue;
+		}
+
+		if (node.leaf)
+		{
+			for (std::uint32_t i = node.first; i < node.first + node.count; i++)
+				_rendered[i] = true;
+
+			if (!inside && !node.pending && _frame >= node.nextQuery)
+				_visibleQueries.push_back(index);
+		}
+		else
+		{
+			auto& left = _nodes[index + 1];
+			auto& right = _nodes[node.right];
+
+			traversal.push(std::make_pair(math::sqrDistance(left.bound.closestPoint(eye), eye), index + 1));
+			traversal.push(std::make_pair(math::sqrDistance(right.bound.closestPoint(eye), eye), node.right));
+		}
+	}
+
+	auto& nodes = list.iter();
+	auto end = std::remove_if(nodes.begin(), nodes.end(), [this](const OcclusionCullNode& it)
+	{
+		auto slot = _slots.find(it.getOcclusionCullNode());
+		if (slot == _slots.end())
+			return false;
+
+		if (_rendered[slot->second])
+			return false;
+
+		_numCulled++;
+		return true;
+	});
+
+	nodes.erase(end, nodes.end());
+}
+
+void
+OcclusionQueryQueue::renderQueries(RenderPipeline& pipeline) noexcept
+{
+	_numQueries = 0;
+	_numBatchedNodes = 0;
+
+	for (auto index : _visibleQueries)
+	{
+		auto query = this->allocQuery();
+		if (!query)
+			break;
+
+		query->queryBegin();
+		this->drawBound(pipeline, _nodes[index].bound);
+		query->queryEnd();
+
+		_nodes[index].pending = true;
+		_pendingQueries.push_back(PendingQuery{ query, { index }, _frame, _build });
+		_numQueries++;
+	}
+
+	// hidden nodes tend to stay hidden, so one query answers for several of them and only a visible batch costs extra
+	for (std::size_t i = 0; i < _invisibleQueries.size(); i += _batchSize)
+	{
+		auto query = this->allocQuery();
+		if (!query)
+			break;
+
+		auto begin = _invisibleQueries.begin() + i;
+		auto end = _invisibleQueries.begin() + std::min(i + _batchSize, _invisibleQueries.size());
+
+		query->queryBegin();
+
+		for (auto it = begin; it != end; ++it)
+		{
+			this->drawBound(pipeline, _nodes[*it].bound);
+			_nodes[*it].pending = true;
+		}
+
+		query->queryEnd();
+
+		_pendingQueries.push_back(PendingQuery{ query, std::vector<std::uint32_t>(begin, end), _frame, _build });
+		_numQueries++;
+
+		if (end - begin > 1)
+			_numBatchedNodes += end - begin;
+	}
+
+	_visibleQueries.clear();
+	_invisibleQueries.clear();
+}
+
+std::size_t
+OcclusionQueryQueue::getNumNodes() const noexcept
+{
+	return _nodes.size();
+}
+
+std::size_t
+OcclusionQueryQueue::getNumQueries() const noexcept
+{
+	return _numQueries;
+}
+
+std::size_t
+OcclusionQueryQueue::getNumBatchedNodes() const noexcept
+{
+	return _numBatchedNodes;
+}
+
+std::size_t
+OcclusionQueryQueue::getNumPendingQueries() const noexcept
+{
+	return _pendingQueries.size();
+}
+
+std::size_t
+OcclusionQueryQueue::getNumCulled() const noexcept
+{
+	return _numCulled;
+}
+
+std::size_t
+OcclusionQueryQueue::getNumStalls() const noexcept
+{
+	return _numStalls;
+}
+
+float
+OcclusionQueryQueue::getAverageLatency() const noexcept
+{
+	return _numResults > 0 ? (float)_totalLatency / _numResults : 0.0f;
+}
+
+bool
+OcclusionQueryQueue::updateObjects(const RenderScene& scene) noexcept
+{
+	RenderObjectRaws objects;
+
+	for (auto& it : scene.getRenderObjectList())
+	{
+		if (!it->getVisible() || !it->isInstanceOf<Geometry>())
+			continue;
+
+		if (it->getBoundingBoxInWorld().empty())
+			continue;
+
+		objects.push_back(it);
+	}
+
+	bool changed = objects.size() != _objects.size();
+
+	for (std::size_t i = 0; i < objects.size() && !changed; i++)
+		changed = _slots.find(objects[i]) == _slots.end();
+
+	if (changed)
+		_objects.swap(objects);
+
+	return changed;
+}
+
+void
+OcclusionQueryQueue::buildHierarchy() noexcept
+{
+	_build++;
+
+	_nodes.clear();
+	_slots.clear();
+	_rendered.assign(_objects.size(), false);
+
+	if (_objects.empty())
+		return;
+
+	this->buildNode(0, static_cast<std::uint32_t>(_objects.size()));
+
+	for (std::size_t i = 0; i < _objects.size(); i++)
+		_slots[_objects[i]] = static_cast<std::uint32_t>(i);
+}
+
+std::uint32_t
+OcclusionQueryQueue::buildNode(std::uint32_t first, std::uint32_t count) noexcept
+{
+	AABB bound;
+	AABB centers;
+
+	for (std::uint32_t i = first; i < first + count; i++)
+	{
+		auto box = _objects[i]->getBoundingBoxInWorld().aabb();
+		bound.encapsulate(box);
+		centers.encapsulate(box.center());
+	}
+
+	Node node;
+	node.bound = bound;
+	node.right = 0;
+	node.next = 0;
+	node.first = first;
+	node.count = count;
+	node.nextQuery = _frame + this->random() % _visibleQueryInterval;
+	node.leaf = count <= _leafSize;
+	node.visible = true;
+	node.pending = false;
+
+	auto index = static_cast<std::uint32_t>(_nodes.size());
+	_nodes.push_back(node);
+
+	if (!node.leaf)
+	{
+		auto size = centers.size();
+
+		std::uint8_t axis = 0;
+		if (size.y > size[axis]) axis = 1;
+		if (size.z > size[axis]) axis = 2;
+
+		auto begin = _objects.begin() + first;
+		auto middle = begin + count / 2;
+
+		std::nth_element(begin, middle, begin + count, [axis](RenderObject* a, RenderObject* b)
+		{
+			return a->getBoundingBoxInWorld().aabb().center()[axis] < b->getBoundingBoxInWorld().aabb().center()[axis];
+		});
+
+		this->buildNode(first, count / 2);
+		_nodes[index].right = this->buildNode(first + count / 2, count - count / 2);
+	}
+
+	_nodes[index].next = static_cast<std::uint32_t>(_nodes.size());
+	return index;
+}
+
+void
+OcclusionQueryQueue::refitHierarchy() noexcept
+{
+	for (auto i = _nodes.size(); i > 0; i--)
+	{
+		auto& node = _nodes[i - 1];
+		node.bound.reset();
+
+		if (node.leaf)
+		{
+			for (std::uint32_t j = node.first; j < node.first + node.count; j++)
+				node.bound.encapsulate(_objects[j]->getBoundingBoxInWorld().aabb());
+		}
+		else
+		{
+			node.bound.encapsulate(_nodes[i].bound);
+			node.bound.encapsulate(_nodes[node.right].bound);
+		}
+	}
+}
+
+void
+OcclusionQueryQueue::fetchResults() noexcept
+{
+	bool changed = false;
+
+	while (!_pendingQueries.empty())
+	{
+		auto& pending = _pendingQueries.front();
+
+		if (!pending.query->isAvailable())
+		{
+			// only a result that has fallen too far behind is worth waiting for
+			if (_frame - pending.frame < _maxLatency)
+				break;
+
+			_numStalls++;
+		}
+
+		bool visible = pending.query->getResult() > 0;
+
+		if (pending.build == _build)
+		{
+			for (auto index : pending.nodes)
+			{
+				this->setSubtreeVisible(index, visible);
+
+				auto& node = _nodes[index];
+				node.pending = false;
+
+				// spread the next queries of visible nodes so they do not all come due on the same frame
+				if (visible && node.leaf)
+					node.nextQuery = _frame + _visibleQueryInterval + this->random() % _visibleQueryInterval;
+			}
+
+			changed = true;
+		}
+
+		_numResults++;
+		_totalLatency += _frame - pending.frame;
+
+		_freeQueries.push_back(pending.query);
+		_pendingQueries.pop_front();
+	}
+
+	if (changed)
+		this->pullUpVisibility();
+}
+
+void
+OcclusionQueryQueue::setSubtreeVisible(std::uint32_t index, bool visible) noexcept
+{
+	for (std::uint32_t i = index; i < _nodes[index].next; i++)
+	{
+		auto& node = _nodes[i];
+
+		// leaves under a node that just came into view are queried on their own next frame to find the hidden ones
+		if (visible && !node.visible && node.leaf)
+			node.nextQuery = _frame + 1;
+
+		node.visible = visible;
+	}
+}
+
+void
+OcclusionQueryQueue::pullUpVisibility() noexcept
+{
+	for (auto i = _nodes.size(); i > 0; i--)
+	{
+		auto& node = _nodes[i - 1];
+		if (!node.leaf)
+			node.visible = _nodes[i].visible || _nodes[node.right].visible;
+	}
+}
+
+GraphicsQueryPtr
+OcclusionQueryQueue::allocQuery() noexcept
+{
+	if (!_freeQueries.empty())
+	{
+		auto query = _freeQueries.back();
+		_freeQueries.pop_back();
+		return query;
+	}
+
+	return RenderSystem::instance()->createQuery(GraphicsQueryDesc(GraphicsQueryType::GraphicsQueryTypeAnySamplesPassed));
+}
+
+void
+OcclusionQueryQueue::drawBound(RenderPipeline& pipeline, const AABB& bound) noexcept
+{
+	// grown a little so the faces of a box do not fight with geometry lying on them
+	float4x4 transform;
+	transform.makeTranslate(bound.center());
+	transform.scale(bound.extents() * 1.01f);
+
+	pipeline.setTransform(transform);
+	pipeline.drawCube(*_technique);
+}
+
+std::uint32_t
+OcclusionQueryQueue::random() noexcept
+{
+	_seed = _seed * 1664525u + 1013904223u;
+	return _seed >> 8;
+}
+
+_NAME_END
\ No newline at end of file
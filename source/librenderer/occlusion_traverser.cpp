@@ -35,34 +35,682 @@
 // | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // +----------------------------------------------------------------------
 #include <ray/occlusion_traverser.h>
+#include <ray/render_object.h>
+#include <ray/render_system.h>
+#include <ray/geometry.h>
+#include <ray/camera.h>
+#include <ray/graphics_texture.h>
+
+#include <chrono>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#	include <emmintrin.h>
+#endif
 
 _NAME_BEGIN
 
-void 
-OcclusionTraverser::traverse() noexcept
+namespace
+{
+	const std::uint32_t tileWidth = 32;
+	const std::uint32_t tileHeight = 32;
+
+	// triangles and boxes that reach behind this w are left alone instead of being clipped
+	const float nearClipW = 1e-4f;
+}
+
+Occluder::Occluder() noexcept
+{
+}
+
+Occluder::Occluder(const Float3Array& vertices, const UintArray& indices) noexcept
+	: _vertices(vertices)
+	, _indices(indices)
+{
+	assert(_indices.size() % 3 == 0);
+}
+
+Occluder::~Occluder() noexcept
+{
+}
+
+void
+Occluder::setVertices(const Float3Array& vertices) noexcept
+{
+	_vertices = vertices;
+}
+
+const Float3Array&
+Occluder::getVertices() const noexcept
+{
+	return _vertices;
+}
+
+void
+Occluder::setIndices(const UintArray& indices) noexcept
+{
+	assert(indices.size() % 3 == 0);
+	_indices = indices;
+}
+
+const UintArray&
+Occluder::getIndices() const noexcept
+{
+	return _indices;
+}
+
+OccluderPtr
+Occluder::makeBox(const AABB& box) noexcept
+{
+	Float3Array vertices;
+	for (std::uint8_t i = 0; i < 8; i++)
+		vertices.push_back(float3(i & 1 ? box.max.x : box.min.x, i & 2 ? box.max.y : box.min.y, i & 4 ? box.max.z : box.min.z));
+
+	UintArray indices =
+	{
+		0, 2, 1, 1, 2, 3,
+		4, 5, 6, 5, 7, 6,
+		0, 1, 4, 1, 5, 4,
+		2, 6, 3, 3, 6, 7,
+		0, 4, 2, 2, 4, 6,
+		1, 3, 5, 3, 7, 5
+	};
+
+	return std::make_shared<Occluder>(vertices, indices);
+}
+
+OcclusionTraverser::OcclusionTraverser() noexcept
+	: _width(0)
+	, _height(0)
+	, _tilesX(0)
+	, _tilesY(0)
+	, _maxOccluders(32)
+	, _occluderMinSize(0.05f)
+	, _debugEnable(false)
+	, _viewProject(float4x4::One)
+	, _numTested(0)
+	, _numCulled(0)
+	, _rasterTime(0)
+	, _testTime(0)
+	, _quit(false)
+	, _generation(0)
+	, _numBusy(0)
+	, _nextTile(0)
+{
+}
+
+OcclusionTraverser::~OcclusionTraverser() noexcept
+{
+	this->close();
+}
+
+bool
+OcclusionTraverser::setup(std::uint32_t width, std::uint32_t height, std::uint32_t numThreads) noexcept
+{
+	assert(_threads.empty());
+	assert(width > 0 && width % tileWidth == 0);
+	assert(height > 0 && height % tileHeight == 0);
+
+	_width = width;
+	_height = height;
+	_tilesX = width / tileWidth;
+	_tilesY = height / tileHeight;
+
+	_depth.assign(width * height, 1.0f);
+	_bins.resize(_tilesX * _tilesY);
+
+	_pyramid.clear();
+
+	for (std::uint32_t w = width / 2, h = height / 2; w > 0 && h > 0; w /= 2, h /= 2)
+		_pyramid.push_back(std::vector<float>(w * h, 1.0f));
+
+	// the calling thread rasterizes tiles as well, so a few helpers are plenty for a buffer this small
+	if (numThreads == 0)
+		numThreads = std::min(std::max(std::thread::hardware_concurrency(), 2u) - 1, 3u);
+
+	for (std::uint32_t i = 0; i < numThreads; i++)
+		_threads.push_back(std::make_unique<std::thread>(std::bind(&OcclusionTraverser::dispose, this)));
+
+	return true;
+}
+
+void
+OcclusionTraverser::close() noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+
+	_dispatch.notify_all();
+
+	for (auto& it : _threads)
+		it->join();
+
+	_threads.clear();
+	_quit = false;
+
+	_depth.clear();
+	_pyramid.clear();
+	_bins.clear();
+	_triangles.clear();
+	_occluders.clear();
+
+	_debugTexture.reset();
+}
+
+void
+OcclusionTraverser::setMaxOccluders(std::uint32_t count) noexcept
+{
+	_maxOccluders = count;
+}
+
+std::uint32_t
+OcclusionTraverser::getMaxOccluders() const noexcept
+{
+	return _maxOccluders;
+}
+
+void
+OcclusionTraverser::setOccluderMinSize(float size) noexcept
+{
+	_occluderMinSize = size;
+}
+
+float
+OcclusionTraverser::getOccluderMinSize() const noexcept
+{
+	return _occluderMinSize;
+}
+
+void
+OcclusionTraverser::setDebugEnable(bool enable) noexcept
+{
+	_debugEnable = enable;
+
+	if (!enable)
+		_debugTexture.reset();
+}
+
+bool
+OcclusionTraverser::getDebugEnable() const noexcept
+{
+	return _debugEnable;
+}
+
+void
+OcclusionTraverser::traverse(const Camera& camera, OcclusionCullList& list) noexcept
+{
+	if (_depth.empty())
+		return;
+
+	auto begin = std::chrono::high_resolution_clock::now();
+
+	_viewProject = camera.getViewProject();
+
+	this->selectOccluders(camera, list);
+	this->setupTriangles(_viewProject);
+	this->rasterize();
+	this->buildPyramid();
+
+	auto middle = std::chrono::high_resolution_clock::now();
+
+	_numTested = 0;
+	_numCulled = 0;
+
+	auto& nodes = list.iter();
+	auto end = std::remove_if(nodes.begin(), nodes.end(), [this](const OcclusionCullNode& node)
+	{
+		// only plain geometry is culled, lights and custom objects may use their bounds for other things
+		auto object = node.getOcclusionCullNode();
+		if (!object->isInstanceOf<Geometry>())
+			return false;
+
+		if (std::find(_occluders.begin(), _occluders.end(), object) != _occluders.end())
+			return false;
+
+		auto& bound = object->getBoundingBoxInWorld();
+		if (bound.empty())
+			return false;
+
+		_numTested++;
+
+		if (this->traverseObject(bound.aabb()))
+			return false;
+
+		_numCulled++;
+		return true;
+	});
+
+	nodes.erase(end, nodes.end());
+
+	if (_debugEnable)
+		this->updateDebugTexture();
+
+	auto finish = std::chrono::high_resolution_clock::now();
+
+	_rasterTime = std::chrono::duration<float, std::milli>(middle - begin).count();
+	_testTime = std::chrono::duration<float, std::milli>(finish - middle).count();
+}
+
+bool
+OcclusionTraverser::traverseObject(const AABB& bound) const noexcept
+{
+	if (_depth.empty())
+		return true;
+
+	float minX = std::numeric_limits<float>::max();
+	float minY = std::numeric_limits<float>::max();
+	float maxX = -std::numeric_limits<float>::max();
+	float maxY = -std::numeric_limits<float>::max();
+	float minZ = std::numeric_limits<float>::max();
+
+	for (std::uint8_t i = 0; i < 8; i++)
+	{
+		float3 corner(i & 1 ? bound.max.x : bound.min.x, i & 2 ? bound.max.y : bound.min.y, i & 4 ? bound.max.z : bound.min.z);
+		float4 clip = _viewProject * float4(corner, 1.0f);
+
+		if (clip.w <= nearClipW)
+			return true;
+
+		float x = (clip.x / clip.w * 0.5f + 0.5f) * _width;
+		float y = (clip.y / clip.w * 0.5f + 0.5f) * _height;
+
+		minX = std::min(minX, x);
+		minY = std::min(minY, y);
+		maxX = std::max(maxX, x);
+		maxY = std::max(maxY, y);
+		minZ = std::min(minZ, clip.z / clip.w);
+	}
+
+	std::int32_t x0 = std::max(0, (std::int32_t)std::floor(minX));
+	std::int32_t y0 = std::max(0, (std::int32_t)std::floor(minY));
+	std::int32_t x1 = std::min((std::int32_t)_width - 1, (std::int32_t)std::floor(maxX));
+	std::int32_t y1 = std::min((std::int32_t)_height - 1, (std::int32_t)std::floor(maxY));
+
+	if (x0 > x1 || y0 > y1)
+		return true;
+
+	// go up the pyramid until the rectangle spans a handful of texels
+	std::size_t level = 0;
+	while (level < _pyramid.size() && ((x1 >> level) - (x0 >> level) >= 4 || (y1 >> level) - (y0 >> level) >= 4))
+		level++;
+
+	const float* depth = level > 0 ? _pyramid[level - 1].data() : _depth.data();
+	std::uint32_t width = _width >> level;
+
+	for (std::int32_t y = y0 >> level; y <= y1 >> level; y++)
+	{
+		for (std::int32_t x = x0 >> level; x <= x1 >> level; x++)
+		{
+			if (depth[y * width + x] >= minZ)
+				return true;
+		}
+	}
+
+	return false;
+}
+
+std::uint32_t
+OcclusionTraverser::getWidth() const noexcept
+{
+	return _width;
+}
+
+std::uint32_t
+OcclusionTraverser::getHeight() const noexcept
+{
+	return _height;
+}
+
+const std::vector<float>&
+OcclusionTraverser::getDepthMap() const noexcept
+{
+	return _depth;
+}
+
+const GraphicsTexturePtr&
+OcclusionTraverser::getDebugTexture() const noexcept
 {
+	return _debugTexture;
+}
 
+std::size_t
+OcclusionTraverser::getNumOccluders() const noexcept
+{
+	return _occluders.size();
 }
 
-void 
-OcclusionTraverser::traverseObject(OcclusionObjectPtr object) noexcept
+std::size_t
+OcclusionTraverser::getNumTriangles() const noexcept
 {
-    if (object->isVirtualLeaf())
-    {
+	return _triangles.size();
+}
 
-    }
-    else
-    {
+std::size_t
+OcclusionTraverser::getNumTested() const noexcept
+{
+	return _numTested;
+}
 
-    }
+std::size_t
+OcclusionTraverser::getNumCulled() const noexcept
+{
+	return _numCulled;
+}
+
+float
+OcclusionTraverser::getRasterTime() const noexcept
+{
+	return _rasterTime;
 }
 
-void 
-OcclusionTraverser::update() noexcept
+float
+OcclusionTraverser::getTestTime() const noexcept
 {
+	return _testTime;
+}
+
+void
+OcclusionTraverser::selectOccluders(const Camera& camera, const OcclusionCullList& list) noexcept
+{
+	std::vector<std::pair<float, RenderObject*>> candidates;
+
+	for (auto& it : list.iter())
+	{
+		auto object = it.getOcclusionCullNode();
+		if (!object->getOccluder())
+			continue;
+
+		// the squared ratio of radius to distance stands in for the area the occluder covers on screen
+		auto& sphere = object->getBoundingBoxInWorld().sphere();
+		float distance = std::max(math::sqrDistance(sphere.center(), camera.getTranslate()), 1e-4f);
+		float size = sphere.radius() * sphere.radius() / distance;
+
+		if (size >= _occluderMinSize * _occluderMinSize)
+			candidates.push_back(std::make_pair(size, object));
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const std::pair<float, RenderObject*>& a, const std::pair<float, RenderObject*>& b)
+	{
+		return a.first > b.first;
+	});
+
+	_occluders.clear();
+
+	for (std::size_t i = 0; i < candidates.size() && i < _maxOccluders; i++)
+		_occluders.push_back(candidates[i].second);
+}
+
+void
+OcclusionTraverser::setupTriangles(const float4x4& viewProject) noexcept
+{
+	_triangles.clear();
+
+	for (auto& it : _bins)
+		it.clear();
+
+	std::vector<float3> screen;
+
+	for (auto& object : _occluders)
+	{
+		auto& occluder = object->getOccluder();
+		auto& vertices = occluder->getVertices();
+		auto& indices = occluder->getIndices();
+
+		auto transform = viewProject * object->getTransform();
+
+		// w <= 0 is marked with an infinite depth so triangles touching it can be skipped below
+		screen.resize(vertices.size());
+
+		for (std::size_t i = 0; i < vertices.size(); i++)
+		{
+			float4 clip = transform * float4(vertices[i], 1.0f);
+			if (clip.w > nearClipW)
+				screen[i] = float3((clip.x / clip.w * 0.5f + 0.5f) * _width, (clip.y / clip.w * 0.5f + 0.5f) * _height, clip.z / clip.w);
+			else
+				screen[i] = float3(0.0f, 0.0f, std::numeric_limits<float>::infinity());
+		}
+
+		for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			float3 a = screen[indices[i]];
+			float3 b = screen[indices[i + 1]];
+			float3 c = screen[indices[i + 2]];
+
+			if (std::isinf(a.z) || std::isinf(b.z) || std::isinf(c.z))
+				continue;
+
+			float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+			if (std::abs(area) < 1e-6f)
+				continue;
+
+			// occluders are drawn from both sides, so flip the winding instead of culling back faces
+			if (area < 0.0f)
+			{
+				std::swap(b, c);
+				area = -area;
+			}
+
+			Triangle triangle;
+			triangle.bounds[0] = std::max(0, (std::int32_t)std::floor(std::min(std::min(a.x, b.x), c.x)));
+			triangle.bounds[1] = std::min((std::int32_t)_width - 1, (std::int32_t)std::ceil(std::max(std::max(a.x, b.x), c.x)));
+			triangle.bounds[2] = std::max(0, (std::int32_t)std::floor(std::min(std::min(a.y, b.y), c.y)));
+			triangle.bounds[3] = std::min((std::int32_t)_height - 1, (std::int32_t)std::ceil(std::max(std::max(a.y, b.y), c.y)));
+
+			if (triangle.bounds[0] > triangle.bounds[1] || triangle.bounds[2] > triangle.bounds[3])
+				continue;
+
+			const float3* edges[3][2] = { { &a, &b }, { &b, &c }, { &c, &a } };
+
+			for (std::uint8_t j = 0; j < 3; j++)
+			{
+				auto& v0 = *edges[j][0];
+				auto& v1 = *edges[j][1];
+
+				triangle.edge[j][0] = v0.y - v1.y;
+				triangle.edge[j][1] = v1.x - v0.x;
+				triangle.edge[j][2] = (v1.y - v0.y) * v0.x - (v1.x - v0.x) * v0.y;
+			}
+
+			float dzdx = ((b.z - a.z) * (c.y - a.y) - (b.y - a.y) * (c.z - a.z)) / area;
+			float dzdy = ((b.x - a.x) * (c.z - a.z) - (b.z - a.z) * (c.x - a.x)) / area;
+
+			triangle.depth[0] = dzdx;
+			triangle.depth[1] = dzdy;
+			triangle.depth[2] = a.z - dzdx * a.x - dzdy * a.y;
+
+			auto index = static_cast<std::uint32_t>(_triangles.size());
+			_triangles.push_back(triangle);
+
+			for (std::uint32_t ty = triangle.bounds[2] / tileHeight; ty <= triangle.bounds[3] / tileHeight; ty++)
+			{
+				for (std::uint32_t tx = triangle.bounds[0] / tileWidth; tx <= triangle.bounds[1] / tileWidth; tx++)
+					_bins[ty * _tilesX + tx].push_back(index);
+			}
+		}
+	}
+}
+
+void
+OcclusionTraverser::rasterize() noexcept
+{
+	std::fill(_depth.begin(), _depth.end(), 1.0f);
+
+	if (_triangles.empty())
+		return;
+
+	if (_threads.empty())
+	{
+		for (std::uint32_t i = 0; i < _tilesX * _tilesY; i++)
+			this->rasterizeTile(i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_nextTile = 0;
+		_numBusy = static_cast<std::uint32_t>(_threads.size());
+		_generation++;
+	}
+
+	_dispatch.notify_all();
+
+	this->rasterizeTiles();
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_finish.wait(lock, [this]() { return _numBusy == 0; });
+}
+
+void
+OcclusionTraverser::rasterizeTiles() noexcept
+{
+	for (;;)
+	{
+		std::uint32_t tile = _nextTile++;
+		if (tile >= _tilesX * _tilesY)
+			break;
+
+		this->rasterizeTile(tile);
+	}
+}
+
+void
+OcclusionTraverser::rasterizeTile(std::uint32_t tile) noexcept
+{
+	std::int32_t tileX0 = (tile % _tilesX) * tileWidth;
+	std::int32_t tileY0 = (tile / _tilesX) * tileHeight;
+	std::int32_t tileX1 = tileX0 + tileWidth - 1;
+	std::int32_t tileY1 = tileY0 + tileHeight - 1;
+
+	for (auto index : _bins[tile])
+	{
+		auto& triangle = _triangles[index];
+
+		// rows are walked four pixels at a time, tiles are a multiple of four wide so no group crosses into a neighbour
+		std::int32_t x0 = std::max(triangle.bounds[0], tileX0) & ~3;
+		std::int32_t x1 = std::min(triangle.bounds[1], tileX1);
+		std::int32_t y0 = std::max(triangle.bounds[2], tileY0);
+		std::int32_t y1 = std::min(triangle.bounds[3], tileY1);
+
+		for (std::int32_t y = y0; y <= y1; y++)
+		{
+			float py = y + 0.5f;
+			float* row = &_depth[y * _width];
+
+#if defined(__SSE2__) || defined(_M_X64)
+			__m128 offset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+			__m128 zero = _mm_setzero_ps();
+
+			__m128 a0 = _mm_set1_ps(triangle.edge[0][0]);
+			__m128 a1 = _mm_set1_ps(triangle.edge[1][0]);
+			__m128 a2 = _mm_set1_ps(triangle.edge[2][0]);
+			__m128 az = _mm_set1_ps(triangle.depth[0]);
+
+			__m128 r0 = _mm_set1_ps(triangle.edge[0][1] * py + triangle.edge[0][2]);
+			__m128 r1 = _mm_set1_ps(triangle.edge[1][1] * py + triangle.edge[1][2]);
+			__m128 r2 = _mm_set1_ps(triangle.edge[2][1] * py + triangle.edge[2][2]);
+			__m128 rz = _mm_set1_ps(triangle.depth[1] * py + triangle.depth[2]);
+
+			for (std::int32_t x = x0; x <= x1; x += 4)
+			{
+				__m128 px = _mm_add_ps(_mm_set1_ps((float)x), offset);
+
+				__m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), r0);
+				__m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), r1);
+				__m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), r2);
+
+				__m128 mask = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+				if (_mm_movemask_ps(mask) == 0)
+					continue;
+
+				__m128 depth = _mm_add_ps(_mm_mul_ps(az, px), rz);
+				__m128 old = _mm_loadu_ps(row + x);
+				__m128 nearest = _mm_min_ps(old, depth);
+
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(mask, nearest), _mm_andnot_ps(mask, old)));
+			}
+#else
+			for (std::int32_t x = x0; x <= x1; x++)
+			{
+				float px = x + 0.5f;
+
+				float e0 = triangle.edge[0][0] * px + triangle.edge[0][1] * py + triangle.edge[0][2];
+				float e1 = triangle.edge[1][0] * px + triangle.edge[1][1] * py + triangle.edge[1][2];
+				float e2 = triangle.edge[2][0] * px + triangle.edge[2][1] * py + triangle.edge[2][2];
+
+				if (e0 < 0.0f || e1 < 0.0f || e2 < 0.0f)
+					continue;
+
+				float depth = triangle.depth[0] * px + triangle.depth[1] * py + triangle.depth[2];
+				row[x] = std::min(row[x], depth);
+			}
+#endif
+		}
+	}
+}
+
+void
+OcclusionTraverser::buildPyramid() noexcept
+{
+	const float* source = _depth.data();
+	std::uint32_t width = _width;
+
+	// every level keeps the farthest depth of the four texels below it
+	for (auto& level : _pyramid)
+	{
+		std::uint32_t w = width / 2;
+		std::uint32_t h = static_cast<std::uint32_t>(level.size()) / w;
+
+		for (std::uint32_t y = 0; y < h; y++)
+		{
+			for (std::uint32_t x = 0; x < w; x++)
+			{
+				const float* texel = source + (y * 2) * width + x * 2;
+				level[y * w + x] = std::max(std::max(texel[0], texel[1]), std::max(texel[width], texel[width + 1]));
+			}
+		}
+
+		source = level.data();
+		width = w;
+	}
+}
+
+void
+OcclusionTraverser::updateDebugTexture() noexcept
+{
+	if (!_debugTexture)
+	{
+		_debugTexture = RenderSystem::instance()->createTexture(_width, _height, GraphicsTextureDim::GraphicsTextureDim2D, GraphicsFormat::GraphicsFormatR32SFloat, GraphicsSamplerFilter::GraphicsSamplerFilterNearest);
+		if (!_debugTexture)
+			return;
+	}
+
+	_debugTexture->update(0, 0, _width, _height, 0, _depth.data());
+}
+
+void
+OcclusionTraverser::dispose() noexcept
+{
+	std::uint32_t generation = 0;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_dispatch.wait(lock, [&]() { return _quit || _generation != generation; });
+
+			if (_quit)
+				break;
+
+			generation = _generation;
+		}
 
+		this->rasterizeTiles();
 
-    this->traverse();
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (--_numBusy == 0)
+			_finish.notify_one();
+	}
 }
 
 _NAME_END
\ No newline at end of file
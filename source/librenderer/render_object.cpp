@@ -108,6 +108,18 @@ RenderObject::getBoundingBoxInWorld() const noexcept
 	return _worldBoundingxBox;
 }
 
+void
+RenderObject::setOccluder(const OccluderPtr& occluder) noexcept
+{
+	_occluder = occluder;
+}
+
+const OccluderPtr&
+RenderObject::getOccluder() const noexcept
+{
+	return _occluder;
+}
+
 void
 RenderObject::setOwnerListener(RenderListener* listener) noexcept
 {
@@ -39,6 +39,7 @@
 #include <ray/light.h>
 #include <ray/geometry.h>
 #include <ray/material.h>
+#include <ray/occlusion_query_queue.h>
 
 _NAME_BEGIN
 
@@ -82,6 +83,9 @@ DefaultRenderDataManager::assginVisiable(const Camera& camera) noexcept
 		assert(scene);
 		scene->computVisiable(camera, _visiable);
 
+		if (_occlusionQueryQueue && cameraOrder == CameraOrder::CameraOrder3D)
+			_occlusionQueryQueue->traverse(camera, _visiable);
+
 		this->sortDistance(_visiable);
 
 		for (auto& it : _visiable.iter())
@@ -92,6 +96,36 @@ DefaultRenderDataManager::assginVisiable(const Camera& camera) noexcept
 	}
 }
 
+void
+DefaultRenderDataManager::setOcclusionQueryEnable(bool enable) noexcept
+{
+	if (enable)
+	{
+		if (_occlusionQueryQueue)
+			return;
+
+		auto queue = std::make_shared<OcclusionQueryQueue>();
+		if (queue->setup())
+			_occlusionQueryQueue = queue;
+	}
+	else
+	{
+		_occlusionQueryQueue.reset();
+	}
+}
+
+bool
+DefaultRenderDataManager::getOcclusionQueryEnable() const noexcept
+{
+	return _occlusionQueryQueue ? true : false;
+}
+
+const OcclusionQueryQueuePtr&
+DefaultRenderDataManager::getOcclusionQueryQueue() const noexcept
+{
+	return _occlusionQueryQueue;
+}
+
 void
 DefaultRenderDataManager::sortMaterial(RenderObjectRaws& list) noexcept
 {
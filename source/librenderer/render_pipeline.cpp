@@ -70,11 +70,13 @@ RenderPipeline::RenderPipeline() noexcept
 	, _dpi_h(0)
 	, _planeIndices(0)
 	, _sphereIndices(0)
+	, _cubeIndices(0)
 	, _coneIndices(0)
 	, _camera(0)
 	, _planeIndexType(GraphicsIndexType::GraphicsIndexTypeUInt16)
 	, _coneIndexType(GraphicsIndexType::GraphicsIndexTypeUInt16)
 	, _sphereIndexType(GraphicsIndexType::GraphicsIndexTypeUInt16)
+	, _cubeIndexType(GraphicsIndexType::GraphicsIndexTypeUInt16)
 {
 }
 
@@ -367,6 +369,22 @@ RenderPipeline::drawSphere(const MaterialTech& tech, std::uint32_t layer) noexce
 	}
 }
 
+void
+RenderPipeline::drawCube(const MaterialTech& tech, std::uint32_t layer) noexcept
+{
+	this->setVertexBuffer(0, _cubeVbo, 0);
+	this->setIndexBuffer(_cubeIbo, 0, _cubeIndexType);
+
+	auto& passList = tech.getPassList();
+	for (auto& pass : passList)
+	{
+		pass->update(*_semanticsManager);
+
+		this->setMaterialPass(pass);
+		this->drawIndexedLayer(_cubeIndices, 1, 0, 0, 0, layer);
+	}
+}
+
 void
 RenderPipeline::drawCone(const MaterialTech& tech, std::uint32_t layer) noexcept
 {
@@ -548,6 +566,13 @@ RenderPipeline::createGraphicsData(const GraphicsDataDesc& desc) noexcept
 	return _pipelineDevice->createGraphicsData(desc);
 }
 
+GraphicsQueryPtr
+RenderPipeline::createQuery(const GraphicsQueryDesc& desc) noexcept
+{
+	assert(_pipelineDevice);
+	return _pipelineDevice->createQuery(desc);
+}
+
 GraphicsInputLayoutPtr
 RenderPipeline::createInputLayout(const GraphicsInputLayoutDesc& desc) noexcept
 {
@@ -634,6 +659,7 @@ RenderPipeline::setupBaseMeshes() noexcept
 {
 	this->makePlane(2, 2, 1, 1);
 	this->makeSphere(1, 24, 18);
+	this->makeCube(2);
 	this->makeCone(1, 1, 16);
 
 	return true;
@@ -716,6 +742,44 @@ RenderPipeline::makePlane(float width, float height, std::uint32_t widthSegments
 	_planeIndexType = GraphicsIndexType::GraphicsIndexTypeUInt16;
 }
 
+void
+RenderPipeline::makeCube(float size) noexcept
+{
+	float half = size * 0.5f;
+
+	std::vector<float3> _vertices;
+	for (std::uint8_t i = 0; i < 8; i++)
+		_vertices.emplace_back(i & 1 ? half : -half, i & 2 ? half : -half, i & 4 ? half : -half);
+
+	std::vector<std::uint16_t> _indices =
+	{
+		0, 2, 1, 1, 2, 3,
+		4, 5, 6, 5, 7, 6,
+		0, 1, 4, 1, 5, 4,
+		2, 6, 3, 3, 6, 7,
+		0, 4, 2, 2, 4, 6,
+		1, 3, 5, 3, 7, 5
+	};
+
+	GraphicsDataDesc _vb;
+	_vb.setType(GraphicsDataType::GraphicsDataTypeStorageVertexBuffer);
+	_vb.setUsage(GraphicsUsageFlagBits::GraphicsUsageFlagReadBit);
+	_vb.setStream((std::uint8_t*)_vertices.data());
+	_vb.setStreamSize(_vertices.size() * sizeof(float3));
+
+	_cubeVbo = this->createGraphicsData(_vb);
+
+	GraphicsDataDesc _ib;
+	_ib.setType(GraphicsDataType::GraphicsDataTypeStorageIndexBuffer);
+	_ib.setUsage(GraphicsUsageFlagBits::GraphicsUsageFlagReadBit);
+	_ib.setStream((std::uint8_t*)_indices.data());
+	_ib.setStreamSize(_indices.size() * sizeof(std::uint16_t));
+
+	_cubeIbo = this->createGraphicsData(_ib);
+	_cubeIndices = static_cast<std::uint16_t>(_indices.size());
+	_cubeIndexType = GraphicsIndexType::GraphicsIndexTypeUInt16;
+}
+
 void
 RenderPipeline::makeSphere(float radius, std::uint32_t widthSegments, std::uint32_t heightSegments, float phiStart, float phiLength, float thetaStart, float thetaLength) noexcept
 {
@@ -895,9 +959,11 @@ RenderPipeline::destroyBaseMeshes() noexcept
 {
 	_planeVbo.reset();
 	_sphereVbo.reset();
+	_cubeVbo.reset();
 	_coneVbo.reset();
 	_planeIbo.reset();
 	_sphereIbo.reset();
+	_cubeIbo.reset();
 	_coneIbo.reset();
 }
 
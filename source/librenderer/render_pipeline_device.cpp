@@ -44,6 +44,8 @@
 #include <ray/graphics_device.h>
 #include <ray/graphics_texture.h>
 
+#include <ray/ioserver.h>
+
 _NAME_BEGIN
 
 __ImplementSubClass(RenderPipelineDevice, rtti::Interface, "RenderPipelineDevice")
@@ -70,6 +72,11 @@ RenderPipelineDevice::open(GraphicsDeviceType type) noexcept
 
 	GraphicsDeviceDesc deviceDesc;
 	deviceDesc.setDeviceType(type);
+
+	util::string shaderCachePath;
+	if (IoServer::instance()->getResolveAssign(util::string("bin:shader.cache"), shaderCachePath))
+		deviceDesc.setShaderCachePath(shaderCachePath);
+
 	_graphicsDevice = GraphicsSystem::instance()->createDevice(deviceDesc);
 	if (!_graphicsDevice)
 		return false;
@@ -110,6 +117,13 @@ RenderPipelineDevice::createMaterial(const std::string& name) noexcept
 	return _materialManager->createMaterial(name);
 }
 
+bool
+RenderPipelineDevice::createMaterials(const std::vector<std::string>& names, Materials& materials) noexcept
+{
+	assert(_materialManager);
+	return _materialManager->createMaterials(names, materials);
+}
+
 void
 RenderPipelineDevice::destroyMaterial(MaterialPtr material) noexcept
 {
@@ -187,4 +201,18 @@ RenderPipelineDevice::createGraphicsData(const GraphicsDataDesc& desc) noexcept
 	return _graphicsDevice->createGraphicsData(desc);
 }
 
+GraphicsTransientBufferPtr
+RenderPipelineDevice::createTransientBuffer(const GraphicsTransientBufferDesc& desc) noexcept
+{
+	assert(_graphicsDevice);
+	return _graphicsDevice->createTransientBuffer(desc);
+}
+
+GraphicsQueryPtr
+RenderPipelineDevice::createQuery(const GraphicsQueryDesc& desc) noexcept
+{
+	assert(_graphicsDevice);
+	return _graphicsDevice->createQuery(desc);
+}
+
 _NAME_END
\ No newline at end of file
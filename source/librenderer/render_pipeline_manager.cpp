@@ -42,6 +42,8 @@
 #include <ray/deferred_lighting_framebuffers.h>
 #include <ray/except.h>
 
+#include <iostream>
+
 #include "deferred_lighting_pipeline.h"
 #include "forward_render_pipeline.h"
 #include "shadow_render_pipeline.h"
@@ -98,6 +100,39 @@ RenderPipelineManager::setup(const RenderSetting& setting) except
 	if (!_pipeline)
 		throw failure("Failed to create the pipeline");
 
+	// parse the effects the setting is going to need in parallel, the stages below then only clone them,
+	// the names must match the ones the stages load or the warm-up is lost
+	std::vector<std::string> effects;
+	if (setting.pipelineType == RenderPipelineType::RenderPipelineTypeDeferredLighting)
+		effects.push_back("sys:fx/deferred_lighting.fxml");
+
+	if (setting.shadowQuality != ShadowQuality::ShadowQualityNone)
+		effects.push_back("sys:fx/shadowmap.fxml");
+	if (setting.enableAtmospheric)
+		effects.push_back("sys:fx/atmospheric.fxml");
+	if (setting.enableSSDO)
+		effects.push_back("sys:fx/PostProcessOcclusion.fxml");
+	if (setting.enableSSSS)
+		effects.push_back("sys:fx/ssss.fxml");
+	if (setting.enableSSR)
+		effects.push_back("sys:fx/ssr.fxml");
+	if (setting.enableHDR)
+		effects.push_back("sys:fx/PostProcessHDR.fxml");
+	if (setting.enableFXAA)
+		effects.push_back("sys:fx/fxaa.fxml");
+	if (setting.enableColorGrading)
+		effects.push_back("sys:fx/color_grading.fxml");
+
+	Materials materials;
+	if (!_pipelineDevice->createMaterials(effects, materials))
+	{
+		for (std::size_t i = 0; i < effects.size(); i++)
+		{
+			if (!materials[i])
+				std::cout << "Failed to preload the effect: " << effects[i] << std::endl;
+		}
+	}
+
 	auto forwardShading = std::make_shared<ForwardRenderPipeline>();
 	if (!forwardShading->setup(_pipeline))
 		throw failure("Failed to create the ForwardRenderPipeline");
@@ -411,6 +446,7 @@ RenderPipelineManager::setupShadowRenderer(RenderPipelinePtr pipeline, const Ren
 	auto shadowMapGen = std::make_shared<ShadowRenderPipeline>();
 	shadowMapGen->setShadowMode(setting.shadowMode);
 	shadowMapGen->setShadowQuality(setting.shadowQuality);
+	shadowMapGen->setShadowCacheBudget(setting.shadowCacheBudget);
 
 	if (!shadowMapGen->setup(pipeline))
 		return false;
@@ -38,6 +38,7 @@
 #include <ray/camera.h>
 #include <ray/light.h>
 #include <ray/geometry.h>
+#include <ray/occlusion_traverser.h>
 
 _NAME_BEGIN
 
@@ -136,6 +137,7 @@ OcclusionCullList::sort(iterator begin, iterator end) noexcept
 
 RenderScene::RenderScene() except
 	: _visible(true)
+	, _frameIndex(1)
 {
 	this->addRenderScene(this);
 }
@@ -211,6 +213,9 @@ RenderScene::addRenderObject(RenderObject* object) except
 		this->addCamera(object->downcast<Camera>());
 	else
 		_renderObjectList.push_back(object);
+
+	if (object->isInstanceOf<Geometry>() && object->downcast<Geometry>()->getCastShadow())
+		this->addShadowCasterChanged(object->getBoundingBoxInWorld());
 }
 
 void
@@ -231,6 +236,15 @@ RenderScene::removeRenderObject(RenderObject* object) noexcept
 		if (it != _renderObjectList.end())
 			_renderObjectList.erase(it);
 	}
+
+	if (object->isInstanceOf<Geometry>() && object->downcast<Geometry>()->getCastShadow())
+		this->addShadowCasterChanged(object->getBoundingBoxInWorld());
+}
+
+const RenderObjectRaws&
+RenderScene::getRenderObjectList() const noexcept
+{
+	return _renderObjectList;
 }
 
 void
@@ -246,6 +260,9 @@ RenderScene::computVisiable(const Camera& camera, OcclusionCullList& list) excep
 		if (it->onVisiableTest(camera, fru))
 			list.insert(it, math::sqrDistance(camera.getTranslate(), it->getTransform().getTranslate()));
 	}
+
+	if (_occlusionTraverser && camera.getCameraOrder() == CameraOrder::CameraOrder3D)
+		_occlusionTraverser->traverse(camera, list);
 }
 
 void
@@ -266,6 +283,54 @@ RenderScene::computVisiableLight(const Camera& camera, OcclusionCullList& list)
 	}
 }
 
+void
+RenderScene::setOcclusionCullEnable(bool enable) noexcept
+{
+	if (enable)
+	{
+		if (_occlusionTraverser)
+			return;
+
+		auto traverser = std::make_shared<OcclusionTraverser>();
+		if (traverser->setup())
+			_occlusionTraverser = traverser;
+	}
+	else
+	{
+		_occlusionTraverser.reset();
+	}
+}
+
+bool
+RenderScene::getOcclusionCullEnable() const noexcept
+{
+	return _occlusionTraverser ? true : false;
+}
+
+const OcclusionTraverserPtr&
+RenderScene::getOcclusionTraverser() const noexcept
+{
+	return _occlusionTraverser;
+}
+
+std::uint32_t
+RenderScene::getFrameIndex() const noexcept
+{
+	return _frameIndex;
+}
+
+void
+RenderScene::addShadowCasterChanged(const BoundingBox& bound) noexcept
+{
+	_shadowCasterChanged.push_back(bound);
+}
+
+const BoundingBoxes&
+RenderScene::getShadowCasterChanged() const noexcept
+{
+	return _shadowCasterChanged;
+}
+
 const RenderScenes&
 RenderScene::getSceneAll() noexcept
 {
@@ -320,6 +385,9 @@ RenderScene::onRenderAfter() except
 
 		_cameraWillAddList.clear();
 	}
+
+	_shadowCasterChanged.clear();
+	_frameIndex++;
 }
 
 _NAME_END
\ No newline at end of file
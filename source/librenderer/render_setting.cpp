@@ -70,6 +70,7 @@ RenderSetting::RenderSetting() noexcept
 	, pipelineType(RenderPipelineType::RenderPipelineTypeDeferredLighting)
 	, shadowMode(ShadowMode::ShadowModeSoft)
 	, shadowQuality(ShadowQuality::ShadowQualityMedium)
+	, shadowCacheBudget(2)
 	, enableSSDO(true)
 	, enableAtmospheric(false)
 	, enableSSR(false)
@@ -353,6 +353,20 @@ RenderSystem::createGraphicsData(const GraphicsDataDesc& desc) noexcept
 	return _pipelineManager->getRenderPipelineDevice()->createGraphicsData(desc);
 }
 
+GraphicsTransientBufferPtr
+RenderSystem::createTransientBuffer(const GraphicsTransientBufferDesc& desc) noexcept
+{
+	assert(_pipelineManager);
+	return _pipelineManager->getRenderPipelineDevice()->createTransientBuffer(desc);
+}
+
+GraphicsQueryPtr
+RenderSystem::createQuery(const GraphicsQueryDesc& desc) noexcept
+{
+	assert(_pipelineManager);
+	return _pipelineManager->getRenderPipelineDevice()->createQuery(desc);
+}
+
 GraphicsInputLayoutPtr
 RenderSystem::createInputLayout(const GraphicsInputLayoutDesc& desc) noexcept
 {
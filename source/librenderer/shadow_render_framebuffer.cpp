@@ -44,6 +44,12 @@ _NAME_BEGIN
 __ImplementSubInterface(ShadowRenderFramebuffer, RenderPipelineFramebuffer, "ShadowRenderFramebuffer")
 
 ShadowRenderFramebuffer::ShadowRenderFramebuffer() noexcept
+	: _shadowMapSize(0)
+	, _shadowAtlasSize(1)
+	, _staticCacheFrame(0)
+	, _staticCacheStale(0)
+	, _staticCacheDynamic(false)
+	, _staticCacheViewProject(float4x4::One)
 {
 }
 
@@ -52,8 +58,10 @@ ShadowRenderFramebuffer::~ShadowRenderFramebuffer() noexcept
 }
 
 bool
-ShadowRenderFramebuffer::setup()
+ShadowRenderFramebuffer::setup(std::uint32_t atlasSize)
 {
+	assert(atlasSize > 0);
+
 	std::uint32_t shadowMapSize = 0;
 
 	ShadowQuality shadowQuality = RenderSystem::instance()->getRenderSetting().shadowQuality;
@@ -68,6 +76,9 @@ ShadowRenderFramebuffer::setup()
 	else
 		return false;
 
+	_shadowMapSize = shadowMapSize;
+	_shadowAtlasSize = atlasSize;
+
 	GraphicsFormat depthLinearFormat;
 	if (RenderSystem::instance()->isTextureSupport(GraphicsFormat::GraphicsFormatR32SFloat))
 		depthLinearFormat = GraphicsFormat::GraphicsFormatR32SFloat;
@@ -77,8 +88,8 @@ ShadowRenderFramebuffer::setup()
 		return false;
 
 	GraphicsTextureDesc depthLinearDesc;
-	depthLinearDesc.setWidth(shadowMapSize);
-	depthLinearDesc.setHeight(shadowMapSize);
+	depthLinearDesc.setWidth(shadowMapSize * atlasSize);
+	depthLinearDesc.setHeight(shadowMapSize * atlasSize);
 	depthLinearDesc.setTexDim(GraphicsTextureDim::GraphicsTextureDim2D);
 	depthLinearDesc.setTexFormat(depthLinearFormat);
 	depthLinearDesc.setSamplerWrap(GraphicsSamplerWrap::GraphicsSamplerWrapClampToEdge);
@@ -93,8 +104,8 @@ ShadowRenderFramebuffer::setup()
 		return false;
 
 	GraphicsFramebufferDesc shadowViewDesc;
-	shadowViewDesc.setWidth(shadowMapSize);
-	shadowViewDesc.setHeight(shadowMapSize);
+	shadowViewDesc.setWidth(shadowMapSize * atlasSize);
+	shadowViewDesc.setHeight(shadowMapSize * atlasSize);
 	shadowViewDesc.addColorAttachment(GraphicsAttachmentBinding(_shadowDepthLinearMap, 0, 0));
 	shadowViewDesc.setGraphicsFramebufferLayout(_shadowDepthLinearViewLayout);
 	_shadowDepthLinearView = RenderSystem::instance()->createFramebuffer(shadowViewDesc);
@@ -105,6 +116,126 @@ ShadowRenderFramebuffer::setup()
 	return true;
 }
 
+std::uint32_t
+ShadowRenderFramebuffer::getShadowMapSize() const noexcept
+{
+	return _shadowMapSize;
+}
+
+std::uint32_t
+ShadowRenderFramebuffer::getShadowAtlasSize() const noexcept
+{
+	return _shadowAtlasSize;
+}
+
+bool
+ShadowRenderFramebuffer::setupStaticCache(GraphicsFormat depthFormat) noexcept
+{
+	assert(_shadowMapSize > 0);
+
+	GraphicsTextureDesc depthDesc;
+	depthDesc.setWidth(_shadowMapSize);
+	depthDesc.setHeight(_shadowMapSize);
+	depthDesc.setTexDim(GraphicsTextureDim::GraphicsTextureDim2D);
+	depthDesc.setTexFormat(depthFormat);
+	depthDesc.setSamplerFilter(GraphicsSamplerFilter::GraphicsSamplerFilterNearest, GraphicsSamplerFilter::GraphicsSamplerFilterNearest);
+	depthDesc.setSamplerWrap(GraphicsSamplerWrap::GraphicsSamplerWrapClampToEdge);
+	_staticCacheMap = RenderSystem::instance()->createTexture(depthDesc);
+	if (!_staticCacheMap)
+		return false;
+
+	GraphicsFramebufferLayoutDesc depthLayoutDesc;
+	depthLayoutDesc.addComponent(GraphicsAttachmentLayout(0, GraphicsImageLayout::GraphicsImageLayoutDepthStencilAttachmentOptimal, depthFormat));
+	_staticCacheViewLayout = RenderSystem::instance()->createFramebufferLayout(depthLayoutDesc);
+	if (!_staticCacheViewLayout)
+		return false;
+
+	GraphicsFramebufferDesc depthViewDesc;
+	depthViewDesc.setWidth(_shadowMapSize);
+	depthViewDesc.setHeight(_shadowMapSize);
+	depthViewDesc.setDepthStencilAttachment(GraphicsAttachmentBinding(_staticCacheMap, 0, 0));
+	depthViewDesc.setGraphicsFramebufferLayout(_staticCacheViewLayout);
+	_staticCacheView = RenderSystem::instance()->createFramebuffer(depthViewDesc);
+	if (!_staticCacheView)
+		return false;
+
+	_staticCacheFrame = 0;
+	_staticCacheStale = 0;
+	_staticCacheDynamic = false;
+	return true;
+}
+
+void
+ShadowRenderFramebuffer::destroyStaticCache() noexcept
+{
+	_staticCacheFrame = 0;
+	_staticCacheStale = 0;
+	_staticCacheDynamic = false;
+	_staticCacheView.reset();
+	_staticCacheViewLayout.reset();
+	_staticCacheMap.reset();
+}
+
+const GraphicsTexturePtr&
+ShadowRenderFramebuffer::getStaticCacheMap() const noexcept
+{
+	return _staticCacheMap;
+}
+
+const GraphicsFramebufferPtr&
+ShadowRenderFramebuffer::getStaticCacheView() const noexcept
+{
+	return _staticCacheView;
+}
+
+void
+ShadowRenderFramebuffer::setStaticCacheFrame(std::uint32_t frame) noexcept
+{
+	_staticCacheFrame = frame;
+}
+
+std::uint32_t
+ShadowRenderFramebuffer::getStaticCacheFrame() const noexcept
+{
+	return _staticCacheFrame;
+}
+
+void
+ShadowRenderFramebuffer::setStaticCacheViewProject(const float4x4& viewProject) noexcept
+{
+	_staticCacheViewProject = viewProject;
+}
+
+const float4x4&
+ShadowRenderFramebuffer::getStaticCacheViewProject() const noexcept
+{
+	return _staticCacheViewProject;
+}
+
+void
+ShadowRenderFramebuffer::setStaticCacheStale(std::uint32_t frames) noexcept
+{
+	_staticCacheStale = frames;
+}
+
+std::uint32_t
+ShadowRenderFramebuffer::getStaticCacheStale() const noexcept
+{
+	return _staticCacheStale;
+}
+
+void
+ShadowRenderFramebuffer::setStaticCacheDynamic(bool dynamic) noexcept
+{
+	_staticCacheDynamic = dynamic;
+}
+
+bool
+ShadowRenderFramebuffer::getStaticCacheDynamic() const noexcept
+{
+	return _staticCacheDynamic;
+}
+
 void
 ShadowRenderFramebuffer::onRenderBefore() noexcept
 {
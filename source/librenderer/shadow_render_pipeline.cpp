@@ -40,8 +40,12 @@
 #include <ray/render_pipeline_framebuffer.h>
 #include <ray/render_object_manager.h>
 
+#include <ray/render_scene.h>
+#include <ray/shadow_render_framebuffer.h>
+
 #include <ray/camera.h>
 #include <ray/light.h>
+#include <ray/geometry.h>
 #include <ray/material.h>
 
 #include <ray/graphics_texture.h>
@@ -51,9 +55,42 @@ _NAME_BEGIN
 
 __ImplementSubClass(ShadowRenderPipeline, RenderPipelineController, "ShadowRenderPipeline")
 
+namespace
+{
+	bool isShadowStaticCaster(const RenderObject* object) noexcept
+	{
+		return object->isInstanceOf<Geometry>() && object->downcast<Geometry>()->getShadowStatic();
+	}
+
+	bool isShadowCasterOverlap(const Camera& camera, const BoundingBox& bound) noexcept
+	{
+		if (camera.getCameraType() == CameraType::CameraTypeCube)
+		{
+			float distance = camera.getFar() + bound.sphere().radius();
+			return math::sqrDistance(camera.getTranslate(), bound.center()) < distance * distance;
+		}
+
+		return Frustum(camera.getViewProject()).contains(bound.aabb());
+	}
+
+	ShadowRenderFramebuffer* getShadowFramebuffer(const Light& light) noexcept
+	{
+		auto& camera = light.getCamera();
+		if (!camera || !camera->getRenderPipelineFramebuffer())
+			return nullptr;
+
+		auto& framebuffer = camera->getRenderPipelineFramebuffer();
+		if (!framebuffer->isInstanceOf<ShadowRenderFramebuffer>())
+			return nullptr;
+
+		return framebuffer->downcast<ShadowRenderFramebuffer>();
+	}
+}
+
 ShadowRenderPipeline::ShadowRenderPipeline() noexcept
 	: _shadowMode(ShadowMode::ShadowModeSoft)
 	, _shadowQuality(ShadowQuality::ShadowQualityMedium)
+	, _shadowCacheBudget(2)
 	, _shadowDepthFormat(GraphicsFormat::GraphicsFormatD16UNorm)
 	, _shadowDepthLinearFormat(GraphicsFormat::GraphicsFormatR32SFloat)
 {
@@ -118,12 +155,25 @@ ShadowRenderPipeline::getShadowQuality() const noexcept
 	return _shadowQuality;
 }
 
+void
+ShadowRenderPipeline::setShadowCacheBudget(std::uint32_t budget) noexcept
+{
+	_shadowCacheBudget = budget;
+}
+
+std::uint32_t
+ShadowRenderPipeline::getShadowCacheBudget() const noexcept
+{
+	return _shadowCacheBudget;
+}
+
 void
 ShadowRenderPipeline::renderShadowMaps(const Camera* mainCamera) noexcept
 {
 	assert(mainCamera);
 
 	_pipeline->setCamera(mainCamera);
+	_shadowCacheLights.clear();
 
 	const auto& lights = mainCamera->getRenderDataManager()->getRenderData(RenderQueue::RenderQueueLights);
 	for (auto& it : lights)
@@ -136,10 +186,49 @@ ShadowRenderPipeline::renderShadowMaps(const Camera* mainCamera) noexcept
 			light->getLightType() == LightType::LightTypeEnvironment)
 			continue;
 
-		if (!light->getGlobalIllumination())
+		if (!light->getShadowCascadeCameras().empty())
+			this->renderShadowCascades(*light, *mainCamera, RenderQueue::RenderQueueShadow);
+		else if (light->getGlobalIllumination())
+			this->renderShadowMap(*light, RenderQueue::RenderQueueReflectiveShadow);
+		else if (_shadowCacheBudget > 0 && this->checkShadowCache(*light))
+			_shadowCacheLights.push_back(light);
+		else
 			this->renderShadowMap(*light, RenderQueue::RenderQueueShadow);
+	}
+
+	// the caches that waited the longest are rebuilt first, the others keep their stale static layer
+	std::stable_sort(_shadowCacheLights.begin(), _shadowCacheLights.end(),
+		[](const Light* lhs, const Light* rhs)
+	{
+		return getShadowFramebuffer(*lhs)->getStaticCacheStale() > getShadowFramebuffer(*rhs)->getStaticCacheStale();
+	});
+
+	std::uint32_t refresh = 0;
+
+	for (auto& light : _shadowCacheLights)
+	{
+		auto& camera = *light->getCamera();
+		auto framebuffer = getShadowFramebuffer(*light);
+
+		if (framebuffer->getStaticCacheStale() > 0 && refresh < _shadowCacheBudget)
+		{
+			this->renderShadowCache(*light, true);
+			refresh++;
+		}
+		else if (framebuffer->getStaticCacheFrame() == 0)
+		{
+			this->renderShadowDepth(camera, RenderQueue::RenderQueueShadow);
+			this->renderShadowConvert(*light, camera, nullptr);
+			camera.onRenderAfter(camera);
+		}
+		else if (framebuffer->getStaticCacheDynamic() || this->renderShadowCasters(camera, false, false) > 0)
+		{
+			this->renderShadowCache(*light, false);
+		}
 		else
-			this->renderShadowMap(*light, RenderQueue::RenderQueueReflectiveShadow);
+		{
+			camera.onRenderAfter(camera);
+		}
 	}
 }
 
@@ -148,56 +237,212 @@ ShadowRenderPipeline::renderShadowMap(const Light& light, RenderQueue queue) noe
 {
 	auto& camera = light.getCamera();
 	if (camera)
+		this->renderShadowCamera(light, *camera, queue, nullptr);
+}
+
+void
+ShadowRenderPipeline::renderShadowCascades(Light& light, const Camera& mainCamera, RenderQueue queue) noexcept
+{
+	light.updateShadowCascades(mainCamera);
+
+	auto& cameras = light.getShadowCascadeCameras();
+	for (std::uint8_t i = 0; i < cameras.size(); i++)
 	{
-		camera->onRenderBefore(*camera);
+		auto tile = light.getShadowCascadeViewport(i);
+		this->renderShadowCamera(light, *cameras[i], queue, &tile);
+	}
+}
 
-		auto shadowFrambuffer = _shadowShadowDepthViewTemp;
-		auto shadowLienarFrambuffer = camera->getRenderPipelineFramebuffer()->getFramebuffer();
-		auto shadowTexture = shadowFrambuffer->getGraphicsFramebufferDesc().getDepthStencilAttachment().getBindingTexture();
+void
+ShadowRenderPipeline::renderShadowCamera(const Light& light, Camera& camera, RenderQueue queue, const Viewport* tile) noexcept
+{
+	camera.onRenderBefore(camera);
 
-		_pipeline->setCamera(camera.get());
-		_pipeline->setFramebuffer(shadowFrambuffer);
+	this->renderShadowDepth(camera, queue);
+	this->renderShadowConvert(light, camera, tile);
 
-		if (queue == RenderQueue::RenderQueueReflectiveShadow)
-		{
-			_pipeline->clearFramebuffer(0, GraphicsClearFlagBits::GraphicsClearFlagColorBit, float4::Zero, 1.0, 0);
-			_pipeline->clearFramebuffer(1, GraphicsClearFlagBits::GraphicsClearFlagColorBit, float4::Zero, 1.0, 0);
-			_pipeline->clearFramebuffer(2, GraphicsClearFlagBits::GraphicsClearFlagDepthBit, float4::Zero, 1.0, 0);
-		}
-		else
-		{
-			_pipeline->clearFramebuffer(0, GraphicsClearFlagBits::GraphicsClearFlagDepthBit, float4::Zero, 1.0, 0);
-		}
+	camera.onRenderAfter(camera);
+}
+
+void
+ShadowRenderPipeline::renderShadowDepth(Camera& camera, RenderQueue queue) noexcept
+{
+	_pipeline->setCamera(&camera);
+	_pipeline->setFramebuffer(_shadowShadowDepthViewTemp);
 
-		_pipeline->drawRenderQueue(queue, nullptr);
+	if (queue == RenderQueue::RenderQueueReflectiveShadow)
+	{
+		_pipeline->clearFramebuffer(0, GraphicsClearFlagBits::GraphicsClearFlagColorBit, float4::Zero, 1.0, 0);
+		_pipeline->clearFramebuffer(1, GraphicsClearFlagBits::GraphicsClearFlagColorBit, float4::Zero, 1.0, 0);
+		_pipeline->clearFramebuffer(2, GraphicsClearFlagBits::GraphicsClearFlagDepthBit, float4::Zero, 1.0, 0);
+	}
+	else
+	{
+		_pipeline->clearFramebuffer(0, GraphicsClearFlagBits::GraphicsClearFlagDepthBit, float4::Zero, 1.0, 0);
+	}
 
-		if (_shadowMode == ShadowMode::ShadowModeSoft && light.getShadowMode() == ShadowMode::ShadowModeSoft)
-		{
-			_shadowShadowSource->uniformTexture(shadowTexture);
-			_shadowClipConstant->uniform4f(float4(camera->getClipConstant().xy(), 1.0, 1.0));
+	_pipeline->drawRenderQueue(queue, nullptr);
+}
 
-			_pipeline->setFramebuffer(_shadowShadowDepthLinearViewTemp);
+void
+ShadowRenderPipeline::renderShadowConvert(const Light& light, Camera& camera, const Viewport* tile) noexcept
+{
+	auto shadowFrambuffer = _shadowShadowDepthViewTemp;
+	auto shadowLienarFrambuffer = camera.getRenderPipelineFramebuffer()->getFramebuffer();
+	auto shadowTexture = shadowFrambuffer->getGraphicsFramebufferDesc().getDepthStencilAttachment().getBindingTexture();
+
+	if (_shadowMode == ShadowMode::ShadowModeSoft && light.getShadowMode() == ShadowMode::ShadowModeSoft)
+	{
+		_shadowShadowSource->uniformTexture(shadowTexture);
+		_shadowClipConstant->uniform4f(float4(camera.getClipConstant().xy(), 1.0, 1.0));
+
+		_pipeline->setFramebuffer(_shadowShadowDepthLinearViewTemp);
+		_pipeline->discardFramebuffer(0);
+		_pipeline->drawScreenQuad(*_shadowBlurShadowX[(std::uint8_t)light.getLightType()]);
+
+		_shadowShadowSource->uniformTexture(_shadowShadowDepthLinearMapTemp);
+
+		_pipeline->setFramebuffer(shadowLienarFrambuffer);
+
+		// the other tiles of an atlas still hold the cascades rendered before this one
+		if (tile)
+			_pipeline->setViewport(0, *tile);
+		else
 			_pipeline->discardFramebuffer(0);
-			_pipeline->drawScreenQuad(*_shadowBlurShadowX[(std::uint8_t)light.getLightType()]);
 
-			_shadowShadowSource->uniformTexture(_shadowShadowDepthLinearMapTemp);
+		_pipeline->drawScreenQuad(*_shadowBlurShadowY);
+	}
+	else
+	{
+		_shadowShadowSource->uniformTexture(shadowTexture);
+		_shadowClipConstant->uniform4f(float4(camera.getClipConstant().xy(), 1.0f, 1.0f));
 
-			_pipeline->setFramebuffer(shadowLienarFrambuffer);
+		_pipeline->setFramebuffer(shadowLienarFrambuffer);
+
+		if (tile)
+			_pipeline->setViewport(0, *tile);
+		else
 			_pipeline->discardFramebuffer(0);
-			_pipeline->drawScreenQuad(*_shadowBlurShadowY);
+
+		_pipeline->drawScreenQuad(*_shadowBlurShadowX[(std::uint8_t)light.getLightType()]);
+	}
+}
+
+bool
+ShadowRenderPipeline::checkShadowCache(const Light& light) noexcept
+{
+	auto framebuffer = getShadowFramebuffer(light);
+	if (!framebuffer || framebuffer->getShadowAtlasSize() > 1)
+		return false;
+
+	auto& camera = *light.getCamera();
+	auto& scene = camera.getRenderScene();
+	if (!scene)
+		return false;
+
+	if (!framebuffer->getStaticCacheView())
+	{
+		if (!framebuffer->setupStaticCache(_shadowDepthFormat))
+		{
+			framebuffer->destroyStaticCache();
+			return false;
 		}
-		else
+	}
+
+	camera.onRenderBefore(camera);
+
+	auto cacheFrame = framebuffer->getStaticCacheFrame();
+	auto frame = scene->getFrameIndex();
+
+	// a moved light or a changed projection leaves nothing worth keeping
+	bool dirty = cacheFrame == 0 || framebuffer->getStaticCacheViewProject() != camera.getViewProject();
+
+	if (!dirty)
+	{
+		for (auto& bound : scene->getShadowCasterChanged())
 		{
-			_shadowShadowSource->uniformTexture(shadowTexture);
-			_shadowClipConstant->uniform4f(float4(camera->getClipConstant().xy(), 1.0f, 1.0f));
+			if (isShadowCasterOverlap(camera, bound))
+			{
+				dirty = true;
+				break;
+			}
+		}
+	}
 
-			_pipeline->setFramebuffer(shadowLienarFrambuffer);
-			_pipeline->discardFramebuffer(0);
-			_pipeline->drawScreenQuad(*_shadowBlurShadowX[(std::uint8_t)light.getLightType()]);
+	// casters that came to rest after the cache was built are only in the dynamic layer so far
+	if (!dirty)
+	{
+		auto& renderable = camera.getRenderDataManager()->getRenderData(RenderQueue::RenderQueueShadow);
+		for (auto& it : renderable)
+		{
+			if (!it->isInstanceOf<Geometry>())
+				continue;
+
+			auto staticFrame = it->downcast<Geometry>()->getShadowStaticFrame();
+			if (staticFrame > cacheFrame && staticFrame <= frame)
+			{
+				dirty = true;
+				break;
+			}
 		}
+	}
+
+	if (dirty)
+		framebuffer->setStaticCacheStale(framebuffer->getStaticCacheStale() + 1);
+
+	return true;
+}
+
+void
+ShadowRenderPipeline::renderShadowCache(const Light& light, bool refresh) noexcept
+{
+	auto& camera = *light.getCamera();
+	auto framebuffer = getShadowFramebuffer(light);
+
+	_pipeline->setCamera(&camera);
+
+	if (refresh)
+	{
+		_pipeline->setFramebuffer(framebuffer->getStaticCacheView());
+		_pipeline->clearFramebuffer(0, GraphicsClearFlagBits::GraphicsClearFlagDepthBit, float4::Zero, 1.0, 0);
 
-		camera->onRenderAfter(*camera);
+		this->renderShadowCasters(camera, true, true);
+
+		framebuffer->setStaticCacheFrame(camera.getRenderScene()->getFrameIndex());
+		framebuffer->setStaticCacheViewProject(camera.getViewProject());
+		framebuffer->setStaticCacheStale(0);
+	}
+
+	_shadowShadowSource->uniformTexture(framebuffer->getStaticCacheMap());
+
+	_pipeline->setFramebuffer(_shadowShadowDepthViewTemp);
+	_pipeline->drawScreenQuad(*_shadowCopyDepth);
+
+	framebuffer->setStaticCacheDynamic(this->renderShadowCasters(camera, false, true) > 0);
+
+	this->renderShadowConvert(light, camera, nullptr);
+
+	camera.onRenderAfter(camera);
+}
+
+std::size_t
+ShadowRenderPipeline::renderShadowCasters(Camera& camera, bool isStatic, bool draw) noexcept
+{
+	std::size_t count = 0;
+
+	auto& renderable = camera.getRenderDataManager()->getRenderData(RenderQueue::RenderQueueShadow);
+	for (auto& it : renderable)
+	{
+		if (isShadowStaticCaster(it) != isStatic)
+			continue;
+
+		if (draw)
+			it->onRenderObject(*_pipeline, RenderQueue::RenderQueueShadow, nullptr);
+
+		count++;
 	}
+
+	return count;
 }
 
 bool
@@ -206,6 +451,7 @@ ShadowRenderPipeline::setupShadowMaterial(RenderPipeline& pipeline) noexcept
 	_shadowRender = pipeline.createMaterial("sys:fx/shadowmap.fxml"); if (!_shadowRender) return false;
 	_shadowConvOrthoLinearDepth = _shadowRender->getTech("ConvOrthoLinearDepth"); if (!_shadowConvOrthoLinearDepth) return false;
 	_shadowConvPerspectiveFovLinearDepth = _shadowRender->getTech("ConvPerspectiveFovLinearDepth"); if (!_shadowConvPerspectiveFovLinearDepth) return false;
+	_shadowCopyDepth = _shadowRender->getTech("CopyDepth"); if (!_shadowCopyDepth) return false;
 	_shadowBlurOrthoShadowX = _shadowRender->getTech("ConvOrthoLinearDepthBlurX"); if (!_shadowBlurOrthoShadowX) return false;
 	_shadowBlurPerspectiveFovShadowX = _shadowRender->getTech("ConvPerspectiveFovLinearDepthBlurX"); if (!_shadowBlurPerspectiveFovShadowX) return false;
 	_shadowBlurShadowY = _shadowRender->getTech("BlurY"); if (!_shadowBlurShadowY) return false;
@@ -342,6 +588,7 @@ ShadowRenderPipeline::destroyShadowMaterial() noexcept
 	_shadowLogBlurShadowY.reset();
 	_shadowConvOrthoLinearDepth.reset();
 	_shadowConvPerspectiveFovLinearDepth.reset();
+	_shadowCopyDepth.reset();
 
 	for (std::size_t i = 0; i < (std::uint8_t)LightType::LightTypeRangeSize; i++)
 		_shadowBlurShadowX[i].reset();
@@ -57,9 +57,20 @@ public:
 	void setShadowQuality(ShadowQuality quality) noexcept;
 	ShadowQuality getShadowQuality() const noexcept;
 
+	void setShadowCacheBudget(std::uint32_t budget) noexcept;
+	std::uint32_t getShadowCacheBudget() const noexcept;
+
 private:
 	void renderShadowMaps(const Camera* camera) noexcept;
 	void renderShadowMap(const Light& light, RenderQueue queue) noexcept;
+	void renderShadowCascades(Light& light, const Camera& mainCamera, RenderQueue queue) noexcept;
+	void renderShadowCamera(const Light& light, Camera& camera, RenderQueue queue, const Viewport* tile) noexcept;
+	void renderShadowDepth(Camera& camera, RenderQueue queue) noexcept;
+	void renderShadowConvert(const Light& light, Camera& camera, const Viewport* tile) noexcept;
+
+	bool checkShadowCache(const Light& light) noexcept;
+	void renderShadowCache(const Light& light, bool refresh) noexcept;
+	std::size_t renderShadowCasters(Camera& camera, bool isStatic, bool draw) noexcept;
 
 private:
 	bool setupShadowMaterial(RenderPipeline& pipeline) noexcept;
@@ -82,6 +93,9 @@ private:
 	ShadowMode _shadowMode;
 	ShadowQuality _shadowQuality;
 
+	std::uint32_t _shadowCacheBudget;
+	std::vector<const Light*> _shadowCacheLights;
+
 	MaterialPtr _shadowRender;
 	MaterialTechPtr _shadowBlurOrthoShadowX;
 	MaterialTechPtr _shadowBlurPerspectiveFovShadowX;
@@ -91,6 +105,7 @@ private:
 	MaterialTechPtr _shadowLogBlurShadowY;
 	MaterialTechPtr _shadowConvOrthoLinearDepth;
 	MaterialTechPtr _shadowConvPerspectiveFovLinearDepth;
+	MaterialTechPtr _shadowCopyDepth;
 	MaterialParamPtr _shadowShadowSource;
 	MaterialParamPtr _shadowShadowSourceInv;
 	MaterialParamPtr _shadowClipConstant;
@@ -0,0 +1,811 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#include <ray/terrain_cdlod.h>
+#include <ray/render_system.h>
+#include <ray/render_pipeline.h>
+#include <ray/render_object_manager.h>
+#include <ray/render_scene.h>
+#include <ray/material.h>
+#include <ray/camera.h>
+#include <ray/graphics_data.h>
+#include <ray/graphics_texture.h>
+#include <ray/ioserver.h>
+#include <ray/format.h>
+
+#include <chrono>
+
+_NAME_BEGIN
+
+namespace
+{
+	const std::uint8_t maxLods = 16;
+}
+
+__ImplementSubClass(TerrainCDLOD, RenderObject, "TerrainCDLOD")
+
+TerrainCDLOD::TerrainCDLOD() noexcept
+	: _size(0)
+	, _tileSize(0)
+	, _gridSize(0)
+	, _numLods(0)
+	, _cellSize(1.0f)
+	, _heightScale(256.0f)
+	, _lodDistance(64.0f)
+	, _morphRatio(0.7f)
+	, _numSelectedNodes(0)
+	, _tileBudget(64 * 1024 * 1024)
+	, _residentMemory(0)
+	, _numResidentTiles(0)
+	, _maxRequests(8)
+	, _maxUploads(4)
+	, _selectTime(0)
+	, _numPending(0)
+	, _numIndices(0)
+{
+}
+
+TerrainCDLOD::~TerrainCDLOD() noexcept
+{
+	this->close();
+}
+
+bool
+TerrainCDLOD::setup(const std::string& path, std::uint32_t size, std::uint32_t tileSize, std::uint32_t gridSize) noexcept
+{
+	assert(!_thread);
+	assert(gridSize > 0 && gridSize < 256);
+	assert(tileSize >= gridSize && tileSize % gridSize == 0);
+	assert(size >= gridSize && size % gridSize == 0);
+
+	_path = path;
+	_size = size;
+	_tileSize = tileSize;
+	_gridSize = gridSize;
+
+	// the coarsest level is the first one whose node covers the whole map
+	_numLods = 1;
+	while ((_gridSize << (_numLods - 1)) < _size && _numLods < maxLods)
+		_numLods++;
+
+	if (!this->setupGridMesh())
+		return false;
+
+	if (!this->setupMaterial())
+		return false;
+
+	this->updateLodRanges();
+	this->updateBoundingBox();
+
+	_thread = std::make_unique<std::thread>(std::bind(&TerrainCDLOD::dispose, this));
+	return true;
+}
+
+void
+TerrainCDLOD::close() noexcept
+{
+	if (_thread)
+	{
+		TilePtr tile;
+		while (_requests.try_pop(tile))
+			;
+
+		// an empty tile tells the loader to quit
+		_requests.push(nullptr);
+
+		_thread->join();
+		_thread.reset();
+
+		while (_loaded.try_pop(tile))
+			;
+	}
+
+	_tiles.clear();
+	_selections.clear();
+
+	_numSelectedNodes = 0;
+	_numPending = 0;
+	_numResidentTiles = 0;
+	_residentMemory = 0;
+
+	_vbo.reset();
+	_ibo.reset();
+}
+
+void
+TerrainCDLOD::setMaterial(const MaterialPtr& material) noexcept
+{
+	if (_material != material)
+	{
+		_material = material;
+
+		if (_vbo)
+			this->setupMaterial();
+	}
+}
+
+const MaterialPtr&
+TerrainCDLOD::getMaterial() const noexcept
+{
+	return _material;
+}
+
+void
+TerrainCDLOD::setCellSize(float size) noexcept
+{
+	assert(size > 0.0f);
+	_cellSize = size;
+	this->updateBoundingBox();
+}
+
+float
+TerrainCDLOD::getCellSize() const noexcept
+{
+	return _cellSize;
+}
+
+void
+TerrainCDLOD::setHeightScale(float scale) noexcept
+{
+	assert(scale > 0.0f);
+	_heightScale = scale;
+	this->updateBoundingBox();
+}
+
+float
+TerrainCDLOD::getHeightScale() const noexcept
+{
+	return _heightScale;
+}
+
+void
+TerrainCDLOD::setLodDistance(float distance) noexcept
+{
+	assert(distance > 0.0f);
+	_lodDistance = distance;
+	this->updateLodRanges();
+}
+
+float
+TerrainCDLOD::getLodDistance() const noexcept
+{
+	return _lodDistance;
+}
+
+void
+TerrainCDLOD::setMorphRatio(float ratio) noexcept
+{
+	assert(ratio >= 0.0f && ratio < 1.0f);
+	_morphRatio = ratio;
+}
+
+float
+TerrainCDLOD::getMorphRatio() const noexcept
+{
+	return _morphRatio;
+}
+
+void
+TerrainCDLOD::setTileBudget(std::size_t bytes) noexcept
+{
+	_tileBudget = bytes;
+}
+
+std::size_t
+TerrainCDLOD::getTileBudget() const noexcept
+{
+	return _tileBudget;
+}
+
+std::uint8_t
+TerrainCDLOD::getNumLods() const noexcept
+{
+	return _numLods;
+}
+
+std::size_t
+TerrainCDLOD::getNumSelectedNodes() const noexcept
+{
+	return _numSelectedNodes;
+}
+
+std::size_t
+TerrainCDLOD::getNumResidentTiles() const noexcept
+{
+	return _numResidentTiles;
+}
+
+std::size_t
+TerrainCDLOD::getNumPendingTiles() const noexcept
+{
+	return _numPending;
+}
+
+std::size_t
+TerrainCDLOD::getResidentMemory() const noexcept
+{
+	return _residentMemory;
+}
+
+float
+TerrainCDLOD::getSelectTime() const noexcept
+{
+	return _selectTime;
+}
+
+bool
+TerrainCDLOD::setupGridMesh() noexcept
+{
+	std::vector<float3> vertices;
+	std::vector<std::uint32_t> indices;
+
+	for (std::uint32_t z = 0; z <= _gridSize; z++)
+	{
+		for (std::uint32_t x = 0; x <= _gridSize; x++)
+			vertices.push_back(float3((float)x / _gridSize, 0.0f, (float)z / _gridSize));
+	}
+
+	for (std::uint32_t z = 0; z < _gridSize; z++)
+	{
+		for (std::uint32_t x = 0; x < _gridSize; x++)
+		{
+			std::uint32_t a = z * (_gridSize + 1) + x;
+			std::uint32_t b = a + 1;
+			std::uint32_t c = a + _gridSize + 1;
+			std::uint32_t d = c + 1;
+
+			indices.push_back(a);
+			indices.push_back(c);
+			indices.push_back(b);
+
+			indices.push_back(b);
+			indices.push_back(c);
+			indices.push_back(d);
+		}
+	}
+
+	GraphicsDataDesc vb;
+	vb.setType(GraphicsDataType::GraphicsDataTypeStorageVertexBuffer);
+	vb.setUsage(GraphicsUsageFlagBits::GraphicsUsageFlagReadBit);
+	vb.setStream((std::uint8_t*)vertices.data());
+	vb.setStreamSize(vertices.size() * sizeof(float3));
+
+	_vbo = RenderSystem::instance()->createGraphicsData(vb);
+	if (!_vbo)
+		return false;
+
+	GraphicsDataDesc ib;
+	ib.setType(GraphicsDataType::GraphicsDataTypeStorageIndexBuffer);
+	ib.setUsage(GraphicsUsageFlagBits::GraphicsUsageFlagReadBit);
+	ib.setStream((std::uint8_t*)indices.data());
+	ib.setStreamSize(indices.size() * sizeof(std::uint32_t));
+
+	_ibo = RenderSystem::instance()->createGraphicsData(ib);
+	if (!_ibo)
+		return false;
+
+	_numIndices = static_cast<std::uint32_t>(indices.size());
+	return true;
+}
+
+bool
+TerrainCDLOD::setupMaterial() noexcept
+{
+	if (!_material)
+		_material = RenderSystem::instance()->createMaterial("sys:fx/terrain_cdlod.fxml");
+
+	if (!_material)
+		return false;
+
+	for (std::size_t i = 0; i < RenderQueue::RenderQueueRangeSize; i++)
+		_techniques[i] = nullptr;
+
+	_techniques[RenderQueue::RenderQueueOpaque] = _material->getTech("Opaque");
+	_techniques[RenderQueue::RenderQueueShadow] = _material->getTech("Shadow");
+
+	_cdlodNode = _material->getParameter("cdlodNode");
+	_cdlodMorph = _material->getParameter("cdlodMorph");
+	_cdlodTile = _material->getParameter("cdlodTile");
+	_cdlodCamera = _material->getParameter("cdlodCamera");
+	_cdlodHeightMap = _material->getParameter("cdlodHeightMap");
+	_cdlodNormalMap = _material->getParameter("cdlodNormalMap");
+
+	return _cdlodNode && _cdlodMorph && _cdlodTile && _cdlodCamera && _cdlodHeightMap && _cdlodNormalMap;
+}
+
+void
+TerrainCDLOD::updateLodRanges() noexcept
+{
+	_lodRanges.resize(_numLods);
+
+	for (std::uint8_t i = 0; i < _numLods; i++)
+		_lodRanges[i] = _lodDistance * (1 << i);
+
+	// the coarsest level draws everything that is left up to the far plane
+	if (_numLods > 0)
+		_lodRanges.back() = std::numeric_limits<float>::max();
+}
+
+void
+TerrainCDLOD::updateBoundingBox() noexcept
+{
+	float extent = _size * _cellSize;
+	this->setBoundingBox(BoundingBox(float3::Zero, float3(extent, _heightScale, extent)));
+}
+
+bool
+TerrainCDLOD::selectNode(std::vector<Node>& nodes, const Frustum& fru, const float3& eye, std::uint8_t level, std::uint32_t x, std::uint32_t z, std::uint32_t frame) noexcept
+{
+	auto bound = this->getNodeBound(level, x, z);
+	auto distance = math::sqrDistance(bound.closestPoint(eye), eye);
+
+	// out of reach of this level, the parent covers the area with coarser geometry
+	if (level + 1 < _numLods && distance > _lodRanges[level] * _lodRanges[level])
+		return false;
+
+	this->getNodeTile(level, x, z, true, frame);
+
+	if (!fru.contains(bound))
+		return true;
+
+	if (level == 0 || distance > _lodRanges[level - 1] * _lodRanges[level - 1])
+	{
+		this->addNode(nodes, level, x, z, frame);
+		return true;
+	}
+
+	std::uint32_t childCells = _gridSize << (level - 1);
+
+	for (std::uint32_t j = z * 2; j < z * 2 + 2; j++)
+	{
+		for (std::uint32_t i = x * 2; i < x * 2 + 2; i++)
+		{
+			if (i * childCells >= _size || j * childCells >= _size)
+				continue;
+
+			// a child out of its own range is drawn with its grid fully morphed, which matches this level
+			if (!this->selectNode(nodes, fru, eye, level - 1, i, j, frame))
+				this->addNode(nodes, level - 1, i, j, frame);
+		}
+	}
+
+	return true;
+}
+
+void
+TerrainCDLOD::addNode(std::vector<Node>& nodes, std::uint8_t level, std::uint32_t x, std::uint32_t z, std::uint32_t frame) noexcept
+{
+	auto tile = this->getNodeTile(level, x, z, false, frame);
+	if (!tile)
+		return;
+
+	Node node;
+	node.level = level;
+	node.x = x;
+	node.z = z;
+	node.tile = tile;
+
+	nodes.push_back(node);
+}
+
+AABB
+TerrainCDLOD::getNodeBound(std::uint8_t level, std::uint32_t x, std::uint32_t z) const noexcept
+{
+	float2 bounds(0.0f, 1.0f);
+
+	std::uint32_t nodesPerTile = _tileSize / _gridSize;
+
+	// nodes without height data of their own borrow the range of the closest ancestor that has it
+	for (std::uint8_t i = level; i < _numLods; i++)
+	{
+		std::uint32_t nx = x >> (i - level);
+		std::uint32_t nz = z >> (i - level);
+
+		auto it = _tiles.find(makeTileKey(i, nx / nodesPerTile, nz / nodesPerTile));
+		if (it == _tiles.end())
+			continue;
+
+		auto& tile = *it->second;
+		if (tile.state == Tile::Loaded || tile.state == Tile::Resident)
+		{
+			bounds = tile.bounds[(nz % nodesPerTile) * nodesPerTile + nx % nodesPerTile];
+			break;
+		}
+	}
+
+	float nodeSize = (_gridSize << level) * _cellSize;
+
+	float3 min(x * nodeSize, bounds.x * _heightScale, z * nodeSize);
+	float3 max(min.x + nodeSize, bounds.y * _heightScale, min.z + nodeSize);
+
+	return AABB(min, max);
+}
+
+TerrainCDLOD::Tile*
+TerrainCDLOD::getNodeTile(std::uint8_t level, std::uint32_t x, std::uint32_t z, bool request, std::uint32_t frame) noexcept
+{
+	std::uint32_t nodesPerTile = _tileSize / _gridSize;
+
+	for (std::uint8_t i = level; i < _numLods; i++)
+	{
+		std::uint32_t tx = (x >> (i - level)) / nodesPerTile;
+		std::uint32_t tz = (z >> (i - level)) / nodesPerTile;
+
+		auto key = makeTileKey(i, tx, tz);
+		auto it = _tiles.find(key);
+		if (it == _tiles.end())
+		{
+			if (request && i == level && _numPending < _maxRequests)
+			{
+				auto tile = std::make_shared<Tile>();
+				tile->level = i;
+				tile->x = tx;
+				tile->z = tz;
+				tile->state = Tile::Loading;
+				tile->lastFrame = frame;
+				tile->memoryUsage = 0;
+				tile->spacing = (1 << i) * _cellSize;
+				tile->heightScale = _heightScale;
+
+				_tiles[key] = tile;
+				_requests.push(tile);
+				_numPending++;
+			}
+
+			continue;
+		}
+
+		auto& tile = *it->second;
+		if (tile.state == Tile::Resident)
+		{
+			tile.lastFrame = frame;
+			return &tile;
+		}
+	}
+
+	return nullptr;
+}
+
+void
+TerrainCDLOD::uploadTiles() noexcept
+{
+	TilePtr tile;
+
+	for (std::size_t i = 0; i < _maxUploads && _loaded.try_pop(tile); i++)
+	{
+		_numPending--;
+
+		if (tile->state != Tile::Loaded)
+			continue;
+
+		std::uint32_t samples = _tileSize + 1;
+
+		GraphicsTextureDesc heightDesc;
+		heightDesc.setWidth(samples);
+		heightDesc.setHeight(samples);
+		heightDesc.setTexDim(GraphicsTextureDim::GraphicsTextureDim2D);
+		heightDesc.setTexFormat(GraphicsFormat::GraphicsFormatR16UNorm);
+		heightDesc.setSamplerWrap(GraphicsSamplerWrap::GraphicsSamplerWrapClampToEdge);
+		heightDesc.setSamplerFilter(GraphicsSamplerFilter::GraphicsSamplerFilterLinear, GraphicsSamplerFilter::GraphicsSamplerFilterLinear);
+		heightDesc.setStream(tile->heights.data());
+		heightDesc.setStreamSize(tile->heights.size() * sizeof(std::uint16_t));
+
+		GraphicsTextureDesc normalDesc;
+		normalDesc.setWidth(samples);
+		normalDesc.setHeight(samples);
+		normalDesc.setTexDim(GraphicsTextureDim::GraphicsTextureDim2D);
+		normalDesc.setTexFormat(GraphicsFormat::GraphicsFormatR8G8UNorm);
+		normalDesc.setSamplerWrap(GraphicsSamplerWrap::GraphicsSamplerWrapClampToEdge);
+		normalDesc.setSamplerFilter(GraphicsSamplerFilter::GraphicsSamplerFilterLinear, GraphicsSamplerFilter::GraphicsSamplerFilterLinear);
+		normalDesc.setStream(tile->normals.data());
+		normalDesc.setStreamSize(tile->normals.size());
+
+		tile->heightMap = RenderSystem::instance()->createTexture(heightDesc);
+		tile->normalMap = RenderSystem::instance()->createTexture(normalDesc);
+
+		if (!tile->heightMap || !tile->normalMap)
+		{
+			tile->heightMap = nullptr;
+			tile->normalMap = nullptr;
+
+			this->missingTile(*tile);
+			continue;
+		}
+
+		tile->memoryUsage = tile->heights.size() * sizeof(std::uint16_t) + tile->normals.size();
+		tile->heights = std::vector<std::uint16_t>();
+		tile->normals = std::vector<std::uint8_t>();
+		tile->state = Tile::Resident;
+
+		_residentMemory += tile->memoryUsage;
+		_numResidentTiles++;
+	}
+}
+
+void
+TerrainCDLOD::evictTiles(std::uint32_t frame) noexcept
+{
+	while (_residentMemory > _tileBudget)
+	{
+		auto victim = _tiles.end();
+
+		for (auto it = _tiles.begin(); it != _tiles.end(); ++it)
+		{
+			auto& tile = *it->second;
+			if (tile.state != Tile::Resident || tile.lastFrame >= frame)
+				continue;
+
+			// the coarsest level is what everything falls back to, so it never leaves
+			if (tile.level + 1 == _numLods)
+				continue;
+
+			if (victim == _tiles.end() || tile.lastFrame < victim->second->lastFrame)
+				victim = it;
+		}
+
+		if (victim == _tiles.end())
+			break;
+
+		_residentMemory -= victim->second->memoryUsage;
+		_numResidentTiles--;
+		_tiles.erase(victim);
+	}
+}
+
+void
+TerrainCDLOD::loadTile(Tile& tile) noexcept
+{
+	std::uint32_t samples = _tileSize + 1;
+
+	std::string name = format("%s/%d_%d_%d") % _path % (int)tile.level % tile.x % tile.z;
+
+	tile.heights.resize(samples * samples);
+
+	// the ios state of the server is shared with the main thread, only the stream tells whether this open succeeded
+	StreamReaderPtr stream;
+	IoServer::instance()->openFileURL(stream, name + ".r16");
+	if (!stream || !stream->read((char*)tile.heights.data(), tile.heights.size() * sizeof(std::uint16_t)))
+	{
+		this->missingTile(tile);
+		return;
+	}
+
+	tile.normals.resize(samples * samples * 2);
+
+	StreamReaderPtr normalStream;
+	bool hasNormals = false;
+	IoServer::instance()->openFileURL(normalStream, name + ".rg8");
+	if (normalStream)
+		hasNormals = normalStream->read((char*)tile.normals.data(), tile.normals.size()) ? true : false;
+
+	if (!hasNormals)
+	{
+		float scale = tile.heightScale / 65535.0f;
+
+		for (std::uint32_t z = 0; z < samples; z++)
+		{
+			for (std::uint32_t x = 0; x < samples; x++)
+			{
+				std::uint32_t x0 = x > 0 ? x - 1 : x;
+				std::uint32_t x1 = x + 1 < samples ? x + 1 : x;
+				std::uint32_t z0 = z > 0 ? z - 1 : z;
+				std::uint32_t z1 = z + 1 < samples ? z + 1 : z;
+
+				float dx = (tile.heights[z * samples + x1] - tile.heights[z * samples + x0]) * scale / ((x1 - x0) * tile.spacing);
+				float dz = (tile.heights[z1 * samples + x] - tile.heights[z0 * samples + x]) * scale / ((z1 - z0) * tile.spacing);
+
+				float3 normal = math::normalize(float3(-dx, 1.0f, -dz));
+
+				tile.normals[(z * samples + x) * 2 + 0] = static_cast<std::uint8_t>((normal.x * 0.5f + 0.5f) * 255.0f);
+				tile.normals[(z * samples + x) * 2 + 1] = static_cast<std::uint8_t>((normal.z * 0.5f + 0.5f) * 255.0f);
+			}
+		}
+	}
+
+	std::uint32_t nodesPerTile = _tileSize / _gridSize;
+
+	tile.bounds.resize(nodesPerTile * nodesPerTile);
+
+	for (std::uint32_t nz = 0; nz < nodesPerTile; nz++)
+	{
+		for (std::uint32_t nx = 0; nx < nodesPerTile; nx++)
+		{
+			std::uint16_t min = std::numeric_limits<std::uint16_t>::max();
+			std::uint16_t max = 0;
+
+			for (std::uint32_t z = nz * _gridSize; z <= (nz + 1) * _gridSize; z++)
+			{
+				for (std::uint32_t x = nx * _gridSize; x <= (nx + 1) * _gridSize; x++)
+				{
+					min = std::min(min, tile.heights[z * samples + x]);
+					max = std::max(max, tile.heights[z * samples + x]);
+				}
+			}
+
+			tile.bounds[nz * nodesPerTile + nx] = float2(min / 65535.0f, max / 65535.0f);
+		}
+	}
+
+	tile.state = Tile::Loaded;
+}
+
+void
+TerrainCDLOD::missingTile(Tile& tile) noexcept
+{
+	// a missing tile is never retried, so its samples would otherwise stay outside the tile budget forever
+	tile.heights = std::vector<std::uint16_t>();
+	tile.normals = std::vector<std::uint8_t>();
+	tile.bounds = std::vector<float2>();
+	tile.state = Tile::Missing;
+}
+
+void
+TerrainCDLOD::dispose() noexcept
+{
+	for (;;)
+	{
+		auto tile = _requests.wait_and_pop();
+		if (!tile)
+			break;
+
+		this->loadTile(*tile);
+
+		_loaded.push(tile);
+	}
+}
+
+std::uint64_t
+TerrainCDLOD::makeTileKey(std::uint8_t level, std::uint32_t x, std::uint32_t z) noexcept
+{
+	return (std::uint64_t)level << 56 | (std::uint64_t)x << 28 | z;
+}
+
+bool
+TerrainCDLOD::onVisiableTest(const Camera& camera, const Frustum&) noexcept
+{
+	if (!_thread)
+		return false;
+
+	if (camera.getCameraOrder() == CameraOrder::CameraOrderShadow)
+	{
+		if (!_techniques[RenderQueue::RenderQueueShadow])
+			return false;
+	}
+
+	auto begin = std::chrono::high_resolution_clock::now();
+
+	auto& scene = this->getRenderScene();
+	auto frame = scene ? scene->getFrameIndex() : 0;
+
+	this->uploadTiles();
+
+	// nodes are tested in the terrain space, so the frustum is moved there instead of every node box
+	Frustum local(camera.getViewProject() * this->getTransform());
+
+	for (auto it = _selections.begin(); it != _selections.end();)
+	{
+		if (it->second.frame + 1 < frame)
+			it = _selections.erase(it);
+		else
+			++it;
+	}
+
+	auto& selection = _selections[&camera];
+	selection.frame = frame;
+	selection.nodes.clear();
+
+	auto eye = this->getTransformInverse() * camera.getTranslate();
+
+	std::uint32_t rootCells = _gridSize << (_numLods - 1);
+	std::uint32_t numRoots = (_size + rootCells - 1) / rootCells;
+
+	for (std::uint32_t z = 0; z < numRoots; z++)
+	{
+		for (std::uint32_t x = 0; x < numRoots; x++)
+			this->selectNode(selection.nodes, local, eye, _numLods - 1, x, z, frame);
+	}
+
+	this->evictTiles(frame);
+
+	auto end = std::chrono::high_resolution_clock::now();
+	_selectTime = std::chrono::duration<float, std::milli>(end - begin).count();
+
+	if (camera.getCameraOrder() != CameraOrder::CameraOrderShadow)
+		_numSelectedNodes = selection.nodes.size();
+
+	return !selection.nodes.empty();
+}
+
+void
+TerrainCDLOD::onAddRenderData(RenderDataManager& manager) noexcept
+{
+	for (std::size_t i = 0; i < RenderQueue::RenderQueueRangeSize; i++)
+	{
+		if (_techniques[i])
+			manager.addRenderData((RenderQueue)i, this);
+	}
+}
+
+void
+TerrainCDLOD::onRenderObject(RenderPipeline& pipeline, RenderQueue queue, MaterialTech*) noexcept
+{
+	// an override technique knows nothing about the height tiles, so only our own ones can draw the grid
+	auto& technique = _techniques[queue];
+	if (!technique)
+		return;
+
+	auto selection = _selections.find(pipeline.getCamera());
+	if (selection == _selections.end())
+		return;
+
+	pipeline.setTransform(this->getTransform());
+	pipeline.setTransformInverse(this->getTransformInverse());
+	pipeline.setVertexBuffer(0, _vbo, 0);
+	pipeline.setIndexBuffer(_ibo, 0, GraphicsIndexType::GraphicsIndexTypeUInt32);
+
+	_cdlodCamera->uniform3f(this->getTransformInverse() * pipeline.getCamera()->getTranslate());
+
+	for (auto& node : selection->second.nodes)
+	{
+		float nodeSize = (_gridSize << node.level) * _cellSize;
+		float tileSize = (_tileSize << node.tile->level) * _cellSize;
+
+		float morphEnd = _lodRanges[node.level];
+		float morphStart = std::numeric_limits<float>::max();
+		float morphScale = 0.0f;
+
+		if (node.level + 1 < _numLods)
+		{
+			float prev = node.level > 0 ? _lodRanges[node.level - 1] : 0.0f;
+			morphStart = prev + (morphEnd - prev) * _morphRatio;
+			morphScale = 1.0f / (morphEnd - morphStart);
+		}
+
+		_cdlodNode->uniform4f(float4(node.x * nodeSize, node.z * nodeSize, nodeSize, (float)_gridSize));
+		_cdlodMorph->uniform4f(float4(morphStart, morphScale, _heightScale, 0.0f));
+		_cdlodTile->uniform4f(float4(node.tile->x * tileSize, node.tile->z * tileSize, 1.0f / tileSize, (float)_tileSize));
+		_cdlodHeightMap->uniformTexture(node.tile->heightMap);
+		_cdlodNormalMap->uniformTexture(node.tile->normalMap);
+
+		for (auto& pass : technique->getPassList())
+		{
+			pipeline.setMaterialPass(pass);
+			pipeline.drawIndexedLayer(_numIndices, 1, 0, 0, 0, this->getLayer());
+		}
+	}
+}
+
+_NAME_END
\ No newline at end of file
@@ -0,0 +1,218 @@
+// +----------------------------------------------------------------------
+// | Project : ray.
+// | All rights reserved.
+// +----------------------------------------------------------------------
+// | Copyright (c) 2013-2017.
+// +----------------------------------------------------------------------
+// | * Redistribution and use of this software in source and binary forms,
+// |   with or without modification, are permitted provided that the following
+// |   conditions are met:
+// |
+// | * Redistributions of source code must retain the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer.
+// |
+// | * Redistributions in binary form must reproduce the above
+// |   copyright notice, this list of conditions and the
+// |   following disclaimer in the documentation and/or other
+// |   materials provided with the distribution.
+// |
+// | * Neither the name of the ray team, nor the names of its
+// |   contributors may be used to endorse or promote products
+// |   derived from this software without specific prior
+// |   written permission of the ray team.
+// |
+// | THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// | "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// | LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// | A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// | OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// | SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// | LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// | DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// | THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// | (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// | OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// +----------------------------------------------------------------------
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include <ray/fcntl.h>
+#include <ray/fstream.h>
+#include <ray/package.h>
+#include <ray/utf8.h>
+
+#if defined(__WINDOWS__)
+#	include <windows.h>
+#else
+#	include <dirent.h>
+#	include <sys/stat.h>
+#endif
+
+class Options
+{
+public:
+	Options() noexcept
+		: compress(false)
+	{
+	}
+
+	bool compress;
+
+	std::string input;
+	std::string output;
+};
+
+bool parseOptions(Options& options, int argc, char** argv)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "-z") == 0)
+			options.compress = true;
+		else if (options.input.empty())
+			options.input = argv[i];
+		else if (options.output.empty())
+			options.output = argv[i];
+		else
+			return false;
+	}
+
+	if (options.input.empty() || options.output.empty())
+		return false;
+
+	std::replace(options.input.begin(), options.input.end(), '\\', '/');
+	if (options.input.back() != '/')
+		options.input += '/';
+
+	return true;
+}
+
+void listFiles(const std::string& root, const std::string& relative, std::vector<std::string>& files)
+{
+#if defined(__WINDOWS__)
+	wchar_t pattern[PATHLIMIT];
+	if (!ray::utf8_to_utf16((root + relative + "*").c_str(), pattern))
+		return;
+
+	WIN32_FIND_DATAW data;
+	HANDLE find = ::FindFirstFileW(pattern, &data);
+	if (find == INVALID_HANDLE_VALUE)
+		return;
+
+	do
+	{
+		char name[PATHLIMIT];
+		if (!ray::utf16_to_utf8(data.cFileName, name))
+			continue;
+
+		if (std::strcmp(name, ".") == 0 || std::strcmp(name, "..") == 0)
+			continue;
+
+		if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			listFiles(root, relative + name + "/", files);
+		else
+			files.push_back(relative + name);
+	} while (::FindNextFileW(find, &data));
+
+	::FindClose(find);
+#else
+	DIR* dir = ::opendir((root + relative).c_str());
+	if (!dir)
+		return;
+
+	while (auto entry = ::readdir(dir))
+	{
+		if (std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0)
+			continue;
+
+		struct stat st;
+		if (::stat((root + relative + entry->d_name).c_str(), &st) != 0)
+			continue;
+
+		if (S_ISDIR(st.st_mode))
+			listFiles(root, relative + entry->d_name + "/", files);
+		else if (S_ISREG(st.st_mode))
+			files.push_back(relative + entry->d_name);
+	}
+
+	::closedir(dir);
+#endif
+}
+
+bool readFile(const std::string& path, std::vector<char>& data)
+{
+	ray::ifstream stream;
+	if (!stream.open(path))
+		return false;
+
+	data.resize(stream.size());
+	if (data.empty())
+		return true;
+
+	return (bool)stream.read(data.data(), data.size());
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!parseOptions(options, argc, argv))
+	{
+		std::cout << "usage : Packer [-z] <directory> <output.pak>" << std::endl;
+		std::cout << "  -z : store entries zlib compressed when that saves at least an eighth of their size" << std::endl;
+		return 1;
+	}
+
+	std::vector<std::string> files;
+	listFiles(options.input, "", files);
+	std::sort(files.begin(), files.end());
+
+	if (files.empty())
+	{
+		std::cout << "no files found in : " << options.input << std::endl;
+		return 1;
+	}
+
+	ray::PackageWriter writer;
+	if (!writer.open(options.output))
+	{
+		std::cout << "failed to create : " << options.output << std::endl;
+		return 1;
+	}
+
+	std::uint64_t totalSize = 0;
+	std::uint64_t totalPackedSize = 0;
+
+	std::vector<char> data;
+
+	for (auto& it : files)
+	{
+		if (!readFile(options.input + it, data))
+		{
+			std::cout << "failed to read : " << it << std::endl;
+			return 1;
+		}
+
+		if (!writer.addFile(it, data.data(), data.size(), options.compress))
+		{
+			std::cout << "failed to add : " << it << std::endl;
+			return 1;
+		}
+
+		auto& entry = writer.getEntry(writer.size() - 1);
+		totalSize += entry.size;
+		totalPackedSize += entry.packedSize;
+	}
+
+	if (!writer.close())
+	{
+		std::cout << "failed to write : " << options.output << std::endl;
+		return 1;
+	}
+
+	std::cout << "packed " << files.size() << " files, " << totalSize << " bytes -> " << totalPackedSize << " bytes" << std::endl;
+	return 0;
+}
\ No newline at end of file